@@ -7,6 +7,23 @@ LOCAL_LDFLAGS := -Wformat -Wl,--build-id=none -Wl,-z,relro -fPIE -Wl,-z,now,-z,n
 
 LOCAL_SRC_FILES := \
     VideoEncoderWrapper.cpp \
+    VideoEncoderAsyncWorker.cpp \
+    VideoEncoderBufferPool.cpp \
+    VideoEncoderCapture.cpp \
+    VideoEncoderColorConverter.cpp \
+    VideoEncoderDirtyDetector.cpp \
+    VideoEncoderExecutor.cpp \
+    VideoEncoderFrameRing.cpp \
+    VideoEncoderFrameTrace.cpp \
+    VideoEncoderNalParser.cpp \
+    VideoEncoderOutputRing.cpp \
+    VideoEncoderRateControl.cpp \
+    VideoEncoderScaler.cpp \
+    VideoEncoderScheduler.cpp \
+    VideoEncoderSimd.cpp \
+    VideoEncoderStats.cpp \
+    VideoEncoderWarmPool.cpp \
+    VideoEncoderWorkerGroup.cpp \
     VideoEncoderLog.cpp
 
 LOCAL_C_INCLUDES := \
@@ -0,0 +1,325 @@
+/*
+ * 功能说明: 异步编码工作线程，维护有界待编码队列并按提交顺序编码和回调，
+ *           编码由专属线程执行，或作为串行任务交给共享编码执行器执行。
+ *           编码慢于提交时按过载策略以最新帧替换积压帧、丢弃预计超时的帧或按帧率抽帧，使时延保持有界
+ */
+
+#define LOG_TAG "VideoEncoderAsyncWorker"
+#include "VideoEncoderAsyncWorker.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <system_error>
+#include "VideoEncoderFrameTrace.h"
+#include "VideoEncoderLog.h"
+#include "VideoEncoderTime.h"
+
+namespace {
+    constexpr uint32_t ASYNC_QUEUE_DEPTH_DEFAULT = 4;
+    constexpr uint32_t ASYNC_QUEUE_DEPTH_MAX = 64;
+    constexpr uint32_t ASYNC_FRAME_RATE_DEFAULT = 30;
+    constexpr uint32_t ASYNC_DECIMATION_MAX = 8;
+    constexpr uint64_t ENCODE_TIME_EWMA_WEIGHT = 8;  // 新样本权重为1/8，约8帧后跟上编码耗时的变化
+    constexpr double DECIMATION_HYSTERESIS = 0.9;  // 编码耗时低于较小倍数对应间隔的90%时才降低抽帧倍数
+    constexpr uint64_t NS_PER_SEC = 1000000000;
+    constexpr uint64_t NS_PER_MS = 1000000;
+    constexpr uint64_t NS_PER_US = 1000;
+}
+
+VideoEncoderAsyncWorker::VideoEncoderAsyncWorker(uint32_t encHandle, const VmiAsyncEncodeConfig &config,
+    uint32_t frameRate, EncodeFunc encodeFunc, InputDoneFunc inputDoneFunc)
+    : m_encHandle(encHandle), m_config(config), m_encodeFunc(std::move(encodeFunc)),
+      m_inputDoneFunc(std::move(inputDoneFunc))
+{
+    bool isLatestWins = (m_config.overloadPolicy == VMI_OVERLOAD_LATEST_WINS);
+    uint32_t depth = m_config.queueDepth;
+    if (depth == 0) {
+        depth = isLatestWins ? 1 : ASYNC_QUEUE_DEPTH_DEFAULT;
+    }
+    if (depth > ASYNC_QUEUE_DEPTH_MAX) {
+        WARN("encoder %#x async queue depth %u exceeds max, use %u", encHandle, depth, ASYNC_QUEUE_DEPTH_MAX);
+        depth = ASYNC_QUEUE_DEPTH_MAX;
+    }
+    m_config.queueDepth = depth;
+    // 被替换的帧仍占用队列直到回调，编码一帧期间可能替换多帧，容量满时提交按timeoutMs等待
+    m_capacity = isLatestWins ? ASYNC_QUEUE_DEPTH_MAX : depth;
+    m_queue.resize(m_capacity);
+    SetFrameRate(frameRate);
+}
+
+VideoEncoderAsyncWorker::~VideoEncoderAsyncWorker()
+{
+    Stop(false);
+}
+
+bool VideoEncoderAsyncWorker::Start()
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    if (m_isRunning) {
+        return true;
+    }
+    m_isRunning = true;
+    m_drainOnStop = false;
+    if (m_config.useSharedExecutor) {
+        if (!VideoEncoderExecutor::GetInstance().Attach()) {
+            ERR("encoder %#x attach to shared executor failed", m_encHandle);
+            m_isRunning = false;
+            return false;
+        }
+        return true;
+    }
+    try {
+        m_thread = std::thread(&VideoEncoderAsyncWorker::Run, this);
+    } catch (const std::system_error &e) {
+        ERR("encoder %#x start async worker failed: %s", m_encHandle, e.what());
+        m_isRunning = false;
+        return false;
+    }
+    return true;
+}
+
+void VideoEncoderAsyncWorker::Stop(bool drain)
+{
+    {
+        std::unique_lock<std::mutex> lck(m_lock);
+        if (!m_isRunning) {
+            return;
+        }
+        m_isRunning = false;
+        m_drainOnStop = drain;
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+    if (m_config.useSharedExecutor) {
+        // 已调度的会话由执行器编码或丢弃剩余帧后才不再被引用
+        {
+            std::unique_lock<std::mutex> lck(m_lock);
+            m_idle.wait(lck, [this]() { return !m_isScheduled; });
+        }
+        VideoEncoderExecutor::GetInstance().Detach();
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void VideoEncoderAsyncWorker::SetFrameRate(uint32_t frameRate)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    m_intervalNs = NS_PER_SEC / ((frameRate == 0) ? ASYNC_FRAME_RATE_DEFAULT : frameRate);
+    m_deadlineNs = (m_config.deadlineMs == 0) ? m_intervalNs : m_config.deadlineMs * NS_PER_MS;
+}
+
+bool VideoEncoderAsyncWorker::IsDecimatedLocked()
+{
+    if (!m_config.adaptiveFrameRate) {
+        return false;
+    }
+    return (m_decimationPhase++ % m_decimation) != 0;
+}
+
+void VideoEncoderAsyncWorker::ReplaceOldestLocked()
+{
+    for (uint32_t i = 0; i < m_count; ++i) {
+        PendingFrame &frame = m_queue[(m_head + i) % m_capacity];
+        if (!frame.isReplaced) {
+            frame.isReplaced = true;
+            --m_liveCount;
+            ++m_replacedFrames;
+            return;
+        }
+    }
+}
+
+VmiEncoderRetCode VideoEncoderAsyncWorker::Submit(const uint8_t *inputData, uint32_t inputSize, int32_t timeoutMs,
+    uint64_t *frameSeq)
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    if (m_isRunning && IsDecimatedLocked()) {
+        ++m_decimatedFrames;
+        return VMI_ENCODER_FRAME_DROPPED;
+    }
+    auto hasRoom = [this]() { return !m_isRunning || m_count < m_capacity; };
+    if (timeoutMs < 0) {
+        m_notFull.wait(lck, hasRoom);
+    } else if (!m_notFull.wait_for(lck, std::chrono::milliseconds(timeoutMs), hasRoom)) {
+        return VMI_ENCODER_QUEUE_FULL;
+    }
+    if (!m_isRunning) {
+        return VMI_ENCODER_SUBMIT_FAIL;
+    }
+    // 只有LATEST_WINS的队列容量大于待编码帧数上限，其余策略等到有空位时未替换的帧数必然小于上限
+    if (m_liveCount >= m_config.queueDepth) {
+        ReplaceOldestLocked();
+    }
+    PendingFrame &frame = m_queue[(m_head + m_count) % m_capacity];
+    frame.frameSeq = m_nextFrameSeq++;
+    frame.inputData = inputData;
+    frame.inputSize = inputSize;
+    frame.submitNs = GetMonotonicTimeNs();
+    frame.deadlineNs = frame.submitNs + m_deadlineNs;
+    frame.isReplaced = false;
+    ++m_count;
+    ++m_liveCount;
+    ++m_submittedFrames;
+    if (frameSeq != nullptr) {
+        *frameSeq = frame.frameSeq;
+    }
+    // 共享执行器模式下队列由空变为非空时调度，之后由执行器持续调度直到队列为空
+    bool needSchedule = m_config.useSharedExecutor && !m_isScheduled;
+    m_isScheduled = m_isScheduled || needSchedule;
+    uint64_t deadlineNs = m_queue[m_head].deadlineNs;
+    lck.unlock();
+    if (needSchedule) {
+        VideoEncoderExecutor::GetInstance().Schedule(this, deadlineNs);
+    } else {
+        m_notEmpty.notify_one();
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+void VideoEncoderAsyncWorker::Flush()
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    m_idle.wait(lck, [this]() { return m_count == 0 && !m_isBusy; });
+}
+
+void VideoEncoderAsyncWorker::GetStats(VmiAsyncEncodeStats &stats)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    stats.submittedFrames = m_submittedFrames;
+    stats.encodedFrames = m_encodedFrames;
+    stats.droppedFrames = m_droppedFrames;
+    stats.deadlineMisses = m_deadlineMisses;
+    stats.queueWaitAvgUs = (m_encodedFrames == 0) ? 0 : m_queueWaitTotalNs / m_encodedFrames / NS_PER_US;
+    stats.queueWaitMaxUs = m_queueWaitMaxNs / NS_PER_US;
+    stats.latencyAvgUs = (m_encodedFrames == 0) ? 0 : m_latencyTotalNs / m_encodedFrames / NS_PER_US;
+    stats.latencyMaxUs = m_latencyMaxNs / NS_PER_US;
+    stats.replacedFrames = m_replacedFrames;
+    stats.lateDroppedFrames = m_lateDroppedFrames;
+    stats.decimatedFrames = m_decimatedFrames;
+    stats.decimation = m_decimation;
+    stats.encodeTimeUs = m_encodeTimeNs / NS_PER_US;
+}
+
+void VideoEncoderAsyncWorker::Deliver(const PendingFrame &frame, VmiEncoderRetCode result, uint8_t *outputData,
+    uint32_t outputSize)
+{
+    VmiEncodeOutput output;
+    output.frameSeq = frame.frameSeq;
+    output.result = result;
+    output.inputData = frame.inputData;
+    output.inputSize = frame.inputSize;
+    output.outputData = outputData;
+    output.outputSize = outputSize;
+    FrameTraceKey traceKey = { m_encHandle, frame.frameSeq };
+    VideoEncoderTraceSpan callbackSpan(FRAME_TRACE_CALLBACK, traceKey);
+    m_config.callback(m_encHandle, &output, m_config.userData);
+    callbackSpan.End();
+    if (m_inputDoneFunc != nullptr) {
+        m_inputDoneFunc(frame.inputData);
+    }
+}
+
+void VideoEncoderAsyncWorker::UpdateEncodeTimeLocked(uint64_t encodeNs)
+{
+    m_encodeTimeNs = (m_encodeTimeNs == 0) ? encodeNs :
+        (m_encodeTimeNs * (ENCODE_TIME_EWMA_WEIGHT - 1) + encodeNs) / ENCODE_TIME_EWMA_WEIGHT;
+    if (!m_config.adaptiveFrameRate) {
+        return;
+    }
+    // 每decimation帧编码一帧时编码间隔不小于编码耗时，积压不再增长
+    auto needed = static_cast<uint32_t>(std::min<uint64_t>((m_encodeTimeNs + m_intervalNs - 1) / m_intervalNs,
+        ASYNC_DECIMATION_MAX));
+    needed = std::max(needed, 1U);
+    if (needed > m_decimation ||
+        m_encodeTimeNs < (m_decimation - 1) * m_intervalNs * DECIMATION_HYSTERESIS) {
+        if (needed != m_decimation) {
+            INFO("encoder %#x adaptive decimation %u -> %u, encode time %" PRIu64 " us", m_encHandle,
+                m_decimation, needed, m_encodeTimeNs / NS_PER_US);
+        }
+        m_decimation = needed;
+    }
+}
+
+void VideoEncoderAsyncWorker::ProcessFrameLocked(std::unique_lock<std::mutex> &lck)
+{
+    PendingFrame frame = m_queue[m_head];
+    m_head = (m_head + 1) % m_capacity;
+    --m_count;
+    m_liveCount -= frame.isReplaced ? 0 : 1;
+    uint64_t startNs = GetMonotonicTimeNs();
+    bool isStopping = !m_isRunning && !m_drainOnStop;
+    // 其后还有待编码帧时才按截止时间丢弃，保证最新的帧总会被编码
+    bool isLate = !frame.isReplaced && !isStopping && m_config.dropLateFrames && m_liveCount > 0 &&
+        startNs + m_encodeTimeNs > frame.deadlineNs;
+    bool drop = frame.isReplaced || isStopping || isLate;
+    m_isBusy = true;
+    lck.unlock();
+    m_notFull.notify_one();
+
+    uint64_t encodeNs = 0;
+    if (drop) {
+        Deliver(frame, VMI_ENCODER_FRAME_DROPPED, nullptr, 0);
+    } else {
+        uint8_t *outputData = nullptr;
+        uint32_t outputSize = 0;
+        VmiEncoderRetCode ret = m_encodeFunc(frame.inputData, frame.inputSize, &outputData, &outputSize);
+        encodeNs = GetMonotonicTimeNs() - startNs;
+        Deliver(frame, ret, outputData, outputSize);
+    }
+    uint64_t endNs = GetMonotonicTimeNs();
+
+    lck.lock();
+    m_isBusy = false;
+    if (drop) {
+        ++m_droppedFrames;
+        m_lateDroppedFrames += isLate ? 1 : 0;
+        return;
+    }
+    UpdateEncodeTimeLocked(encodeNs);
+    ++m_encodedFrames;
+    m_queueWaitTotalNs += startNs - frame.submitNs;
+    m_queueWaitMaxNs = std::max(m_queueWaitMaxNs, startNs - frame.submitNs);
+    m_latencyTotalNs += endNs - frame.submitNs;
+    m_latencyMaxNs = std::max(m_latencyMaxNs, endNs - frame.submitNs);
+    if (endNs > frame.deadlineNs) {
+        ++m_deadlineMisses;
+        if (m_config.useSharedExecutor) {
+            VideoEncoderExecutor::GetInstance().RecordDeadlineMiss();
+        }
+    }
+}
+
+bool VideoEncoderAsyncWorker::RunStep(uint64_t &nextDeadlineNs)
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    if (m_count > 0) {
+        ProcessFrameLocked(lck);
+    }
+    if (m_count == 0) {
+        m_isScheduled = false;
+        m_idle.notify_all();
+        return false;
+    }
+    nextDeadlineNs = m_queue[m_head].deadlineNs;
+    return true;
+}
+
+void VideoEncoderAsyncWorker::Run()
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    while (true) {
+        m_notEmpty.wait(lck, [this]() { return m_count > 0 || !m_isRunning; });
+        if (m_count == 0) {
+            break;
+        }
+        ProcessFrameLocked(lck);
+        if (m_count == 0) {
+            m_idle.notify_all();
+        }
+    }
+    m_isBusy = false;
+    m_idle.notify_all();
+}
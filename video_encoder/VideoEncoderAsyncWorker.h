@@ -0,0 +1,150 @@
+/*
+ * 功能说明: 异步编码工作线程，维护有界待编码队列并按提交顺序编码和回调，
+ *           编码由专属线程执行，或作为串行任务交给共享编码执行器执行。
+ *           编码慢于提交时按过载策略以最新帧替换积压帧、丢弃预计超时的帧或按帧率抽帧，使时延保持有界
+ */
+#ifndef VIDEO_ENCODER_ASYNC_WORKER_H
+#define VIDEO_ENCODER_ASYNC_WORKER_H
+
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VideoEncoderExecutor.h"
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderAsyncWorker : public VideoEncoderExecutor::Strand {
+public:
+    using EncodeFunc = std::function<VmiEncoderRetCode(const uint8_t *inputData, uint32_t inputSize,
+        uint8_t **outputData, uint32_t *outputSize)>;
+    using InputDoneFunc = std::function<void(const uint8_t *inputData)>;
+
+    /**
+     * @功能描述: 构造函数
+     * @参数 [in] encHandle: 编码器对象句柄，透传给回调
+     * @参数 [in] config: 异步编码配置
+     * @参数 [in] frameRate: 编码帧率，决定帧间隔和默认截止时间，0表示30帧/秒
+     * @参数 [in] encodeFunc: 编码一帧的实现，在工作线程上调用
+     * @参数 [in] inputDoneFunc: 每帧回调返回后调用，用于回收输入数据
+     */
+    VideoEncoderAsyncWorker(uint32_t encHandle, const VmiAsyncEncodeConfig &config, uint32_t frameRate,
+        EncodeFunc encodeFunc, InputDoneFunc inputDoneFunc);
+
+    /**
+     * @功能描述: 析构函数，丢弃未编码的帧并退出工作线程
+     */
+    ~VideoEncoderAsyncWorker() override;
+
+    /**
+     * @功能描述: 启动专属工作线程，或登记到共享编码执行器
+     * @返回值: true 成功，false 失败
+     */
+    bool Start();
+
+    /**
+     * @功能描述: 停止工作线程，或等待共享编码执行器处理完本会话后注销
+     * @参数 [in] drain: true 先编码完已提交的帧，false 丢弃未编码的帧并以VMI_ENCODER_FRAME_DROPPED回调
+     */
+    void Stop(bool drain);
+
+    /**
+     * @功能描述: 提交一帧数据，队列满时按timeoutMs等待
+     * @参数 [in] inputData: 编码输入数据地址
+     * @参数 [in] inputSize: 编码输入数据大小
+     * @参数 [in] timeoutMs: 队列满时的等待时间，0表示不等待，小于0表示一直等待
+     * @参数 [out] frameSeq: 分配的帧序号，可为空
+     * @返回值: VMI_ENCODER_SUCCESS 成功
+     *          VMI_ENCODER_QUEUE_FULL 等待超时后队列仍满
+     *          VMI_ENCODER_FRAME_DROPPED 被自适应抽帧丢弃
+     *          VMI_ENCODER_SUBMIT_FAIL 工作线程未运行
+     */
+    VmiEncoderRetCode Submit(const uint8_t *inputData, uint32_t inputSize, int32_t timeoutMs, uint64_t *frameSeq);
+
+    /**
+     * @功能描述: 编码帧率变化时调用，更新帧间隔，未配置deadlineMs时同时更新截止时间
+     * @参数 [in] frameRate: 编码帧率，0表示30帧/秒
+     */
+    void SetFrameRate(uint32_t frameRate);
+
+    /**
+     * @功能描述: 等待已提交的帧全部编码并回调完成
+     */
+    void Flush();
+
+    /**
+     * @功能描述: 获取异步编码统计
+     * @参数 [out] stats: 异步编码统计
+     */
+    void GetStats(VmiAsyncEncodeStats &stats);
+
+    /**
+     * @功能描述: 共享编码执行器模式下编码或丢弃队首一帧
+     * @参数 [out] nextDeadlineNs: 返回true时为新队首帧的截止时间
+     * @返回值: true 队列中还有帧，false 队列已空，本会话不再处于调度中
+     */
+    bool RunStep(uint64_t &nextDeadlineNs) override;
+
+private:
+    VideoEncoderAsyncWorker(const VideoEncoderAsyncWorker&) = delete;
+    VideoEncoderAsyncWorker& operator=(const VideoEncoderAsyncWorker&) = delete;
+    VideoEncoderAsyncWorker(VideoEncoderAsyncWorker &&) = delete;
+    VideoEncoderAsyncWorker& operator=(VideoEncoderAsyncWorker &&) = delete;
+
+    struct PendingFrame {
+        uint64_t frameSeq = 0;
+        const uint8_t *inputData = nullptr;
+        uint32_t inputSize = 0;
+        uint64_t submitNs = 0;
+        uint64_t deadlineNs = 0;
+        bool isReplaced = false;  // 已被更新的帧替换，出队时直接以VMI_ENCODER_FRAME_DROPPED回调
+    };
+
+    void Run();
+    bool IsDecimatedLocked();
+    void ReplaceOldestLocked();
+    void UpdateEncodeTimeLocked(uint64_t encodeNs);
+    void ProcessFrameLocked(std::unique_lock<std::mutex> &lck);
+    void Deliver(const PendingFrame &frame, VmiEncoderRetCode result, uint8_t *outputData, uint32_t outputSize);
+
+    uint32_t m_encHandle = 0;
+    VmiAsyncEncodeConfig m_config = {};  // queueDepth为待编码帧数上限
+    uint32_t m_capacity = 0;    // 环形队列容量，LATEST_WINS时还需容纳已被替换、尚未回调的帧
+    uint64_t m_intervalNs = 0;  // 帧间隔
+    uint64_t m_deadlineNs = 0;  // 帧从提交到编码完成的时限
+    EncodeFunc m_encodeFunc = nullptr;
+    InputDoneFunc m_inputDoneFunc = nullptr;
+
+    std::mutex m_lock = {};
+    std::condition_variable m_notEmpty = {};
+    std::condition_variable m_notFull = {};
+    std::condition_variable m_idle = {};
+    std::vector<PendingFrame> m_queue = {};  // 固定容量环形队列
+    uint32_t m_head = 0;
+    uint32_t m_count = 0;
+    uint32_t m_liveCount = 0;  // 队列中未被替换的帧数
+    uint64_t m_nextFrameSeq = 0;
+    bool m_isBusy = false;
+    bool m_isRunning = false;
+    bool m_drainOnStop = false;
+    bool m_isScheduled = false;  // 共享执行器模式下已交给执行器，直到队列为空
+    std::thread m_thread;
+
+    uint64_t m_submittedFrames = 0;
+    uint64_t m_encodedFrames = 0;
+    uint64_t m_droppedFrames = 0;
+    uint64_t m_deadlineMisses = 0;
+    uint64_t m_queueWaitTotalNs = 0;
+    uint64_t m_queueWaitMaxNs = 0;
+    uint64_t m_latencyTotalNs = 0;
+    uint64_t m_latencyMaxNs = 0;
+    uint64_t m_replacedFrames = 0;
+    uint64_t m_lateDroppedFrames = 0;
+    uint64_t m_decimatedFrames = 0;
+    uint64_t m_decimationPhase = 0;  // 开启自适应抽帧后的提交调用计数
+    uint32_t m_decimation = 1;
+    uint64_t m_encodeTimeNs = 0;  // 单帧编码耗时的指数滑动平均
+};
+
+#endif  // VIDEO_ENCODER_ASYNC_WORKER_H
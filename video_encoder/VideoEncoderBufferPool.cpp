@@ -0,0 +1,170 @@
+/*
+ * 功能说明: 编码输入缓冲池，预分配页对齐的帧缓冲区并复用，避免每帧申请释放大块内存
+ */
+
+#define LOG_TAG "VideoEncoderBufferPool"
+#include "VideoEncoderBufferPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "VideoEncoderLog.h"
+
+namespace {
+    constexpr uint32_t BUFFER_POOL_INIT_COUNT_DEFAULT = 4;
+    constexpr uint32_t BUFFER_POOL_MAX_COUNT_DEFAULT = 8;
+    constexpr uint32_t BUFFER_POOL_MAX_COUNT_LIMIT = 64;
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    size_t AlignUp(size_t size, size_t align)
+    {
+        return (size + align - 1) / align * align;
+    }
+}
+
+VideoEncoderBufferPool::~VideoEncoderBufferPool()
+{
+    for (auto &buffer : m_buffers) {
+        FreeBuffer(buffer);
+    }
+}
+
+bool VideoEncoderBufferPool::AllocateBuffer(Buffer &buffer) const
+{
+    // MAP_POPULATE预先建立页表，编码热路径上首次写入不再触发缺页
+    if (m_useHugePage) {
+        size_t mapSize = AlignUp(m_bufferSize, HUGE_PAGE_SIZE);
+        void *addr = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        if (addr != MAP_FAILED) {
+            buffer.data = static_cast<uint8_t *>(addr);
+            buffer.mapSize = mapSize;
+            buffer.size = m_bufferSize;
+            return true;
+        }
+        DBG("mmap %zu bytes with huge page failed: %s, fallback to normal page", mapSize, strerror(errno));
+    }
+    size_t mapSize = AlignUp(m_bufferSize, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    void *addr = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (addr == MAP_FAILED) {
+        ERR("mmap %zu bytes failed: %s", mapSize, strerror(errno));
+        return false;
+    }
+    if (m_useHugePage && mapSize >= HUGE_PAGE_SIZE) {
+        (void) madvise(addr, mapSize, MADV_HUGEPAGE);
+    }
+    buffer.data = static_cast<uint8_t *>(addr);
+    buffer.mapSize = mapSize;
+    buffer.size = m_bufferSize;
+    return true;
+}
+
+void VideoEncoderBufferPool::FreeBuffer(Buffer &buffer)
+{
+    if (buffer.data != nullptr) {
+        (void) munmap(buffer.data, buffer.mapSize);
+        buffer.data = nullptr;
+        buffer.mapSize = 0;
+    }
+}
+
+std::vector<VideoEncoderBufferPool::Buffer>::iterator VideoEncoderBufferPool::FindBuffer(const uint8_t *data)
+{
+    return std::find_if(m_buffers.begin(), m_buffers.end(),
+        [data](const Buffer &buffer) { return buffer.data == data; });
+}
+
+bool VideoEncoderBufferPool::Init(uint32_t bufferSize, const VmiBufferPoolConfig &config)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    auto it = m_buffers.begin();
+    while (it != m_buffers.end()) {
+        if (it->isAcquired) {
+            it->isStale = true;
+            ++it;
+        } else {
+            FreeBuffer(*it);
+            it = m_buffers.erase(it);
+        }
+    }
+    m_bufferSize = bufferSize;
+    m_useHugePage = config.useHugePage;
+    uint32_t initCount = (config.initCount == 0) ? BUFFER_POOL_INIT_COUNT_DEFAULT : config.initCount;
+    m_maxCount = (config.maxCount == 0) ? BUFFER_POOL_MAX_COUNT_DEFAULT : config.maxCount;
+    m_maxCount = std::min(std::max(m_maxCount, initCount), BUFFER_POOL_MAX_COUNT_LIMIT);
+    initCount = std::min(initCount, m_maxCount);
+    for (uint32_t i = 0; i < initCount; ++i) {
+        Buffer buffer;
+        if (!AllocateBuffer(buffer)) {
+            return false;
+        }
+        m_buffers.push_back(buffer);
+    }
+    INFO("buffer pool init: buffer size %u, init count %u, max count %u, huge page %d",
+        m_bufferSize, initCount, m_maxCount, m_useHugePage);
+    return true;
+}
+
+uint8_t *VideoEncoderBufferPool::Acquire(uint32_t &size)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    if (m_bufferSize == 0) {
+        return nullptr;
+    }
+    auto it = std::find_if(m_buffers.begin(), m_buffers.end(),
+        [](const Buffer &buffer) { return !buffer.isAcquired; });
+    if (it != m_buffers.end()) {
+        ++m_hits;
+    } else {
+        ++m_misses;
+        uint32_t freshCount = static_cast<uint32_t>(std::count_if(m_buffers.begin(), m_buffers.end(),
+            [](const Buffer &buffer) { return !buffer.isStale; }));
+        Buffer buffer;
+        if (freshCount >= m_maxCount || !AllocateBuffer(buffer)) {
+            ++m_exhausted;
+            return nullptr;
+        }
+        it = m_buffers.insert(m_buffers.end(), buffer);
+    }
+    it->isAcquired = true;
+    ++m_acquiredCount;
+    m_highWaterMark = std::max(m_highWaterMark, m_acquiredCount);
+    size = it->size;
+    return it->data;
+}
+
+bool VideoEncoderBufferPool::Release(const uint8_t *buffer)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    auto it = FindBuffer(buffer);
+    if (it == m_buffers.end() || !it->isAcquired) {
+        return false;
+    }
+    it->isAcquired = false;
+    --m_acquiredCount;
+    if (it->isStale) {
+        FreeBuffer(*it);
+        (void) m_buffers.erase(it);
+    }
+    return true;
+}
+
+bool VideoEncoderBufferPool::IsAcquired(const uint8_t *buffer) const
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    return std::any_of(m_buffers.begin(), m_buffers.end(),
+        [buffer](const Buffer &item) { return item.data == buffer && item.isAcquired; });
+}
+
+void VideoEncoderBufferPool::GetStats(VmiBufferPoolStats &stats) const
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    stats.bufferSize = m_bufferSize;
+    stats.totalBuffers = static_cast<uint32_t>(m_buffers.size());
+    stats.acquiredBuffers = m_acquiredCount;
+    stats.highWaterMark = m_highWaterMark;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.exhausted = m_exhausted;
+}
@@ -0,0 +1,88 @@
+/*
+ * 功能说明: 编码输入缓冲池，预分配页对齐的帧缓冲区并复用，避免每帧申请释放大块内存
+ */
+#ifndef VIDEO_ENCODER_BUFFER_POOL_H
+#define VIDEO_ENCODER_BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderBufferPool {
+public:
+    VideoEncoderBufferPool() = default;
+
+    /**
+     * @功能描述: 析构函数，释放所有缓冲区
+     */
+    ~VideoEncoderBufferPool();
+
+    /**
+     * @功能描述: 按缓冲区大小(重新)初始化缓冲池并预分配缓冲区，空闲缓冲区立即释放，
+     *            仍被占用的旧缓冲区在归还时释放
+     * @参数 [in] bufferSize: 单个缓冲区大小
+     * @参数 [in] config: 缓冲池配置
+     * @返回值: true 成功，false 预分配失败
+     */
+    bool Init(uint32_t bufferSize, const VmiBufferPoolConfig &config);
+
+    /**
+     * @功能描述: 获取一个空闲缓冲区，无空闲缓冲区且未达上限时新分配一个
+     * @参数 [out] size: 该缓冲区的大小，与地址在同一次加锁中取得，不受并发重新初始化影响
+     * @返回值: 缓冲区地址，缓冲池未初始化或已达上限时返回空
+     */
+    uint8_t *Acquire(uint32_t &size);
+
+    /**
+     * @功能描述: 归还缓冲区
+     * @参数 [in] buffer: 缓冲区地址
+     * @返回值: true 成功，false 缓冲区不属于该缓冲池或未被占用
+     */
+    bool Release(const uint8_t *buffer);
+
+    /**
+     * @功能描述: 判断缓冲区是否为该缓冲池中被占用的缓冲区
+     * @参数 [in] buffer: 缓冲区地址
+     * @返回值: true 是，false 否
+     */
+    bool IsAcquired(const uint8_t *buffer) const;
+
+    /**
+     * @功能描述: 获取缓冲池统计信息
+     * @参数 [out] stats: 统计信息
+     */
+    void GetStats(VmiBufferPoolStats &stats) const;
+
+private:
+    VideoEncoderBufferPool(const VideoEncoderBufferPool&) = delete;
+    VideoEncoderBufferPool& operator=(const VideoEncoderBufferPool&) = delete;
+    VideoEncoderBufferPool(VideoEncoderBufferPool &&) = delete;
+    VideoEncoderBufferPool& operator=(VideoEncoderBufferPool &&) = delete;
+
+    struct Buffer {
+        uint8_t *data = nullptr;
+        size_t mapSize = 0;
+        uint32_t size = 0;  // 分配时的缓冲区大小，重新初始化后旧缓冲区仍保持原大小
+        bool isAcquired = false;
+        bool isStale = false;  // 缓冲池重新初始化前分配，归还时释放
+    };
+
+    bool AllocateBuffer(Buffer &buffer) const;
+    static void FreeBuffer(Buffer &buffer);
+    std::vector<Buffer>::iterator FindBuffer(const uint8_t *data);
+
+    mutable std::mutex m_lock = {};
+    std::vector<Buffer> m_buffers = {};
+    uint32_t m_bufferSize = 0;
+    uint32_t m_maxCount = 0;
+    bool m_useHugePage = false;
+    uint32_t m_acquiredCount = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_exhausted = 0;
+    uint32_t m_highWaterMark = 0;
+};
+
+#endif  // VIDEO_ENCODER_BUFFER_POOL_H
@@ -0,0 +1,430 @@
+/*
+ * 功能说明: 编码会话抓取，将输入帧、编码参数、调用时间和输出大小追加写入内存映射的抓取文件，
+ *           输入帧与上一帧异或后按游程压缩存储；读取器按记录顺序解析抓取文件供离线回放
+ */
+
+#define LOG_TAG "VideoEncoderCapture"
+#include "VideoEncoderCapture.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "VideoEncoderLog.h"
+#include "VideoEncoderTime.h"
+
+namespace {
+    // 写入窗口大小，文件按窗口扩展并映射，内存占用与抓取时长无关
+    constexpr uint64_t WINDOW_SIZE = 16 * 1024 * 1024;
+    constexpr uint32_t WORD_SIZE = sizeof(uint64_t);
+    constexpr uint32_t CHUNK_SIZE = 256;  // 相同部分先按块用memcmp比较，libc按SIMD实现
+    constexpr uint8_t VARINT_MORE = 0x80;
+    constexpr uint8_t VARINT_MASK = 0x7f;
+    constexpr uint32_t VARINT_SHIFT = 7;
+    constexpr uint32_t VARINT_MAX_LEN = 5;
+
+    uint64_t LoadWord(const uint8_t *data)
+    {
+        uint64_t word = 0;
+        (void) memcpy(&word, data, WORD_SIZE);
+        return word;
+    }
+
+    // 返回从pos开始cur与prev相同部分的结束位置，按块、8字节、单字节逐级比较
+    uint32_t SkipEqual(const uint8_t *cur, const uint8_t *prev, uint32_t pos, uint32_t size)
+    {
+        while (pos + CHUNK_SIZE <= size && memcmp(cur + pos, prev + pos, CHUNK_SIZE) == 0) {
+            pos += CHUNK_SIZE;
+        }
+        while (pos + WORD_SIZE <= size && LoadWord(cur + pos) == LoadWord(prev + pos)) {
+            pos += WORD_SIZE;
+        }
+        while (pos < size && cur[pos] == prev[pos]) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    // 返回从pos开始cur与prev不同部分的结束位置，连续8个相同字节才结束，避免过多的短游程
+    uint32_t SkipDifferent(const uint8_t *cur, const uint8_t *prev, uint32_t pos, uint32_t size)
+    {
+        uint32_t equalRun = 0;
+        while (pos < size) {
+            if (pos + WORD_SIZE <= size && equalRun == 0 && LoadWord(cur + pos) != LoadWord(prev + pos)) {
+                pos += WORD_SIZE;
+                continue;
+            }
+            if (cur[pos] == prev[pos]) {
+                if (++equalRun == WORD_SIZE) {
+                    return pos + 1 - WORD_SIZE;
+                }
+            } else {
+                equalRun = 0;
+            }
+            ++pos;
+        }
+        return pos - equalRun;
+    }
+
+    uint8_t *PutVarint(uint8_t *out, uint32_t value)
+    {
+        while (value >= VARINT_MORE) {
+            *out++ = static_cast<uint8_t>(value | VARINT_MORE);
+            value >>= VARINT_SHIFT;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    bool GetVarint(const uint8_t *&in, const uint8_t *end, uint32_t &value)
+    {
+        value = 0;
+        for (uint32_t i = 0; i < VARINT_MAX_LEN && in < end; ++i) {
+            uint8_t byte = *in++;
+            value |= static_cast<uint32_t>(byte & VARINT_MASK) << (VARINT_SHIFT * i);
+            if ((byte & VARINT_MORE) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+VideoEncoderCaptureWriter::~VideoEncoderCaptureWriter()
+{
+    Close();
+}
+
+bool VideoEncoderCaptureWriter::Open(const std::string &path, uint64_t maxFileSize, uint32_t encType)
+{
+    Close();
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP);
+    if (m_fd < 0) {
+        ERR("open capture file %s failed: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    m_maxFileSize = std::max<uint64_t>(maxFileSize, sizeof(CaptureFileHeader));
+    m_fileSize = 0;
+    m_offset = 0;
+    m_isFull = false;
+    m_startTimeUs = GetMonotonicTimeUs();
+    m_prevFrame.clear();
+    m_frames = 0;
+    m_droppedFrames = 0;
+    m_inputBytes = 0;
+    CaptureFileHeader header = {};
+    (void) memcpy(header.magic, CAPTURE_FILE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_FILE_VERSION;
+    header.encType = encType;
+    header.startTimeUs = m_startTimeUs;
+    if (!MapWindow(0)) {
+        Close();
+        return false;
+    }
+    Write(&header, sizeof(header));
+    INFO("capture to %s, max %" PRIu64 " bytes", path.c_str(), m_maxFileSize);
+    return true;
+}
+
+void VideoEncoderCaptureWriter::Close()
+{
+    if (m_window != nullptr) {
+        (void) munmap(m_window, WINDOW_SIZE);
+        m_window = nullptr;
+    }
+    if (m_fd >= 0) {
+        if (ftruncate(m_fd, static_cast<off_t>(m_offset)) != 0) {
+            WARN("truncate capture file failed: %s", strerror(errno));
+        }
+        (void) close(m_fd);
+        m_fd = -1;
+        INFO("capture closed: %" PRIu64 " frames, %" PRIu64 " input bytes in %" PRIu64 " bytes", m_frames,
+            m_inputBytes, m_offset);
+    }
+}
+
+uint64_t VideoEncoderCaptureWriter::GetTimestampUs(uint64_t nowUs) const
+{
+    return (nowUs > m_startTimeUs) ? nowUs - m_startTimeUs : 0;
+}
+
+bool VideoEncoderCaptureWriter::MapWindow(uint64_t offset)
+{
+    uint64_t windowOffset = offset - offset % WINDOW_SIZE;
+    if (m_window != nullptr && windowOffset == m_windowOffset) {
+        return true;
+    }
+    if (m_window != nullptr) {
+        (void) munmap(m_window, WINDOW_SIZE);
+        m_window = nullptr;
+    }
+    // 文件按窗口扩展，未写入部分为空洞，不占用磁盘空间，关闭时截断
+    if (m_fileSize < windowOffset + WINDOW_SIZE) {
+        if (ftruncate(m_fd, static_cast<off_t>(windowOffset + WINDOW_SIZE)) != 0) {
+            ERR("extend capture file failed: %s", strerror(errno));
+            return false;
+        }
+        m_fileSize = windowOffset + WINDOW_SIZE;
+    }
+    void *window = mmap(nullptr, WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd,
+        static_cast<off_t>(windowOffset));
+    if (window == MAP_FAILED) {
+        ERR("map capture file at %" PRIu64 " failed: %s", windowOffset, strerror(errno));
+        return false;
+    }
+    m_window = static_cast<uint8_t *>(window);
+    m_windowOffset = windowOffset;
+    return true;
+}
+
+void VideoEncoderCaptureWriter::Write(const void *data, size_t size)
+{
+    auto src = static_cast<const uint8_t *>(data);
+    while (size > 0) {
+        if (!MapWindow(m_offset)) {
+            m_isFull = true;
+            return;
+        }
+        uint64_t pos = m_offset - m_windowOffset;
+        auto len = static_cast<size_t>(std::min<uint64_t>(size, WINDOW_SIZE - pos));
+        (void) memcpy(m_window + pos, src, len);
+        src += len;
+        size -= len;
+        m_offset += len;
+    }
+}
+
+bool VideoEncoderCaptureWriter::BeginRecord(uint32_t type, uint64_t payloadSize)
+{
+    if (m_fd < 0 || m_isFull) {
+        return false;
+    }
+    // 结束标记占一个记录头，保证文件末尾之前的记录总是完整的
+    if (payloadSize > UINT32_MAX ||
+        m_offset + 2 * sizeof(CaptureRecordHeader) + payloadSize > m_maxFileSize) {
+        WARN("capture file reaches max size %" PRIu64 " bytes, stop capturing", m_maxFileSize);
+        m_isFull = true;
+        return false;
+    }
+    CaptureRecordHeader header = { type, static_cast<uint32_t>(payloadSize) };
+    Write(&header, sizeof(header));
+    return !m_isFull;
+}
+
+void VideoEncoderCaptureWriter::RecordParams(const EncodeParams &params)
+{
+    CaptureParamsRecord record = {};
+    record.timestampUs = GetTimestampUs(GetMonotonicTimeUs());
+    record.width = params.width;
+    record.height = params.height;
+    record.frameRate = params.frameRate;
+    record.bitrate = params.bitrate;
+    record.gopSize = params.gopSize;
+    record.profile = params.profile;
+    if (BeginRecord(CAPTURE_RECORD_PARAMS, sizeof(record))) {
+        Write(&record, sizeof(record));
+    }
+}
+
+void VideoEncoderCaptureWriter::RecordInputFormat(const VmiInputFormat &format)
+{
+    CaptureInputFormatRecord record = {};
+    record.timestampUs = GetTimestampUs(GetMonotonicTimeUs());
+    record.pixelFormat = format.pixelFormat;
+    record.stride = format.stride;
+    record.convertThreads = format.convertThreads;
+    if (BeginRecord(CAPTURE_RECORD_INPUT_FORMAT, sizeof(record))) {
+        Write(&record, sizeof(record));
+    }
+}
+
+void VideoEncoderCaptureWriter::RecordKeyFrameRequest()
+{
+    CaptureKeyFrameRecord record = { GetTimestampUs(GetMonotonicTimeUs()) };
+    if (BeginRecord(CAPTURE_RECORD_KEY_FRAME, sizeof(record))) {
+        Write(&record, sizeof(record));
+    }
+}
+
+void VideoEncoderCaptureWriter::RecordFrame(uint64_t startUs, uint64_t callTimeUs, VmiEncoderRetCode result,
+    const uint8_t *inputData, uint32_t inputSize, uint32_t outputSize)
+{
+    if (m_fd < 0) {
+        return;
+    }
+    if (inputData == nullptr) {
+        inputSize = 0;
+    }
+    CaptureFrameRecord record = {};
+    record.timestampUs = GetTimestampUs(startUs);
+    record.callTimeUs = static_cast<uint32_t>(std::min<uint64_t>(callTimeUs, UINT32_MAX));
+    record.result = result;
+    record.inputSize = inputSize;
+    record.outputSize = outputSize;
+    record.encoding = CAPTURE_FRAME_RAW;
+    const uint8_t *payload = inputData;
+    uint32_t payloadSize = inputSize;
+    bool isDelta = inputSize != 0 && m_prevFrame.size() == inputSize;
+    uint32_t deltaSize = 0;
+    try {
+        if (isDelta && EncodeDelta(inputData, m_prevFrame.data(), inputSize, m_delta, deltaSize)) {
+            record.encoding = CAPTURE_FRAME_DELTA;
+            payload = m_delta.data();
+            payloadSize = deltaSize;
+        } else {
+            m_prevFrame.assign(inputData, inputData + inputSize);
+        }
+    } catch (const std::bad_alloc &e) {
+        ERR("capture frame failed: alloc memory failed");
+        m_prevFrame.clear();
+    }
+    if (!BeginRecord(CAPTURE_RECORD_FRAME, sizeof(record) + static_cast<uint64_t>(payloadSize))) {
+        // 上一帧已更新为未记录的当前帧，之后的帧不能再以其为参考
+        m_prevFrame.clear();
+        ++m_droppedFrames;
+        return;
+    }
+    Write(&record, sizeof(record));
+    if (payloadSize != 0) {
+        Write(payload, payloadSize);
+    }
+    ++m_frames;
+    m_inputBytes += inputSize;
+}
+
+void VideoEncoderCaptureWriter::GetStats(VmiCaptureStats &stats) const
+{
+    stats.frames = m_frames;
+    stats.droppedFrames = m_droppedFrames;
+    stats.inputBytes = m_inputBytes;
+    stats.fileBytes = m_offset;
+    stats.isFull = m_isFull;
+}
+
+bool VideoEncoderCaptureWriter::EncodeDelta(const uint8_t *cur, uint8_t *prev, uint32_t size,
+    std::vector<uint8_t> &out, uint32_t &outSize)
+{
+    // 每个游程对最多占两个变长整数，编码结果达到原始大小即放弃。缓冲区只增不减，避免每帧重新初始化
+    if (out.size() < static_cast<size_t>(size) + 2 * VARINT_MAX_LEN) {
+        out.resize(static_cast<size_t>(size) + 2 * VARINT_MAX_LEN);
+    }
+    uint8_t *dst = out.data();
+    const uint8_t *limit = out.data() + size;
+    uint32_t pos = 0;
+    while (pos < size) {
+        uint32_t diffBegin = SkipEqual(cur, prev, pos, size);
+        uint32_t diffEnd = SkipDifferent(cur, prev, diffBegin, size);
+        dst = PutVarint(dst, diffBegin - pos);
+        dst = PutVarint(dst, diffEnd - diffBegin);
+        if (dst + (diffEnd - diffBegin) >= limit) {
+            return false;
+        }
+        // 只有不同部分需要更新到上一帧，避免每帧整帧拷贝
+        for (uint32_t i = diffBegin; i < diffEnd; ++i) {
+            *dst++ = cur[i] ^ prev[i];
+            prev[i] = cur[i];
+        }
+        pos = diffEnd;
+    }
+    outSize = static_cast<uint32_t>(dst - out.data());
+    return true;
+}
+
+VideoEncoderCaptureReader::~VideoEncoderCaptureReader()
+{
+    if (m_map != nullptr) {
+        (void) munmap(m_map, m_size);
+    }
+}
+
+bool VideoEncoderCaptureReader::Open(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ERR("open capture file %s failed: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(CaptureFileHeader)) {
+        ERR("capture file %s is too small", path.c_str());
+        (void) close(fd);
+        return false;
+    }
+    void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    (void) close(fd);
+    if (data == MAP_FAILED) {
+        ERR("map capture file %s failed: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    m_map = data;
+    m_data = static_cast<const uint8_t *>(data);
+    m_size = static_cast<size_t>(st.st_size);
+    (void) memcpy(&m_header, m_data, sizeof(m_header));
+    if (memcmp(m_header.magic, CAPTURE_FILE_MAGIC, sizeof(m_header.magic)) != 0 ||
+        m_header.version != CAPTURE_FILE_VERSION) {
+        ERR("capture file %s has invalid magic or version %u", path.c_str(), m_header.version);
+        return false;
+    }
+    m_offset = sizeof(CaptureFileHeader);
+    return true;
+}
+
+bool VideoEncoderCaptureReader::Next(Record &record)
+{
+    if (m_data == nullptr || m_offset + sizeof(CaptureRecordHeader) > m_size) {
+        return false;
+    }
+    CaptureRecordHeader header = {};
+    (void) memcpy(&header, m_data + m_offset, sizeof(header));
+    // 进程异常退出时文件末尾可能残留未截断的空洞，读到类型0即结束
+    if (header.type == CAPTURE_RECORD_END || m_offset + sizeof(header) + header.size > m_size) {
+        return false;
+    }
+    record.type = header.type;
+    record.payload = m_data + m_offset + sizeof(header);
+    record.size = header.size;
+    m_offset += sizeof(header) + header.size;
+    return true;
+}
+
+bool VideoEncoderCaptureReader::DecodeFrame(const Record &record, std::vector<uint8_t> &frame)
+{
+    CaptureFrameRecord info = {};
+    if (record.type != CAPTURE_RECORD_FRAME || record.size < sizeof(info)) {
+        return false;
+    }
+    (void) memcpy(&info, record.payload, sizeof(info));
+    const uint8_t *in = record.payload + sizeof(info);
+    const uint8_t *end = record.payload + record.size;
+    if (info.encoding == CAPTURE_FRAME_RAW) {
+        if (static_cast<size_t>(end - in) != info.inputSize) {
+            return false;
+        }
+        frame.assign(in, end);
+        return true;
+    }
+    if (info.encoding != CAPTURE_FRAME_DELTA || frame.size() != info.inputSize) {
+        return false;
+    }
+    uint32_t pos = 0;
+    while (in < end) {
+        uint32_t equalLen = 0;
+        uint32_t diffLen = 0;
+        if (!GetVarint(in, end, equalLen) || !GetVarint(in, end, diffLen) ||
+            static_cast<uint64_t>(pos) + equalLen + diffLen > info.inputSize ||
+            static_cast<size_t>(end - in) < diffLen) {
+            return false;
+        }
+        pos += equalLen;
+        for (uint32_t i = 0; i < diffLen; ++i) {
+            frame[pos + i] ^= in[i];
+        }
+        in += diffLen;
+        pos += diffLen;
+    }
+    return true;
+}
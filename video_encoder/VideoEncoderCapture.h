@@ -0,0 +1,232 @@
+/*
+ * 功能说明: 编码会话抓取，将输入帧、编码参数、调用时间和输出大小追加写入内存映射的抓取文件，
+ *           输入帧与上一帧异或后按游程压缩存储；读取器按记录顺序解析抓取文件供离线回放
+ *
+ * 文件格式(小端): 文件头CaptureFileHeader之后依次为记录，每条记录为CaptureRecordHeader加size字节负载，
+ * 类型为0的记录或文件末尾表示结束。帧记录负载为CaptureFrameRecord加帧数据，帧数据按encoding存储:
+ *   RAW    原始输入
+ *   DELTA  与上一帧等长输入逐字节异或后的游程编码，依次为若干(相同字节数, 不同字节数, 异或值)，
+ *          两个长度均为LEB128变长整数
+ */
+#ifndef VIDEO_ENCODER_CAPTURE_H
+#define VIDEO_ENCODER_CAPTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "VideoCodecApi.h"
+#include "VideoEncoderWrapper.h"
+
+constexpr char CAPTURE_FILE_MAGIC[8] = { 'V', 'M', 'I', 'C', 'A', 'P', 'T', '1' };
+constexpr uint32_t CAPTURE_FILE_VERSION = 1;
+
+enum CaptureRecordType : uint32_t {
+    CAPTURE_RECORD_END = 0x00,
+    CAPTURE_RECORD_PARAMS = 0x01,        // 负载为CaptureParamsRecord
+    CAPTURE_RECORD_INPUT_FORMAT = 0x02,  // 负载为CaptureInputFormatRecord
+    CAPTURE_RECORD_FRAME = 0x03,         // 负载为CaptureFrameRecord加帧数据
+    CAPTURE_RECORD_KEY_FRAME = 0x04      // 负载为CaptureKeyFrameRecord
+};
+
+enum CaptureFrameEncoding : uint32_t {
+    CAPTURE_FRAME_RAW = 0x00,
+    CAPTURE_FRAME_DELTA = 0x01
+};
+
+struct CaptureFileHeader {
+    char magic[sizeof(CAPTURE_FILE_MAGIC)];
+    uint32_t version;
+    uint32_t encType;      // 编码器类型
+    uint64_t startTimeUs;  // 开始抓取时的单调时钟时间，记录中的时间戳均相对于该时间
+};
+
+struct CaptureRecordHeader {
+    uint32_t type;  // 取值见CaptureRecordType
+    uint32_t size;  // 负载大小
+};
+
+struct CaptureParamsRecord {
+    uint64_t timestampUs;
+    uint32_t width;
+    uint32_t height;
+    uint32_t frameRate;
+    uint32_t bitrate;
+    uint32_t gopSize;
+    uint32_t profile;
+};
+
+struct CaptureInputFormatRecord {
+    uint64_t timestampUs;
+    uint32_t pixelFormat;
+    uint32_t stride;
+    uint32_t convertThreads;
+    uint32_t reserved;
+};
+
+struct CaptureFrameRecord {
+    uint64_t timestampUs;    // 调用编码接口的时间
+    uint32_t callTimeUs;     // 编码接口调用耗时，包括格式转换等封装层处理
+    uint32_t result;         // 编码结果，取值见VmiEncoderRetCode
+    uint32_t inputSize;      // 输入数据大小
+    uint32_t outputSize;     // 编码输出大小
+    uint32_t encoding;       // 帧数据存储方式，取值见CaptureFrameEncoding
+    uint32_t reserved;
+};
+
+struct CaptureKeyFrameRecord {
+    uint64_t timestampUs;
+};
+
+class VideoEncoderCaptureWriter {
+public:
+    VideoEncoderCaptureWriter() = default;
+
+    /**
+     * @功能描述: 析构函数，关闭抓取文件
+     */
+    ~VideoEncoderCaptureWriter();
+
+    /**
+     * @功能描述: 创建抓取文件并写入文件头，文件已存在时覆盖
+     * @参数 [in] path: 文件路径
+     * @参数 [in] maxFileSize: 文件大小上限，达到上限后不再记录
+     * @参数 [in] encType: 编码器类型
+     * @返回值: true 成功，false 创建或映射文件失败
+     */
+    bool Open(const std::string &path, uint64_t maxFileSize, uint32_t encType);
+
+    /**
+     * @功能描述: 截断文件中预留的未写入部分并关闭文件
+     */
+    void Close();
+
+    /**
+     * @功能描述: 记录编码参数，初始化、修改参数和开始抓取时调用
+     * @参数 [in] params: 编码参数
+     */
+    void RecordParams(const EncodeParams &params);
+
+    /**
+     * @功能描述: 记录输入格式
+     * @参数 [in] format: 输入格式
+     */
+    void RecordInputFormat(const VmiInputFormat &format);
+
+    /**
+     * @功能描述: 记录一次强制I帧请求
+     */
+    void RecordKeyFrameRequest();
+
+    /**
+     * @功能描述: 记录一次编码调用，输入与上一帧等长时按差分存储
+     * @参数 [in] startUs: 调用编码接口的单调时钟时间
+     * @参数 [in] callTimeUs: 编码接口调用耗时
+     * @参数 [in] result: 编码结果
+     * @参数 [in] inputData: 输入数据地址，为空时只记录调用
+     * @参数 [in] inputSize: 输入数据大小
+     * @参数 [in] outputSize: 编码输出大小
+     */
+    void RecordFrame(uint64_t startUs, uint64_t callTimeUs, VmiEncoderRetCode result, const uint8_t *inputData,
+        uint32_t inputSize, uint32_t outputSize);
+
+    /**
+     * @功能描述: 获取抓取统计
+     * @参数 [out] stats: 抓取统计
+     */
+    void GetStats(VmiCaptureStats &stats) const;
+
+    /**
+     * @功能描述: 计算cur相对prev的差分编码，同时把prev中不同的部分更新为cur
+     * @参数 [in] cur: 当前帧
+     * @参数 [in,out] prev: 上一帧，返回true时与cur相同，返回false时只有部分被更新
+     * @参数 [in] size: 帧大小
+     * @参数 [out] out: 差分编码缓冲区，不足时扩大
+     * @参数 [out] outSize: 差分编码大小
+     * @返回值: true 成功，false 编码结果不小于原始大小，应按原始数据存储
+     */
+    static bool EncodeDelta(const uint8_t *cur, uint8_t *prev, uint32_t size, std::vector<uint8_t> &out,
+        uint32_t &outSize);
+
+private:
+    VideoEncoderCaptureWriter(const VideoEncoderCaptureWriter&) = delete;
+    VideoEncoderCaptureWriter& operator=(const VideoEncoderCaptureWriter&) = delete;
+    VideoEncoderCaptureWriter(VideoEncoderCaptureWriter &&) = delete;
+    VideoEncoderCaptureWriter& operator=(VideoEncoderCaptureWriter &&) = delete;
+
+    uint64_t GetTimestampUs(uint64_t nowUs) const;
+    bool BeginRecord(uint32_t type, uint64_t payloadSize);
+    void Write(const void *data, size_t size);
+    bool MapWindow(uint64_t offset);
+
+    int m_fd = -1;
+    uint64_t m_maxFileSize = 0;
+    uint64_t m_fileSize = 0;      // 已扩展的文件大小
+    uint64_t m_offset = 0;        // 下一条记录的写入位置
+    uint8_t *m_window = nullptr;  // 当前映射的写入窗口
+    uint64_t m_windowOffset = 0;
+    uint64_t m_startTimeUs = 0;
+    bool m_isFull = false;
+    std::vector<uint8_t> m_prevFrame = {};  // 上一个已记录的帧，读取器还原差分帧时以其为参考
+    std::vector<uint8_t> m_delta = {};
+    uint64_t m_frames = 0;
+    uint64_t m_droppedFrames = 0;
+    uint64_t m_inputBytes = 0;
+};
+
+class VideoEncoderCaptureReader {
+public:
+    struct Record {
+        uint32_t type = CAPTURE_RECORD_END;
+        const uint8_t *payload = nullptr;
+        uint32_t size = 0;
+    };
+
+    VideoEncoderCaptureReader() = default;
+
+    /**
+     * @功能描述: 析构函数，解除文件映射
+     */
+    ~VideoEncoderCaptureReader();
+
+    /**
+     * @功能描述: 以只读方式映射抓取文件并校验文件头
+     * @参数 [in] path: 文件路径
+     * @返回值: true 成功，false 文件不存在或格式不符
+     */
+    bool Open(const std::string &path);
+
+    const CaptureFileHeader &GetHeader() const
+    {
+        return m_header;
+    }
+
+    /**
+     * @功能描述: 读取下一条记录
+     * @参数 [out] record: 记录，负载在读取器析构前有效
+     * @返回值: true 成功，false 已到结束标记、文件末尾或记录不完整
+     */
+    bool Next(Record &record);
+
+    /**
+     * @功能描述: 按帧记录还原输入帧
+     * @参数 [in] record: 帧记录
+     * @参数 [in,out] frame: 传入上一帧，返回还原的当前帧
+     * @返回值: true 成功，false 记录损坏
+     */
+    static bool DecodeFrame(const Record &record, std::vector<uint8_t> &frame);
+
+private:
+    VideoEncoderCaptureReader(const VideoEncoderCaptureReader&) = delete;
+    VideoEncoderCaptureReader& operator=(const VideoEncoderCaptureReader&) = delete;
+    VideoEncoderCaptureReader(VideoEncoderCaptureReader &&) = delete;
+    VideoEncoderCaptureReader& operator=(VideoEncoderCaptureReader &&) = delete;
+
+    void *m_map = nullptr;
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+    CaptureFileHeader m_header = {};
+};
+
+#endif  // VIDEO_ENCODER_CAPTURE_H
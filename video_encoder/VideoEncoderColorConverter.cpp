@@ -0,0 +1,145 @@
+/*
+ * 功能说明: 编码前输入格式转换，将RGBA/BGRA、NV12及带行跨度的I420输入转换为紧密排列的I420，
+ *           高分辨率时按行分带多线程转换
+ */
+
+#define LOG_TAG "VideoEncoderColorConverter"
+#include "VideoEncoderColorConverter.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <new>
+#include <thread>
+#include "VideoEncoderLog.h"
+
+namespace {
+    constexpr uint32_t BYTES_PER_PIXEL = 4;
+    constexpr uint32_t CONVERT_THREADS_MAX = 8;
+    constexpr uint32_t CONVERT_THREADS_AUTO = 4;
+    // 自动选择时超过1080p才使用多线程，更低分辨率下线程同步开销与收益相当
+    constexpr uint64_t SINGLE_THREAD_PIXELS_MAX = 1920 * 1088;
+
+    uint32_t GetAutoThreadCount(uint32_t width, uint32_t height)
+    {
+        if (static_cast<uint64_t>(width) * height <= SINGLE_THREAD_PIXELS_MAX) {
+            return 1;
+        }
+        return std::max(1U, std::min(CONVERT_THREADS_AUTO, std::thread::hardware_concurrency()));
+    }
+}
+
+VideoEncoderColorConverter::VideoEncoderColorConverter(const VideoEncoderSimdKernels &kernels) : m_kernels(kernels) {}
+
+bool VideoEncoderColorConverter::IsNativeFormat(const VmiInputFormat &format, uint32_t width)
+{
+    return format.pixelFormat == VMI_PIXEL_FORMAT_I420 && (format.stride == 0 || format.stride == width);
+}
+
+bool VideoEncoderColorConverter::Init(const VmiInputFormat &format, uint32_t width, uint32_t height)
+{
+    m_inputSize = 0;
+    uint64_t chromaWidth = (width + 1) / 2;
+    uint64_t chromaHeight = (height + 1) / 2;
+    uint64_t minStride = 0;
+    switch (format.pixelFormat) {
+        case VMI_PIXEL_FORMAT_I420:
+            minStride = width;
+            break;
+        case VMI_PIXEL_FORMAT_NV12:
+            minStride = 2 * chromaWidth;
+            break;
+        case VMI_PIXEL_FORMAT_RGBA:
+        case VMI_PIXEL_FORMAT_BGRA:
+            minStride = static_cast<uint64_t>(width) * BYTES_PER_PIXEL;
+            break;
+        default:
+            ERR("init color converter failed: unsupported pixel format %u", format.pixelFormat);
+            return false;
+    }
+    uint64_t stride = (format.stride == 0) ? minStride : format.stride;
+    if (width == 0 || height == 0 || stride < minStride) {
+        ERR("init color converter failed: invalid resolution %ux%u or stride %u", width, height, format.stride);
+        return false;
+    }
+    uint64_t inputSize = stride * height;
+    if (format.pixelFormat == VMI_PIXEL_FORMAT_I420) {
+        inputSize += 2 * ((stride + 1) / 2) * chromaHeight;
+    } else if (format.pixelFormat == VMI_PIXEL_FORMAT_NV12) {
+        inputSize += stride * chromaHeight;
+    }
+    uint64_t frameSize = static_cast<uint64_t>(width) * height + 2 * chromaWidth * chromaHeight;
+    if (inputSize > UINT32_MAX || frameSize > UINT32_MAX) {
+        ERR("init color converter failed: frame of %ux%u stride %" PRIu64 " is too large", width, height, stride);
+        return false;
+    }
+    try {
+        m_frame.resize(frameSize);
+    } catch (const std::bad_alloc &e) {
+        ERR("init color converter failed: alloc %" PRIu64 " bytes frame failed", frameSize);
+        return false;
+    }
+
+    uint32_t threadCount = (format.convertThreads == 0) ? GetAutoThreadCount(width, height) : format.convertThreads;
+    threadCount = std::max(1U, std::min({ threadCount, CONVERT_THREADS_MAX, static_cast<uint32_t>(chromaHeight) }));
+    (void) m_workers.Resize(threadCount);
+    m_pixelFormat = format.pixelFormat;
+    m_stride = static_cast<uint32_t>(stride);
+    m_width = width;
+    m_height = height;
+    m_bandRows = static_cast<uint32_t>((chromaHeight + GetThreadCount() - 1) / GetThreadCount());
+    m_inputSize = static_cast<uint32_t>(inputSize);
+    INFO("color converter: format %u, %ux%u, stride %u, %u threads", m_pixelFormat, width, height, m_stride,
+        GetThreadCount());
+    return true;
+}
+
+const uint8_t *VideoEncoderColorConverter::Convert(const uint8_t *input)
+{
+    if (m_inputSize == 0 || input == nullptr) {
+        return nullptr;
+    }
+    m_workers.Run([this, input](uint32_t band) { ConvertBand(band, input); });
+    return m_frame.data();
+}
+
+void VideoEncoderColorConverter::ConvertBand(uint32_t band, const uint8_t *input)
+{
+    uint32_t chromaWidth = (m_width + 1) / 2;
+    uint32_t chromaHeight = (m_height + 1) / 2;
+    uint32_t beginRow = std::min(band * m_bandRows, chromaHeight);
+    uint32_t endRow = std::min(beginRow + m_bandRows, chromaHeight);
+    uint8_t *dstY = m_frame.data();
+    uint8_t *dstU = dstY + static_cast<size_t>(m_width) * m_height;
+    uint8_t *dstV = dstU + static_cast<size_t>(chromaWidth) * chromaHeight;
+    const uint8_t *srcChroma = input + static_cast<size_t>(m_stride) * m_height;
+    uint32_t chromaStride = (m_stride + 1) / 2;
+    // 每个色度行对应两个亮度行，高度为奇数时最后一个亮度行与自身配对
+    for (uint32_t row = beginRow; row < endRow; ++row) {
+        uint32_t y0 = 2 * row;
+        uint32_t y1 = std::min(y0 + 1, m_height - 1);
+        const uint8_t *src0 = input + static_cast<size_t>(y0) * m_stride;
+        const uint8_t *src1 = input + static_cast<size_t>(y1) * m_stride;
+        uint8_t *dstY0 = dstY + static_cast<size_t>(y0) * m_width;
+        uint8_t *dstY1 = dstY + static_cast<size_t>(y1) * m_width;
+        uint8_t *u = dstU + static_cast<size_t>(row) * chromaWidth;
+        uint8_t *v = dstV + static_cast<size_t>(row) * chromaWidth;
+        switch (m_pixelFormat) {
+            case VMI_PIXEL_FORMAT_RGBA:
+            case VMI_PIXEL_FORMAT_BGRA:
+                m_kernels.rgbToI420Rows(src0, src1, m_width, m_pixelFormat == VMI_PIXEL_FORMAT_BGRA,
+                    dstY0, dstY1, u, v);
+                break;
+            case VMI_PIXEL_FORMAT_NV12:
+                (void) memcpy(dstY0, src0, m_width);
+                (void) memcpy(dstY1, src1, m_width);
+                m_kernels.splitUvRow(srcChroma + static_cast<size_t>(row) * m_stride, chromaWidth, u, v);
+                break;
+            default:
+                (void) memcpy(dstY0, src0, m_width);
+                (void) memcpy(dstY1, src1, m_width);
+                (void) memcpy(u, srcChroma + static_cast<size_t>(row) * chromaStride, chromaWidth);
+                (void) memcpy(v, srcChroma + static_cast<size_t>(chromaHeight + row) * chromaStride, chromaWidth);
+                break;
+        }
+    }
+}
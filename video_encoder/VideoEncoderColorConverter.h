@@ -0,0 +1,76 @@
+/*
+ * 功能说明: 编码前输入格式转换，将RGBA/BGRA、NV12及带行跨度的I420输入转换为紧密排列的I420，
+ *           高分辨率时按行分带多线程转换
+ */
+#ifndef VIDEO_ENCODER_COLOR_CONVERTER_H
+#define VIDEO_ENCODER_COLOR_CONVERTER_H
+
+#include <cstdint>
+#include <vector>
+#include "VideoEncoderSimd.h"
+#include "VideoEncoderWorkerGroup.h"
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderColorConverter {
+public:
+    explicit VideoEncoderColorConverter(const VideoEncoderSimdKernels &kernels = GetSimdKernels());
+    ~VideoEncoderColorConverter() = default;
+
+    /**
+     * @功能描述: 输入格式是否为编码器原生的紧密排列I420，无需转换
+     * @参数 [in] format: 输入格式
+     * @参数 [in] width: 宽度
+     */
+    static bool IsNativeFormat(const VmiInputFormat &format, uint32_t width);
+
+    /**
+     * @功能描述: 按输入格式和分辨率(重新)初始化，分配转换输出并按需启动转换线程
+     * @参数 [in] format: 输入格式
+     * @参数 [in] width: 宽度
+     * @参数 [in] height: 高度
+     * @返回值: true 成功，false 格式或行跨度无效、分配内存失败
+     */
+    bool Init(const VmiInputFormat &format, uint32_t width, uint32_t height);
+
+    /**
+     * @功能描述: 转换一帧输入数据，未初始化成功时失败
+     * @参数 [in] input: 大小不小于GetInputSize()的一帧输入数据
+     * @返回值: 转换后的一帧I420数据，大小为GetFrameSize()，下次转换前有效；失败时返回空
+     */
+    const uint8_t *Convert(const uint8_t *input);
+
+    uint32_t GetInputSize() const
+    {
+        return m_inputSize;
+    }
+
+    uint32_t GetFrameSize() const
+    {
+        return static_cast<uint32_t>(m_frame.size());
+    }
+
+    uint32_t GetThreadCount() const
+    {
+        return m_workers.GetCount();
+    }
+
+private:
+    VideoEncoderColorConverter(const VideoEncoderColorConverter&) = delete;
+    VideoEncoderColorConverter& operator=(const VideoEncoderColorConverter&) = delete;
+    VideoEncoderColorConverter(VideoEncoderColorConverter &&) = delete;
+    VideoEncoderColorConverter& operator=(VideoEncoderColorConverter &&) = delete;
+
+    void ConvertBand(uint32_t band, const uint8_t *input);
+
+    const VideoEncoderSimdKernels &m_kernels;
+    uint32_t m_pixelFormat = VMI_PIXEL_FORMAT_I420;
+    uint32_t m_stride = 0;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_inputSize = 0;  // 0表示未初始化
+    uint32_t m_bandRows = 0;   // 每个分带的色度行数
+    std::vector<uint8_t> m_frame = {};
+    VideoEncoderWorkerGroup m_workers;  // 每个线程转换一个分带
+};
+
+#endif  // VIDEO_ENCODER_COLOR_CONVERTER_H
@@ -0,0 +1,219 @@
+/*
+ * 功能说明: 编码前变化区域检测，将YUV420输入帧与上一帧按分块比较，得到变化分块，用于跳过静止帧
+ */
+
+#define LOG_TAG "VideoEncoderDirtyDetector"
+#include "VideoEncoderDirtyDetector.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "VideoEncoderLog.h"
+#include "VideoEncoderTime.h"
+
+constexpr uint32_t VideoEncoderDirtyDetector::TILE_SIZE;
+
+VideoEncoderDirtyDetector::VideoEncoderDirtyDetector(const VideoEncoderSimdKernels &kernels) : m_kernels(kernels) {}
+
+bool VideoEncoderDirtyDetector::Init(uint32_t width, uint32_t height)
+{
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+    uint64_t lumaSize = static_cast<uint64_t>(width) * height;
+    uint64_t chromaSize = static_cast<uint64_t>(chromaWidth) * chromaHeight;
+    if (width == 0 || height == 0 || lumaSize + 2 * chromaSize > UINT32_MAX) {
+        ERR("init dirty detector failed: invalid resolution %ux%u", width, height);
+        return false;
+    }
+    constexpr uint32_t chromaTileSize = TILE_SIZE / 2;
+    m_width = width;
+    m_height = height;
+    m_frameSize = static_cast<uint32_t>(lumaSize + 2 * chromaSize);
+    m_tileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+    m_planes[0] = { 0, width, height, TILE_SIZE };
+    m_planes[1] = { static_cast<uint32_t>(lumaSize), chromaWidth, chromaHeight, chromaTileSize };
+    m_planes[2] = { static_cast<uint32_t>(lumaSize + chromaSize), chromaWidth, chromaHeight, chromaTileSize };
+    try {
+        m_reference.resize(m_frameSize);
+        m_dirty.assign(static_cast<size_t>(m_tileColumns) * m_tileRows, 1);
+    } catch (const std::bad_alloc &e) {
+        ERR("init dirty detector failed: alloc %u bytes reference frame failed", m_frameSize);
+        m_frameSize = 0;
+        return false;
+    }
+    m_hasReference = false;
+    m_hasHint = false;
+    m_dirtyCount = static_cast<uint32_t>(m_dirty.size());
+    m_stats.tileSize = TILE_SIZE;
+    m_stats.tilesPerFrame = m_dirtyCount;
+    return true;
+}
+
+void VideoEncoderDirtyDetector::Invalidate()
+{
+    m_hasReference = false;
+    m_hasHint = false;
+}
+
+void VideoEncoderDirtyDetector::SetDamageHint(const VmiRect *rects, uint32_t rectCount)
+{
+    m_hint.assign(rects, rects + rectCount);
+    m_hasHint = true;
+}
+
+uint32_t VideoEncoderDirtyDetector::Detect(const uint8_t *frame)
+{
+    uint64_t startUs = GetMonotonicTimeUs();
+    if (!m_hasReference) {
+        // 没有参考帧时整帧视为变化
+        (void) memcpy(m_reference.data(), frame, m_frameSize);
+        std::fill(m_dirty.begin(), m_dirty.end(), 1);
+        m_hasReference = true;
+        m_hasHint = false;
+    } else {
+        std::fill(m_dirty.begin(), m_dirty.end(), 0);
+        if (m_hasHint) {
+            for (const auto &rect : m_hint) {
+                MarkRect(rect);
+            }
+            m_hasHint = false;
+            ++m_stats.hintedFrames;
+        } else {
+            for (const auto &plane : m_planes) {
+                ScanPlane(plane, frame);
+            }
+        }
+        for (const auto &plane : m_planes) {
+            UpdatePlane(plane, frame);
+        }
+    }
+    m_dirtyCount = static_cast<uint32_t>(std::count(m_dirty.begin(), m_dirty.end(), 1));
+    uint64_t detectTimeUs = GetMonotonicTimeUs() - startUs;
+    ++m_stats.framesChecked;
+    m_stats.staticFrames += (m_dirtyCount == 0) ? 1 : 0;
+    m_stats.dirtyTiles += m_dirtyCount;
+    m_detectTimeTotalUs += detectTimeUs;
+    m_stats.detectTimeMaxUs = std::max(m_stats.detectTimeMaxUs, detectTimeUs);
+    return m_dirtyCount;
+}
+
+uint32_t VideoEncoderDirtyDetector::GetDirtyRects(VmiRect *rects, uint32_t maxRects) const
+{
+    // 每个分块行内的连续变化分块合并为一段，与上一分块行中位置和宽度相同的矩形向下合并
+    std::vector<VmiRect> merged;
+    std::vector<size_t> open;  // 底边与当前分块行顶边相接的矩形下标
+    std::vector<size_t> nextOpen;
+    for (uint32_t row = 0; row < m_tileRows; ++row) {
+        const uint8_t *dirty = m_dirty.data() + static_cast<size_t>(row) * m_tileColumns;
+        nextOpen.clear();
+        for (uint32_t col = 0; col < m_tileColumns;) {
+            if (dirty[col] == 0) {
+                ++col;
+                continue;
+            }
+            uint32_t end = col;
+            while (end < m_tileColumns && dirty[end] != 0) {
+                ++end;
+            }
+            VmiRect rect;
+            rect.x = col * TILE_SIZE;
+            rect.y = row * TILE_SIZE;
+            rect.width = std::min(end * TILE_SIZE, m_width) - rect.x;
+            rect.height = std::min((row + 1) * TILE_SIZE, m_height) - rect.y;
+            auto above = std::find_if(open.begin(), open.end(), [&merged, &rect](size_t index) {
+                return merged[index].x == rect.x && merged[index].width == rect.width;
+            });
+            if (above != open.end()) {
+                merged[*above].height += rect.height;
+                nextOpen.push_back(*above);
+            } else {
+                merged.push_back(rect);
+                nextOpen.push_back(merged.size() - 1);
+            }
+            col = end;
+        }
+        open.swap(nextOpen);
+    }
+    if (merged.size() <= maxRects) {
+        std::copy(merged.begin(), merged.end(), rects);
+        return static_cast<uint32_t>(merged.size());
+    }
+    if (maxRects == 0) {
+        return 0;
+    }
+    uint32_t left = m_width;
+    uint32_t top = m_height;
+    uint32_t right = 0;
+    uint32_t bottom = 0;
+    for (const auto &rect : merged) {
+        left = std::min(left, rect.x);
+        top = std::min(top, rect.y);
+        right = std::max(right, rect.x + rect.width);
+        bottom = std::max(bottom, rect.y + rect.height);
+    }
+    rects[0] = { left, top, right - left, bottom - top };
+    return 1;
+}
+
+void VideoEncoderDirtyDetector::GetStats(VmiDirtyDetectStats &stats) const
+{
+    stats = m_stats;
+    stats.detectTimeAvgUs = (m_stats.framesChecked == 0) ? 0 : m_detectTimeTotalUs / m_stats.framesChecked;
+}
+
+void VideoEncoderDirtyDetector::RecordSkip()
+{
+    ++m_stats.skippedFrames;
+}
+
+void VideoEncoderDirtyDetector::ScanPlane(const Plane &plane, const uint8_t *frame)
+{
+    const uint8_t *cur = frame + plane.offset;
+    const uint8_t *ref = m_reference.data() + plane.offset;
+    for (uint32_t y = 0; y < plane.height; ++y) {
+        size_t rowOffset = static_cast<size_t>(y) * plane.width;
+        uint8_t *dirty = m_dirty.data() + static_cast<size_t>(y / plane.tileSize) * m_tileColumns;
+        m_kernels.markDirtyTiles(cur + rowOffset, ref + rowOffset, plane.width, plane.tileSize, dirty);
+    }
+}
+
+void VideoEncoderDirtyDetector::UpdatePlane(const Plane &plane, const uint8_t *frame)
+{
+    const uint8_t *cur = frame + plane.offset;
+    uint8_t *ref = m_reference.data() + plane.offset;
+    for (uint32_t row = 0; row < m_tileRows; ++row) {
+        const uint8_t *dirty = m_dirty.data() + static_cast<size_t>(row) * m_tileColumns;
+        uint32_t yBegin = row * plane.tileSize;
+        uint32_t yEnd = std::min(yBegin + plane.tileSize, plane.height);
+        for (uint32_t col = 0; col < m_tileColumns;) {
+            if (dirty[col] == 0) {
+                ++col;
+                continue;
+            }
+            uint32_t end = col;
+            while (end < m_tileColumns && dirty[end] != 0) {
+                ++end;
+            }
+            uint32_t xBegin = col * plane.tileSize;
+            uint32_t xEnd = std::min(end * plane.tileSize, plane.width);
+            for (uint32_t y = yBegin; y < yEnd && xBegin < xEnd; ++y) {
+                size_t offset = static_cast<size_t>(y) * plane.width + xBegin;
+                (void) memcpy(ref + offset, cur + offset, xEnd - xBegin);
+            }
+            col = end;
+        }
+    }
+}
+
+void VideoEncoderDirtyDetector::MarkRect(const VmiRect &rect)
+{
+    if (rect.width == 0 || rect.height == 0 || rect.x >= m_width || rect.y >= m_height) {
+        return;
+    }
+    uint32_t colEnd = (std::min(m_width - rect.x, rect.width) + rect.x + TILE_SIZE - 1) / TILE_SIZE;
+    uint32_t rowEnd = (std::min(m_height - rect.y, rect.height) + rect.y + TILE_SIZE - 1) / TILE_SIZE;
+    for (uint32_t row = rect.y / TILE_SIZE; row < rowEnd; ++row) {
+        uint8_t *dirty = m_dirty.data() + static_cast<size_t>(row) * m_tileColumns;
+        std::fill(dirty + rect.x / TILE_SIZE, dirty + colEnd, 1);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * 功能说明: 编码前变化区域检测，将YUV420输入帧与上一帧按分块比较，得到变化分块，用于跳过静止帧
+ */
+#ifndef VIDEO_ENCODER_DIRTY_DETECTOR_H
+#define VIDEO_ENCODER_DIRTY_DETECTOR_H
+
+#include <cstdint>
+#include <vector>
+#include "VideoEncoderSimd.h"
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderDirtyDetector {
+public:
+    static constexpr uint32_t TILE_SIZE = 64;  // 亮度分块边长，色度分块边长为其一半
+
+    explicit VideoEncoderDirtyDetector(const VideoEncoderSimdKernels &kernels = GetSimdKernels());
+    ~VideoEncoderDirtyDetector() = default;
+
+    /**
+     * @功能描述: 按分辨率(重新)初始化，分配参考帧，下一帧视为全部变化
+     * @参数 [in] width: 宽度
+     * @参数 [in] height: 高度
+     * @返回值: true 成功，false 分配内存失败
+     */
+    bool Init(uint32_t width, uint32_t height);
+
+    /**
+     * @功能描述: 丢弃参考帧，下一帧视为全部变化
+     */
+    void Invalidate();
+
+    /**
+     * @功能描述: 设置下一帧的变化区域，该帧不再扫描比较
+     * @参数 [in] rects: 变化区域，超出画面的部分被裁剪
+     * @参数 [in] rectCount: 变化区域个数，0表示无变化
+     */
+    void SetDamageHint(const VmiRect *rects, uint32_t rectCount);
+
+    /**
+     * @功能描述: 检测一帧YUV420数据的变化分块，并以变化分块更新参考帧
+     * @参数 [in] frame: 大小为GetFrameSize()的一帧数据
+     * @返回值: 变化分块个数，0表示静止帧
+     */
+    uint32_t Detect(const uint8_t *frame);
+
+    /**
+     * @功能描述: 获取最近一帧的变化区域，相邻变化分块合并为矩形，超出maxRects时合并为一个外接矩形
+     * @参数 [out] rects: 变化区域
+     * @参数 [in] maxRects: rects可容纳的个数
+     * @返回值: 变化区域个数
+     */
+    uint32_t GetDirtyRects(VmiRect *rects, uint32_t maxRects) const;
+
+    /**
+     * @功能描述: 获取检测统计
+     * @参数 [out] stats: 检测统计
+     */
+    void GetStats(VmiDirtyDetectStats &stats) const;
+
+    /**
+     * @功能描述: 记录一次跳过静止帧
+     */
+    void RecordSkip();
+
+    uint32_t GetFrameSize() const
+    {
+        return m_frameSize;
+    }
+
+private:
+    VideoEncoderDirtyDetector(const VideoEncoderDirtyDetector&) = delete;
+    VideoEncoderDirtyDetector& operator=(const VideoEncoderDirtyDetector&) = delete;
+    VideoEncoderDirtyDetector(VideoEncoderDirtyDetector &&) = delete;
+    VideoEncoderDirtyDetector& operator=(VideoEncoderDirtyDetector &&) = delete;
+
+    struct Plane {
+        uint32_t offset = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t tileSize = 0;
+    };
+
+    void ScanPlane(const Plane &plane, const uint8_t *frame);
+    void UpdatePlane(const Plane &plane, const uint8_t *frame);
+    void MarkRect(const VmiRect &rect);
+
+    const VideoEncoderSimdKernels &m_kernels;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_frameSize = 0;
+    uint32_t m_tileColumns = 0;
+    uint32_t m_tileRows = 0;
+    Plane m_planes[3] = {};
+    std::vector<uint8_t> m_reference = {};
+    std::vector<uint8_t> m_dirty = {};  // 按分块行优先排列的变化标记
+    bool m_hasReference = false;
+    bool m_hasHint = false;
+    std::vector<VmiRect> m_hint = {};
+    uint32_t m_dirtyCount = 0;
+    VmiDirtyDetectStats m_stats = {};
+    uint64_t m_detectTimeTotalUs = 0;
+};
+
+#endif  // VIDEO_ENCODER_DIRTY_DETECTOR_H
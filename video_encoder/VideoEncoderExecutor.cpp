@@ -0,0 +1,332 @@
+/*
+ * 功能说明: 多会话共享编码执行器，固定数量的工作线程按截止时间优先执行各会话的编码任务，
+ *           每个工作线程有本地任务队列，空闲时从其他线程窃取，可按CPU核或NUMA节点绑定
+ */
+
+#define LOG_TAG "VideoEncoderExecutor"
+#include "VideoEncoderExecutor.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <new>
+#include <sched.h>
+#include <string>
+#include <system_error>
+#include <utility>
+#include "VideoEncoderLog.h"
+
+namespace {
+    constexpr uint32_t EXECUTOR_THREADS_MAX = 64;
+    const std::string NUMA_NODE_PATH = "/sys/devices/system/node";
+
+    // 当前进程允许运行的CPU
+    std::vector<uint32_t> GetAllowedCpus()
+    {
+        std::vector<uint32_t> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+            return cpus;
+        }
+        for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    // 解析形如"0-3,8-11"的CPU列表
+    std::vector<uint32_t> ParseCpuList(const char *text)
+    {
+        std::vector<uint32_t> cpus;
+        const char *p = text;
+        while (*p != '\0' && *p != '\n') {
+            char *end = nullptr;
+            unsigned long first = strtoul(p, &end, 10);
+            if (end == p) {
+                break;
+            }
+            unsigned long last = first;
+            p = end;
+            if (*p == '-') {
+                last = strtoul(p + 1, &end, 10);
+                p = end;
+            }
+            for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+                cpus.push_back(static_cast<uint32_t>(cpu));
+            }
+            if (*p == ',') {
+                ++p;
+            }
+        }
+        return cpus;
+    }
+
+    // 各NUMA节点中当前进程允许运行的CPU，按节点编号排列，无法读取时返回空
+    std::vector<std::vector<uint32_t>> GetNumaNodeCpus(const std::vector<uint32_t> &allowed)
+    {
+        std::vector<std::pair<uint32_t, std::vector<uint32_t>>> nodes;
+        DIR *dir = opendir(NUMA_NODE_PATH.c_str());
+        if (dir == nullptr) {
+            return {};
+        }
+        struct dirent *entry = nullptr;
+        while ((entry = readdir(dir)) != nullptr) {
+            uint32_t node = 0;
+            if (sscanf(entry->d_name, "node%u", &node) != 1) {
+                continue;
+            }
+            std::string path = NUMA_NODE_PATH + "/" + entry->d_name + "/cpulist";
+            FILE *file = fopen(path.c_str(), "r");
+            if (file == nullptr) {
+                continue;
+            }
+            char text[256] = {};
+            bool isRead = (fgets(text, sizeof(text), file) != nullptr);
+            (void) fclose(file);
+            std::vector<uint32_t> cpus;
+            for (uint32_t cpu : isRead ? ParseCpuList(text) : std::vector<uint32_t>()) {
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                nodes.emplace_back(node, std::move(cpus));
+            }
+        }
+        (void) closedir(dir);
+        std::sort(nodes.begin(), nodes.end());
+        std::vector<std::vector<uint32_t>> result;
+        for (auto &node : nodes) {
+            result.push_back(std::move(node.second));
+        }
+        return result;
+    }
+}
+
+VideoEncoderExecutor& VideoEncoderExecutor::GetInstance()
+{
+    static VideoEncoderExecutor instance;
+    return instance;
+}
+
+VideoEncoderExecutor::~VideoEncoderExecutor()
+{
+    std::lock_guard<std::mutex> lck(m_configLock);
+    StopLocked();
+}
+
+bool VideoEncoderExecutor::Configure(const VmiEncodeExecutorConfig &config)
+{
+    if (config.threadCount > EXECUTOR_THREADS_MAX || config.affinity > VMI_EXECUTOR_AFFINITY_NODE) {
+        ERR("configure executor failed: thread count %u exceeds %u or invalid affinity %u", config.threadCount,
+            EXECUTOR_THREADS_MAX, config.affinity);
+        return false;
+    }
+    std::lock_guard<std::mutex> lck(m_configLock);
+    if (m_sessions != 0) {
+        ERR("configure executor failed: %u sessions are attached", m_sessions);
+        return false;
+    }
+    StopLocked();
+    m_config = config;
+    return true;
+}
+
+bool VideoEncoderExecutor::Attach()
+{
+    std::lock_guard<std::mutex> lck(m_configLock);
+    if (m_workers.empty() && !StartLocked()) {
+        return false;
+    }
+    ++m_sessions;
+    return true;
+}
+
+void VideoEncoderExecutor::Detach()
+{
+    std::lock_guard<std::mutex> lck(m_configLock);
+    if (m_sessions > 0) {
+        --m_sessions;
+    }
+}
+
+bool VideoEncoderExecutor::StartLocked()
+{
+    std::vector<uint32_t> allowed = GetAllowedCpus();
+    uint32_t threadCount = m_config.threadCount;
+    if (threadCount == 0) {
+        threadCount = static_cast<uint32_t>(allowed.size());
+        threadCount = (threadCount == 0) ? std::max(1U, std::thread::hardware_concurrency()) : threadCount;
+        threadCount = std::min(threadCount, EXECUTOR_THREADS_MAX);
+    }
+    std::vector<std::vector<uint32_t>> cpuSets;
+    if (m_config.affinity == VMI_EXECUTOR_AFFINITY_CORE) {
+        for (uint32_t cpu : allowed) {
+            cpuSets.push_back({ cpu });
+        }
+    } else if (m_config.affinity == VMI_EXECUTOR_AFFINITY_NODE) {
+        cpuSets = GetNumaNodeCpus(allowed);
+        if (cpuSets.empty()) {
+            WARN("read numa nodes from %s failed, executor threads are not bound", NUMA_NODE_PATH.c_str());
+        }
+    }
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        std::unique_ptr<Worker> worker(new (std::nothrow) Worker());
+        if (worker == nullptr) {
+            break;
+        }
+        if (!cpuSets.empty()) {
+            worker->cpus = cpuSets[i % cpuSets.size()];
+        }
+        m_workers.push_back(std::move(worker));
+    }
+    {
+        std::lock_guard<std::mutex> wakeLck(m_wakeLock);
+        m_isRunning = true;
+    }
+    uint32_t started = 0;
+    for (; started < m_workers.size(); ++started) {
+        try {
+            m_workers[started]->thread = std::thread(&VideoEncoderExecutor::Loop, this, started);
+        } catch (const std::system_error &e) {
+            WARN("start executor thread failed: %s, %u threads started", e.what(), started);
+            break;
+        }
+    }
+    if (started == 0) {
+        ERR("start executor failed: no thread started");
+        StopLocked();
+        return false;
+    }
+    // 线程未能全部启动时保留其本地队列，其中的任务由已启动的线程窃取执行
+    m_threadCount = started;
+    INFO("executor started: %u threads, affinity %u", started, m_config.affinity);
+    return true;
+}
+
+void VideoEncoderExecutor::StopLocked()
+{
+    {
+        std::lock_guard<std::mutex> wakeLck(m_wakeLock);
+        m_isRunning = false;
+    }
+    m_wakeCond.notify_all();
+    for (auto &worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    m_workers.clear();
+    m_threadCount = 0;
+    m_pendingTasks = 0;
+}
+
+bool VideoEncoderExecutor::IsLater(const Task &a, const Task &b)
+{
+    return (a.deadlineNs != b.deadlineNs) ? (a.deadlineNs > b.deadlineNs) : (a.seq > b.seq);
+}
+
+void VideoEncoderExecutor::Schedule(Strand *strand, uint64_t deadlineNs)
+{
+    if (strand->m_homeWorker == UINT32_MAX) {
+        strand->m_homeWorker = m_nextHome++;
+    }
+    Task task;
+    task.deadlineNs = deadlineNs;
+    task.seq = m_nextSeq++;
+    task.strand = strand;
+    Push(strand->m_homeWorker % static_cast<uint32_t>(m_workers.size()), task);
+}
+
+void VideoEncoderExecutor::Push(uint32_t index, const Task &task)
+{
+    Worker &worker = *m_workers[index];
+    {
+        std::lock_guard<std::mutex> lck(worker.lock);
+        worker.heap.push_back(task);
+        std::push_heap(worker.heap.begin(), worker.heap.end(), IsLater);
+    }
+    {
+        std::lock_guard<std::mutex> wakeLck(m_wakeLock);
+        ++m_pendingTasks;
+    }
+    m_wakeCond.notify_one();
+}
+
+bool VideoEncoderExecutor::PopLocal(uint32_t index, Task &task)
+{
+    Worker &worker = *m_workers[index];
+    std::lock_guard<std::mutex> lck(worker.lock);
+    if (worker.heap.empty()) {
+        return false;
+    }
+    std::pop_heap(worker.heap.begin(), worker.heap.end(), IsLater);
+    task = worker.heap.back();
+    worker.heap.pop_back();
+    --m_pendingTasks;
+    return true;
+}
+
+bool VideoEncoderExecutor::Steal(uint32_t index, Task &task)
+{
+    auto count = static_cast<uint32_t>(m_workers.size());
+    for (uint32_t i = 1; i < count; ++i) {
+        if (PopLocal((index + i) % count, task)) {
+            ++m_steals;
+            return true;
+        }
+    }
+    return false;
+}
+
+void VideoEncoderExecutor::Loop(uint32_t index)
+{
+    const std::vector<uint32_t> &cpus = m_workers[index]->cpus;
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (uint32_t cpu : cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            WARN("executor thread %u bind to %zu cpus from cpu %u failed", index, cpus.size(), cpus[0]);
+        }
+    }
+    while (m_isRunning) {
+        Task task;
+        if (!PopLocal(index, task) && !Steal(index, task)) {
+            std::unique_lock<std::mutex> wakeLck(m_wakeLock);
+            m_wakeCond.wait(wakeLck, [this] { return !m_isRunning || m_pendingTasks > 0; });
+            continue;
+        }
+        ++m_tasksExecuted;
+        uint64_t nextDeadlineNs = 0;
+        if (task.strand->RunStep(nextDeadlineNs)) {
+            // 同一会话的后续帧留在本线程，保持缓存局部性，其他线程空闲时可窃取
+            task.strand->m_homeWorker = index;
+            task.deadlineNs = nextDeadlineNs;
+            task.seq = m_nextSeq++;
+            Push(index, task);
+        }
+    }
+}
+
+void VideoEncoderExecutor::RecordDeadlineMiss()
+{
+    ++m_deadlineMisses;
+}
+
+void VideoEncoderExecutor::GetStats(VmiEncodeExecutorStats &stats)
+{
+    std::lock_guard<std::mutex> lck(m_configLock);
+    stats.threadCount = m_threadCount;
+    stats.affinity = m_config.affinity;
+    stats.sessions = m_sessions;
+    stats.queuedTasks = static_cast<uint64_t>(std::max<int64_t>(0, m_pendingTasks));
+    stats.tasksExecuted = m_tasksExecuted;
+    stats.steals = m_steals;
+    stats.deadlineMisses = m_deadlineMisses;
+}
@@ -0,0 +1,130 @@
+/*
+ * 功能说明: 多会话共享编码执行器，固定数量的工作线程按截止时间优先执行各会话的编码任务，
+ *           每个工作线程有本地任务队列，空闲时从其他线程窃取，可按CPU核或NUMA节点绑定
+ */
+#ifndef VIDEO_ENCODER_EXECUTOR_H
+#define VIDEO_ENCODER_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderExecutor {
+public:
+    /**
+     * 串行任务，同一时刻最多在一个工作线程上执行，由此保证同一会话内的帧按顺序编码。
+     * 任务被调度后到RunStep返回false之前不能析构
+     */
+    class Strand {
+    public:
+        virtual ~Strand() = default;
+
+        /**
+         * @功能描述: 执行一步，在工作线程上调用
+         * @参数 [out] nextDeadlineNs: 返回true时为下一步的截止时间
+         * @返回值: true 还有后续步骤，执行器按nextDeadlineNs重新调度；false 本次调度结束
+         */
+        virtual bool RunStep(uint64_t &nextDeadlineNs) = 0;
+
+    private:
+        friend class VideoEncoderExecutor;
+        uint32_t m_homeWorker = UINT32_MAX;  // 最近执行该任务的工作线程，重新调度时放回其本地队列
+    };
+
+    /**
+     * @功能描述: 获取VideoEncoderExecutor单例对象
+     * @返回值: 返回值VideoEncoderExecutor单例对象引用
+     */
+    static VideoEncoderExecutor& GetInstance();
+
+    /**
+     * @功能描述: 配置线程数和绑核策略，停止已有的工作线程，下次有会话登记时按新配置启动
+     * @参数 [in] config: 执行器配置
+     * @返回值: true 成功，false 配置无效或仍有会话在使用执行器
+     */
+    bool Configure(const VmiEncodeExecutorConfig &config);
+
+    /**
+     * @功能描述: 登记使用执行器的会话，首次登记时按当前配置启动工作线程
+     * @返回值: true 成功，false 启动工作线程失败
+     */
+    bool Attach();
+
+    /**
+     * @功能描述: 注销会话，工作线程保持运行
+     */
+    void Detach();
+
+    /**
+     * @功能描述: 调度任务，任务在工作线程上执行RunStep直到其返回false
+     * @参数 [in] strand: 未处于调度中的任务
+     * @参数 [in] deadlineNs: 截止时间，越早越优先
+     */
+    void Schedule(Strand *strand, uint64_t deadlineNs);
+
+    /**
+     * @功能描述: 记录一次截止时间超时，计入执行器统计
+     */
+    void RecordDeadlineMiss();
+
+    /**
+     * @功能描述: 获取执行器统计
+     * @参数 [out] stats: 执行器统计
+     */
+    void GetStats(VmiEncodeExecutorStats &stats);
+
+private:
+    VideoEncoderExecutor() = default;
+    ~VideoEncoderExecutor();
+    VideoEncoderExecutor(const VideoEncoderExecutor&) = delete;
+    VideoEncoderExecutor& operator=(const VideoEncoderExecutor&) = delete;
+    VideoEncoderExecutor(VideoEncoderExecutor &&) = delete;
+    VideoEncoderExecutor& operator=(VideoEncoderExecutor &&) = delete;
+
+    struct Task {
+        uint64_t deadlineNs = 0;
+        uint64_t seq = 0;  // 截止时间相同时按调度顺序
+        Strand *strand = nullptr;
+    };
+
+    // 工作线程本地队列，按截止时间组织的小顶堆
+    struct Worker {
+        std::mutex lock = {};
+        std::vector<Task> heap = {};
+        std::thread thread;
+        std::vector<uint32_t> cpus = {};  // 绑定的CPU，为空表示不绑定
+    };
+
+    static bool IsLater(const Task &a, const Task &b);
+    bool StartLocked();
+    void StopLocked();
+    void Push(uint32_t index, const Task &task);
+    bool PopLocal(uint32_t index, Task &task);
+    bool Steal(uint32_t index, Task &task);
+    void Loop(uint32_t index);
+
+    std::mutex m_configLock = {};  // 保护配置、工作线程的启停和会话计数
+    VmiEncodeExecutorConfig m_config = {};
+    uint32_t m_sessions = 0;
+    uint32_t m_threadCount = 0;  // 已启动的工作线程数
+    // 只在没有会话登记时增删，有会话时只读，调度和窃取无需加锁访问
+    std::vector<std::unique_ptr<Worker>> m_workers = {};
+
+    std::mutex m_wakeLock = {};  // 与m_wakeCond配合，增加m_pendingTasks和修改m_isRunning时持有
+    std::condition_variable m_wakeCond = {};
+    std::atomic<int64_t> m_pendingTasks = { 0 };  // 各本地队列中的任务总数，出队与入队计数的先后可能短暂颠倒
+    std::atomic<bool> m_isRunning = { false };
+
+    std::atomic<uint64_t> m_nextSeq = { 0 };
+    std::atomic<uint32_t> m_nextHome = { 0 };  // 首次调度的任务轮流放入各本地队列
+    std::atomic<uint64_t> m_tasksExecuted = { 0 };
+    std::atomic<uint64_t> m_steals = { 0 };
+    std::atomic<uint64_t> m_deadlineMisses = { 0 };
+};
+
+#endif  // VIDEO_ENCODER_EXECUTOR_H
@@ -0,0 +1,346 @@
+/*
+ * 功能说明: 跨进程共享内存帧环，基于memfd的单生产者单消费者帧槽位环，读写下标位于共享内存中，
+ *           一侧无事可做时在对端下标上futex睡眠，对端只在其睡眠时才发起唤醒系统调用
+ */
+
+#define LOG_TAG "VideoEncoderFrameRing"
+#include "VideoEncoderFrameRing.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <linux/memfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "VideoEncoderLog.h"
+#include "VideoEncoderTime.h"
+
+namespace {
+    constexpr char FRAME_RING_MAGIC[8] = { 'V', 'M', 'I', 'F', 'R', 'I', 'N', 'G' };
+    constexpr uint32_t FRAME_RING_VERSION = 1;
+    constexpr uint32_t FRAME_RING_SLOTS_DEFAULT = 4;
+    constexpr uint32_t FRAME_RING_SLOTS_MAX = 64;
+    constexpr uint64_t FRAME_RING_SIZE_MAX = 1ULL << 30;  // 32位进程也能映射
+    constexpr uint32_t FRAME_RING_SPIN_COUNT = 64;  // 睡眠前自旋检查对端下标的次数，对端即将提交时省去一次睡眠唤醒
+    constexpr size_t CACHE_LINE_SIZE = 64;
+    constexpr uint64_t NS_PER_MS = 1000000;
+    constexpr uint64_t NS_PER_SEC = 1000000000;
+
+    struct FrameRingSlotDesc {
+        uint64_t timestampNs;
+        uint32_t dataSize;
+        uint32_t reserved;
+    };
+
+    uint32_t RoundUpPowerOfTwo(uint32_t value)
+    {
+        uint32_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    size_t GetPageSize()
+    {
+        long pageSize = sysconf(_SC_PAGESIZE);
+        return (pageSize > 0) ? static_cast<size_t>(pageSize) : 4096;
+    }
+
+    size_t RoundUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint32_t *FutexWord(std::atomic<uint32_t> &word)
+    {
+        return reinterpret_cast<uint32_t *>(&word);
+    }
+
+    // 共享映射上的futex不能使用FUTEX_PRIVATE_FLAG
+    void FutexWait(std::atomic<uint32_t> &word, uint32_t expected, const struct timespec *timeout)
+    {
+        (void) syscall(SYS_futex, FutexWord(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+    }
+
+    void FutexWake(std::atomic<uint32_t> &word)
+    {
+        (void) syscall(SYS_futex, FutexWord(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && ATOMIC_INT_LOCK_FREE == 2,
+    "frame ring indices must be lock-free 32-bit words usable as futexes");
+
+// 位于共享内存中，两个进程各自映射，下标只增不减，差值即已提交未交还的帧数
+struct FrameRingShared {
+    char magic[sizeof(FRAME_RING_MAGIC)];
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    uint32_t slotOffset;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> writeIndex;  // 生产者已提交的帧数，消费者在其上等待
+    std::atomic<uint32_t> isConsumerWaiting;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> readIndex;   // 消费者已交还的帧数，生产者在其上等待
+    std::atomic<uint32_t> isProducerWaiting;
+    alignas(CACHE_LINE_SIZE) FrameRingSlotDesc slots[FRAME_RING_SLOTS_MAX];
+};
+
+VideoEncoderFrameRing::~VideoEncoderFrameRing()
+{
+    if (m_map != nullptr) {
+        (void) munmap(m_map, m_mapSize);
+    }
+    if (m_fd >= 0) {
+        (void) close(m_fd);
+    }
+}
+
+bool VideoEncoderFrameRing::Map(int fd, size_t mapSize)
+{
+    void *map = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        ERR("map frame ring of %zu bytes failed: %s", mapSize, strerror(errno));
+        return false;
+    }
+    m_map = map;
+    m_mapSize = mapSize;
+    m_shared = static_cast<FrameRingShared *>(map);
+    return true;
+}
+
+bool VideoEncoderFrameRing::Create(uint32_t slotCount, uint32_t slotSize)
+{
+    // 先检查上限再取整，避免超过2^31的槽位数在取整时溢出
+    if (slotCount > FRAME_RING_SLOTS_MAX) {
+        ERR("create frame ring failed: slot count %u exceeds max %u", slotCount, FRAME_RING_SLOTS_MAX);
+        return false;
+    }
+    slotCount = RoundUpPowerOfTwo((slotCount == 0) ? FRAME_RING_SLOTS_DEFAULT : slotCount);
+    size_t pageSize = GetPageSize();
+    uint64_t alignedSlotSize = RoundUp(slotSize, pageSize);
+    size_t slotOffset = RoundUp(sizeof(FrameRingShared), pageSize);
+    uint64_t totalSize = slotOffset + alignedSlotSize * slotCount;
+    if (m_map != nullptr || slotSize == 0 || totalSize > FRAME_RING_SIZE_MAX) {
+        ERR("create frame ring failed: %u slots of %u bytes is invalid or ring already mapped", slotCount, slotSize);
+        return false;
+    }
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "vmi_frame_ring", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd < 0) {
+        ERR("create frame ring memfd failed: %s", strerror(errno));
+        return false;
+    }
+    // 封印大小后对端无法截断文件
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0 ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0 || !Map(fd, totalSize)) {
+        ERR("size, seal or map frame ring memfd failed: %s", strerror(errno));
+        (void) close(fd);
+        return false;
+    }
+    m_fd = fd;
+    (void) memcpy(m_shared->magic, FRAME_RING_MAGIC, sizeof(FRAME_RING_MAGIC));
+    m_shared->version = FRAME_RING_VERSION;
+    m_shared->slotCount = slotCount;
+    m_shared->slotSize = static_cast<uint32_t>(alignedSlotSize);
+    m_shared->slotOffset = static_cast<uint32_t>(slotOffset);
+    m_mask = slotCount - 1;
+    m_slotSize = m_shared->slotSize;
+    m_slotOffset = m_shared->slotOffset;
+    INFO("created frame ring: fd %d, %u slots of %u bytes", fd, slotCount, m_slotSize);
+    return true;
+}
+
+bool VideoEncoderFrameRing::Attach(int fd)
+{
+    struct stat st = {};
+    if (m_map != nullptr || fd < 0 || fstat(fd, &st) != 0 ||
+        static_cast<uint64_t>(st.st_size) < sizeof(FrameRingShared) ||
+        static_cast<uint64_t>(st.st_size) > FRAME_RING_SIZE_MAX) {
+        ERR("attach frame ring failed: fd %d is invalid or ring already mapped", fd);
+        return false;
+    }
+    // 未封印的文件可能被对端截断，不予映射
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & F_SEAL_SHRINK) == 0) {
+        ERR("attach frame ring failed: fd %d is not a sealed memfd", fd);
+        return false;
+    }
+    auto fileSize = static_cast<size_t>(st.st_size);
+    if (!Map(fd, fileSize)) {
+        return false;
+    }
+    uint32_t slotCount = m_shared->slotCount;
+    uint32_t slotSize = m_shared->slotSize;
+    uint32_t slotOffset = m_shared->slotOffset;
+    size_t pageSize = GetPageSize();
+    if (memcmp(m_shared->magic, FRAME_RING_MAGIC, sizeof(FRAME_RING_MAGIC)) != 0 ||
+        m_shared->version != FRAME_RING_VERSION || slotCount == 0 || slotCount > FRAME_RING_SLOTS_MAX ||
+        (slotCount & (slotCount - 1)) != 0 || slotSize == 0 || slotSize % pageSize != 0 ||
+        slotOffset != RoundUp(sizeof(FrameRingShared), pageSize) ||
+        slotOffset + static_cast<uint64_t>(slotSize) * slotCount > fileSize) {
+        ERR("attach frame ring failed: fd %d header is invalid", fd);
+        (void) munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_shared = nullptr;
+        return false;
+    }
+    m_mask = slotCount - 1;
+    m_slotSize = slotSize;
+    m_slotOffset = slotOffset;
+    INFO("attached frame ring: fd %d, %u slots of %u bytes", fd, slotCount, slotSize);
+    return true;
+}
+
+uint8_t *VideoEncoderFrameRing::GetSlot(uint32_t index) const
+{
+    return static_cast<uint8_t *>(m_map) + m_slotOffset + static_cast<size_t>(index & m_mask) * m_slotSize;
+}
+
+bool VideoEncoderFrameRing::WaitUntil(bool isProducer, int32_t timeoutMs)
+{
+    // 生产者等待消费者交还槽位，消费者等待生产者提交帧，各自在对端推进的下标上睡眠；
+    // 共享状态损坏时也视为就绪，由调用者校验后报错
+    auto isReady = [this, isProducer]() {
+        uint32_t pending = m_shared->writeIndex.load(std::memory_order_acquire) -
+            m_shared->readIndex.load(std::memory_order_acquire);
+        return isProducer ? (pending != m_mask + 1) : (pending != 0);
+    };
+    for (uint32_t i = 0; i < FRAME_RING_SPIN_COUNT; ++i) {
+        if (isReady()) {
+            return true;
+        }
+    }
+    if (timeoutMs == 0) {
+        m_timeouts.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::atomic<uint32_t> &peerIndex = isProducer ? m_shared->readIndex : m_shared->writeIndex;
+    std::atomic<uint32_t> &isWaiting = isProducer ? m_shared->isProducerWaiting : m_shared->isConsumerWaiting;
+    uint64_t deadlineNs = (timeoutMs < 0) ? UINT64_MAX : GetMonotonicTimeNs() + timeoutMs * NS_PER_MS;
+    m_waits.fetch_add(1, std::memory_order_relaxed);
+    while (true) {
+        // 先读下标再置等待标志并复查: 对端在复查之后推进下标时必然看到等待标志，futex也会因下标已变而不睡眠
+        uint32_t observed = peerIndex.load(std::memory_order_seq_cst);
+        isWaiting.store(1, std::memory_order_seq_cst);
+        if (isReady()) {
+            isWaiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        struct timespec timeout = {};
+        if (deadlineNs != UINT64_MAX) {
+            uint64_t nowNs = GetMonotonicTimeNs();
+            uint64_t remainingNs = (deadlineNs > nowNs) ? deadlineNs - nowNs : 0;
+            timeout.tv_sec = static_cast<time_t>(remainingNs / NS_PER_SEC);
+            timeout.tv_nsec = static_cast<long>(remainingNs % NS_PER_SEC);
+        }
+        FutexWait(peerIndex, observed, (deadlineNs == UINT64_MAX) ? nullptr : &timeout);
+        isWaiting.store(0, std::memory_order_relaxed);
+        if (isReady()) {
+            return true;
+        }
+        if (deadlineNs != UINT64_MAX && GetMonotonicTimeNs() >= deadlineNs) {
+            m_timeouts.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+}
+
+VmiEncoderRetCode VideoEncoderFrameRing::AcquireSlot(int32_t timeoutMs, uint8_t *&slot, uint32_t &slotSize)
+{
+    if (m_shared == nullptr || m_isSlotAcquired) {
+        ERR("acquire frame slot failed: ring is not mapped or previous slot is not committed");
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    if (!WaitUntil(true, timeoutMs)) {
+        return VMI_ENCODER_FRAME_RING_TIMEOUT;
+    }
+    uint32_t writeIndex = m_shared->writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - m_shared->readIndex.load(std::memory_order_acquire) > m_mask) {
+        ERR("acquire frame slot failed: ring indices are corrupted");
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    slot = GetSlot(writeIndex);
+    slotSize = m_slotSize;
+    m_isSlotAcquired = true;
+    return VMI_ENCODER_SUCCESS;
+}
+
+VmiEncoderRetCode VideoEncoderFrameRing::CommitSlot(uint32_t dataSize, uint64_t timestampNs)
+{
+    if (!m_isSlotAcquired || dataSize > m_slotSize) {
+        ERR("commit frame slot failed: slot is not acquired or data size %u exceeds slot size %u", dataSize,
+            m_slotSize);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    uint32_t writeIndex = m_shared->writeIndex.load(std::memory_order_relaxed);
+    FrameRingSlotDesc &desc = m_shared->slots[writeIndex & m_mask];
+    desc.timestampNs = timestampNs;
+    desc.dataSize = dataSize;
+    m_shared->writeIndex.store(writeIndex + 1, std::memory_order_seq_cst);
+    m_isSlotAcquired = false;
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    if (m_shared->isConsumerWaiting.load(std::memory_order_seq_cst) != 0) {
+        FutexWake(m_shared->writeIndex);
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+VmiEncoderRetCode VideoEncoderFrameRing::AcquireFrame(int32_t timeoutMs, Frame &frame)
+{
+    if (m_shared == nullptr || m_isFrameAcquired) {
+        ERR("acquire frame failed: ring is not mapped or previous frame is not released");
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    if (!WaitUntil(false, timeoutMs)) {
+        return VMI_ENCODER_FRAME_RING_TIMEOUT;
+    }
+    uint32_t readIndex = m_shared->readIndex.load(std::memory_order_relaxed);
+    if (m_shared->writeIndex.load(std::memory_order_acquire) - readIndex > m_mask + 1) {
+        ERR("acquire frame failed: ring indices are corrupted");
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    // 描述位于对端可写的共享内存中，只读取一次，之后使用本地副本
+    const FrameRingSlotDesc &desc = m_shared->slots[readIndex & m_mask];
+    uint32_t dataSize = desc.dataSize;
+    uint64_t timestampNs = desc.timestampNs;
+    m_isFrameAcquired = true;
+    if (dataSize > m_slotSize) {
+        ERR("acquire frame failed: data size %u exceeds slot size %u", dataSize, m_slotSize);
+        ReleaseFrame();
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    frame.data = GetSlot(readIndex);
+    frame.dataSize = dataSize;
+    frame.frameSeq = m_frames.fetch_add(1, std::memory_order_relaxed);
+    frame.timestampNs = timestampNs;
+    return VMI_ENCODER_SUCCESS;
+}
+
+void VideoEncoderFrameRing::ReleaseFrame()
+{
+    if (!m_isFrameAcquired) {
+        return;
+    }
+    uint32_t readIndex = m_shared->readIndex.load(std::memory_order_relaxed);
+    m_shared->readIndex.store(readIndex + 1, std::memory_order_seq_cst);
+    m_isFrameAcquired = false;
+    if (m_shared->isProducerWaiting.load(std::memory_order_seq_cst) != 0) {
+        FutexWake(m_shared->readIndex);
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void VideoEncoderFrameRing::GetStats(VmiFrameRingStats &stats) const
+{
+    stats.slotCount = m_mask + 1;
+    stats.slotSize = m_slotSize;
+    stats.frames = m_frames.load(std::memory_order_relaxed);
+    stats.waits = m_waits.load(std::memory_order_relaxed);
+    stats.wakeups = m_wakeups.load(std::memory_order_relaxed);
+    stats.timeouts = m_timeouts.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,127 @@
+/*
+ * 功能说明: 跨进程共享内存帧环，基于memfd的单生产者单消费者帧槽位环，读写下标位于共享内存中，
+ *           一侧无事可做时在对端下标上futex睡眠，对端只在其睡眠时才发起唤醒系统调用。
+ *           生产者进程直接把帧写入槽位，编码进程在槽位上原地编码后交还，帧数据全程不拷贝
+ *
+ * 共享内存布局: 首页起为FrameRingShared共享头(魔数、版本、槽位参数、读写下标和每个槽位的帧描述)，
+ * 其后从slotOffset开始依次为slotCount个slotSize字节的槽位，槽位均页对齐。创建者设置大小后封印文件，
+ * 任何一方都不能再改变文件大小，避免对端截断文件使本进程访问映射时收到SIGBUS
+ */
+#ifndef VIDEO_ENCODER_FRAME_RING_H
+#define VIDEO_ENCODER_FRAME_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "VideoEncoderWrapper.h"
+
+struct FrameRingShared;
+
+class VideoEncoderFrameRing {
+public:
+    struct Frame {
+        uint8_t *data = nullptr;
+        uint32_t dataSize = 0;
+        uint64_t frameSeq = 0;
+        uint64_t timestampNs = 0;
+    };
+
+    VideoEncoderFrameRing() = default;
+
+    /**
+     * @功能描述: 析构函数，解除映射，创建者一侧同时关闭共享内存fd
+     */
+    ~VideoEncoderFrameRing();
+
+    /**
+     * @功能描述: 创建并映射共享内存帧环，作为消费者一侧
+     * @参数 [in] slotCount: 槽位个数，向上取整为2的幂，0表示默认值
+     * @参数 [in] slotSize: 槽位大小，向上取整为页大小的整数倍
+     * @返回值: true 成功，false 参数无效或创建共享内存失败
+     */
+    bool Create(uint32_t slotCount, uint32_t slotSize);
+
+    /**
+     * @功能描述: 映射对端创建的共享内存帧环并校验共享头，作为生产者一侧，不持有fd
+     * @参数 [in] fd: 共享内存文件描述符
+     * @返回值: true 成功，false 映射失败或共享内存不是帧环
+     */
+    bool Attach(int fd);
+
+    /**
+     * @功能描述: 获取创建者一侧持有的共享内存fd
+     * @返回值: fd，生产者一侧为-1
+     */
+    int GetFd() const
+    {
+        return m_fd;
+    }
+
+    /**
+     * @功能描述: 生产者获取下一个空闲槽位
+     * @参数 [in] timeoutMs: 无空闲槽位时的等待时间，0表示不等待，小于0表示一直等待
+     * @参数 [out] slot: 槽位地址
+     * @参数 [out] slotSize: 槽位大小
+     * @返回值: VMI_ENCODER_SUCCESS 成功
+     *          VMI_ENCODER_FRAME_RING_TIMEOUT 等待超时
+     *          VMI_ENCODER_FRAME_RING_FAIL 已有未提交的槽位或共享状态损坏
+     */
+    VmiEncoderRetCode AcquireSlot(int32_t timeoutMs, uint8_t *&slot, uint32_t &slotSize);
+
+    /**
+     * @功能描述: 生产者提交已获取的槽位，消费者正在等待时将其唤醒
+     * @参数 [in] dataSize: 帧数据大小
+     * @参数 [in] timestampNs: 时间戳
+     * @返回值: VMI_ENCODER_SUCCESS 成功
+     *          VMI_ENCODER_FRAME_RING_FAIL 未获取槽位或数据大小超过槽位大小
+     */
+    VmiEncoderRetCode CommitSlot(uint32_t dataSize, uint64_t timestampNs);
+
+    /**
+     * @功能描述: 消费者取出下一帧，帧数据在ReleaseFrame之前有效且不会被生产者改写
+     * @参数 [in] timeoutMs: 无待编码帧时的等待时间，0表示不等待，小于0表示一直等待
+     * @参数 [out] frame: 帧信息
+     * @返回值: VMI_ENCODER_SUCCESS 成功
+     *          VMI_ENCODER_FRAME_RING_TIMEOUT 等待超时
+     *          VMI_ENCODER_FRAME_RING_FAIL 已有未交还的帧，或共享状态损坏，损坏的帧已被交还
+     */
+    VmiEncoderRetCode AcquireFrame(int32_t timeoutMs, Frame &frame);
+
+    /**
+     * @功能描述: 消费者交还AcquireFrame取出的帧所在槽位，生产者正在等待时将其唤醒
+     */
+    void ReleaseFrame();
+
+    /**
+     * @功能描述: 获取本进程一侧的统计
+     * @参数 [out] stats: 帧环统计
+     */
+    void GetStats(VmiFrameRingStats &stats) const;
+
+private:
+    VideoEncoderFrameRing(const VideoEncoderFrameRing&) = delete;
+    VideoEncoderFrameRing& operator=(const VideoEncoderFrameRing&) = delete;
+    VideoEncoderFrameRing(VideoEncoderFrameRing &&) = delete;
+    VideoEncoderFrameRing& operator=(VideoEncoderFrameRing &&) = delete;
+
+    bool Map(int fd, size_t mapSize);
+    bool WaitUntil(bool isProducer, int32_t timeoutMs);
+    uint8_t *GetSlot(uint32_t index) const;
+
+    int m_fd = -1;  // 仅创建者一侧持有
+    void *m_map = nullptr;
+    size_t m_mapSize = 0;
+    FrameRingShared *m_shared = nullptr;
+    uint32_t m_mask = 0;
+    uint32_t m_slotSize = 0;
+    uint32_t m_slotOffset = 0;
+    bool m_isSlotAcquired = false;   // 生产者已获取尚未提交的槽位
+    bool m_isFrameAcquired = false;  // 消费者已取出尚未交还的帧
+    // 统计可能在另一线程阻塞等待时读取
+    std::atomic<uint64_t> m_frames = { 0 };
+    std::atomic<uint64_t> m_waits = { 0 };
+    std::atomic<uint64_t> m_wakeups = { 0 };
+    std::atomic<uint64_t> m_timeouts = { 0 };
+};
+
+#endif  // VIDEO_ENCODER_FRAME_RING_H
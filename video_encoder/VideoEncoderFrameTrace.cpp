@@ -0,0 +1,288 @@
+/*
+ * 功能说明: 逐帧追踪，按句柄和帧序号记录每次编码调用在封装层各阶段(句柄查找、锁等待、格式转换、厂商编码、
+ *           输出交付)的起止时间。事件写入每线程无锁环形缓冲区，按需导出为Chrome trace JSON，
+ *           或实时写入内核trace_marker供systrace/Perfetto采集。未开启时每个追踪点只有一次可预测的分支
+ */
+
+#define LOG_TAG "VideoEncoderFrameTrace"
+#include "VideoEncoderFrameTrace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+#include "VideoEncoderLog.h"
+
+std::atomic<bool> g_isFrameTraceEnabled = { false };
+
+namespace {
+    constexpr uint32_t EVENTS_PER_THREAD_DEFAULT = 65536;
+    constexpr uint32_t EVENTS_PER_THREAD_MAX = 1U << 24;
+    constexpr uint32_t VALID_MODES = VMI_FRAME_TRACE_BUFFER | VMI_FRAME_TRACE_ATRACE;
+    constexpr size_t THREAD_NAME_LEN = 16;  // 含结尾'\0'，与pthread_setname_np的限制一致
+    constexpr size_t MARKER_LEN = 96;
+    constexpr double NS_PER_US = 1000.0;
+    // Android上tracefs挂载在/sys/kernel/tracing，较早的内核只有debugfs下的路径
+    const char *const TRACE_MARKER_PATHS[] = {
+        "/sys/kernel/tracing/trace_marker",
+        "/sys/kernel/debug/tracing/trace_marker"
+    };
+    const char *const STAGE_NAMES[FRAME_TRACE_STAGE_COUNT] = {
+        "frame", "lookup", "lock_wait", "convert", "encode", "output", "callback"
+    };
+
+    // 当前线程的缓冲区及其所属的开启批次，线程退出后缓冲区由列表继续持有，可被新线程复用
+    thread_local std::shared_ptr<void> g_threadBuffer = nullptr;
+    thread_local uint32_t g_threadGeneration = 0;
+
+    uint32_t GetThreadId()
+    {
+        return static_cast<uint32_t>(syscall(SYS_gettid));
+    }
+
+    uint64_t RoundUpPowerOfTwo(uint64_t value)
+    {
+        uint64_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+VideoEncoderFrameTrace& VideoEncoderFrameTrace::GetInstance()
+{
+    static VideoEncoderFrameTrace instance;
+    return instance;
+}
+
+const char *VideoEncoderFrameTrace::GetStageName(uint32_t stage)
+{
+    return (stage < FRAME_TRACE_STAGE_COUNT) ? STAGE_NAMES[stage] : "unknown";
+}
+
+bool VideoEncoderFrameTrace::OpenTraceMarker()
+{
+    if (m_markerFd >= 0) {
+        return true;
+    }
+    for (const char *path : TRACE_MARKER_PATHS) {
+        m_markerFd = open(path, O_WRONLY | O_CLOEXEC);
+        if (m_markerFd >= 0) {
+            INFO("frame trace writes markers to %s", path);
+            return true;
+        }
+    }
+    WARN("open trace_marker failed: %s", strerror(errno));
+    return false;
+}
+
+bool VideoEncoderFrameTrace::Enable(const VmiFrameTraceConfig &config)
+{
+    if (config.modes == 0 || (config.modes & ~VALID_MODES) != 0 || config.eventsPerThread > EVENTS_PER_THREAD_MAX) {
+        ERR("invalid frame trace config: modes %#x, events per thread %u", config.modes, config.eventsPerThread);
+        return false;
+    }
+    bool isBufferEnabled = (config.modes & VMI_FRAME_TRACE_BUFFER) != 0;
+    bool isMarkerEnabled = false;
+    std::lock_guard<std::mutex> lck(m_lock);
+    if ((config.modes & VMI_FRAME_TRACE_ATRACE) != 0) {
+        isMarkerEnabled = OpenTraceMarker();
+        if (!isMarkerEnabled && !isBufferEnabled) {
+            ERR("enable frame trace failed: trace_marker is not available");
+            return false;
+        }
+    }
+    uint32_t eventsPerThread = (config.eventsPerThread == 0) ? EVENTS_PER_THREAD_DEFAULT : config.eventsPerThread;
+    m_eventsPerThread = isBufferEnabled ? RoundUpPowerOfTwo(eventsPerThread) : 0;
+    m_buffers.clear();
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+    m_isBufferEnabled.store(isBufferEnabled, std::memory_order_relaxed);
+    m_isMarkerEnabled.store(isMarkerEnabled, std::memory_order_relaxed);
+    g_isFrameTraceEnabled.store(true, std::memory_order_release);
+    INFO("frame trace enabled: buffer %s, %" PRIu64 " events per thread, trace_marker %s",
+        isBufferEnabled ? "on" : "off", m_eventsPerThread, isMarkerEnabled ? "on" : "off");
+    return true;
+}
+
+void VideoEncoderFrameTrace::Disable()
+{
+    g_isFrameTraceEnabled.store(false, std::memory_order_release);
+    m_isMarkerEnabled.store(false, std::memory_order_relaxed);
+}
+
+void VideoEncoderFrameTrace::WriteTraceMarker(const char *text, int len) const
+{
+    if (len > 0) {
+        // 内核未在采集时写入会失败，不影响编码
+        ssize_t written = write(m_markerFd, text, std::min(static_cast<size_t>(len), MARKER_LEN - 1));
+        (void) written;
+    }
+}
+
+void VideoEncoderFrameTrace::BeginStage(uint32_t stage, const FrameTraceKey &key)
+{
+    if (!m_isMarkerEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // 与ATrace_beginSection格式一致: B|pid|name
+    char text[MARKER_LEN];
+    int len = snprintf(text, sizeof(text), "B|%d|venc %s %#x #%" PRIu64, static_cast<int>(getpid()),
+        GetStageName(stage), key.encHandle, key.frameSeq);
+    WriteTraceMarker(text, len);
+}
+
+void VideoEncoderFrameTrace::EndStage()
+{
+    if (!m_isMarkerEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    char text[MARKER_LEN];
+    int len = snprintf(text, sizeof(text), "E|%d", static_cast<int>(getpid()));
+    WriteTraceMarker(text, len);
+}
+
+VideoEncoderFrameTrace::ThreadBuffer *VideoEncoderFrameTrace::GetThreadBuffer()
+{
+    if (g_threadBuffer != nullptr && g_threadGeneration == m_generation.load(std::memory_order_relaxed)) {
+        return static_cast<ThreadBuffer *>(g_threadBuffer.get());
+    }
+    std::lock_guard<std::mutex> lck(m_lock);
+    g_threadBuffer = nullptr;
+    if (m_eventsPerThread == 0) {
+        return nullptr;
+    }
+    std::shared_ptr<ThreadBuffer> buffer = nullptr;
+    // 优先复用所属线程已退出的缓冲区(只剩列表持有)，避免线程频繁创建销毁时缓冲区无限增长
+    for (auto &candidate : m_buffers) {
+        if (candidate.use_count() == 1) {
+            buffer = candidate;
+            break;
+        }
+    }
+    if (buffer == nullptr) {
+        try {
+            buffer = std::make_shared<ThreadBuffer>();
+            buffer->events.reset(new Event[m_eventsPerThread]);
+            buffer->mask = m_eventsPerThread - 1;
+            m_buffers.push_back(buffer);
+        } catch (const std::bad_alloc &e) {
+            ERR("alloc frame trace buffer of %" PRIu64 " events failed", m_eventsPerThread);
+            return nullptr;
+        }
+    }
+    buffer->tid = GetThreadId();
+    char name[THREAD_NAME_LEN] = {'\0'};
+    (void) pthread_getname_np(pthread_self(), name, sizeof(name));
+    buffer->threadName.assign(name);
+    g_threadBuffer = buffer;
+    g_threadGeneration = m_generation.load(std::memory_order_relaxed);
+    return buffer.get();
+}
+
+void VideoEncoderFrameTrace::Record(uint32_t stage, const FrameTraceKey &key, uint64_t beginNs, uint64_t endNs)
+{
+    if (!m_isBufferEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadBuffer *buffer = GetThreadBuffer();
+    if (buffer == nullptr) {
+        return;
+    }
+    uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+    Event &event = buffer->events[index & buffer->mask];
+    event.beginNs = beginNs;
+    event.endNs = endNs;
+    event.frameSeq = key.frameSeq;
+    event.encHandle = key.encHandle;
+    event.stage = stage;
+    event.tid = buffer->tid;
+    buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void VideoEncoderFrameTrace::CopyEvents(const ThreadBuffer &buffer, std::vector<Event> &events) const
+{
+    uint64_t capacity = buffer.mask + 1;
+    uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+    uint64_t begin = (end > capacity) ? end - capacity : 0;
+    size_t first = events.size();
+    for (uint64_t i = begin; i < end; ++i) {
+        events.push_back(buffer.events[i & buffer.mask]);
+    }
+    // 复制期间写入线程可能覆盖了最旧的事件，正在写入(尚未发布)的事件还会再覆盖一个
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = buffer.writeIndex.load(std::memory_order_relaxed);
+    uint64_t valid = (after + 1 > capacity) ? after + 1 - capacity : 0;
+    if (valid > begin) {
+        size_t overwritten = static_cast<size_t>(std::min(valid, end) - begin);
+        events.erase(events.begin() + first, events.begin() + first + overwritten);
+    }
+}
+
+bool VideoEncoderFrameTrace::Export(const std::string &path)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;  // 缓冲区被复用时会改写线程名，在锁内复制
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        buffers = m_buffers;
+        for (const auto &buffer : m_buffers) {
+            if (!buffer->threadName.empty()) {
+                threadNames.emplace_back(buffer->tid, buffer->threadName);
+            }
+        }
+    }
+    std::vector<Event> events;
+    for (const auto &buffer : buffers) {
+        CopyEvents(*buffer, events);
+    }
+    FILE *file = fopen(path.c_str(), "we");
+    if (file == nullptr) {
+        ERR("open frame trace file %s failed: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    int pid = static_cast<int>(getpid());
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool isFirst = true;
+    for (const auto &threadName : threadNames) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            isFirst ? "" : ",\n", pid, threadName.first, threadName.second.c_str());
+        isFirst = false;
+    }
+    for (const Event &event : events) {
+        fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"venc\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,"
+            "\"tid\":%u,\"args\":{\"handle\":\"%#x\",\"frame\":%" PRIu64 "}}", isFirst ? "" : ",\n",
+            GetStageName(event.stage), event.beginNs / NS_PER_US, (event.endNs - event.beginNs) / NS_PER_US, pid,
+            event.tid, event.encHandle, event.frameSeq);
+        isFirst = false;
+    }
+    fprintf(file, "\n]}\n");
+    bool isOk = (ferror(file) == 0);
+    isOk = (fclose(file) == 0) && isOk;
+    if (!isOk) {
+        ERR("write frame trace file %s failed", path.c_str());
+        return false;
+    }
+    INFO("exported %zu frame trace events to %s", events.size(), path.c_str());
+    return true;
+}
+
+void VideoEncoderFrameTrace::GetStats(VmiFrameTraceStats &stats)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    stats.recordedEvents = 0;
+    stats.overwrittenEvents = 0;
+    stats.threads = static_cast<uint32_t>(m_buffers.size());
+    for (const auto &buffer : m_buffers) {
+        uint64_t written = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->mask + 1;
+        stats.recordedEvents += written;
+        stats.overwrittenEvents += (written > capacity) ? written - capacity : 0;
+    }
+}
@@ -0,0 +1,182 @@
+/*
+ * 功能说明: 逐帧追踪，按句柄和帧序号记录每次编码调用在封装层各阶段(句柄查找、锁等待、格式转换、厂商编码、
+ *           输出交付)的起止时间。事件写入每线程无锁环形缓冲区，按需导出为Chrome trace JSON，
+ *           或实时写入内核trace_marker供systrace/Perfetto采集。未开启时每个追踪点只有一次可预测的分支
+ */
+#ifndef VIDEO_ENCODER_FRAME_TRACE_H
+#define VIDEO_ENCODER_FRAME_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "VideoEncoderTime.h"
+#include "VideoEncoderWrapper.h"
+
+enum FrameTraceStage : uint32_t {
+    FRAME_TRACE_FRAME = 0,      // 整个编码调用
+    FRAME_TRACE_LOOKUP = 1,     // 句柄查找
+    FRAME_TRACE_LOCK_WAIT = 2,  // 等待实例锁
+    FRAME_TRACE_CONVERT = 3,    // 输入格式转换
+    FRAME_TRACE_ENCODE = 4,     // 厂商EncodeOneFrame
+    FRAME_TRACE_OUTPUT = 5,     // 输出交付: 提交输出环或拷贝到调用者缓冲区
+    FRAME_TRACE_CALLBACK = 6,   // 异步编码回调，帧序号为异步提交序号
+    FRAME_TRACE_STAGE_COUNT
+};
+
+// 追踪事件的键，帧序号在取得实例锁后才确定
+struct FrameTraceKey {
+    uint32_t encHandle = 0;
+    uint64_t frameSeq = 0;
+};
+
+// 是否开启逐帧追踪，追踪点只读取该标志
+extern std::atomic<bool> g_isFrameTraceEnabled;
+
+class VideoEncoderFrameTrace {
+public:
+    /**
+     * @功能描述: 获取VideoEncoderFrameTrace单例对象
+     * @返回值: 返回值VideoEncoderFrameTrace单例对象引用
+     */
+    static VideoEncoderFrameTrace& GetInstance();
+
+    /**
+     * @功能描述: 开启逐帧追踪，已开启时按新配置重新开始，之前记录的事件被丢弃
+     * @参数 [in] config: 追踪配置
+     * @返回值: true 成功，false 配置无效，或只要求写入trace_marker而其无法打开
+     */
+    bool Enable(const VmiFrameTraceConfig &config);
+
+    /**
+     * @功能描述: 关闭逐帧追踪，已记录的事件保留到下次开启，仍可导出
+     */
+    void Disable();
+
+    /**
+     * @功能描述: 阶段开始时调用，需要时写入trace_marker开始标记
+     * @参数 [in] stage: 阶段
+     * @参数 [in] key: 事件键
+     */
+    void BeginStage(uint32_t stage, const FrameTraceKey &key);
+
+    /**
+     * @功能描述: 阶段结束时调用，需要时写入trace_marker结束标记
+     */
+    void EndStage();
+
+    /**
+     * @功能描述: 将一个阶段写入当前线程的环形缓冲区，缓冲区满时覆盖最旧的事件
+     * @参数 [in] stage: 阶段
+     * @参数 [in] key: 事件键
+     * @参数 [in] beginNs: 开始时间
+     * @参数 [in] endNs: 结束时间
+     */
+    void Record(uint32_t stage, const FrameTraceKey &key, uint64_t beginNs, uint64_t endNs);
+
+    /**
+     * @功能描述: 将各线程缓冲区中的事件导出为Chrome trace JSON，可在chrome://tracing或ui.perfetto.dev中打开，
+     *            导出时记录线程继续写入，被覆盖的事件不导出
+     * @参数 [in] path: 文件路径
+     * @返回值: true 成功，false 文件无法写入
+     */
+    bool Export(const std::string &path);
+
+    /**
+     * @功能描述: 获取追踪统计
+     * @参数 [out] stats: 追踪统计
+     */
+    void GetStats(VmiFrameTraceStats &stats);
+
+    /**
+     * @功能描述: 获取阶段名称
+     * @参数 [in] stage: 阶段
+     * @返回值: 阶段名称
+     */
+    static const char *GetStageName(uint32_t stage);
+
+private:
+    VideoEncoderFrameTrace() = default;
+    ~VideoEncoderFrameTrace() = default;
+    VideoEncoderFrameTrace(const VideoEncoderFrameTrace&) = delete;
+    VideoEncoderFrameTrace& operator=(const VideoEncoderFrameTrace&) = delete;
+    VideoEncoderFrameTrace(VideoEncoderFrameTrace &&) = delete;
+    VideoEncoderFrameTrace& operator=(VideoEncoderFrameTrace &&) = delete;
+
+    struct Event {
+        uint64_t beginNs;
+        uint64_t endNs;
+        uint64_t frameSeq;
+        uint32_t encHandle;
+        uint32_t stage;
+        uint32_t tid;
+    };
+
+    // 单写者环形缓冲区，只由所属线程写入，导出时无锁读取
+    struct ThreadBuffer {
+        std::unique_ptr<Event[]> events = nullptr;
+        uint64_t mask = 0;  // 容量为2的幂，下标按掩码取模
+        std::atomic<uint64_t> writeIndex = { 0 };  // 已发布的事件总数
+        uint32_t tid = 0;
+        std::string threadName = "";
+    };
+
+    ThreadBuffer *GetThreadBuffer();
+    void CopyEvents(const ThreadBuffer &buffer, std::vector<Event> &events) const;
+    bool OpenTraceMarker();
+    void WriteTraceMarker(const char *text, int len) const;
+
+    std::mutex m_lock = {};  // 保护配置和缓冲区列表，只在开启、线程首次记录和导出时持有
+    uint64_t m_eventsPerThread = 0;
+    std::atomic<uint32_t> m_generation = { 0 };  // 每次开启加1，线程据此丢弃上次开启时的缓冲区
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers = {};
+    std::atomic<bool> m_isBufferEnabled = { false };
+    std::atomic<bool> m_isMarkerEnabled = { false };
+    int m_markerFd = -1;  // 打开后不再关闭，避免与正在写入的线程竞争
+};
+
+/**
+ * 追踪阶段的作用域对象，构造时开始，End或析构时结束，析构时按键的当前值写入缓冲区，
+ * 因此可在帧序号确定之前开始阶段。未开启追踪时构造只读取一次开关
+ */
+class VideoEncoderTraceSpan {
+public:
+    VideoEncoderTraceSpan(uint32_t stage, const FrameTraceKey &key) : m_stage(stage), m_key(key)
+    {
+        if (g_isFrameTraceEnabled.load(std::memory_order_relaxed)) {
+            m_beginNs = GetMonotonicTimeNs();
+            VideoEncoderFrameTrace::GetInstance().BeginStage(stage, key);
+        }
+    }
+
+    ~VideoEncoderTraceSpan()
+    {
+        if (m_beginNs != 0) {
+            End();
+            VideoEncoderFrameTrace::GetInstance().Record(m_stage, m_key, m_beginNs, m_endNs);
+        }
+    }
+
+    void End()
+    {
+        if (m_beginNs != 0 && m_endNs == 0) {
+            m_endNs = GetMonotonicTimeNs();
+            VideoEncoderFrameTrace::GetInstance().EndStage();
+        }
+    }
+
+private:
+    VideoEncoderTraceSpan(const VideoEncoderTraceSpan&) = delete;
+    VideoEncoderTraceSpan& operator=(const VideoEncoderTraceSpan&) = delete;
+    VideoEncoderTraceSpan(VideoEncoderTraceSpan &&) = delete;
+    VideoEncoderTraceSpan& operator=(VideoEncoderTraceSpan &&) = delete;
+
+    uint32_t m_stage = FRAME_TRACE_FRAME;
+    const FrameTraceKey &m_key;
+    uint64_t m_beginNs = 0;
+    uint64_t m_endNs = 0;
+};
+
+#endif  // VIDEO_ENCODER_FRAME_TRACE_H
@@ -0,0 +1,132 @@
+/*
+ * 功能说明: 编码器句柄表，基于固定容量槽位数组和带代数标记的句柄，支持不同句柄间的并发查找
+ */
+#ifndef VIDEO_ENCODER_HANDLE_TABLE_H
+#define VIDEO_ENCODER_HANDLE_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+/**
+ * 句柄格式: 低INDEX_BITS位为槽位下标，高位为槽位代数。槽位每次被重新占用时代数加一，
+ * 因此已销毁句柄即使槽位被复用也不会查到新对象。代数从1开始，保证句柄永不为0。
+ * 每个槽位自带一把锁，仅在查找时短暂持有以取出对象引用，不同句柄的查找互不阻塞；
+ * 对象自身的并发保护由调用者负责。空闲槽位链表仅在插入和删除时加锁。
+ */
+template <typename T, uint32_t INDEX_BITS>
+class VideoEncoderHandleTable {
+    struct Slot;
+
+public:
+    static constexpr uint32_t CAPACITY = 1U << INDEX_BITS;
+    static constexpr uint32_t INVALID_HANDLE = 0;
+
+    VideoEncoderHandleTable() : m_slots(new Slot[CAPACITY])
+    {
+        for (uint32_t i = 0; i < CAPACITY; ++i) {
+            m_freeSlots.push_back(i);
+        }
+    }
+
+    ~VideoEncoderHandleTable() = default;
+    VideoEncoderHandleTable(const VideoEncoderHandleTable&) = delete;
+    VideoEncoderHandleTable& operator=(const VideoEncoderHandleTable&) = delete;
+    VideoEncoderHandleTable(VideoEncoderHandleTable &&) = delete;
+    VideoEncoderHandleTable& operator=(VideoEncoderHandleTable &&) = delete;
+
+    /**
+     * @功能描述: 插入对象并分配句柄
+     * @参数 [in] object: 待插入对象
+     * @返回值: 分配的句柄，表已满时返回INVALID_HANDLE
+     */
+    uint32_t Insert(std::shared_ptr<T> object)
+    {
+        uint32_t index = 0;
+        {
+            std::lock_guard<std::mutex> lck(m_freeLock);
+            if (m_freeSlots.empty()) {
+                return INVALID_HANDLE;
+            }
+            index = m_freeSlots.front();
+            m_freeSlots.pop_front();
+        }
+        Slot &slot = m_slots[index];
+        std::lock_guard<std::mutex> lck(slot.lock);
+        slot.generation = (slot.generation + 1) & GENERATION_MASK;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.handle = (slot.generation << INDEX_BITS) | index;
+        slot.object = std::move(object);
+        return slot.handle;
+    }
+
+    /**
+     * @功能描述: 查找句柄对应的对象
+     * @参数 [in] handle: 对象句柄
+     * @返回值: 句柄有效时返回对象引用，否则返回空
+     */
+    std::shared_ptr<T> Find(uint32_t handle)
+    {
+        if (handle == INVALID_HANDLE) {
+            return nullptr;
+        }
+        Slot &slot = m_slots[handle & INDEX_MASK];
+        std::lock_guard<std::mutex> lck(slot.lock);
+        if (slot.handle != handle) {
+            return nullptr;
+        }
+        return slot.object;
+    }
+
+    /**
+     * @功能描述: 删除句柄并回收槽位，已通过Find取得的对象引用仍然有效
+     * @参数 [in] handle: 对象句柄
+     * @返回值: 被删除的对象，句柄无效时返回空
+     */
+    std::shared_ptr<T> Remove(uint32_t handle)
+    {
+        if (handle == INVALID_HANDLE) {
+            return nullptr;
+        }
+        uint32_t index = handle & INDEX_MASK;
+        std::shared_ptr<T> object = nullptr;
+        {
+            Slot &slot = m_slots[index];
+            std::lock_guard<std::mutex> lck(slot.lock);
+            if (slot.handle != handle) {
+                return nullptr;
+            }
+            slot.handle = INVALID_HANDLE;
+            object = std::move(slot.object);
+        }
+        std::lock_guard<std::mutex> lck(m_freeLock);
+        m_freeSlots.push_back(index);
+        return object;
+    }
+
+private:
+    static constexpr uint32_t INDEX_MASK = CAPACITY - 1;
+    static constexpr uint32_t GENERATION_MASK = (1U << (32 - INDEX_BITS)) - 1;
+
+    struct Slot {
+        std::mutex lock;
+        uint32_t handle = INVALID_HANDLE;
+        uint32_t generation = 0;
+        std::shared_ptr<T> object = nullptr;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::mutex m_freeLock = {};
+    std::deque<uint32_t> m_freeSlots = {};
+};
+
+template <typename T, uint32_t INDEX_BITS>
+constexpr uint32_t VideoEncoderHandleTable<T, INDEX_BITS>::CAPACITY;
+
+template <typename T, uint32_t INDEX_BITS>
+constexpr uint32_t VideoEncoderHandleTable<T, INDEX_BITS>::INVALID_HANDLE;
+
+#endif  // VIDEO_ENCODER_HANDLE_TABLE_H
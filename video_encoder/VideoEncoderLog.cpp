@@ -3,14 +3,341 @@
  */
 
 #include "VideoEncoderLog.h"
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <string>
-#include <android/log.h>
+#include <system_error>
+#include <thread>
 #include <cinttypes>
 #include <sys/system_properties.h>
+#include "VideoEncoderTime.h"
 
 namespace {
     std::string PROP_VMI_LOG_LEVEL = "ro.vmi.loglevel";
+
+    constexpr int LOG_BUF_SIZE = 512;
+    constexpr int LOG_TAG_SIZE = 64;
+    constexpr uint64_t LOG_QUEUE_CAPACITY = 256;  // 必须为2的幂
+    constexpr uint64_t LOG_SITE_WINDOW_NS = 1000000000ULL;
+    constexpr auto LOG_IDLE_WAIT = std::chrono::milliseconds(100);
+    constexpr auto LOG_FLUSH_WAIT = std::chrono::milliseconds(10);
+    constexpr uint32_t LOG_FLUSH_RETRY_MAX = 100;
+
+    // 发生过抑制的调用点，只增不删，调用点为静态变量，生命周期与进程相同
+    std::atomic<VmiLogSite *> g_logSites = { nullptr };
+
+    /**
+     * @功能描述: 时间窗口已结束但仍有未报告抑制条数的调用点，由后台线程补报。与调用线程竞争同一个窗口切换，
+     *            只有切换成功的一方取走抑制条数，因此同一批抑制不会重复报告
+     */
+    void ReportSuppressedSites()
+    {
+        uint64_t nowNs = GetMonotonicTimeNs();
+        for (VmiLogSite *site = g_logSites.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+            if (site->suppressed.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            uint64_t windowStart = site->windowStartNs.load(std::memory_order_relaxed);
+            if (nowNs - windowStart < LOG_SITE_WINDOW_NS ||
+                !site->windowStartNs.compare_exchange_strong(windowStart, nowNs, std::memory_order_relaxed)) {
+                continue;
+            }
+            site->count.store(0, std::memory_order_relaxed);
+            uint32_t suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+            char tag[LOG_TAG_SIZE] = {0};
+            (void) snprintf(tag, sizeof(tag), "VMI_%s", site->vmiTag);
+            __android_log_print(site->level, tag, "suppressed %u similar messages: %s", suppressed, site->fmt);
+        }
+    }
+
+    struct LogRecord {
+        int level = ANDROID_LOG_DEFAULT;
+        const char *vmiTag = nullptr;  // 静态字符串，写入时加"VMI_"前缀；为空时使用tag
+        char tag[LOG_TAG_SIZE] = {0};
+        char msg[LOG_BUF_SIZE] = {0};
+    };
+
+    enum class PushResult {
+        QUEUED,       // 已入队
+        FULL,         // 队列已满，日志被丢弃并计入丢弃条数
+        NOT_RUNNING   // 后台线程不可用，需由调用者同步写入
+    };
+
+    /**
+     * 异步日志写入器: 有界多生产者单消费者无锁环形队列，生产者直接格式化到队列槽位中，
+     * 后台线程按序写入系统日志。槽位序号的用法同Vyukov有界队列，生产者之间只竞争一次CAS
+     */
+    class AsyncLogWriter {
+    public:
+        static AsyncLogWriter& GetInstance()
+        {
+            static AsyncLogWriter writer;
+            return writer;
+        }
+
+        /**
+         * @功能描述: 申请一个槽位并由fill填充日志内容后发布
+         * @返回值: 入队结果，队列满时直接丢弃，不回退为同步写入，避免日志风暴时调用线程阻塞在系统日志上
+         */
+        template <typename Fill>
+        PushResult Push(Fill fill)
+        {
+            if (!m_isRunning.load(std::memory_order_acquire)) {
+                return PushResult::NOT_RUNNING;
+            }
+            uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            Cell *cell = nullptr;
+            while (true) {
+                cell = &m_cells[pos & (LOG_QUEUE_CAPACITY - 1)];
+                uint64_t seq = cell->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<int64_t>(seq - pos);
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    (void) m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return PushResult::FULL;
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            fill(cell->record);
+            cell->seq.store(pos + 1, std::memory_order_release);
+            // 与消费者设置休眠标志后的队列检查配对，避免丢失唤醒；消费者休眠期间只有第一个生产者加锁唤醒
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_isSleeping.load(std::memory_order_relaxed) &&
+                m_isSleeping.exchange(false, std::memory_order_relaxed)) {
+                std::lock_guard<std::mutex> lck(m_lock);
+                m_wakeCond.notify_one();
+            }
+            return PushResult::QUEUED;
+        }
+
+        void Flush()
+        {
+            if (!m_isRunning.load(std::memory_order_acquire)) {
+                return;
+            }
+            uint64_t target = m_enqueuePos.load(std::memory_order_acquire);
+            std::unique_lock<std::mutex> lck(m_lock);
+            m_wakeCond.notify_one();
+            for (uint32_t i = 0; i < LOG_FLUSH_RETRY_MAX; ++i) {
+                if (m_idleCond.wait_for(lck, LOG_FLUSH_WAIT,
+                    [this, target] { return m_drainedPos.load(std::memory_order_acquire) >= target; })) {
+                    return;
+                }
+                m_wakeCond.notify_one();
+            }
+        }
+
+    private:
+        struct Cell {
+            std::atomic<uint64_t> seq;
+            LogRecord record;
+        };
+
+        AsyncLogWriter()
+        {
+            m_cells.reset(new (std::nothrow) Cell[LOG_QUEUE_CAPACITY]);
+            if (m_cells == nullptr) {
+                return;
+            }
+            for (uint64_t i = 0; i < LOG_QUEUE_CAPACITY; ++i) {
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+            m_isRunning.store(true, std::memory_order_release);
+            try {
+                m_thread = std::thread(&AsyncLogWriter::Run, this);
+            } catch (const std::system_error &e) {
+                m_isRunning.store(false, std::memory_order_release);
+                __android_log_print(ANDROID_LOG_ERROR, "VMI_Logging", "start log thread failed: %s, log synchronously",
+                    e.what());
+            }
+        }
+
+        ~AsyncLogWriter()
+        {
+            if (!m_thread.joinable()) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lck(m_lock);
+                m_isRunning.store(false, std::memory_order_release);
+                m_wakeCond.notify_one();
+            }
+            m_thread.join();
+        }
+
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+        AsyncLogWriter(AsyncLogWriter &&) = delete;
+        AsyncLogWriter& operator=(AsyncLogWriter &&) = delete;
+
+        bool IsEmpty() const
+        {
+            const Cell &cell = m_cells[m_dequeuePos & (LOG_QUEUE_CAPACITY - 1)];
+            return cell.seq.load(std::memory_order_acquire) != m_dequeuePos + 1;
+        }
+
+        bool DrainOne()
+        {
+            if (IsEmpty()) {
+                return false;
+            }
+            Cell &cell = m_cells[m_dequeuePos & (LOG_QUEUE_CAPACITY - 1)];
+            const char *tag = cell.record.tag;
+            char fullTag[LOG_TAG_SIZE] = {0};
+            if (cell.record.vmiTag != nullptr) {
+                (void) snprintf(fullTag, sizeof(fullTag), "VMI_%s", cell.record.vmiTag);
+                tag = fullTag;
+            }
+            (void) __android_log_write(cell.record.level, tag, cell.record.msg);
+            cell.seq.store(m_dequeuePos + LOG_QUEUE_CAPACITY, std::memory_order_release);
+            ++m_dequeuePos;
+            m_drainedPos.store(m_dequeuePos, std::memory_order_release);
+            return true;
+        }
+
+        void ReportDropped()
+        {
+            uint64_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped != 0) {
+                __android_log_print(ANDROID_LOG_WARN, "VMI_Logging", "log queue full, dropped %" PRIu64 " messages",
+                    dropped);
+            }
+        }
+
+        void Run()
+        {
+            while (true) {
+                while (DrainOne()) {
+                }
+                ReportDropped();
+                ReportSuppressedSites();
+                std::unique_lock<std::mutex> lck(m_lock);
+                m_idleCond.notify_all();
+                m_isSleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (IsEmpty()) {
+                    if (!m_isRunning.load(std::memory_order_acquire)) {
+                        break;
+                    }
+                    (void) m_wakeCond.wait_for(lck, LOG_IDLE_WAIT);
+                }
+                m_isSleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        std::unique_ptr<Cell[]> m_cells = nullptr;
+        alignas(64) std::atomic<uint64_t> m_enqueuePos = { 0 };
+        alignas(64) uint64_t m_dequeuePos = 0;  // 仅后台线程访问
+        std::atomic<uint64_t> m_drainedPos = { 0 };
+        std::atomic<uint64_t> m_dropped = { 0 };
+        std::atomic<bool> m_isSleeping = { false };
+        std::atomic<bool> m_isRunning = { false };
+        std::mutex m_lock = {};
+        std::condition_variable m_wakeCond = {};
+        std::condition_variable m_idleCond = {};
+        std::thread m_thread;
+    };
+
+    /**
+     * @功能描述: 调用点首次抑制时记录其日志级别、标签和格式串并登记到全局链表
+     * @参数 [in] site: 调用点限流状态
+     * @参数 [in] level: 日志级别
+     * @参数 [in] vmiTag: 日志标签
+     * @参数 [in] fmt: 格式串
+     */
+    void RegisterLogSite(VmiLogSite &site, int level, const char *vmiTag, const char *fmt)
+    {
+        if (site.isRegistered.load(std::memory_order_relaxed) || site.isRegistered.exchange(true)) {
+            return;
+        }
+        site.level = level;
+        site.vmiTag = (vmiTag == nullptr) ? "Native" : vmiTag;
+        site.fmt = fmt;
+        site.next = g_logSites.load(std::memory_order_relaxed);
+        while (!g_logSites.compare_exchange_weak(site.next, &site, std::memory_order_release,
+            std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @功能描述: 调用点限流，时间窗口内前VMI_LOG_SITE_BURST条放行，其余只计数
+     * @参数 [in] site: 调用点限流状态
+     * @参数 [in] level: 日志级别
+     * @参数 [in] vmiTag: 日志标签
+     * @参数 [in] fmt: 格式串
+     * @参数 [out] suppressed: 放行时为上一个时间窗口内被抑制的条数
+     * @返回值: true 放行，false 抑制
+     */
+    bool AcquireLogSite(VmiLogSite &site, int level, const char *vmiTag, const char *fmt, uint32_t &suppressed)
+    {
+        suppressed = 0;
+        uint64_t nowNs = GetMonotonicTimeNs();
+        uint64_t windowStart = site.windowStartNs.load(std::memory_order_relaxed);
+        if (nowNs - windowStart >= LOG_SITE_WINDOW_NS &&
+            site.windowStartNs.compare_exchange_strong(windowStart, nowNs, std::memory_order_relaxed)) {
+            site.count.store(1, std::memory_order_relaxed);
+            suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        if (site.count.fetch_add(1, std::memory_order_relaxed) < VMI_LOG_SITE_BURST) {
+            return true;
+        }
+        if (site.suppressed.fetch_add(1, std::memory_order_relaxed) == 0) {
+            RegisterLogSite(site, level, vmiTag, fmt);
+        }
+        return false;
+    }
+
+    bool IsLevelEnabled(int level)
+    {
+        return level >= VideoEncoderLog::GetInstance().GetLogLevel() && level <= ANDROID_LOG_SILENT;
+    }
+
+    void FormatRecord(LogRecord &record, int level, const char *vmiTag, uint32_t suppressed, const char *fmt,
+        va_list ap)
+    {
+        record.level = level;
+        record.vmiTag = (vmiTag == nullptr) ? "Native" : vmiTag;
+        int ret = vsnprintf(record.msg, sizeof(record.msg), fmt, ap);
+        if (ret < 0) {
+            record.msg[0] = '\0';
+            return;
+        }
+        if (suppressed != 0) {
+            size_t len = strnlen(record.msg, sizeof(record.msg));
+            (void) snprintf(record.msg + len, sizeof(record.msg) - len, " (suppressed %u similar messages)",
+                suppressed);
+        }
+    }
+
+    void VmiLogPrintV(int level, const char *vmiTag, uint32_t suppressed, const char *fmt, va_list ap)
+    {
+        // FATAL通常紧接着进程退出，同步写入以保证不丢失
+        if (level < ANDROID_LOG_FATAL) {
+            va_list apCopy;
+            va_copy(apCopy, ap);
+            PushResult result = AsyncLogWriter::GetInstance().Push([&](LogRecord &record) {
+                FormatRecord(record, level, vmiTag, suppressed, fmt, apCopy);
+            });
+            va_end(apCopy);
+            if (result != PushResult::NOT_RUNNING) {
+                return;
+            }
+        }
+        LogRecord record;
+        FormatRecord(record, level, vmiTag, suppressed, fmt, ap);
+        (void) snprintf(record.tag, sizeof(record.tag), "VMI_%s", record.vmiTag);
+        (void) __android_log_write(record.level, record.tag, record.msg);
+    }
 }
 
 VideoEncoderLog& VideoEncoderLog::GetInstance()
@@ -50,25 +377,48 @@ int VideoEncoderLog::GetLogLevel() const
 
 void VmiLogPrint(int level, const char *vmiTag, const char *fmt, ...)
 {
-    if (level < VideoEncoderLog::GetInstance().GetLogLevel() || level > ANDROID_LOG_SILENT || fmt == nullptr) {
+    if (!IsLevelEnabled(level) || fmt == nullptr) {
         return;
     }
-    std::string fullTag = ((vmiTag == nullptr) ? "VMI_Native" : ("VMI_" + std::string(vmiTag)));
-
-    constexpr int logBufSize = 512;
-    char szBuff[logBufSize] = {0};
     va_list ap;
     va_start(ap, fmt);
-    int ret = vsnprintf(szBuff, logBufSize - 1, fmt, ap);
+    VmiLogPrintV(level, vmiTag, 0, fmt, ap);
     va_end(ap);
+}
 
-    if (ret <= 0) {
+void VmiLogPrintLimited(VmiLogSite *site, int level, const char *vmiTag, const char *fmt, ...)
+{
+    if (!IsLevelEnabled(level) || fmt == nullptr) {
+        return;
+    }
+    uint32_t suppressed = 0;
+    if (site != nullptr && !AcquireLogSite(*site, level, vmiTag, fmt, suppressed)) {
         return;
     }
+    va_list ap;
+    va_start(ap, fmt);
+    VmiLogPrintV(level, vmiTag, suppressed, fmt, ap);
+    va_end(ap);
+}
 
-    if (static_cast<int64_t>(ret) < static_cast<int64_t>(logBufSize)) {
-        szBuff[ret] = '\0';
+void VmiLogWrite(int level, const char *tag, const char *msg)
+{
+    if (!IsLevelEnabled(level) || msg == nullptr) {
+        return;
+    }
+    // FATAL同步写入，其余级别只在后台线程不可用时同步写入
+    if (level < ANDROID_LOG_FATAL && AsyncLogWriter::GetInstance().Push([&](LogRecord &record) {
+        record.level = level;
+        record.vmiTag = nullptr;
+        (void) snprintf(record.tag, sizeof(record.tag), "%s", (tag == nullptr) ? "" : tag);
+        (void) snprintf(record.msg, sizeof(record.msg), "%s", msg);
+    }) != PushResult::NOT_RUNNING) {
+        return;
     }
+    (void) __android_log_write(level, tag, msg);
+}
 
-    (void) __android_log_write(level, fullTag.c_str(), szBuff);
+void VmiLogFlush()
+{
+    AsyncLogWriter::GetInstance().Flush();
 }
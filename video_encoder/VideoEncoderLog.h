@@ -4,6 +4,8 @@
 #ifndef VIDEO_ENCODER_LOG_H
 #define VIDEO_ENCODER_LOG_H
 
+#include <atomic>
+#include <cstdint>
 #include <android/log.h>
 
 #ifndef LOG_TAG
@@ -55,19 +57,68 @@ private:
     int m_logLevel = ANDROID_LOG_INFO;
 };
 
+// 每个日志调用点每秒最多打印的条数
+constexpr uint32_t VMI_LOG_SITE_BURST = 10;
+
+// 日志调用点的限流状态，作为日志宏内的静态变量零初始化，多线程并发访问无需加锁
+struct VmiLogSite {
+    std::atomic<uint64_t> windowStartNs;
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> suppressed;
+    // 首次抑制时登记到全局链表，供后台线程补报不再打印的调用点的抑制条数；登记后不再修改
+    std::atomic<bool> isRegistered;
+    int level;
+    const char *vmiTag;
+    const char *fmt;
+    VmiLogSite *next;
+};
+
 /**
- * @功能描述: 日志打印公共实现接口，供宏函数DBG/INFO/WARN/ERR/FATAL调用
+ * @功能描述: 日志打印公共实现接口，格式化到无锁环形队列后立即返回，由后台线程写入系统日志，
+ *            调用线程上不分配堆内存；队列满时丢弃并计数，FATAL级别同步写入
  * @参数 [in] level: 日志级别
- * @参数 [in] vmiTag: 日志标签
+ * @参数 [in] vmiTag: 日志标签，须为静态字符串(如LOG_TAG)，由后台线程写入时引用
  * @参数 [in] fmt: 格式化输出，与printf保持一致
  * @参数 [in] ...: 附加参数
  */
 void VmiLogPrint(int level, const char *vmiTag, const char *fmt, ...) __attribute__((format (printf, 3, 4)));
 
-#define DBG(fmt, ...) VmiLogPrint(ANDROID_LOG_DEBUG, LOG_TAG, fmt, ##__VA_ARGS__)
-#define INFO(fmt, ...) VmiLogPrint(ANDROID_LOG_INFO, LOG_TAG, fmt, ##__VA_ARGS__)
-#define WARN(fmt, ...) VmiLogPrint(ANDROID_LOG_WARN, LOG_TAG, fmt, ##__VA_ARGS__)
-#define ERR(fmt, ...) VmiLogPrint(ANDROID_LOG_ERROR, LOG_TAG, fmt, ##__VA_ARGS__)
-#define FATAL(fmt, ...) VmiLogPrint(ANDROID_LOG_FATAL, LOG_TAG, fmt, ##__VA_ARGS__)                                                                                      \
+/**
+ * @功能描述: 带调用点限流的日志打印，供宏函数DBG/INFO/WARN/ERR/FATAL调用
+ *            每个调用点每秒最多打印VMI_LOG_SITE_BURST条，超出部分只计数，
+ *            下一个时间窗口的第一条日志附带被抑制的条数；调用点之后不再打印时，
+ *            由后台线程在时间窗口结束后单独输出被抑制的条数
+ * @参数 [in] site: 调用点限流状态
+ * @参数 [in] level: 日志级别
+ * @参数 [in] vmiTag: 日志标签，须为静态字符串
+ * @参数 [in] fmt: 格式化输出，与printf保持一致
+ * @参数 [in] ...: 附加参数
+ */
+void VmiLogPrintLimited(VmiLogSite *site, int level, const char *vmiTag, const char *fmt, ...)
+    __attribute__((format (printf, 4, 5)));
+
+/**
+ * @功能描述: 写入一条已格式化的日志，标签不加前缀，供编解码库日志回调使用
+ * @参数 [in] level: 日志级别
+ * @参数 [in] tag: 日志标签
+ * @参数 [in] msg: 日志内容
+ */
+void VmiLogWrite(int level, const char *tag, const char *msg);
+
+/**
+ * @功能描述: 等待后台线程将队列中已有的日志全部写入系统日志
+ */
+void VmiLogFlush();
+
+#define VMI_LOG_LIMITED(level, fmt, ...) do {                                   \
+        static VmiLogSite vmiLogSite;                                           \
+        VmiLogPrintLimited(&vmiLogSite, level, LOG_TAG, fmt, ##__VA_ARGS__);    \
+    } while (0)
+
+#define DBG(fmt, ...) VMI_LOG_LIMITED(ANDROID_LOG_DEBUG, fmt, ##__VA_ARGS__)
+#define INFO(fmt, ...) VMI_LOG_LIMITED(ANDROID_LOG_INFO, fmt, ##__VA_ARGS__)
+#define WARN(fmt, ...) VMI_LOG_LIMITED(ANDROID_LOG_WARN, fmt, ##__VA_ARGS__)
+#define ERR(fmt, ...) VMI_LOG_LIMITED(ANDROID_LOG_ERROR, fmt, ##__VA_ARGS__)
+#define FATAL(fmt, ...) VMI_LOG_LIMITED(ANDROID_LOG_FATAL, fmt, ##__VA_ARGS__)
 
 #endif  // VIDEO_ENCODER_LOG_H
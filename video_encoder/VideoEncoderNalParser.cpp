@@ -0,0 +1,185 @@
+/*
+ * 功能说明: 编码输出NAL单元解析，单次扫描Annex-B码流建立NAL单元索引并识别关键帧，
+ *           缓存编码器最近输出的参数集，供新观众加入时直接获取
+ */
+
+#define LOG_TAG "VideoEncoderNalParser"
+#include "VideoEncoderNalParser.h"
+#include <cstring>
+#include <new>
+#include "VideoCodecApi.h"
+#include "VideoEncoderLog.h"
+
+namespace {
+    constexpr uint8_t START_CODE[] = { 0x00, 0x00, 0x00, 0x01 };
+    constexpr uint8_t H264_TYPE_MASK = 0x1f;
+    constexpr uint8_t H264_TYPE_SLICE = 1;
+    constexpr uint8_t H264_TYPE_IDR = 5;
+    constexpr uint8_t H264_TYPE_SPS = 7;
+    constexpr uint8_t H264_TYPE_PPS = 8;
+    constexpr uint8_t H265_TYPE_MASK = 0x3f;
+    constexpr uint8_t H265_TYPE_VCL_MAX = 31;
+    constexpr uint8_t H265_TYPE_IRAP_MIN = 16;  // BLA/IDR/CRA及保留的IRAP类型
+    constexpr uint8_t H265_TYPE_IRAP_MAX = 23;
+    constexpr uint8_t H265_TYPE_VPS = 32;
+    constexpr uint8_t H265_TYPE_PPS = 34;
+
+    uint32_t GetNalType(bool isH265, uint8_t header)
+    {
+        return isH265 ? ((header >> 1) & H265_TYPE_MASK) : (header & H264_TYPE_MASK);
+    }
+
+    bool IsVcl(bool isH265, uint32_t type)
+    {
+        return isH265 ? (type <= H265_TYPE_VCL_MAX) : (type >= H264_TYPE_SLICE && type <= H264_TYPE_IDR);
+    }
+
+    bool IsIrap(bool isH265, uint32_t type)
+    {
+        return isH265 ? (type >= H265_TYPE_IRAP_MIN && type <= H265_TYPE_IRAP_MAX) : (type == H264_TYPE_IDR);
+    }
+
+    bool IsParameterSet(bool isH265, uint32_t type)
+    {
+        return isH265 ? (type >= H265_TYPE_VPS && type <= H265_TYPE_PPS) :
+            (type == H264_TYPE_SPS || type == H264_TYPE_PPS);
+    }
+
+    // 参数集在缓存中的槽位，依次为VPS、SPS、PPS，h.264无VPS
+    uint32_t GetParameterSetSlot(bool isH265, uint32_t type)
+    {
+        return isH265 ? (type - H265_TYPE_VPS) : (type - H264_TYPE_SPS + 1);
+    }
+
+    /**
+     * 查找pos及之后的第一个起始码00 00 01，返回01所在下标，找不到时返回size。
+     * 用memchr查找01字节再回看前两个字节，libc的memchr按SIMD实现，码流负载中01字节约占1/256
+     */
+    uint32_t FindStartCode(const uint8_t *data, uint32_t pos, uint32_t size)
+    {
+        while (pos < size) {
+            auto found = static_cast<const uint8_t *>(memchr(data + pos, 0x01, size - pos));
+            if (found == nullptr) {
+                return size;
+            }
+            auto index = static_cast<uint32_t>(found - data);
+            if (index >= 2 && data[index - 1] == 0 && data[index - 2] == 0) {
+                return index;
+            }
+            pos = index + 1;
+        }
+        return size;
+    }
+}
+
+void VideoEncoderNalParser::Parse(uint32_t encType, const uint8_t *data, uint32_t size, bool isHeaderOnly,
+    VmiEncodeFrameInfo &info)
+{
+    info.isKeyFrame = false;
+    info.hasParameterSets = false;
+    info.nalCount = 0;
+    info.nalTotal = 0;
+    if (data == nullptr) {
+        return;
+    }
+    const bool isH265 = (encType == ENCODER_TYPE_NETINTH265);
+    bool hasVcl = false;
+    uint32_t marker = FindStartCode(data, 0, size);
+    while (marker + 1 < size) {
+        uint32_t begin = marker + 1;
+        uint32_t type = GetNalType(isH265, data[begin]);
+        bool isVcl = IsVcl(isH265, type);
+        bool isFirstVcl = isVcl && !hasVcl;
+        // 只解析头部时第一个切片即最后一个NAL单元，不再扫描切片负载
+        uint32_t next = (isHeaderOnly && isFirstVcl) ? size : FindStartCode(data, begin, size);
+        // 下一个起始码前的00属于起始码(4字节起始码)或trailing_zero_8bits，NAL单元本身不以00结尾
+        uint32_t end = next;
+        if (next < size) {
+            end = next - 2;
+            while (end > begin + 1 && data[end - 1] == 0) {
+                --end;
+            }
+        }
+        if (info.nalCount < VMI_NAL_UNIT_MAX) {
+            VmiNalUnit &unit = info.nals[info.nalCount++];
+            unit.offset = begin;
+            unit.size = end - begin;
+            unit.type = type;
+        }
+        ++info.nalTotal;
+        info.hasParameterSets = info.hasParameterSets || IsParameterSet(isH265, type);
+        if (isFirstVcl) {
+            // 帧类型以第一个切片为准
+            hasVcl = true;
+            info.isKeyFrame = IsIrap(isH265, type);
+        }
+        marker = next;
+    }
+}
+
+void VideoEncoderNalParser::UpdateParameterSets(uint32_t encType, const uint8_t *data, const VmiEncodeFrameInfo &info)
+{
+    if (!info.hasParameterSets) {
+        return;
+    }
+    const bool isH265 = (encType == ENCODER_TYPE_NETINTH265);
+    // 先在局部组装帧中携带的类型，分配失败时保留原缓存
+    std::vector<uint8_t> parameterSets[PARAMETER_SET_SLOT_COUNT];
+    try {
+        for (uint32_t i = 0; i < info.nalCount; ++i) {
+            const VmiNalUnit &unit = info.nals[i];
+            if (!IsParameterSet(isH265, unit.type)) {
+                continue;
+            }
+            std::vector<uint8_t> &slot = parameterSets[GetParameterSetSlot(isH265, unit.type)];
+            slot.insert(slot.end(), START_CODE, START_CODE + sizeof(START_CODE));
+            slot.insert(slot.end(), data + unit.offset, data + unit.offset + unit.size);
+        }
+    } catch (const std::bad_alloc &e) {
+        ERR("cache parameter sets failed: alloc memory failed");
+        return;
+    }
+    std::lock_guard<std::mutex> lck(m_lock);
+    if (isH265 != m_isH265) {
+        for (auto &slot : m_parameterSets) {
+            slot.clear();
+        }
+        m_isH265 = isH265;
+    }
+    for (uint32_t i = 0; i < PARAMETER_SET_SLOT_COUNT; ++i) {
+        if (!parameterSets[i].empty()) {
+            m_parameterSets[i].swap(parameterSets[i]);
+        }
+    }
+}
+
+bool VideoEncoderNalParser::GetParameterSets(uint8_t *buffer, uint32_t bufferSize, uint32_t &size)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    if ((m_isH265 && m_parameterSets[PARAMETER_SET_VPS].empty()) || m_parameterSets[PARAMETER_SET_SPS].empty() ||
+        m_parameterSets[PARAMETER_SET_PPS].empty()) {
+        return false;
+    }
+    size_t total = 0;
+    for (const auto &slot : m_parameterSets) {
+        total += slot.size();
+    }
+    size = static_cast<uint32_t>(total);
+    if (buffer != nullptr && size <= bufferSize) {
+        for (const auto &slot : m_parameterSets) {
+            if (!slot.empty()) {
+                (void) memcpy(buffer, slot.data(), slot.size());
+                buffer += slot.size();
+            }
+        }
+    }
+    return true;
+}
+
+void VideoEncoderNalParser::Clear()
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    for (auto &slot : m_parameterSets) {
+        slot.clear();
+    }
+}
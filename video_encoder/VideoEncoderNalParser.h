@@ -0,0 +1,72 @@
+/*
+ * 功能说明: 编码输出NAL单元解析，单次扫描Annex-B码流建立NAL单元索引并识别关键帧，
+ *           缓存编码器最近输出的参数集，供新观众加入时直接获取
+ */
+#ifndef VIDEO_ENCODER_NAL_PARSER_H
+#define VIDEO_ENCODER_NAL_PARSER_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderNalParser {
+public:
+    VideoEncoderNalParser() = default;
+    ~VideoEncoderNalParser() = default;
+
+    /**
+     * @功能描述: 解析一帧Annex-B码流，填充帧信息中的NAL单元索引、关键帧和参数集标志，不修改时间戳和编码耗时
+     * @参数 [in] encType: 编码器类型，决定按h.264还是h.265解析NAL头
+     * @参数 [in] data: 编码输出数据地址
+     * @参数 [in] size: 编码输出数据大小
+     * @参数 [in] isHeaderOnly: true 解析到第一个切片NAL单元即停止，只用于判断帧类型和提取参数集，
+     *                          此时最后记录的切片NAL单元大小延伸到码流末尾且nalTotal不含其后的NAL单元
+     * @参数 [out] info: 帧信息
+     */
+    static void Parse(uint32_t encType, const uint8_t *data, uint32_t size, bool isHeaderOnly,
+        VmiEncodeFrameInfo &info);
+
+    /**
+     * @功能描述: 帧携带参数集时按类型(VPS/SPS/PPS)替换缓存的参数集，帧中未携带的类型保留原缓存
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] data: 编码输出数据地址
+     * @参数 [in] info: Parse填充的帧信息
+     */
+    void UpdateParameterSets(uint32_t encType, const uint8_t *data, const VmiEncodeFrameInfo &info);
+
+    /**
+     * @功能描述: 获取缓存的参数集，按VPS、SPS、PPS顺序排列，每个参数集前带4字节起始码
+     * @参数 [out] buffer: 输出缓冲区，可为空
+     * @参数 [in] bufferSize: 输出缓冲区大小
+     * @参数 [out] size: 参数集大小，缓冲区不足时为所需大小
+     * @返回值: true 成功或缓冲区不足，以size是否大于bufferSize区分；
+     *          false 尚未缓存完整的参数集(h.264为SPS和PPS，h.265另需VPS)
+     */
+    bool GetParameterSets(uint8_t *buffer, uint32_t bufferSize, uint32_t &size);
+
+    /**
+     * @功能描述: 清空缓存的参数集，分辨率改变后旧参数集失效
+     */
+    void Clear();
+
+private:
+    VideoEncoderNalParser(const VideoEncoderNalParser&) = delete;
+    VideoEncoderNalParser& operator=(const VideoEncoderNalParser&) = delete;
+    VideoEncoderNalParser(VideoEncoderNalParser &&) = delete;
+    VideoEncoderNalParser& operator=(VideoEncoderNalParser &&) = delete;
+
+    enum ParameterSetSlot : uint32_t {
+        PARAMETER_SET_VPS = 0,
+        PARAMETER_SET_SPS = 1,
+        PARAMETER_SET_PPS = 2,
+        PARAMETER_SET_SLOT_COUNT
+    };
+
+    std::mutex m_lock = {};  // 编码线程更新与新观众读取可并发
+    bool m_isH265 = false;
+    // 每种参数集一个槽位，同一帧中同类型的多个参数集(如多个PPS)一起保存，均带起始码
+    std::vector<uint8_t> m_parameterSets[PARAMETER_SET_SLOT_COUNT] = {};
+};
+
+#endif  // VIDEO_ENCODER_NAL_PARSER_H
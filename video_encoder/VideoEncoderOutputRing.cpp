@@ -0,0 +1,101 @@
+/*
+ * 功能说明: 编码输出环，每帧码流存放在独立槽位中，槽位在调用者显式释放前保持有效
+ */
+
+#define LOG_TAG "VideoEncoderOutputRing"
+#include "VideoEncoderOutputRing.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "VideoEncoderLog.h"
+
+constexpr int32_t VideoEncoderOutputRing::INVALID_SLOT;
+
+namespace {
+    // 槽位至少分配该大小，空帧的码流地址也非空且各槽位互不相同，Commit和Release据此区分槽位
+    constexpr uint32_t SLOT_SIZE_MIN = 64;
+}
+
+bool VideoEncoderOutputRing::Init(uint32_t slotCount, uint32_t slotSize)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    std::vector<Slot> slots;
+    try {
+        slots.resize(slotCount);
+        for (auto &slot : slots) {
+            slot.data.resize(std::max(slotSize, SLOT_SIZE_MIN));
+        }
+        for (auto &slot : m_slots) {
+            if (slot.isReserved) {
+                slot.isStale = true;
+                slots.push_back(std::move(slot));
+            }
+        }
+    } catch (const std::bad_alloc &) {
+        ERR("output ring init failed: alloc %u slots of %u bytes failed", slotCount, slotSize);
+        return false;
+    }
+    m_slots = std::move(slots);
+    m_slotCount = slotCount;
+    m_next = 0;
+    return true;
+}
+
+int32_t VideoEncoderOutputRing::Reserve()
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    for (uint32_t i = 0; i < m_slotCount; ++i) {
+        uint32_t index = (m_next + i) % m_slotCount;
+        if (!m_slots[index].isReserved) {
+            m_slots[index].isReserved = true;
+            m_next = (index + 1) % m_slotCount;
+            return static_cast<int32_t>(index);
+        }
+    }
+    return INVALID_SLOT;
+}
+
+uint8_t *VideoEncoderOutputRing::Commit(int32_t slot, const uint8_t *data, uint32_t size)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    if (slot < 0 || static_cast<uint32_t>(slot) >= m_slotCount) {
+        return nullptr;
+    }
+    Slot &item = m_slots[slot];
+    if (item.data.size() < size) {
+        try {
+            item.data.resize(size);
+        } catch (const std::bad_alloc &) {
+            ERR("output ring commit failed: grow slot %d to %u bytes failed", slot, size);
+            item.isReserved = false;
+            return nullptr;
+        }
+    }
+    if (size > 0) {
+        (void) memcpy(item.data.data(), data, size);
+    }
+    return item.data.data();
+}
+
+void VideoEncoderOutputRing::Cancel(int32_t slot)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    if (slot >= 0 && static_cast<uint32_t>(slot) < m_slotCount) {
+        m_slots[slot].isReserved = false;
+    }
+}
+
+bool VideoEncoderOutputRing::Release(const uint8_t *data)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+        if (it->isReserved && it->data.data() == data) {
+            it->isReserved = false;
+            if (it->isStale) {
+                (void) m_slots.erase(it);
+            }
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+/*
+ * 功能说明: 编码输出环，每帧码流存放在独立槽位中，槽位在调用者显式释放前保持有效
+ */
+#ifndef VIDEO_ENCODER_OUTPUT_RING_H
+#define VIDEO_ENCODER_OUTPUT_RING_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class VideoEncoderOutputRing {
+public:
+    static constexpr int32_t INVALID_SLOT = -1;
+
+    VideoEncoderOutputRing() = default;
+    ~VideoEncoderOutputRing() = default;
+
+    /**
+     * @功能描述: (重新)初始化输出环，仍被占用的旧槽位在释放时一并回收
+     * @参数 [in] slotCount: 槽位个数
+     * @参数 [in] slotSize: 每个槽位的预分配大小，帧码流超过该大小时槽位自动扩容，0时按最小值分配
+     * @返回值: true 成功，false 失败
+     */
+    bool Init(uint32_t slotCount, uint32_t slotSize);
+
+    /**
+     * @功能描述: 预留下一个空闲槽位，应在调用编码器编码前预留，避免编码完成后无处存放
+     * @返回值: 槽位序号，无空闲槽位时返回INVALID_SLOT
+     */
+    int32_t Reserve();
+
+    /**
+     * @功能描述: 将一帧码流拷贝到已预留的槽位
+     * @参数 [in] slot: Reserve返回的槽位序号
+     * @参数 [in] data: 码流数据地址
+     * @参数 [in] size: 码流数据大小
+     * @返回值: 槽位中的码流地址，size为0时也非空；失败时返回空且槽位被取消预留
+     */
+    uint8_t *Commit(int32_t slot, const uint8_t *data, uint32_t size);
+
+    /**
+     * @功能描述: 取消预留槽位
+     * @参数 [in] slot: Reserve返回的槽位序号
+     */
+    void Cancel(int32_t slot);
+
+    /**
+     * @功能描述: 释放槽位
+     * @参数 [in] data: Commit返回的码流地址
+     * @返回值: true 成功，false 地址不属于该输出环或未被占用
+     */
+    bool Release(const uint8_t *data);
+
+private:
+    VideoEncoderOutputRing(const VideoEncoderOutputRing&) = delete;
+    VideoEncoderOutputRing& operator=(const VideoEncoderOutputRing&) = delete;
+    VideoEncoderOutputRing(VideoEncoderOutputRing &&) = delete;
+    VideoEncoderOutputRing& operator=(VideoEncoderOutputRing &&) = delete;
+
+    struct Slot {
+        std::vector<uint8_t> data = {};
+        bool isReserved = false;
+        bool isStale = false;  // 输出环重新初始化前被占用，释放时回收
+    };
+
+    std::mutex m_lock = {};
+    std::vector<Slot> m_slots = {};
+    uint32_t m_slotCount = 0;  // m_slots中前m_slotCount个为当前槽位，其后为待回收的旧槽位
+    uint32_t m_next = 0;
+};
+
+#endif  // VIDEO_ENCODER_OUTPUT_RING_H
@@ -0,0 +1,230 @@
+/*
+ * 功能说明: 编码器闭环码率/帧率自适应控制，根据编码输出大小和网络反馈调整编码参数
+ */
+
+#include "VideoEncoderRateControl.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <new>
+
+namespace {
+    constexpr uint64_t US_PER_MS = 1000;
+    constexpr uint64_t US_PER_SEC = 1000000;
+    constexpr uint32_t MIN_INTERVAL_MS_DEFAULT = 1000;
+    constexpr uint32_t THRESHOLD_PERCENT_DEFAULT = 10;
+    constexpr uint32_t MIN_BITRATE_DIVISOR = 8;
+    constexpr uint32_t MIN_FRAME_RATE_DIVISOR = 2;
+    constexpr uint32_t DECREASE_INTERVAL_DIVISOR = 4;
+    constexpr uint64_t FEEDBACK_TIMEOUT_US = 2 * US_PER_SEC;
+
+    constexpr uint32_t BUCKET_COUNT = 10;
+    constexpr uint64_t BUCKET_DURATION_US = US_PER_SEC / BUCKET_COUNT;
+
+    constexpr double PERMILLE = 1000.0;
+    constexpr double LOSS_HIGH = 0.10;           // 丢包率高于该值时按丢包率下调
+    constexpr double LOSS_LOW = 0.02;            // 丢包率低于该值且时延未上升时允许上调
+    constexpr double LOSS_DECREASE_FACTOR = 0.5;
+    constexpr double RTT_RISE_RATIO = 1.5;       // 时延超过基线该倍数视为拥塞
+    constexpr uint32_t RTT_RISE_MIN_MS = 30;
+    constexpr uint32_t RTT_BASELINE_DRIFT = 256; // 时延基线向当前值缓慢漂移，适应路由变化
+    constexpr double DELAY_DECREASE_FACTOR = 0.85;
+    constexpr double INCREASE_FACTOR = 1.08;
+    constexpr double BANDWIDTH_USAGE = 0.9;      // 最多占用可用带宽的比例
+    constexpr double OVERSHOOT_USAGE = 0.85;     // 实际输出超出可用带宽时回退到的比例
+    constexpr double PERCENT = 100.0;
+
+    // 每像素比特数，低于下限时降帧率以保证单帧质量，高于上限时恢复帧率
+    constexpr double BPP_LOW = 0.02;
+    constexpr double BPP_TARGET = 0.04;
+    constexpr double BPP_HIGH = 0.06;
+
+    class AimdRateControlPolicy : public RateControlPolicy {
+    public:
+        AimdRateControlPolicy(const VmiRateControlConfig &config, const EncodeParams &initParams);
+        ~AimdRateControlPolicy() override = default;
+
+        void OnFrameEncoded(uint64_t nowUs, uint32_t frameSize) override;
+        void OnNetworkFeedback(uint64_t nowUs, const VmiNetworkFeedback &feedback) override;
+        bool Decide(uint64_t nowUs, const EncodeParams &current, EncodeParams &target) override;
+
+    private:
+        double MeasureOutputBitrate(uint64_t nowUs) const;
+        double DecideBitrate(uint64_t nowUs);
+        uint32_t DecideFrameRate(double bitrate, const EncodeParams &current) const;
+
+        uint32_t m_minBitrate = 0;
+        uint32_t m_maxBitrate = 0;
+        uint32_t m_minFrameRate = 0;
+        uint32_t m_maxFrameRate = 0;
+        uint64_t m_increaseIntervalUs = 0;
+        uint64_t m_decreaseIntervalUs = 0;
+        uint32_t m_thresholdPercent = 0;
+
+        std::array<uint64_t, BUCKET_COUNT> m_bucketBytes = {};
+        std::array<uint64_t, BUCKET_COUNT> m_bucketIds = {};
+        uint64_t m_firstFrameUs = 0;
+
+        VmiNetworkFeedback m_feedback = {};
+        uint64_t m_feedbackUs = 0;
+        bool m_hasFeedback = false;
+        uint32_t m_baseRttMs = 0;
+
+        double m_targetBitrate = 0;
+        uint64_t m_lastIncreaseUs = 0;
+        uint64_t m_lastDecreaseUs = 0;
+    };
+
+    AimdRateControlPolicy::AimdRateControlPolicy(const VmiRateControlConfig &config, const EncodeParams &initParams)
+    {
+        m_maxBitrate = (config.maxBitrate == 0) ? initParams.bitrate : config.maxBitrate;
+        m_minBitrate = (config.minBitrate == 0) ? (m_maxBitrate / MIN_BITRATE_DIVISOR) : config.minBitrate;
+        m_minBitrate = std::min(m_minBitrate, m_maxBitrate);
+        m_maxFrameRate = (config.maxFrameRate == 0) ? initParams.frameRate : config.maxFrameRate;
+        m_minFrameRate = (config.minFrameRate == 0) ? (m_maxFrameRate / MIN_FRAME_RATE_DIVISOR) :
+            config.minFrameRate;
+        m_minFrameRate = std::max(1U, std::min(m_minFrameRate, m_maxFrameRate));
+        uint32_t intervalMs = (config.minIntervalMs == 0) ? MIN_INTERVAL_MS_DEFAULT : config.minIntervalMs;
+        m_increaseIntervalUs = intervalMs * US_PER_MS;
+        m_decreaseIntervalUs = m_increaseIntervalUs / DECREASE_INTERVAL_DIVISOR;
+        m_thresholdPercent = (config.thresholdPercent == 0) ? THRESHOLD_PERCENT_DEFAULT : config.thresholdPercent;
+    }
+
+    void AimdRateControlPolicy::OnFrameEncoded(uint64_t nowUs, uint32_t frameSize)
+    {
+        if (m_firstFrameUs == 0) {
+            m_firstFrameUs = nowUs;
+        }
+        uint64_t bucketId = nowUs / BUCKET_DURATION_US;
+        uint32_t index = bucketId % BUCKET_COUNT;
+        if (m_bucketIds[index] != bucketId) {
+            m_bucketIds[index] = bucketId;
+            m_bucketBytes[index] = 0;
+        }
+        m_bucketBytes[index] += frameSize;
+    }
+
+    void AimdRateControlPolicy::OnNetworkFeedback(uint64_t nowUs, const VmiNetworkFeedback &feedback)
+    {
+        m_feedback = feedback;
+        m_feedbackUs = nowUs;
+        m_hasFeedback = true;
+        if (feedback.rttMs == 0) {
+            return;
+        }
+        if (m_baseRttMs == 0 || feedback.rttMs < m_baseRttMs) {
+            m_baseRttMs = feedback.rttMs;
+        } else {
+            m_baseRttMs += (feedback.rttMs - m_baseRttMs) / RTT_BASELINE_DRIFT;
+        }
+    }
+
+    double AimdRateControlPolicy::MeasureOutputBitrate(uint64_t nowUs) const
+    {
+        if (m_firstFrameUs == 0) {
+            return 0;
+        }
+        uint64_t curId = nowUs / BUCKET_DURATION_US;
+        uint64_t bytes = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+            if (m_bucketIds[i] + BUCKET_COUNT > curId && m_bucketIds[i] <= curId) {
+                bytes += m_bucketBytes[i];
+            }
+        }
+        uint64_t windowUs = (BUCKET_COUNT - 1) * BUCKET_DURATION_US + nowUs % BUCKET_DURATION_US;
+        windowUs = std::min(windowUs, nowUs - m_firstFrameUs);
+        if (windowUs < BUCKET_DURATION_US) {
+            return 0;
+        }
+        constexpr double bitsPerByte = 8.0;
+        return bytes * bitsPerByte * US_PER_SEC / windowUs;
+    }
+
+    double AimdRateControlPolicy::DecideBitrate(uint64_t nowUs)
+    {
+        if (!m_hasFeedback || nowUs - m_feedbackUs > FEEDBACK_TIMEOUT_US) {
+            return m_targetBitrate;
+        }
+        double desired = m_targetBitrate;
+        double loss = m_feedback.lossPermille / PERMILLE;
+        bool isDelayRising = m_feedback.rttMs != 0 && m_baseRttMs != 0 &&
+            m_feedback.rttMs > m_baseRttMs * RTT_RISE_RATIO && m_feedback.rttMs > m_baseRttMs + RTT_RISE_MIN_MS;
+        bool canDecrease = nowUs - m_lastDecreaseUs >= m_decreaseIntervalUs;
+        bool canIncrease = nowUs - m_lastDecreaseUs >= m_increaseIntervalUs &&
+            nowUs - m_lastIncreaseUs >= m_increaseIntervalUs;
+        double available = m_feedback.availableBitrate;
+        double measured = MeasureOutputBitrate(nowUs);
+        bool isOvershoot = available > 0 && measured > available;
+
+        if (canDecrease && (loss > LOSS_HIGH || isDelayRising || isOvershoot)) {
+            if (loss > LOSS_HIGH) {
+                desired = std::min(desired, m_targetBitrate * (1.0 - LOSS_DECREASE_FACTOR * loss));
+            }
+            if (isDelayRising) {
+                desired = std::min(desired, m_targetBitrate * DELAY_DECREASE_FACTOR);
+            }
+            if (isOvershoot) {
+                desired = std::min(desired, available * OVERSHOOT_USAGE);
+            }
+            m_lastDecreaseUs = nowUs;
+        } else if (canIncrease && loss < LOSS_LOW && !isDelayRising) {
+            desired = m_targetBitrate * INCREASE_FACTOR;
+            m_lastIncreaseUs = nowUs;
+        }
+        if (available > 0) {
+            desired = std::min(desired, available * BANDWIDTH_USAGE);
+        }
+        return desired;
+    }
+
+    uint32_t AimdRateControlPolicy::DecideFrameRate(double bitrate, const EncodeParams &current) const
+    {
+        double pixels = static_cast<double>(current.width) * current.height;
+        if (pixels <= 0 || current.frameRate == 0) {
+            return current.frameRate;
+        }
+        double bpp = bitrate / (pixels * current.frameRate);
+        if ((bpp < BPP_LOW && current.frameRate > m_minFrameRate) ||
+            (bpp > BPP_HIGH && current.frameRate < m_maxFrameRate)) {
+            double frameRate = std::floor(bitrate / (pixels * BPP_TARGET));
+            return static_cast<uint32_t>(std::max<double>(m_minFrameRate, std::min<double>(m_maxFrameRate, frameRate)));
+        }
+        return current.frameRate;
+    }
+
+    bool AimdRateControlPolicy::Decide(uint64_t nowUs, const EncodeParams &current, EncodeParams &target)
+    {
+        if (m_targetBitrate <= 0) {
+            m_targetBitrate = current.bitrate;
+        }
+        double desired = DecideBitrate(nowUs);
+        desired = std::max<double>(m_minBitrate, std::min<double>(m_maxBitrate, desired));
+        m_targetBitrate = desired;
+
+        // 迟滞: 变化不足阈值时不下发，避免频繁重配置编码器；到达上下限时允许下发
+        double delta = std::fabs(desired - current.bitrate);
+        bool isBound = (desired == m_minBitrate || desired == m_maxBitrate);
+        bool isBitrateChanged = (delta >= current.bitrate * m_thresholdPercent / PERCENT) ||
+            (isBound && static_cast<uint32_t>(desired) != current.bitrate);
+        uint32_t bitrate = isBitrateChanged ? static_cast<uint32_t>(desired) : current.bitrate;
+        uint32_t frameRate = DecideFrameRate(bitrate, current);
+        if (bitrate == current.bitrate && frameRate == current.frameRate) {
+            return false;
+        }
+        target = current;
+        target.bitrate = bitrate;
+        target.frameRate = frameRate;
+        return true;
+    }
+}
+
+std::unique_ptr<RateControlPolicy> CreateRateControlPolicy(const VmiRateControlConfig &config,
+    const EncodeParams &initParams)
+{
+    switch (config.policy) {
+        case VMI_RATE_CONTROL_POLICY_AIMD:
+            return std::unique_ptr<RateControlPolicy>(new (std::nothrow) AimdRateControlPolicy(config, initParams));
+        default:
+            return nullptr;
+    }
+}
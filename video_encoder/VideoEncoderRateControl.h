@@ -0,0 +1,92 @@
+/*
+ * 功能说明: 编码器闭环码率/帧率自适应控制，根据编码输出大小和网络反馈调整编码参数
+ */
+#ifndef VIDEO_ENCODER_RATE_CONTROL_H
+#define VIDEO_ENCODER_RATE_CONTROL_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "VideoCodecDefs.h"
+#include "VideoEncoderWrapper.h"
+
+// 码控策略接口，每个编码器句柄持有一个独立的策略对象，调用方负责串行化
+class RateControlPolicy {
+public:
+    RateControlPolicy() = default;
+    virtual ~RateControlPolicy() = default;
+
+    /**
+     * @功能描述: 记录一帧编码输出
+     * @参数 [in] nowUs: 当前单调时钟时间，单位微秒
+     * @参数 [in] frameSize: 编码输出大小，单位字节
+     */
+    virtual void OnFrameEncoded(uint64_t nowUs, uint32_t frameSize) = 0;
+
+    /**
+     * @功能描述: 记录一次网络反馈
+     * @参数 [in] nowUs: 当前单调时钟时间，单位微秒
+     * @参数 [in] feedback: 网络反馈
+     */
+    virtual void OnNetworkFeedback(uint64_t nowUs, const VmiNetworkFeedback &feedback) = 0;
+
+    /**
+     * @功能描述: 根据已记录的信息计算目标编码参数
+     * @参数 [in] nowUs: 当前单调时钟时间，单位微秒
+     * @参数 [in] current: 当前编码参数
+     * @参数 [out] target: 目标编码参数，仅在返回true时有效
+     * @返回值: true 需要调整编码参数，false 保持不变
+     */
+    virtual bool Decide(uint64_t nowUs, const EncodeParams &current, EncodeParams &target) = 0;
+
+private:
+    RateControlPolicy(const RateControlPolicy&) = delete;
+    RateControlPolicy& operator=(const RateControlPolicy&) = delete;
+    RateControlPolicy(RateControlPolicy &&) = delete;
+    RateControlPolicy& operator=(RateControlPolicy &&) = delete;
+};
+
+/**
+ * @功能描述: 按配置创建码控策略对象
+ * @参数 [in] config: 码控配置
+ * @参数 [in] initParams: 开启码控时的编码参数，用于补全配置中为0的上下限
+ * @返回值: 码控策略对象，策略类型不支持时返回空
+ */
+std::unique_ptr<RateControlPolicy> CreateRateControlPolicy(const VmiRateControlConfig &config,
+    const EncodeParams &initParams);
+
+// 码控器，为策略对象加锁，网络反馈线程与编码线程可并发调用
+class VideoEncoderRateController {
+public:
+    explicit VideoEncoderRateController(std::unique_ptr<RateControlPolicy> policy) : m_policy(std::move(policy)) {}
+    ~VideoEncoderRateController() = default;
+
+    void OnFrameEncoded(uint64_t nowUs, uint32_t frameSize)
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        m_policy->OnFrameEncoded(nowUs, frameSize);
+    }
+
+    void OnNetworkFeedback(uint64_t nowUs, const VmiNetworkFeedback &feedback)
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        m_policy->OnNetworkFeedback(nowUs, feedback);
+    }
+
+    bool Decide(uint64_t nowUs, const EncodeParams &current, EncodeParams &target)
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        return m_policy->Decide(nowUs, current, target);
+    }
+
+private:
+    VideoEncoderRateController(const VideoEncoderRateController&) = delete;
+    VideoEncoderRateController& operator=(const VideoEncoderRateController&) = delete;
+    VideoEncoderRateController(VideoEncoderRateController &&) = delete;
+    VideoEncoderRateController& operator=(VideoEncoderRateController &&) = delete;
+
+    std::mutex m_lock = {};
+    std::unique_ptr<RateControlPolicy> m_policy;
+};
+
+#endif  // VIDEO_ENCODER_RATE_CONTROL_H
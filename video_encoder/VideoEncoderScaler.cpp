@@ -0,0 +1,176 @@
+/*
+ * 功能说明: I420帧缩放，逐平面先按2:1盒式滤波逐级缩小，剩余比例使用双线性插值，
+ *           用于联播时将同一输入帧缩放到各层分辨率
+ */
+
+#define LOG_TAG "VideoEncoderScaler"
+#include "VideoEncoderScaler.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "VideoEncoderLog.h"
+
+namespace {
+    constexpr uint32_t FRACTION_BITS = 8;
+    constexpr uint32_t FRACTION_ONE = 1U << FRACTION_BITS;
+    constexpr uint32_t FRACTION_MASK = FRACTION_ONE - 1;
+
+    uint64_t GetI420FrameSize(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint64_t>(width) * height + 2 * static_cast<uint64_t>((width + 1) / 2) * ((height + 1) / 2);
+    }
+}
+
+VideoEncoderScaler::VideoEncoderScaler(const VideoEncoderSimdKernels &kernels) : m_kernels(kernels) {}
+
+bool VideoEncoderScaler::Init(uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight)
+{
+    m_srcFrameSize = 0;
+    m_dstFrameSize = 0;
+    if (srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) {
+        ERR("init scaler failed: invalid resolution %ux%u -> %ux%u", srcWidth, srcHeight, dstWidth, dstHeight);
+        return false;
+    }
+    uint64_t srcFrameSize = GetI420FrameSize(srcWidth, srcHeight);
+    uint64_t dstFrameSize = GetI420FrameSize(dstWidth, dstHeight);
+    if (srcFrameSize > UINT32_MAX || dstFrameSize > UINT32_MAX) {
+        ERR("init scaler failed: frame of %ux%u -> %ux%u is too large", srcWidth, srcHeight, dstWidth, dstHeight);
+        return false;
+    }
+    uint32_t srcChromaWidth = (srcWidth + 1) / 2;
+    uint32_t srcChromaHeight = (srcHeight + 1) / 2;
+    uint32_t dstChromaWidth = (dstWidth + 1) / 2;
+    uint32_t dstChromaHeight = (dstHeight + 1) / 2;
+    size_t srcLumaSize = static_cast<size_t>(srcWidth) * srcHeight;
+    size_t dstLumaSize = static_cast<size_t>(dstWidth) * dstHeight;
+    try {
+        InitPlane(m_planes[0], srcWidth, srcHeight, dstWidth, dstHeight);
+        InitPlane(m_planes[1], srcChromaWidth, srcChromaHeight, dstChromaWidth, dstChromaHeight);
+        InitPlane(m_planes[2], srcChromaWidth, srcChromaHeight, dstChromaWidth, dstChromaHeight);
+        m_row.resize(srcWidth + 1);
+    } catch (const std::bad_alloc &e) {
+        ERR("init scaler failed: alloc buffers for %ux%u -> %ux%u failed", srcWidth, srcHeight, dstWidth, dstHeight);
+        return false;
+    }
+    m_planes[0].srcOffset = 0;
+    m_planes[0].dstOffset = 0;
+    m_planes[1].srcOffset = srcLumaSize;
+    m_planes[1].dstOffset = dstLumaSize;
+    m_planes[2].srcOffset = srcLumaSize + static_cast<size_t>(srcChromaWidth) * srcChromaHeight;
+    m_planes[2].dstOffset = dstLumaSize + static_cast<size_t>(dstChromaWidth) * dstChromaHeight;
+    m_srcFrameSize = static_cast<uint32_t>(srcFrameSize);
+    m_dstFrameSize = static_cast<uint32_t>(dstFrameSize);
+    INFO("scaler: %ux%u -> %ux%u, %zu luma stages", srcWidth, srcHeight, dstWidth, dstHeight,
+        m_planes[0].stages.size());
+    return true;
+}
+
+void VideoEncoderScaler::InitTaps(uint32_t srcSize, uint32_t dstSize, std::vector<uint32_t> &index,
+    std::vector<uint8_t> &fraction)
+{
+    index.resize(dstSize);
+    fraction.resize(dstSize);
+    // 像素中心对齐：目标像素d对应源坐标(d + 0.5) * srcSize / dstSize - 0.5，夹取到[0, srcSize - 1]
+    const int64_t maxPos = static_cast<int64_t>(srcSize - 1) * FRACTION_ONE;
+    for (uint32_t d = 0; d < dstSize; ++d) {
+        uint64_t center = (2 * static_cast<uint64_t>(d) + 1) * srcSize * FRACTION_ONE / (2 * dstSize);
+        int64_t pos = static_cast<int64_t>(center) - FRACTION_ONE / 2;
+        pos = std::max<int64_t>(0, std::min(pos, maxPos));
+        index[d] = static_cast<uint32_t>(pos >> FRACTION_BITS);
+        fraction[d] = static_cast<uint8_t>(pos & FRACTION_MASK);
+    }
+}
+
+void VideoEncoderScaler::InitPlane(Plane &plane, uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth,
+    uint32_t dstHeight)
+{
+    plane.width = srcWidth;
+    plane.height = srcHeight;
+    plane.stages.clear();
+    uint32_t width = srcWidth;
+    uint32_t height = srcHeight;
+    // 缩小一半以上时逐级2:1盒式滤波，既避免双线性插值欠采样产生混叠，也减少后续插值的像素数
+    while (width >= 2 * dstWidth && height >= 2 * dstHeight) {
+        Stage stage;
+        stage.srcWidth = width;
+        stage.srcHeight = height;
+        stage.dstWidth = width / 2;
+        stage.dstHeight = height / 2;
+        stage.isBox2x = true;
+        plane.stages.push_back(std::move(stage));
+        width /= 2;
+        height /= 2;
+    }
+    if (width != dstWidth || height != dstHeight) {
+        Stage stage;
+        stage.srcWidth = width;
+        stage.srcHeight = height;
+        stage.dstWidth = dstWidth;
+        stage.dstHeight = dstHeight;
+        InitTaps(width, dstWidth, stage.xIndex, stage.xFraction);
+        InitTaps(height, dstHeight, stage.yIndex, stage.yFraction);
+        plane.stages.push_back(std::move(stage));
+    }
+    for (size_t i = 0; i + 1 < plane.stages.size(); ++i) {
+        plane.stages[i].output.resize(static_cast<size_t>(plane.stages[i].dstWidth) * plane.stages[i].dstHeight);
+    }
+}
+
+bool VideoEncoderScaler::Scale(const uint8_t *src, uint8_t *dst)
+{
+    if (m_srcFrameSize == 0 || src == nullptr || dst == nullptr) {
+        return false;
+    }
+    for (Plane &plane : m_planes) {
+        const uint8_t *planeSrc = src + plane.srcOffset;
+        uint8_t *planeDst = dst + plane.dstOffset;
+        if (plane.stages.empty()) {
+            (void) memcpy(planeDst, planeSrc, static_cast<size_t>(plane.width) * plane.height);
+            continue;
+        }
+        for (Stage &stage : plane.stages) {
+            uint8_t *stageDst = stage.output.empty() ? planeDst : stage.output.data();
+            RunStage(stage, planeSrc, stageDst);
+            planeSrc = stageDst;
+        }
+    }
+    return true;
+}
+
+void VideoEncoderScaler::RunStage(const Stage &stage, const uint8_t *src, uint8_t *dst)
+{
+    if (stage.isBox2x) {
+        for (uint32_t y = 0; y < stage.dstHeight; ++y) {
+            const uint8_t *src0 = src + static_cast<size_t>(2 * y) * stage.srcWidth;
+            m_kernels.scaleRowBox2x(src0, src0 + stage.srcWidth, stage.dstWidth,
+                dst + static_cast<size_t>(y) * stage.dstWidth);
+        }
+        return;
+    }
+    const bool isSameWidth = stage.srcWidth == stage.dstWidth;
+    for (uint32_t y = 0; y < stage.dstHeight; ++y) {
+        uint32_t y0 = stage.yIndex[y];
+        uint32_t y1 = std::min(y0 + 1, stage.srcHeight - 1);
+        const uint8_t *src0 = src + static_cast<size_t>(y0) * stage.srcWidth;
+        const uint8_t *src1 = src + static_cast<size_t>(y1) * stage.srcWidth;
+        uint8_t *dstRow = dst + static_cast<size_t>(y) * stage.dstWidth;
+        // 先垂直混合整行(SIMD)，宽度不变时直接输出
+        if (isSameWidth) {
+            m_kernels.blendRows(src0, src1, stage.srcWidth, stage.yFraction[y], dstRow);
+            continue;
+        }
+        uint8_t *row = m_row.data();
+        m_kernels.blendRows(src0, src1, stage.srcWidth, stage.yFraction[y], row);
+        row[stage.srcWidth] = row[stage.srcWidth - 1];
+        const uint32_t *xIndex = stage.xIndex.data();
+        const uint8_t *xFraction = stage.xFraction.data();
+        for (uint32_t x = 0; x < stage.dstWidth; ++x) {
+            uint32_t x0 = xIndex[x];
+            uint32_t fraction = xFraction[x];
+            dstRow[x] = static_cast<uint8_t>((row[x0] * (FRACTION_ONE - fraction) + row[x0 + 1] * fraction +
+                FRACTION_ONE / 2) >> FRACTION_BITS);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * 功能说明: I420帧缩放，逐平面先按2:1盒式滤波逐级缩小，剩余比例使用双线性插值，
+ *           用于联播时将同一输入帧缩放到各层分辨率
+ */
+#ifndef VIDEO_ENCODER_SCALER_H
+#define VIDEO_ENCODER_SCALER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "VideoEncoderSimd.h"
+
+class VideoEncoderScaler {
+public:
+    explicit VideoEncoderScaler(const VideoEncoderSimdKernels &kernels = GetSimdKernels());
+    ~VideoEncoderScaler() = default;
+
+    /**
+     * @功能描述: 按源和目标分辨率(重新)初始化，预计算插值位置并分配中间缓冲
+     * @参数 [in] srcWidth: 源宽度
+     * @参数 [in] srcHeight: 源高度
+     * @参数 [in] dstWidth: 目标宽度
+     * @参数 [in] dstHeight: 目标高度
+     * @返回值: true 成功，false 分辨率无效或分配内存失败
+     */
+    bool Init(uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight);
+
+    /**
+     * @功能描述: 缩放一帧紧密排列的I420数据，未初始化成功时失败，不能并发调用
+     * @参数 [in] src: 大小不小于GetSrcFrameSize()的源帧
+     * @参数 [out] dst: 大小不小于GetDstFrameSize()的目标帧
+     * @返回值: true 成功，false 未初始化或参数为空
+     */
+    bool Scale(const uint8_t *src, uint8_t *dst);
+
+    uint32_t GetSrcFrameSize() const
+    {
+        return m_srcFrameSize;
+    }
+
+    uint32_t GetDstFrameSize() const
+    {
+        return m_dstFrameSize;
+    }
+
+private:
+    VideoEncoderScaler(const VideoEncoderScaler&) = delete;
+    VideoEncoderScaler& operator=(const VideoEncoderScaler&) = delete;
+    VideoEncoderScaler(VideoEncoderScaler &&) = delete;
+    VideoEncoderScaler& operator=(VideoEncoderScaler &&) = delete;
+
+    // 平面缩放的一级，盒式滤波级输出恰为输入的一半(向下取整)
+    struct Stage {
+        uint32_t srcWidth = 0;
+        uint32_t srcHeight = 0;
+        uint32_t dstWidth = 0;
+        uint32_t dstHeight = 0;
+        bool isBox2x = false;
+        std::vector<uint32_t> xIndex = {};    // 双线性插值的左侧源像素下标
+        std::vector<uint8_t> xFraction = {};  // 双线性插值的右侧源像素权重
+        std::vector<uint32_t> yIndex = {};
+        std::vector<uint8_t> yFraction = {};
+        std::vector<uint8_t> output = {};     // 中间级输出，最后一级直接写入目标帧
+    };
+
+    struct Plane {
+        size_t srcOffset = 0;
+        size_t dstOffset = 0;
+        uint32_t width = 0;   // 源与目标分辨率相同时直接拷贝
+        uint32_t height = 0;
+        std::vector<Stage> stages = {};
+    };
+
+    static void InitTaps(uint32_t srcSize, uint32_t dstSize, std::vector<uint32_t> &index,
+        std::vector<uint8_t> &fraction);
+    void InitPlane(Plane &plane, uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight);
+    void RunStage(const Stage &stage, const uint8_t *src, uint8_t *dst);
+
+    static constexpr uint32_t PLANE_COUNT = 3;
+    const VideoEncoderSimdKernels &m_kernels;
+    Plane m_planes[PLANE_COUNT];
+    std::vector<uint8_t> m_row = {};  // 双线性插值的垂直混合结果，末尾多一个像素复制行尾
+    uint32_t m_srcFrameSize = 0;      // 0表示未初始化
+    uint32_t m_dstFrameSize = 0;
+};
+
+#endif  // VIDEO_ENCODER_SCALER_H
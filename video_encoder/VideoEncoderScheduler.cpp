@@ -0,0 +1,241 @@
+/*
+ * 功能说明: 编码器调度，按编码器类型和硬件设备统计存活会话和负载，为新会话选择编码器类型
+ */
+
+#define LOG_TAG "VideoEncoderScheduler"
+#include "VideoEncoderScheduler.h"
+#include <algorithm>
+#include <cinttypes>
+#include "VideoEncoderLog.h"
+#include "VideoEncoderTime.h"
+
+namespace {
+    // 设备被标记为满载后，超过该时间未释放会话也重新参与选择，避免一次偶发失败长期屏蔽该设备
+    constexpr uint64_t SATURATION_RETRY_US = 5000000;
+
+    // NETINT h.264和h.265共用同一硬件设备，设备标识取h.264的类型值；其他类型各自独占一个设备
+    uint32_t GetDeviceId(uint32_t encType)
+    {
+        return (encType == VMI_ENCODER_TYPE_NETINTH265) ? VMI_ENCODER_TYPE_NETINTH264 : encType;
+    }
+
+    struct Candidate {
+        uint32_t encType = 0;
+        double load = 0;
+        bool isSaturated = false;
+    };
+}
+
+VideoEncoderScheduler& VideoEncoderScheduler::GetInstance()
+{
+    static VideoEncoderScheduler scheduler;
+    return scheduler;
+}
+
+uint64_t VideoEncoderScheduler::GetPixelRate(uint32_t width, uint32_t height, uint32_t frameRate)
+{
+    return static_cast<uint64_t>(width) * height * frameRate;
+}
+
+void VideoEncoderScheduler::Configure(uint32_t encType, const VmiEncoderBackendConfig &config)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    GetBackendLocked(encType).config = config;
+    INFO("encoder type %u capacity: max sessions %u, max pixel rate %" PRIu64, encType, config.maxSessions,
+        config.maxPixelRate);
+}
+
+std::vector<uint32_t> VideoEncoderScheduler::Select(const VmiEncoderSelectConfig &config, uint64_t pixelRate)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    uint64_t nowUs = GetMonotonicTimeUs();
+    uint32_t typeCount = std::min(config.typeCount, VMI_ENCODER_TYPE_LIST_MAX);
+    std::vector<Candidate> candidates;
+    for (uint32_t i = 0; i < typeCount; ++i) {
+        uint32_t encType = config.encTypes[i];
+        auto isDuplicate = std::any_of(candidates.begin(), candidates.end(), [encType](const Candidate &candidate) {
+            return candidate.encType == encType;
+        });
+        if (isDuplicate) {
+            continue;
+        }
+        Backend &backend = GetBackendLocked(encType);
+        if (IsAtCapacityLocked(backend, pixelRate)) {
+            DBG("encoder type %u is at capacity: %u sessions, pixel rate %" PRIu64, encType, backend.sessions,
+                backend.pixelRate);
+            continue;
+        }
+        Device &device = GetDeviceLocked(backend.device);
+        Candidate candidate;
+        candidate.encType = encType;
+        candidate.load = GetLoadLocked(backend, device, pixelRate);
+        candidate.isSaturated = IsSaturatedLocked(device, nowUs);
+        candidates.push_back(candidate);
+    }
+    bool isLeastLoaded = (config.policy == VMI_ENCODER_SELECT_LEAST_LOADED);
+    std::stable_sort(candidates.begin(), candidates.end(), [isLeastLoaded](const Candidate &a, const Candidate &b) {
+        if (a.isSaturated != b.isSaturated) {
+            return b.isSaturated;
+        }
+        return isLeastLoaded && a.load < b.load;
+    });
+    std::vector<uint32_t> encTypes;
+    for (const auto &candidate : candidates) {
+        encTypes.push_back(candidate.encType);
+    }
+    return encTypes;
+}
+
+bool VideoEncoderScheduler::TryReserve(uint32_t encType, uint64_t pixelRate)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    Backend &backend = GetBackendLocked(encType);
+    if (IsAtCapacityLocked(backend, pixelRate)) {
+        DBG("reserve encoder type %u failed: %u sessions, pixel rate %" PRIu64, encType, backend.sessions,
+            backend.pixelRate);
+        return false;
+    }
+    AddSessionLocked(backend, pixelRate);
+    return true;
+}
+
+void VideoEncoderScheduler::CancelReservation(uint32_t encType, uint64_t pixelRate)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    Backend &backend = GetBackendLocked(encType);
+    backend.sessions = (backend.sessions == 0) ? 0 : backend.sessions - 1;
+    backend.pixelRate -= std::min(backend.pixelRate, pixelRate);
+    Device &device = GetDeviceLocked(backend.device);
+    device.sessions = (device.sessions == 0) ? 0 : device.sessions - 1;
+}
+
+void VideoEncoderScheduler::OnSessionCreated(uint32_t encType)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    AddSessionLocked(GetBackendLocked(encType), 0);
+}
+
+void VideoEncoderScheduler::OnSessionLoadChanged(uint32_t encType, uint64_t oldPixelRate, uint64_t newPixelRate)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    Backend &backend = GetBackendLocked(encType);
+    backend.pixelRate = backend.pixelRate - std::min(backend.pixelRate, oldPixelRate) + newPixelRate;
+}
+
+void VideoEncoderScheduler::OnSessionDestroyed(uint32_t encType, uint64_t pixelRate)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    Backend &backend = GetBackendLocked(encType);
+    backend.sessions = (backend.sessions == 0) ? 0 : backend.sessions - 1;
+    backend.pixelRate -= std::min(backend.pixelRate, pixelRate);
+    Device &device = GetDeviceLocked(backend.device);
+    device.sessions = (device.sessions == 0) ? 0 : device.sessions - 1;
+    device.isSaturated = false;
+}
+
+void VideoEncoderScheduler::OnFailure(uint32_t encType, bool isInit)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    Backend &backend = GetBackendLocked(encType);
+    ++(isInit ? backend.initFailures : backend.createFailures);
+    Device &device = GetDeviceLocked(backend.device);
+    device.isSaturated = true;
+    device.saturatedSinceUs = GetMonotonicTimeUs();
+    // 设备上没有其他会话时失败与容量无关，不作为容量估计
+    if (device.sessions != 0) {
+        device.capacityEstimate = device.sessions;
+    }
+    WARN("encoder type %u %s failed with %u sessions on device %u, mark device saturated", encType,
+        isInit ? "init" : "create", device.sessions, device.id);
+}
+
+void VideoEncoderScheduler::OnPlaced(uint32_t encType, const std::vector<uint32_t> &fallbackTypes)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    ++GetBackendLocked(encType).placements;
+    for (uint32_t fallbackType : fallbackTypes) {
+        ++GetBackendLocked(fallbackType).fallbacks;
+    }
+}
+
+void VideoEncoderScheduler::GetStats(uint32_t encType, VmiEncoderBackendStats &stats)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    Backend &backend = GetBackendLocked(encType);
+    Device &device = GetDeviceLocked(backend.device);
+    stats.liveSessions = backend.sessions;
+    stats.deviceSessions = device.sessions;
+    stats.pixelRate = backend.pixelRate;
+    stats.placements = backend.placements;
+    stats.createFailures = backend.createFailures;
+    stats.initFailures = backend.initFailures;
+    stats.fallbacks = backend.fallbacks;
+    stats.isSaturated = IsSaturatedLocked(device, GetMonotonicTimeUs());
+}
+
+VideoEncoderScheduler::Backend &VideoEncoderScheduler::GetBackendLocked(uint32_t encType)
+{
+    for (auto &backend : m_backends) {
+        if (backend.encType == encType) {
+            return backend;
+        }
+    }
+    Backend backend;
+    backend.encType = encType;
+    backend.device = GetDeviceId(encType);
+    m_backends.push_back(backend);
+    return m_backends.back();
+}
+
+VideoEncoderScheduler::Device &VideoEncoderScheduler::GetDeviceLocked(uint32_t id)
+{
+    for (auto &device : m_devices) {
+        if (device.id == id) {
+            return device;
+        }
+    }
+    Device device;
+    device.id = id;
+    m_devices.push_back(device);
+    return m_devices.back();
+}
+
+bool VideoEncoderScheduler::IsSaturatedLocked(Device &device, uint64_t nowUs)
+{
+    if (device.isSaturated && nowUs - device.saturatedSinceUs >= SATURATION_RETRY_US) {
+        device.isSaturated = false;
+    }
+    return device.isSaturated;
+}
+
+// 负载率取新会话加入后各项容量占用比例的最大值，未配置上限且未估计出设备容量时为0
+bool VideoEncoderScheduler::IsAtCapacityLocked(const Backend &backend, uint64_t pixelRate)
+{
+    const VmiEncoderBackendConfig &limit = backend.config;
+    return (limit.maxSessions != 0 && backend.sessions >= limit.maxSessions) ||
+        (limit.maxPixelRate != 0 && backend.pixelRate + pixelRate > limit.maxPixelRate);
+}
+
+void VideoEncoderScheduler::AddSessionLocked(Backend &backend, uint64_t pixelRate)
+{
+    ++backend.sessions;
+    backend.pixelRate += pixelRate;
+    Device &device = GetDeviceLocked(backend.device);
+    ++device.sessions;
+    device.capacityEstimate = (device.capacityEstimate == 0) ? 0 : std::max(device.capacityEstimate, device.sessions);
+}
+
+double VideoEncoderScheduler::GetLoadLocked(const Backend &backend, const Device &device, uint64_t pixelRate)
+{
+    double load = 0;
+    if (backend.config.maxSessions != 0) {
+        load = std::max(load, static_cast<double>(backend.sessions + 1) / backend.config.maxSessions);
+    }
+    if (backend.config.maxPixelRate != 0) {
+        load = std::max(load, static_cast<double>(backend.pixelRate + pixelRate) / backend.config.maxPixelRate);
+    }
+    if (device.capacityEstimate != 0) {
+        load = std::max(load, static_cast<double>(device.sessions + 1) / device.capacityEstimate);
+    }
+    return load;
+}
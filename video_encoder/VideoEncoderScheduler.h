@@ -0,0 +1,139 @@
+/*
+ * 功能说明: 编码器调度，按编码器类型和硬件设备统计存活会话和负载，为新会话选择编码器类型
+ */
+#ifndef VIDEO_ENCODER_SCHEDULER_H
+#define VIDEO_ENCODER_SCHEDULER_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderScheduler {
+public:
+    /**
+     * @功能描述: 获取VideoEncoderScheduler单例对象
+     * @返回值: 返回值VideoEncoderScheduler单例对象引用
+     */
+    static VideoEncoderScheduler& GetInstance();
+
+    /**
+     * @功能描述: 计算会话的每秒编码像素数
+     */
+    static uint64_t GetPixelRate(uint32_t width, uint32_t height, uint32_t frameRate);
+
+    /**
+     * @功能描述: 配置编码器类型的容量上限
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] config: 容量配置
+     */
+    void Configure(uint32_t encType, const VmiEncoderBackendConfig &config);
+
+    /**
+     * @功能描述: 按选择策略对候选编码器类型排序，跳过已达容量上限的类型，被标记为满载的设备排在最后
+     * @参数 [in] config: 编码器类型选择配置
+     * @参数 [in] pixelRate: 新会话的每秒编码像素数
+     * @返回值: 按尝试顺序排列的编码器类型
+     */
+    std::vector<uint32_t> Select(const VmiEncoderSelectConfig &config, uint64_t pixelRate);
+
+    /**
+     * @功能描述: 未达容量上限时预留一个会话及其负载，检查与计数在同一次加锁中完成，
+     *            并发创建的会话合计不会超过上限。预留成功后会话视为已创建，之后按OnSessionDestroyed释放，
+     *            创建编码器失败时按CancelReservation释放
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] pixelRate: 新会话的每秒编码像素数
+     * @返回值: true 预留成功，false 已达容量上限
+     */
+    bool TryReserve(uint32_t encType, uint64_t pixelRate);
+
+    /**
+     * @功能描述: 释放TryReserve预留但未能创建编码器的会话，不清除设备的满载标记
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] pixelRate: 预留时的每秒编码像素数
+     */
+    void CancelReservation(uint32_t encType, uint64_t pixelRate);
+
+    /**
+     * @功能描述: 记录不经容量检查创建的会话
+     * @参数 [in] encType: 编码器类型
+     */
+    void OnSessionCreated(uint32_t encType);
+
+    /**
+     * @功能描述: 记录会话编码参数变化引起的负载变化
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] oldPixelRate: 变化前的每秒编码像素数
+     * @参数 [in] newPixelRate: 变化后的每秒编码像素数
+     */
+    void OnSessionLoadChanged(uint32_t encType, uint64_t oldPixelRate, uint64_t newPixelRate);
+
+    /**
+     * @功能描述: 记录会话销毁，设备的满载标记随之清除
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] pixelRate: 会话的每秒编码像素数
+     */
+    void OnSessionDestroyed(uint32_t encType, uint64_t pixelRate);
+
+    /**
+     * @功能描述: 记录创建或初始化失败，将设备临时标记为满载
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] isInit: true 初始化失败，false 创建失败
+     */
+    void OnFailure(uint32_t encType, bool isInit);
+
+    /**
+     * @功能描述: 记录选择结果
+     * @参数 [in] encType: 最终使用的编码器类型
+     * @参数 [in] fallbackTypes: 失败后被跳过的编码器类型
+     */
+    void OnPlaced(uint32_t encType, const std::vector<uint32_t> &fallbackTypes);
+
+    /**
+     * @功能描述: 获取编码器类型的调度统计
+     * @参数 [in] encType: 编码器类型
+     * @参数 [out] stats: 调度统计
+     */
+    void GetStats(uint32_t encType, VmiEncoderBackendStats &stats);
+
+private:
+    VideoEncoderScheduler() = default;
+    ~VideoEncoderScheduler() = default;
+    VideoEncoderScheduler(const VideoEncoderScheduler&) = delete;
+    VideoEncoderScheduler& operator=(const VideoEncoderScheduler&) = delete;
+    VideoEncoderScheduler(VideoEncoderScheduler &&) = delete;
+    VideoEncoderScheduler& operator=(VideoEncoderScheduler &&) = delete;
+
+    struct Backend {
+        uint32_t encType = 0;
+        uint32_t device = 0;
+        VmiEncoderBackendConfig config = {};
+        uint32_t sessions = 0;
+        uint64_t pixelRate = 0;
+        uint64_t placements = 0;
+        uint64_t createFailures = 0;
+        uint64_t initFailures = 0;
+        uint64_t fallbacks = 0;
+    };
+
+    struct Device {
+        uint32_t id = 0;
+        uint32_t sessions = 0;
+        bool isSaturated = false;
+        uint64_t saturatedSinceUs = 0;
+        uint32_t capacityEstimate = 0;  // 最近一次失败时的会话数，作为设备容量的估计，0表示未知
+    };
+
+    Backend &GetBackendLocked(uint32_t encType);
+    Device &GetDeviceLocked(uint32_t device);
+    bool IsSaturatedLocked(Device &device, uint64_t nowUs);
+    static bool IsAtCapacityLocked(const Backend &backend, uint64_t pixelRate);
+    void AddSessionLocked(Backend &backend, uint64_t pixelRate);
+    double GetLoadLocked(const Backend &backend, const Device &device, uint64_t pixelRate);
+
+    std::mutex m_lock = {};
+    std::vector<Backend> m_backends = {};
+    std::vector<Device> m_devices = {};
+};
+
+#endif  // VIDEO_ENCODER_SCHEDULER_H
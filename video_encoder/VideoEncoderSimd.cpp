@@ -0,0 +1,669 @@
+/*
+ * 功能说明: 编码前处理使用的SIMD内核，x86按CPU特性在运行时选择AVX2/SSE4.1实现，arm使用NEON实现，
+ *           其他平台及不支持的CPU使用标量实现
+ */
+
+#define LOG_TAG "VideoEncoderSimd"
+#include "VideoEncoderSimd.h"
+#include <algorithm>
+#include <cstring>
+#include "VideoEncoderLog.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VMI_SIMD_X86 1
+#define VMI_TARGET_SSE2 __attribute__((target("sse2")))
+#define VMI_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define VMI_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VMI_SIMD_NEON 1
+#endif
+
+namespace {
+    constexpr uint32_t BYTES_PER_PIXEL = 4;
+    // BT.601有限范围定点系数，Y = ((66R + 129G + 25B + 128) >> 8) + 16，U、V同理并加128
+    constexpr int16_t Y_R = 66;
+    constexpr int16_t Y_G = 129;
+    constexpr int16_t Y_B = 25;
+    constexpr int16_t U_R = -38;
+    constexpr int16_t U_G = -74;
+    constexpr int16_t U_B = 112;
+    constexpr int16_t V_R = 112;
+    constexpr int16_t V_G = -94;
+    constexpr int16_t V_B = -18;
+    constexpr int16_t ROUND = 128;
+    constexpr int16_t Y_OFFSET = 16;
+    constexpr int16_t CHROMA_OFFSET = 128;
+    constexpr int32_t FIXED_SHIFT = 8;
+    constexpr uint32_t BLEND_ONE = 1U << FIXED_SHIFT;
+
+    bool IsEqualScalar(const uint8_t *a, const uint8_t *b, uint32_t len)
+    {
+        uint64_t diff = 0;
+        uint32_t i = 0;
+        for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+            uint64_t va = 0;
+            uint64_t vb = 0;
+            (void) memcpy(&va, a + i, sizeof(va));
+            (void) memcpy(&vb, b + i, sizeof(vb));
+            diff |= va ^ vb;
+        }
+        for (; i < len; ++i) {
+            diff |= static_cast<uint64_t>(a[i] ^ b[i]);
+        }
+        return diff == 0;
+    }
+
+    void MarkDirtyTilesScalar(const uint8_t *cur, const uint8_t *ref, uint32_t width, uint32_t tileWidth,
+        uint8_t *dirty)
+    {
+        for (uint32_t x = 0, tile = 0; x < width; x += tileWidth, ++tile) {
+            if (dirty[tile] == 0 && !IsEqualScalar(cur + x, ref + x, std::min(tileWidth, width - x))) {
+                dirty[tile] = 1;
+            }
+        }
+    }
+
+    inline uint8_t RgbToY(int32_t r, int32_t g, int32_t b)
+    {
+        return static_cast<uint8_t>(((Y_R * r + Y_G * g + Y_B * b + ROUND) >> FIXED_SHIFT) + Y_OFFSET);
+    }
+
+    // 负数右移为算术右移，与各SIMD实现一致
+    inline uint8_t RgbToChroma(int32_t r, int32_t g, int32_t b, int32_t cr, int32_t cg, int32_t cb)
+    {
+        return static_cast<uint8_t>(((cr * r + cg * g + cb * b + ROUND) >> FIXED_SHIFT) + CHROMA_OFFSET);
+    }
+
+    void RgbToI420RowsScalar(const uint8_t *src0, const uint8_t *src1, uint32_t width, bool isBgra,
+        uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+    {
+        const uint32_t ri = isBgra ? 2 : 0;
+        const uint32_t gi = 1;
+        const uint32_t bi = isBgra ? 0 : 2;
+        for (uint32_t x = 0; x < width; x += 2) {
+            uint32_t x1 = std::min(x + 1, width - 1);
+            const uint8_t *p00 = src0 + x * BYTES_PER_PIXEL;
+            const uint8_t *p01 = src0 + x1 * BYTES_PER_PIXEL;
+            const uint8_t *p10 = src1 + x * BYTES_PER_PIXEL;
+            const uint8_t *p11 = src1 + x1 * BYTES_PER_PIXEL;
+            y0[x] = RgbToY(p00[ri], p00[gi], p00[bi]);
+            y0[x1] = RgbToY(p01[ri], p01[gi], p01[bi]);
+            y1[x] = RgbToY(p10[ri], p10[gi], p10[bi]);
+            y1[x1] = RgbToY(p11[ri], p11[gi], p11[bi]);
+            int32_t r = (p00[ri] + p01[ri] + p10[ri] + p11[ri] + 2) >> 2;
+            int32_t g = (p00[gi] + p01[gi] + p10[gi] + p11[gi] + 2) >> 2;
+            int32_t b = (p00[bi] + p01[bi] + p10[bi] + p11[bi] + 2) >> 2;
+            u[x / 2] = RgbToChroma(r, g, b, U_R, U_G, U_B);
+            v[x / 2] = RgbToChroma(r, g, b, V_R, V_G, V_B);
+        }
+    }
+
+    void SplitUvRowScalar(const uint8_t *uv, uint32_t width, uint8_t *u, uint8_t *v)
+    {
+        for (uint32_t i = 0; i < width; ++i) {
+            u[i] = uv[2 * i];
+            v[i] = uv[2 * i + 1];
+        }
+    }
+
+    void ScaleRowBox2xScalar(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint8_t *dst)
+    {
+        for (uint32_t i = 0; i < width; ++i) {
+            dst[i] = static_cast<uint8_t>((src0[2 * i] + src0[2 * i + 1] + src1[2 * i] + src1[2 * i + 1] + 2) >> 2);
+        }
+    }
+
+    void BlendRowsScalar(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint32_t fraction, uint8_t *dst)
+    {
+        if (fraction == 0) {
+            (void) memcpy(dst, src0, width);
+            return;
+        }
+        const uint32_t weight0 = BLEND_ONE - fraction;
+        for (uint32_t i = 0; i < width; ++i) {
+            dst[i] = static_cast<uint8_t>((src0[i] * weight0 + src1[i] * fraction + ROUND) >> FIXED_SHIFT);
+        }
+    }
+
+#ifdef VMI_SIMD_X86
+    VMI_TARGET_SSE2 bool IsEqualSse2(const uint8_t *a, const uint8_t *b, uint32_t len)
+    {
+        constexpr uint32_t step = sizeof(__m128i);
+        __m128i diff = _mm_setzero_si128();
+        uint32_t i = 0;
+        for (; i + step <= len; i += step) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+            diff = _mm_or_si128(diff, _mm_xor_si128(va, vb));
+        }
+        constexpr int allEqualMask = 0xffff;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != allEqualMask) {
+            return false;
+        }
+        return IsEqualScalar(a + i, b + i, len - i);
+    }
+
+    VMI_TARGET_SSE2 void MarkDirtyTilesSse2(const uint8_t *cur, const uint8_t *ref, uint32_t width,
+        uint32_t tileWidth, uint8_t *dirty)
+    {
+        for (uint32_t x = 0, tile = 0; x < width; x += tileWidth, ++tile) {
+            if (dirty[tile] == 0 && !IsEqualSse2(cur + x, ref + x, std::min(tileWidth, width - x))) {
+                dirty[tile] = 1;
+            }
+        }
+    }
+
+    // 将16个像素拆分为R、G、B三个分量，shuffle把每4个像素的同一分量集中到一个32位通道
+    VMI_TARGET_SSE41 inline void LoadRgbSse41(const uint8_t *src, __m128i shuffle, __m128i &r, __m128i &g,
+        __m128i &b)
+    {
+        constexpr uint32_t step = sizeof(__m128i);
+        __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), shuffle);
+        __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + step)), shuffle);
+        __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * step)), shuffle);
+        __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * step)), shuffle);
+        __m128i rg01 = _mm_unpacklo_epi32(p0, p1);
+        __m128i ba01 = _mm_unpackhi_epi32(p0, p1);
+        __m128i rg23 = _mm_unpacklo_epi32(p2, p3);
+        __m128i ba23 = _mm_unpackhi_epi32(p2, p3);
+        r = _mm_unpacklo_epi64(rg01, rg23);
+        g = _mm_unpackhi_epi64(rg01, rg23);
+        b = _mm_unpacklo_epi64(ba01, ba23);
+    }
+
+    // 16位通道上计算亮度，中间结果不超过65535，按无符号数处理
+    VMI_TARGET_SSE41 inline __m128i RgbToY16Sse41(__m128i r, __m128i g, __m128i b)
+    {
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(Y_R)), _mm_mullo_epi16(g, _mm_set1_epi16(Y_G)));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(Y_B)));
+        sum = _mm_add_epi16(sum, _mm_set1_epi16(ROUND));
+        return _mm_add_epi16(_mm_srli_epi16(sum, FIXED_SHIFT), _mm_set1_epi16(Y_OFFSET));
+    }
+
+    VMI_TARGET_SSE41 inline __m128i RgbToYSse41(__m128i r, __m128i g, __m128i b)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i lo = RgbToY16Sse41(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero),
+            _mm_unpacklo_epi8(b, zero));
+        __m128i hi = RgbToY16Sse41(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero),
+            _mm_unpackhi_epi8(b, zero));
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    // 两行相邻像素两两相加后求2x2平均值，结果为8个16位通道
+    VMI_TARGET_SSE41 inline __m128i Average2x2Sse41(__m128i row0, __m128i row1)
+    {
+        const __m128i ones = _mm_set1_epi8(1);
+        __m128i sum = _mm_add_epi16(_mm_maddubs_epi16(row0, ones), _mm_maddubs_epi16(row1, ones));
+        return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+    }
+
+    // 16位通道上计算色度，中间结果在int16范围内，算术右移
+    VMI_TARGET_SSE41 inline __m128i RgbToChromaSse41(__m128i r, __m128i g, __m128i b, int16_t cr, int16_t cg,
+        int16_t cb)
+    {
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(cr)), _mm_mullo_epi16(g, _mm_set1_epi16(cg)));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(cb)));
+        sum = _mm_add_epi16(sum, _mm_set1_epi16(ROUND));
+        __m128i chroma = _mm_add_epi16(_mm_srai_epi16(sum, FIXED_SHIFT), _mm_set1_epi16(CHROMA_OFFSET));
+        return _mm_packus_epi16(chroma, chroma);
+    }
+
+    VMI_TARGET_SSE41 void RgbToI420RowsSse41(const uint8_t *src0, const uint8_t *src1, uint32_t width,
+        bool isBgra, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+    {
+        constexpr uint32_t step = sizeof(__m128i);
+        const __m128i shuffle = isBgra ?
+            _mm_setr_epi8(2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12, 3, 7, 11, 15) :
+            _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+        uint32_t x = 0;
+        for (; x + step <= width; x += step) {
+            __m128i r0;
+            __m128i g0;
+            __m128i b0;
+            __m128i r1;
+            __m128i g1;
+            __m128i b1;
+            LoadRgbSse41(src0 + x * BYTES_PER_PIXEL, shuffle, r0, g0, b0);
+            LoadRgbSse41(src1 + x * BYTES_PER_PIXEL, shuffle, r1, g1, b1);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(y0 + x), RgbToYSse41(r0, g0, b0));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(y1 + x), RgbToYSse41(r1, g1, b1));
+            __m128i r = Average2x2Sse41(r0, r1);
+            __m128i g = Average2x2Sse41(g0, g1);
+            __m128i b = Average2x2Sse41(b0, b1);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2), RgbToChromaSse41(r, g, b, U_R, U_G, U_B));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2), RgbToChromaSse41(r, g, b, V_R, V_G, V_B));
+        }
+        RgbToI420RowsScalar(src0 + x * BYTES_PER_PIXEL, src1 + x * BYTES_PER_PIXEL, width - x, isBgra,
+            y0 + x, y1 + x, u + x / 2, v + x / 2);
+    }
+
+    VMI_TARGET_SSE41 void SplitUvRowSse41(const uint8_t *uv, uint32_t width, uint8_t *u, uint8_t *v)
+    {
+        constexpr uint32_t step = sizeof(__m128i);
+        const __m128i shuffle = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(uv + 2 * i)), shuffle);
+            __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(uv + 2 * i + step)),
+                shuffle);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(u + i), _mm_unpacklo_epi64(p0, p1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(v + i), _mm_unpackhi_epi64(p0, p1));
+        }
+        SplitUvRowScalar(uv + 2 * i, width - i, u + i, v + i);
+    }
+
+    VMI_TARGET_SSE41 void ScaleRowBox2xSse41(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint8_t *dst)
+    {
+        constexpr uint32_t step = sizeof(__m128i);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            const uint8_t *s0 = src0 + 2 * i;
+            const uint8_t *s1 = src1 + 2 * i;
+            __m128i lo = Average2x2Sse41(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s0)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(s1)));
+            __m128i hi = Average2x2Sse41(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s0 + step)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(s1 + step)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        ScaleRowBox2xScalar(src0 + 2 * i, src1 + 2 * i, width - i, dst + i);
+    }
+
+    VMI_TARGET_SSE41 void BlendRowsSse41(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint32_t fraction,
+        uint8_t *dst)
+    {
+        if (fraction == 0) {
+            (void) memcpy(dst, src0, width);
+            return;
+        }
+        constexpr uint32_t step = sizeof(__m128i);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i weight0 = _mm_set1_epi16(static_cast<int16_t>(BLEND_ONE - fraction));
+        const __m128i weight1 = _mm_set1_epi16(static_cast<int16_t>(fraction));
+        const __m128i round = _mm_set1_epi16(ROUND);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src0 + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1 + i));
+            // 加权和不超过255 * 256 + 128，按无符号16位数处理
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), weight0),
+                _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), weight1));
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), weight0),
+                _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), weight1));
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, round), FIXED_SHIFT);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, round), FIXED_SHIFT);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        BlendRowsScalar(src0 + i, src1 + i, width - i, fraction, dst + i);
+    }
+
+    VMI_TARGET_AVX2 bool IsEqualAvx2(const uint8_t *a, const uint8_t *b, uint32_t len)
+    {
+        constexpr uint32_t step = sizeof(__m256i);
+        __m256i diff = _mm256_setzero_si256();
+        uint32_t i = 0;
+        for (; i + step <= len; i += step) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(va, vb));
+        }
+        if (!_mm256_testz_si256(diff, diff)) {
+            return false;
+        }
+        return IsEqualScalar(a + i, b + i, len - i);
+    }
+
+    VMI_TARGET_AVX2 void MarkDirtyTilesAvx2(const uint8_t *cur, const uint8_t *ref, uint32_t width,
+        uint32_t tileWidth, uint8_t *dirty)
+    {
+        for (uint32_t x = 0, tile = 0; x < width; x += tileWidth, ++tile) {
+            if (dirty[tile] == 0 && !IsEqualAvx2(cur + x, ref + x, std::min(tileWidth, width - x))) {
+                dirty[tile] = 1;
+            }
+        }
+    }
+
+    // 将32个像素拆分为R、G、B三个分量，通道内shuffle后跨128位通道重排，使各分量按像素顺序排列
+    VMI_TARGET_AVX2 inline void LoadRgbAvx2(const uint8_t *src, __m256i shuffle, __m256i &r, __m256i &g,
+        __m256i &b)
+    {
+        constexpr uint32_t step = sizeof(__m256i);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        __m256i p[4];
+        for (uint32_t i = 0; i < 4; ++i) {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * step));
+            // 低128位为8个像素的R、G，高128位为B、A
+            p[i] = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(pixels, shuffle), order);
+        }
+        __m256i rb01 = _mm256_unpacklo_epi64(p[0], p[1]);
+        __m256i ga01 = _mm256_unpackhi_epi64(p[0], p[1]);
+        __m256i rb23 = _mm256_unpacklo_epi64(p[2], p[3]);
+        __m256i ga23 = _mm256_unpackhi_epi64(p[2], p[3]);
+        r = _mm256_permute2x128_si256(rb01, rb23, 0x20);
+        g = _mm256_permute2x128_si256(ga01, ga23, 0x20);
+        b = _mm256_permute2x128_si256(rb01, rb23, 0x31);
+    }
+
+    VMI_TARGET_AVX2 inline __m256i RgbToY16Avx2(__m256i r, __m256i g, __m256i b)
+    {
+        __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(Y_R)),
+            _mm256_mullo_epi16(g, _mm256_set1_epi16(Y_G)));
+        sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(b, _mm256_set1_epi16(Y_B)));
+        sum = _mm256_add_epi16(sum, _mm256_set1_epi16(ROUND));
+        return _mm256_add_epi16(_mm256_srli_epi16(sum, FIXED_SHIFT), _mm256_set1_epi16(Y_OFFSET));
+    }
+
+    // unpack和pack均在128位通道内进行，两次重排相互抵消，输出保持像素顺序
+    VMI_TARGET_AVX2 inline __m256i RgbToYAvx2(__m256i r, __m256i g, __m256i b)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i lo = RgbToY16Avx2(_mm256_unpacklo_epi8(r, zero), _mm256_unpacklo_epi8(g, zero),
+            _mm256_unpacklo_epi8(b, zero));
+        __m256i hi = RgbToY16Avx2(_mm256_unpackhi_epi8(r, zero), _mm256_unpackhi_epi8(g, zero),
+            _mm256_unpackhi_epi8(b, zero));
+        return _mm256_packus_epi16(lo, hi);
+    }
+
+    VMI_TARGET_AVX2 inline __m256i Average2x2Avx2(__m256i row0, __m256i row1)
+    {
+        const __m256i ones = _mm256_set1_epi8(1);
+        __m256i sum = _mm256_add_epi16(_mm256_maddubs_epi16(row0, ones), _mm256_maddubs_epi16(row1, ones));
+        return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+    }
+
+    // 返回值低128位为16个色度采样点
+    VMI_TARGET_AVX2 inline __m128i RgbToChromaAvx2(__m256i r, __m256i g, __m256i b, int16_t cr, int16_t cg,
+        int16_t cb)
+    {
+        __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(cr)),
+            _mm256_mullo_epi16(g, _mm256_set1_epi16(cg)));
+        sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(b, _mm256_set1_epi16(cb)));
+        sum = _mm256_add_epi16(sum, _mm256_set1_epi16(ROUND));
+        __m256i chroma = _mm256_add_epi16(_mm256_srai_epi16(sum, FIXED_SHIFT), _mm256_set1_epi16(CHROMA_OFFSET));
+        __m256i packed = _mm256_packus_epi16(chroma, chroma);
+        return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    VMI_TARGET_AVX2 void RgbToI420RowsAvx2(const uint8_t *src0, const uint8_t *src1, uint32_t width,
+        bool isBgra, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+    {
+        constexpr uint32_t step = sizeof(__m256i);
+        const __m256i shuffle = isBgra ?
+            _mm256_setr_epi8(2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12, 3, 7, 11, 15,
+                2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12, 3, 7, 11, 15) :
+            _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+        uint32_t x = 0;
+        for (; x + step <= width; x += step) {
+            __m256i r0;
+            __m256i g0;
+            __m256i b0;
+            __m256i r1;
+            __m256i g1;
+            __m256i b1;
+            LoadRgbAvx2(src0 + x * BYTES_PER_PIXEL, shuffle, r0, g0, b0);
+            LoadRgbAvx2(src1 + x * BYTES_PER_PIXEL, shuffle, r1, g1, b1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(y0 + x), RgbToYAvx2(r0, g0, b0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(y1 + x), RgbToYAvx2(r1, g1, b1));
+            __m256i r = Average2x2Avx2(r0, r1);
+            __m256i g = Average2x2Avx2(g0, g1);
+            __m256i b = Average2x2Avx2(b0, b1);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x / 2), RgbToChromaAvx2(r, g, b, U_R, U_G, U_B));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(v + x / 2), RgbToChromaAvx2(r, g, b, V_R, V_G, V_B));
+        }
+        RgbToI420RowsScalar(src0 + x * BYTES_PER_PIXEL, src1 + x * BYTES_PER_PIXEL, width - x, isBgra,
+            y0 + x, y1 + x, u + x / 2, v + x / 2);
+    }
+
+    VMI_TARGET_AVX2 void ScaleRowBox2xAvx2(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint8_t *dst)
+    {
+        constexpr uint32_t step = sizeof(__m256i);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            const uint8_t *s0 = src0 + 2 * i;
+            const uint8_t *s1 = src1 + 2 * i;
+            __m256i lo = Average2x2Avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s0)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s1)));
+            __m256i hi = Average2x2Avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s0 + step)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s1 + step)));
+            // pack在128位通道内交错两个输入，重排后恢复像素顺序
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), packed);
+        }
+        ScaleRowBox2xScalar(src0 + 2 * i, src1 + 2 * i, width - i, dst + i);
+    }
+
+    VMI_TARGET_AVX2 void BlendRowsAvx2(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint32_t fraction,
+        uint8_t *dst)
+    {
+        if (fraction == 0) {
+            (void) memcpy(dst, src0, width);
+            return;
+        }
+        constexpr uint32_t step = sizeof(__m256i);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i weight0 = _mm256_set1_epi16(static_cast<int16_t>(BLEND_ONE - fraction));
+        const __m256i weight1 = _mm256_set1_epi16(static_cast<int16_t>(fraction));
+        const __m256i round = _mm256_set1_epi16(ROUND);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src0 + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src1 + i));
+            __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), weight0),
+                _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), weight1));
+            __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), weight0),
+                _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), weight1));
+            lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), FIXED_SHIFT);
+            hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), FIXED_SHIFT);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(lo, hi));
+        }
+        BlendRowsScalar(src0 + i, src1 + i, width - i, fraction, dst + i);
+    }
+
+    VMI_TARGET_AVX2 void SplitUvRowAvx2(const uint8_t *uv, uint32_t width, uint8_t *u, uint8_t *v)
+    {
+        constexpr uint32_t step = sizeof(__m128i);
+        const __m256i shuffle = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+            0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            __m256i p = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(uv + 2 * i)),
+                shuffle);
+            p = _mm256_permute4x64_epi64(p, _MM_SHUFFLE(3, 1, 2, 0));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(u + i), _mm256_castsi256_si128(p));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(v + i), _mm256_extracti128_si256(p, 1));
+        }
+        SplitUvRowScalar(uv + 2 * i, width - i, u + i, v + i);
+    }
+#endif
+
+#ifdef VMI_SIMD_NEON
+    bool IsEqualNeon(const uint8_t *a, const uint8_t *b, uint32_t len)
+    {
+        constexpr uint32_t step = sizeof(uint8x16_t);
+        uint8x16_t diff = vdupq_n_u8(0);
+        uint32_t i = 0;
+        for (; i + step <= len; i += step) {
+            diff = vorrq_u8(diff, veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        }
+        uint64x2_t diff64 = vreinterpretq_u64_u8(diff);
+        if ((vgetq_lane_u64(diff64, 0) | vgetq_lane_u64(diff64, 1)) != 0) {
+            return false;
+        }
+        return IsEqualScalar(a + i, b + i, len - i);
+    }
+
+    void MarkDirtyTilesNeon(const uint8_t *cur, const uint8_t *ref, uint32_t width, uint32_t tileWidth,
+        uint8_t *dirty)
+    {
+        for (uint32_t x = 0, tile = 0; x < width; x += tileWidth, ++tile) {
+            if (dirty[tile] == 0 && !IsEqualNeon(cur + x, ref + x, std::min(tileWidth, width - x))) {
+                dirty[tile] = 1;
+            }
+        }
+    }
+
+    inline uint8x8_t RgbToY8Neon(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+    {
+        uint16x8_t sum = vmull_u8(r, vdup_n_u8(Y_R));
+        sum = vmlal_u8(sum, g, vdup_n_u8(Y_G));
+        sum = vmlal_u8(sum, b, vdup_n_u8(Y_B));
+        sum = vaddq_u16(sum, vdupq_n_u16(ROUND));
+        return vadd_u8(vshrn_n_u16(sum, FIXED_SHIFT), vdup_n_u8(Y_OFFSET));
+    }
+
+    inline uint8x16_t RgbToYNeon(uint8x16_t r, uint8x16_t g, uint8x16_t b)
+    {
+        return vcombine_u8(RgbToY8Neon(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)),
+            RgbToY8Neon(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+    }
+
+    // 相邻像素两两相加并累加第二行，舍入右移即(sum + 2) >> 2
+    inline uint16x8_t Average2x2Neon(uint8x16_t row0, uint8x16_t row1)
+    {
+        return vrshrq_n_u16(vpadalq_u8(vpaddlq_u8(row0), row1), 2);
+    }
+
+    inline uint8x8_t RgbToChromaNeon(uint16x8_t r, uint16x8_t g, uint16x8_t b, int16_t cr, int16_t cg,
+        int16_t cb)
+    {
+        int16x8_t sum = vmulq_n_s16(vreinterpretq_s16_u16(r), cr);
+        sum = vmlaq_n_s16(sum, vreinterpretq_s16_u16(g), cg);
+        sum = vmlaq_n_s16(sum, vreinterpretq_s16_u16(b), cb);
+        sum = vaddq_s16(sum, vdupq_n_s16(ROUND));
+        return vqmovun_s16(vaddq_s16(vshrq_n_s16(sum, FIXED_SHIFT), vdupq_n_s16(CHROMA_OFFSET)));
+    }
+
+    void RgbToI420RowsNeon(const uint8_t *src0, const uint8_t *src1, uint32_t width, bool isBgra,
+        uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v)
+    {
+        constexpr uint32_t step = sizeof(uint8x16_t);
+        const uint32_t ri = isBgra ? 2 : 0;
+        const uint32_t bi = isBgra ? 0 : 2;
+        uint32_t x = 0;
+        for (; x + step <= width; x += step) {
+            uint8x16x4_t p0 = vld4q_u8(src0 + x * BYTES_PER_PIXEL);
+            uint8x16x4_t p1 = vld4q_u8(src1 + x * BYTES_PER_PIXEL);
+            vst1q_u8(y0 + x, RgbToYNeon(p0.val[ri], p0.val[1], p0.val[bi]));
+            vst1q_u8(y1 + x, RgbToYNeon(p1.val[ri], p1.val[1], p1.val[bi]));
+            uint16x8_t r = Average2x2Neon(p0.val[ri], p1.val[ri]);
+            uint16x8_t g = Average2x2Neon(p0.val[1], p1.val[1]);
+            uint16x8_t b = Average2x2Neon(p0.val[bi], p1.val[bi]);
+            vst1_u8(u + x / 2, RgbToChromaNeon(r, g, b, U_R, U_G, U_B));
+            vst1_u8(v + x / 2, RgbToChromaNeon(r, g, b, V_R, V_G, V_B));
+        }
+        RgbToI420RowsScalar(src0 + x * BYTES_PER_PIXEL, src1 + x * BYTES_PER_PIXEL, width - x, isBgra,
+            y0 + x, y1 + x, u + x / 2, v + x / 2);
+    }
+
+    void ScaleRowBox2xNeon(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint8_t *dst)
+    {
+        constexpr uint32_t step = sizeof(uint8x16_t);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            const uint8_t *s0 = src0 + 2 * i;
+            const uint8_t *s1 = src1 + 2 * i;
+            uint16x8_t lo = vpadalq_u8(vpaddlq_u8(vld1q_u8(s0)), vld1q_u8(s1));
+            uint16x8_t hi = vpadalq_u8(vpaddlq_u8(vld1q_u8(s0 + step)), vld1q_u8(s1 + step));
+            vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+        }
+        ScaleRowBox2xScalar(src0 + 2 * i, src1 + 2 * i, width - i, dst + i);
+    }
+
+    void BlendRowsNeon(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint32_t fraction, uint8_t *dst)
+    {
+        if (fraction == 0) {
+            (void) memcpy(dst, src0, width);
+            return;
+        }
+        constexpr uint32_t step = sizeof(uint8x16_t);
+        const uint8x8_t weight0 = vdup_n_u8(static_cast<uint8_t>(BLEND_ONE - fraction));
+        const uint8x8_t weight1 = vdup_n_u8(static_cast<uint8_t>(fraction));
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            uint8x16_t a = vld1q_u8(src0 + i);
+            uint8x16_t b = vld1q_u8(src1 + i);
+            uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), weight0), vget_low_u8(b), weight1);
+            uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), weight0), vget_high_u8(b), weight1);
+            // 舍入右移即(sum + 128) >> 8
+            vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, FIXED_SHIFT), vrshrn_n_u16(hi, FIXED_SHIFT)));
+        }
+        BlendRowsScalar(src0 + i, src1 + i, width - i, fraction, dst + i);
+    }
+
+    void SplitUvRowNeon(const uint8_t *uv, uint32_t width, uint8_t *u, uint8_t *v)
+    {
+        constexpr uint32_t step = sizeof(uint8x16_t);
+        uint32_t i = 0;
+        for (; i + step <= width; i += step) {
+            uint8x16x2_t p = vld2q_u8(uv + 2 * i);
+            vst1q_u8(u + i, p.val[0]);
+            vst1q_u8(v + i, p.val[1]);
+        }
+        SplitUvRowScalar(uv + 2 * i, width - i, u + i, v + i);
+    }
+#endif
+
+    const VideoEncoderSimdKernels SCALAR_KERNELS = {
+        SIMD_LEVEL_SCALAR, "scalar", MarkDirtyTilesScalar, RgbToI420RowsScalar, SplitUvRowScalar,
+        ScaleRowBox2xScalar, BlendRowsScalar
+    };
+#ifdef VMI_SIMD_X86
+    // 比较只需要SSE2指令
+    const VideoEncoderSimdKernels SSE41_KERNELS = {
+        SIMD_LEVEL_SSE41, "sse4.1", MarkDirtyTilesSse2, RgbToI420RowsSse41, SplitUvRowSse41,
+        ScaleRowBox2xSse41, BlendRowsSse41
+    };
+    const VideoEncoderSimdKernels AVX2_KERNELS = {
+        SIMD_LEVEL_AVX2, "avx2", MarkDirtyTilesAvx2, RgbToI420RowsAvx2, SplitUvRowAvx2,
+        ScaleRowBox2xAvx2, BlendRowsAvx2
+    };
+#endif
+#ifdef VMI_SIMD_NEON
+    const VideoEncoderSimdKernels NEON_KERNELS = {
+        SIMD_LEVEL_NEON, "neon", MarkDirtyTilesNeon, RgbToI420RowsNeon, SplitUvRowNeon,
+        ScaleRowBox2xNeon, BlendRowsNeon
+    };
+#endif
+
+    const VideoEncoderSimdKernels &SelectSimdKernels()
+    {
+        const VideoEncoderSimdKernels *kernels = &SCALAR_KERNELS;
+        for (auto level : { SIMD_LEVEL_SSE41, SIMD_LEVEL_AVX2, SIMD_LEVEL_NEON }) {
+            const VideoEncoderSimdKernels *candidate = GetSimdKernels(level);
+            if (candidate != nullptr) {
+                kernels = candidate;
+            }
+        }
+        INFO("use %s kernels", kernels->name);
+        return *kernels;
+    }
+}
+
+const VideoEncoderSimdKernels &GetSimdKernels()
+{
+    static const VideoEncoderSimdKernels &kernels = SelectSimdKernels();
+    return kernels;
+}
+
+const VideoEncoderSimdKernels *GetSimdKernels(VideoEncoderSimdLevel level)
+{
+    switch (level) {
+        case SIMD_LEVEL_SCALAR:
+            return &SCALAR_KERNELS;
+#ifdef VMI_SIMD_X86
+        case SIMD_LEVEL_SSE41:
+            return __builtin_cpu_supports("sse4.1") ? &SSE41_KERNELS : nullptr;
+        case SIMD_LEVEL_AVX2:
+            return __builtin_cpu_supports("avx2") ? &AVX2_KERNELS : nullptr;
+#endif
+#ifdef VMI_SIMD_NEON
+        case SIMD_LEVEL_NEON:
+            return &NEON_KERNELS;
+#endif
+        default:
+            return nullptr;
+    }
+}
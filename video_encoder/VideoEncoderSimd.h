@@ -0,0 +1,90 @@
+/*
+ * 功能说明: 编码前处理使用的SIMD内核，x86按CPU特性在运行时选择AVX2/SSE4.1实现，arm使用NEON实现，
+ *           其他平台及不支持的CPU使用标量实现
+ */
+#ifndef VIDEO_ENCODER_SIMD_H
+#define VIDEO_ENCODER_SIMD_H
+
+#include <cstdint>
+
+// 指令集级别
+enum VideoEncoderSimdLevel : uint32_t {
+    SIMD_LEVEL_SCALAR = 0,
+    SIMD_LEVEL_SSE41 = 1,
+    SIMD_LEVEL_AVX2 = 2,
+    SIMD_LEVEL_NEON = 3
+};
+
+struct VideoEncoderSimdKernels {
+    VideoEncoderSimdLevel level;
+    const char *name;
+
+    /**
+     * @功能描述: 以tileWidth为宽度划分一行数据，与参考行不同的分块在dirty中置1，已置1的分块不再比较
+     * @参数 [in] cur: 当前行
+     * @参数 [in] ref: 参考行
+     * @参数 [in] width: 行宽度，单位字节
+     * @参数 [in] tileWidth: 分块宽度，单位字节
+     * @参数 [in,out] dirty: 各分块的变化标记
+     */
+    void (*markDirtyTiles)(const uint8_t *cur, const uint8_t *ref, uint32_t width, uint32_t tileWidth,
+        uint8_t *dirty);
+
+    /**
+     * @功能描述: 按BT.601有限范围定点公式将两行RGBA/BGRA像素转换为两行亮度和一行色度，
+     *            色度取2x2像素的平均值，宽度为奇数时最后一列与自身配对。各级别实现的结果逐位一致
+     * @参数 [in] src0: 第一行像素
+     * @参数 [in] src1: 第二行像素，高度为奇数时最后一行与自身配对，可与src0相同
+     * @参数 [in] width: 行宽度，单位像素
+     * @参数 [in] isBgra: true 像素为BGRA顺序，false 像素为RGBA顺序
+     * @参数 [out] y0: 第一行亮度
+     * @参数 [out] y1: 第二行亮度，可与y0相同
+     * @参数 [out] u: 一行U分量，(width + 1) / 2个
+     * @参数 [out] v: 一行V分量，(width + 1) / 2个
+     */
+    void (*rgbToI420Rows)(const uint8_t *src0, const uint8_t *src1, uint32_t width, bool isBgra,
+        uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v);
+
+    /**
+     * @功能描述: 将一行UV交错的色度拆分为U、V两行
+     * @参数 [in] uv: UV交错的一行色度
+     * @参数 [in] width: 行宽度，单位色度采样点
+     * @参数 [out] u: 一行U分量
+     * @参数 [out] v: 一行V分量
+     */
+    void (*splitUvRow)(const uint8_t *uv, uint32_t width, uint8_t *u, uint8_t *v);
+
+    /**
+     * @功能描述: 2:1缩小一行，输出像素为源中对应2x2像素的平均值
+     * @参数 [in] src0: 第一行源像素，至少2 * width个
+     * @参数 [in] src1: 第二行源像素，至少2 * width个
+     * @参数 [in] width: 输出行宽度
+     * @参数 [out] dst: 输出行
+     */
+    void (*scaleRowBox2x)(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint8_t *dst);
+
+    /**
+     * @功能描述: 按权重混合两行，dst = (src0 * (256 - fraction) + src1 * fraction + 128) >> 8
+     * @参数 [in] src0: 第一行
+     * @参数 [in] src1: 第二行
+     * @参数 [in] width: 行宽度
+     * @参数 [in] fraction: 第二行的权重，取值范围[0, 256)
+     * @参数 [out] dst: 输出行
+     */
+    void (*blendRows)(const uint8_t *src0, const uint8_t *src1, uint32_t width, uint32_t fraction, uint8_t *dst);
+};
+
+/**
+ * @功能描述: 获取当前CPU支持的最优内核，首次调用时检测CPU特性
+ * @返回值: 内核函数表
+ */
+const VideoEncoderSimdKernels &GetSimdKernels();
+
+/**
+ * @功能描述: 获取指定指令集级别的内核，用于基准测试和与标量实现的一致性校验
+ * @参数 [in] level: 指令集级别
+ * @返回值: 内核函数表，当前平台或CPU不支持该级别时返回空
+ */
+const VideoEncoderSimdKernels *GetSimdKernels(VideoEncoderSimdLevel level);
+
+#endif  // VIDEO_ENCODER_SIMD_H
@@ -0,0 +1,167 @@
+/*
+ * 功能说明: 编码器运行统计，在编码热路径上以无锁方式累计计数和时延直方图，并提供进程级汇总
+ */
+
+#include "VideoEncoderStats.h"
+#include <algorithm>
+
+namespace {
+    constexpr uint32_t SUB_BUCKET_BITS = 2;
+    constexpr double PERCENTILE_50 = 0.50;
+    constexpr double PERCENTILE_99 = 0.99;
+    constexpr uint64_t NS_PER_US = 1000;
+
+    uint32_t GetLatencyBucket(uint64_t valueUs)
+    {
+        if (valueUs < STATS_LATENCY_SUB_BUCKETS) {
+            return static_cast<uint32_t>(valueUs);
+        }
+        uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(valueUs));
+        uint32_t sub = static_cast<uint32_t>(valueUs >> (msb - SUB_BUCKET_BITS)) & (STATS_LATENCY_SUB_BUCKETS - 1);
+        uint32_t bucket = (msb - 1) * STATS_LATENCY_SUB_BUCKETS + sub;
+        return std::min(bucket, STATS_LATENCY_BUCKETS - 1);
+    }
+
+    // 返回桶区间中点，作为落入该桶的时延估计值
+    uint64_t GetLatencyBucketValue(uint32_t bucket)
+    {
+        if (bucket < STATS_LATENCY_SUB_BUCKETS) {
+            return bucket;
+        }
+        uint32_t msb = bucket / STATS_LATENCY_SUB_BUCKETS + 1;
+        uint64_t sub = bucket % STATS_LATENCY_SUB_BUCKETS;
+        uint64_t width = 1ULL << (msb - SUB_BUCKET_BITS);
+        return (STATS_LATENCY_SUB_BUCKETS + sub) * width + width / 2;
+    }
+
+    uint64_t GetPercentile(const std::array<uint64_t, STATS_LATENCY_BUCKETS> &histogram, uint64_t total,
+        double percentile, uint64_t maxValue)
+    {
+        if (total == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(percentile * total);
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t count = 0;
+        for (uint32_t i = 0; i < STATS_LATENCY_BUCKETS; ++i) {
+            count += histogram[i];
+            if (count >= rank) {
+                return std::min(GetLatencyBucketValue(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+}
+
+void EncoderStatsSnapshot::ToVmiStats(VmiEncoderStats &stats) const
+{
+    stats.framesEncoded = framesEncoded;
+    stats.encodeFailures = encodeFailures;
+    stats.keyFrames = keyFrames;
+    stats.inputBytes = inputBytes;
+    stats.outputBytes = outputBytes;
+    stats.encodeTimeAvgUs = (framesEncoded == 0) ? 0 : encodeTimeTotalUs / framesEncoded;
+    stats.encodeTimeP50Us = GetPercentile(latencyHistogram, framesEncoded, PERCENTILE_50, encodeTimeMaxUs);
+    stats.encodeTimeP99Us = GetPercentile(latencyHistogram, framesEncoded, PERCENTILE_99, encodeTimeMaxUs);
+    stats.encodeTimeMaxUs = encodeTimeMaxUs;
+    stats.lockWaitTotalUs = lockWaitTotalNs / NS_PER_US;
+    stats.lockWaitMaxUs = lockWaitMaxNs / NS_PER_US;
+}
+
+void VideoEncoderStats::RecordEncode(uint64_t encodeTimeUs, uint32_t inputSize, uint32_t outputSize,
+    bool isKeyFrame)
+{
+    Add(m_framesEncoded, 1);
+    Add(m_inputBytes, inputSize);
+    Add(m_outputBytes, outputSize);
+    Add(m_encodeTimeTotalUs, encodeTimeUs);
+    Max(m_encodeTimeMaxUs, encodeTimeUs);
+    Add(m_latencyHistogram[GetLatencyBucket(encodeTimeUs)], 1);
+    if (isKeyFrame) {
+        Add(m_keyFrames, 1);
+    }
+}
+
+void VideoEncoderStats::RecordFailure()
+{
+    Add(m_encodeFailures, 1);
+}
+
+void VideoEncoderStats::RecordLockWait(uint64_t waitNs)
+{
+    Add(m_lockWaitTotalNs, waitNs);
+    Max(m_lockWaitMaxNs, waitNs);
+}
+
+void VideoEncoderStats::Reset()
+{
+    for (Counter *counter : { &m_framesEncoded, &m_encodeFailures, &m_keyFrames, &m_inputBytes, &m_outputBytes,
+        &m_encodeTimeTotalUs, &m_encodeTimeMaxUs, &m_lockWaitTotalNs, &m_lockWaitMaxNs }) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto &bucket : m_latencyHistogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void VideoEncoderStats::MergeInto(EncoderStatsSnapshot &snapshot) const
+{
+    snapshot.framesEncoded += m_framesEncoded.load(std::memory_order_relaxed);
+    snapshot.encodeFailures += m_encodeFailures.load(std::memory_order_relaxed);
+    snapshot.keyFrames += m_keyFrames.load(std::memory_order_relaxed);
+    snapshot.inputBytes += m_inputBytes.load(std::memory_order_relaxed);
+    snapshot.outputBytes += m_outputBytes.load(std::memory_order_relaxed);
+    snapshot.encodeTimeTotalUs += m_encodeTimeTotalUs.load(std::memory_order_relaxed);
+    snapshot.encodeTimeMaxUs = std::max(snapshot.encodeTimeMaxUs, m_encodeTimeMaxUs.load(std::memory_order_relaxed));
+    snapshot.lockWaitTotalNs += m_lockWaitTotalNs.load(std::memory_order_relaxed);
+    snapshot.lockWaitMaxNs = std::max(snapshot.lockWaitMaxNs, m_lockWaitMaxNs.load(std::memory_order_relaxed));
+    for (uint32_t i = 0; i < STATS_LATENCY_BUCKETS; ++i) {
+        snapshot.latencyHistogram[i] += m_latencyHistogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+VideoEncoderStatsRegistry& VideoEncoderStatsRegistry::GetInstance()
+{
+    static VideoEncoderStatsRegistry registry;
+    return registry;
+}
+
+void VideoEncoderStatsRegistry::Register(const std::shared_ptr<VideoEncoderStats> &stats)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    m_liveStats.push_back(stats);
+}
+
+void VideoEncoderStatsRegistry::Unregister(const std::shared_ptr<VideoEncoderStats> &stats)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    auto it = std::find(m_liveStats.begin(), m_liveStats.end(), stats);
+    if (it == m_liveStats.end()) {
+        return;
+    }
+    (*it)->MergeInto(m_retired);
+    (void) m_liveStats.erase(it);
+}
+
+void VideoEncoderStatsRegistry::Reset(const std::shared_ptr<VideoEncoderStats> &stats)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    stats->MergeInto(m_retired);
+    stats->Reset();
+}
+
+void VideoEncoderStatsRegistry::GetAggregate(VmiEncoderStats &stats)
+{
+    EncoderStatsSnapshot snapshot;
+    uint32_t activeEncoders = 0;
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        snapshot = m_retired;
+        for (const auto &item : m_liveStats) {
+            item->MergeInto(snapshot);
+        }
+        activeEncoders = static_cast<uint32_t>(m_liveStats.size());
+    }
+    snapshot.ToVmiStats(stats);
+    stats.activeEncoders = activeEncoders;
+}
@@ -0,0 +1,157 @@
+/*
+ * 功能说明: 编码器运行统计，在编码热路径上以无锁方式累计计数和时延直方图，并提供进程级汇总
+ */
+#ifndef VIDEO_ENCODER_STATS_H
+#define VIDEO_ENCODER_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "VideoEncoderWrapper.h"
+
+// 时延直方图: 按2的幂分段，每段再等分为4个子桶，相对误差不超过25%，单位微秒
+constexpr uint32_t STATS_LATENCY_SUB_BUCKETS = 4;
+constexpr uint32_t STATS_LATENCY_BUCKETS = 32 * STATS_LATENCY_SUB_BUCKETS;
+
+// 统计快照，用于汇总多个编码器的统计
+struct EncoderStatsSnapshot {
+    uint64_t framesEncoded = 0;
+    uint64_t encodeFailures = 0;
+    uint64_t keyFrames = 0;
+    uint64_t inputBytes = 0;
+    uint64_t outputBytes = 0;
+    uint64_t encodeTimeTotalUs = 0;
+    uint64_t encodeTimeMaxUs = 0;
+    uint64_t lockWaitTotalNs = 0;
+    uint64_t lockWaitMaxNs = 0;
+    std::array<uint64_t, STATS_LATENCY_BUCKETS> latencyHistogram = {};
+
+    /**
+     * @功能描述: 转换为对外统计结构
+     * @参数 [out] stats: 对外统计结构
+     */
+    void ToVmiStats(VmiEncoderStats &stats) const;
+};
+
+/**
+ * 单个编码器的统计。写操作要求单写者，由编码器实例锁保证，因此计数只需relaxed读改写，
+ * 无需原子读改写指令；读操作可在任意线程并发进行。
+ */
+class VideoEncoderStats {
+public:
+    VideoEncoderStats() = default;
+    ~VideoEncoderStats() = default;
+
+    /**
+     * @功能描述: 记录一帧编码成功
+     * @参数 [in] encodeTimeUs: 编码耗时，单位微秒
+     * @参数 [in] inputSize: 编码输入大小
+     * @参数 [in] outputSize: 编码输出大小
+     * @参数 [in] isKeyFrame: 是否为关键帧
+     */
+    void RecordEncode(uint64_t encodeTimeUs, uint32_t inputSize, uint32_t outputSize, bool isKeyFrame);
+
+    /**
+     * @功能描述: 记录一帧编码失败
+     */
+    void RecordFailure();
+
+    /**
+     * @功能描述: 记录一次句柄查找和实例锁等待
+     * @参数 [in] waitNs: 等待时间，单位纳秒
+     */
+    void RecordLockWait(uint64_t waitNs);
+
+    /**
+     * @功能描述: 清零统计，需持有编码器实例锁
+     */
+    void Reset();
+
+    /**
+     * @功能描述: 将统计累加到快照
+     * @参数 [in/out] snapshot: 统计快照
+     */
+    void MergeInto(EncoderStatsSnapshot &snapshot) const;
+
+private:
+    VideoEncoderStats(const VideoEncoderStats&) = delete;
+    VideoEncoderStats& operator=(const VideoEncoderStats&) = delete;
+    VideoEncoderStats(VideoEncoderStats &&) = delete;
+    VideoEncoderStats& operator=(VideoEncoderStats &&) = delete;
+
+    using Counter = std::atomic<uint64_t>;
+
+    static void Add(Counter &counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void Max(Counter &counter, uint64_t value)
+    {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    Counter m_framesEncoded = { 0 };
+    Counter m_encodeFailures = { 0 };
+    Counter m_keyFrames = { 0 };
+    Counter m_inputBytes = { 0 };
+    Counter m_outputBytes = { 0 };
+    Counter m_encodeTimeTotalUs = { 0 };
+    Counter m_encodeTimeMaxUs = { 0 };
+    Counter m_lockWaitTotalNs = { 0 };
+    Counter m_lockWaitMaxNs = { 0 };
+    std::array<Counter, STATS_LATENCY_BUCKETS> m_latencyHistogram = {};
+};
+
+// 进程级统计注册表，汇总存活编码器和已销毁编码器的统计
+class VideoEncoderStatsRegistry {
+public:
+    /**
+     * @功能描述: 获取VideoEncoderStatsRegistry单例对象
+     * @返回值: 返回值VideoEncoderStatsRegistry单例对象引用
+     */
+    static VideoEncoderStatsRegistry& GetInstance();
+
+    /**
+     * @功能描述: 注册编码器统计
+     * @参数 [in] stats: 编码器统计
+     */
+    void Register(const std::shared_ptr<VideoEncoderStats> &stats);
+
+    /**
+     * @功能描述: 注销编码器统计，其累计值计入已销毁编码器的汇总
+     * @参数 [in] stats: 编码器统计
+     */
+    void Unregister(const std::shared_ptr<VideoEncoderStats> &stats);
+
+    /**
+     * @功能描述: 清零编码器统计，清零前的累计值计入进程级汇总，需持有编码器实例锁
+     * @参数 [in] stats: 编码器统计
+     */
+    void Reset(const std::shared_ptr<VideoEncoderStats> &stats);
+
+    /**
+     * @功能描述: 获取进程级汇总统计
+     * @参数 [out] stats: 对外统计结构
+     */
+    void GetAggregate(VmiEncoderStats &stats);
+
+private:
+    VideoEncoderStatsRegistry() = default;
+    ~VideoEncoderStatsRegistry() = default;
+    VideoEncoderStatsRegistry(const VideoEncoderStatsRegistry&) = delete;
+    VideoEncoderStatsRegistry& operator=(const VideoEncoderStatsRegistry&) = delete;
+    VideoEncoderStatsRegistry(VideoEncoderStatsRegistry &&) = delete;
+    VideoEncoderStatsRegistry& operator=(VideoEncoderStatsRegistry &&) = delete;
+
+    std::mutex m_lock = {};
+    std::vector<std::shared_ptr<VideoEncoderStats>> m_liveStats = {};
+    EncoderStatsSnapshot m_retired = {};
+};
+
+#endif  // VIDEO_ENCODER_STATS_H
@@ -0,0 +1,32 @@
+/*
+ * 功能说明: 编码器内部使用的单调时钟
+ */
+#ifndef VIDEO_ENCODER_TIME_H
+#define VIDEO_ENCODER_TIME_H
+
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @功能描述: 获取单调时钟时间
+ * @返回值: 单调时钟时间，单位纳秒
+ */
+inline uint64_t GetMonotonicTimeNs()
+{
+    constexpr uint64_t nsPerSec = 1000000000ULL;
+    struct timespec ts = {};
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * nsPerSec + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @功能描述: 获取单调时钟时间
+ * @返回值: 单调时钟时间，单位微秒
+ */
+inline uint64_t GetMonotonicTimeUs()
+{
+    constexpr uint64_t nsPerUs = 1000ULL;
+    return GetMonotonicTimeNs() / nsPerUs;
+}
+
+#endif  // VIDEO_ENCODER_TIME_H
@@ -0,0 +1,203 @@
+/*
+ * 功能说明: 编码器预热池，缓存已初始化并处于重置状态的编码器实例，缩短会话启动时间
+ */
+
+#define LOG_TAG "VideoEncoderWarmPool"
+#include "VideoEncoderWarmPool.h"
+#include <algorithm>
+#include <system_error>
+#include "VideoEncoderLog.h"
+#include "VideoEncoderTime.h"
+
+namespace {
+    constexpr uint32_t IDLE_TIMEOUT_MS_DEFAULT = 60000;
+    constexpr uint32_t REAP_INTERVAL_MS_MIN = 100;
+    constexpr uint32_t REAP_INTERVAL_MS_MAX = 1000;
+    constexpr uint64_t US_PER_MS = 1000;
+}
+
+VideoEncoderWarmPool::VideoEncoderWarmPool(DestroyFunc destroyFunc) : m_destroyFunc(std::move(destroyFunc)) {}
+
+VideoEncoderWarmPool::~VideoEncoderWarmPool()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        m_isStopping = true;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool VideoEncoderWarmPool::Configure(const VmiWarmPoolConfig &config)
+{
+    std::lock_guard<std::mutex> configLck(m_configLock);
+    std::vector<Entry> evicted;
+    std::thread stoppedThread;
+    bool isOk = true;
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        m_config = config;
+        if (m_config.idleTimeoutMs == 0) {
+            m_config.idleTimeoutMs = IDLE_TIMEOUT_MS_DEFAULT;
+        }
+        TrimLocked(evicted);
+        if (m_config.maxIdleEncoders == 0) {
+            m_isStopping = true;
+            stoppedThread = std::move(m_thread);
+        } else if (!m_thread.joinable()) {
+            m_isStopping = false;
+            try {
+                m_thread = std::thread(&VideoEncoderWarmPool::Run, this);
+            } catch (const std::system_error &e) {
+                ERR("start warm pool reap thread failed: %s", e.what());
+                m_config.maxIdleEncoders = 0;
+                TrimLocked(evicted);
+                isOk = false;
+            }
+        }
+    }
+    m_cond.notify_all();
+    if (stoppedThread.joinable()) {
+        stoppedThread.join();
+    }
+    DestroyEntries(evicted);
+    INFO("warm pool configured: max idle %u, max idle per key %u, idle timeout %u ms, keep library resident %d",
+        config.maxIdleEncoders, config.maxIdlePerKey, m_config.idleTimeoutMs, config.keepLibraryResident);
+    return isOk;
+}
+
+bool VideoEncoderWarmPool::IsEnabled() const
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    return m_config.maxIdleEncoders != 0;
+}
+
+VideoEncoder *VideoEncoderWarmPool::AcquireAny(uint32_t encType, EncodeParams &params)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    if (m_config.maxIdleEncoders == 0) {
+        return nullptr;
+    }
+    for (auto it = m_idle.rbegin(); it != m_idle.rend(); ++it) {
+        if (it->encType == encType) {
+            VideoEncoder *encoder = it->encoder;
+            params = it->params;
+            (void) m_idle.erase(std::next(it).base());
+            ++m_hits;
+            return encoder;
+        }
+    }
+    ++m_misses;
+    return nullptr;
+}
+
+VideoEncoder *VideoEncoderWarmPool::AcquireExact(uint32_t encType, const EncodeParams &params)
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    for (auto it = m_idle.rbegin(); it != m_idle.rend(); ++it) {
+        if (it->encType == encType && it->params == params) {
+            VideoEncoder *encoder = it->encoder;
+            (void) m_idle.erase(std::next(it).base());
+            return encoder;
+        }
+    }
+    return nullptr;
+}
+
+bool VideoEncoderWarmPool::Release(uint32_t encType, const EncodeParams &params, VideoEncoder *encoder)
+{
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        if (m_config.maxIdleEncoders == 0) {
+            return false;
+        }
+        Entry entry;
+        entry.encType = encType;
+        entry.params = params;
+        entry.encoder = encoder;
+        entry.idleSinceUs = GetMonotonicTimeUs();
+        m_idle.push_back(entry);
+        TrimLocked(evicted);
+    }
+    DestroyEntries(evicted);
+    return true;
+}
+
+void VideoEncoderWarmPool::RecordReconfig()
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    ++m_reconfigs;
+}
+
+void VideoEncoderWarmPool::GetStats(VmiWarmPoolStats &stats) const
+{
+    std::lock_guard<std::mutex> lck(m_lock);
+    stats.idleEncoders = static_cast<uint32_t>(m_idle.size());
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.reconfigs = m_reconfigs;
+    stats.evictions = m_evictions;
+}
+
+void VideoEncoderWarmPool::TrimLocked(std::vector<Entry> &evicted)
+{
+    // 从最近放回的开始保留，同一类型和参数超出单独上限的以及超出总数上限的淘汰
+    std::vector<Entry> kept;
+    for (auto it = m_idle.rbegin(); it != m_idle.rend(); ++it) {
+        bool isOverLimit = kept.size() >= m_config.maxIdleEncoders;
+        if (!isOverLimit && m_config.maxIdlePerKey != 0) {
+            auto sameKey = std::count_if(kept.begin(), kept.end(), [&it](const Entry &entry) {
+                return entry.encType == it->encType && entry.params == it->params;
+            });
+            isOverLimit = static_cast<uint32_t>(sameKey) >= m_config.maxIdlePerKey;
+        }
+        if (isOverLimit) {
+            evicted.push_back(*it);
+        } else {
+            kept.push_back(*it);
+        }
+    }
+    std::reverse(kept.begin(), kept.end());
+    m_idle.swap(kept);
+    m_evictions += evicted.size();
+}
+
+void VideoEncoderWarmPool::DestroyEntries(std::vector<Entry> &entries)
+{
+    for (auto &entry : entries) {
+        m_destroyFunc(entry.encType, entry.encoder);
+    }
+    entries.clear();
+}
+
+void VideoEncoderWarmPool::Run()
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    while (!m_isStopping) {
+        uint32_t intervalMs = std::max(REAP_INTERVAL_MS_MIN, std::min(REAP_INTERVAL_MS_MAX, m_config.idleTimeoutMs / 2));
+        (void) m_cond.wait_for(lck, std::chrono::milliseconds(intervalMs));
+        if (m_isStopping) {
+            break;
+        }
+        uint64_t nowUs = GetMonotonicTimeUs();
+        uint64_t timeoutUs = m_config.idleTimeoutMs * US_PER_MS;
+        std::vector<Entry> expired;
+        auto it = m_idle.begin();
+        while (it != m_idle.end() && nowUs - it->idleSinceUs >= timeoutUs) {
+            expired.push_back(*it);
+            ++it;
+        }
+        if (expired.empty()) {
+            continue;
+        }
+        (void) m_idle.erase(m_idle.begin(), it);
+        m_evictions += expired.size();
+        lck.unlock();
+        DBG("warm pool evict %zu idle encoders", expired.size());
+        DestroyEntries(expired);
+        lck.lock();
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * 功能说明: 编码器预热池，缓存已初始化并处于重置状态的编码器实例，缩短会话启动时间
+ */
+#ifndef VIDEO_ENCODER_WARM_POOL_H
+#define VIDEO_ENCODER_WARM_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VideoCodecApi.h"
+#include "VideoEncoderWrapper.h"
+
+class VideoEncoderWarmPool {
+public:
+    // 销毁编码器实例的函数，在不持有预热池锁的情况下调用
+    using DestroyFunc = std::function<void(uint32_t encType, VideoEncoder *encoder)>;
+
+    explicit VideoEncoderWarmPool(DestroyFunc destroyFunc);
+
+    /**
+     * @功能描述: 析构函数，停止空闲回收线程，池中编码器不再销毁
+     */
+    ~VideoEncoderWarmPool();
+
+    /**
+     * @功能描述: 配置预热池，超出新上限的空闲编码器立即销毁，上限为0时关闭预热池并等待回收线程退出，
+     *            并发调用按顺序执行
+     * @参数 [in] config: 预热池配置
+     * @返回值: true 成功，false 启动空闲回收线程失败
+     */
+    bool Configure(const VmiWarmPoolConfig &config);
+
+    /**
+     * @功能描述: 预热池是否开启
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @功能描述: 取出一个指定类型的空闲编码器，优先取最近放回的
+     * @参数 [in] encType: 编码器类型
+     * @参数 [out] params: 取得的编码器当前的编码参数
+     * @返回值: 编码器实例，无可用编码器时返回空
+     */
+    VideoEncoder *AcquireAny(uint32_t encType, EncodeParams &params);
+
+    /**
+     * @功能描述: 取出一个类型和编码参数均相同的空闲编码器
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] params: 编码参数
+     * @返回值: 编码器实例，无可用编码器时返回空
+     */
+    VideoEncoder *AcquireExact(uint32_t encType, const EncodeParams &params);
+
+    /**
+     * @功能描述: 放回一个已停止并重置的编码器，超出上限时销毁最久未使用的空闲编码器
+     * @参数 [in] encType: 编码器类型
+     * @参数 [in] params: 编码器当前的编码参数
+     * @参数 [in] encoder: 编码器实例
+     * @返回值: true 已放入池中，false 预热池未开启，调用者负责销毁
+     */
+    bool Release(uint32_t encType, const EncodeParams &params, VideoEncoder *encoder);
+
+    /**
+     * @功能描述: 记录一次初始化时对池中编码器重设参数
+     */
+    void RecordReconfig();
+
+    /**
+     * @功能描述: 获取预热池统计
+     * @参数 [out] stats: 预热池统计
+     */
+    void GetStats(VmiWarmPoolStats &stats) const;
+
+private:
+    VideoEncoderWarmPool(const VideoEncoderWarmPool&) = delete;
+    VideoEncoderWarmPool& operator=(const VideoEncoderWarmPool&) = delete;
+    VideoEncoderWarmPool(VideoEncoderWarmPool &&) = delete;
+    VideoEncoderWarmPool& operator=(VideoEncoderWarmPool &&) = delete;
+
+    struct Entry {
+        uint32_t encType = 0;
+        EncodeParams params = {};
+        VideoEncoder *encoder = nullptr;
+        uint64_t idleSinceUs = 0;
+    };
+
+    void TrimLocked(std::vector<Entry> &evicted);
+    void DestroyEntries(std::vector<Entry> &entries);
+    void Run();
+
+    DestroyFunc m_destroyFunc;
+    // 串行化Configure，跨越回收线程的join持有，避免并发的开启在旧回收线程退出前复位m_isStopping
+    std::mutex m_configLock = {};
+    mutable std::mutex m_lock = {};
+    std::condition_variable m_cond = {};
+    VmiWarmPoolConfig m_config = {};
+    std::vector<Entry> m_idle = {};  // 按放回时间排序，首个为最久未使用
+    std::thread m_thread;
+    bool m_isStopping = false;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_reconfigs = 0;
+    uint64_t m_evictions = 0;
+};
+
+#endif  // VIDEO_ENCODER_WARM_POOL_H
@@ -0,0 +1,86 @@
+/*
+ * 功能说明: 固定并行度的工作线程组，调用线程与各工作线程分别执行同一任务的不同下标，全部完成后返回，
+ *           用于帧内按行分带转换和联播各层并行编码
+ */
+
+#define LOG_TAG "VideoEncoderWorkerGroup"
+#include "VideoEncoderWorkerGroup.h"
+#include <system_error>
+#include "VideoEncoderLog.h"
+
+VideoEncoderWorkerGroup::~VideoEncoderWorkerGroup()
+{
+    Stop();
+}
+
+uint32_t VideoEncoderWorkerGroup::Resize(uint32_t count)
+{
+    if (count == 0) {
+        count = 1;
+    }
+    if (count == GetCount()) {
+        return count;
+    }
+    Stop();
+    for (uint32_t index = 1; index < count; ++index) {
+        try {
+            m_threads.emplace_back(&VideoEncoderWorkerGroup::Loop, this, index, m_generation);
+        } catch (const std::system_error &e) {
+            WARN("start worker thread failed: %s, parallelism %u", e.what(), GetCount());
+            break;
+        }
+    }
+    return GetCount();
+}
+
+void VideoEncoderWorkerGroup::Run(const Task &task)
+{
+    if (m_threads.empty()) {
+        task(0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        m_task = &task;
+        m_pending = static_cast<uint32_t>(m_threads.size());
+        ++m_generation;
+    }
+    m_cond.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lck(m_lock);
+    m_doneCond.wait(lck, [this] { return m_pending == 0; });
+    m_task = nullptr;
+}
+
+void VideoEncoderWorkerGroup::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_lock);
+        m_isStopping = true;
+    }
+    m_cond.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    m_isStopping = false;
+}
+
+void VideoEncoderWorkerGroup::Loop(uint32_t index, uint64_t generation)
+{
+    std::unique_lock<std::mutex> lck(m_lock);
+    while (true) {
+        m_cond.wait(lck, [this, generation] { return m_isStopping || m_generation != generation; });
+        if (m_isStopping) {
+            return;
+        }
+        generation = m_generation;
+        const Task *task = m_task;
+        lck.unlock();
+        (*task)(index);
+        lck.lock();
+        if (--m_pending == 0) {
+            m_doneCond.notify_one();
+        }
+    }
+}
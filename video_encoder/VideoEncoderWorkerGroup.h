@@ -0,0 +1,64 @@
+/*
+ * 功能说明: 固定并行度的工作线程组，调用线程与各工作线程分别执行同一任务的不同下标，全部完成后返回，
+ *           用于帧内按行分带转换和联播各层并行编码
+ */
+#ifndef VIDEO_ENCODER_WORKER_GROUP_H
+#define VIDEO_ENCODER_WORKER_GROUP_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class VideoEncoderWorkerGroup {
+public:
+    using Task = std::function<void(uint32_t index)>;
+
+    VideoEncoderWorkerGroup() = default;
+
+    /**
+     * @功能描述: 析构函数，停止工作线程
+     */
+    ~VideoEncoderWorkerGroup();
+
+    /**
+     * @功能描述: 调整并行度，创建线程失败时以已创建的线程数为准，不能与Run并发调用
+     * @参数 [in] count: 并行度，包括调用线程
+     * @返回值: 实际并行度
+     */
+    uint32_t Resize(uint32_t count);
+
+    /**
+     * @功能描述: 并行执行任务，下标0在调用线程上执行，其余下标各在一个工作线程上执行，全部完成后返回，
+     *            不能并发调用
+     * @参数 [in] task: 任务，参数为下标，取值范围[0, GetCount())
+     */
+    void Run(const Task &task);
+
+    uint32_t GetCount() const
+    {
+        return static_cast<uint32_t>(m_threads.size()) + 1;
+    }
+
+private:
+    VideoEncoderWorkerGroup(const VideoEncoderWorkerGroup&) = delete;
+    VideoEncoderWorkerGroup& operator=(const VideoEncoderWorkerGroup&) = delete;
+    VideoEncoderWorkerGroup(VideoEncoderWorkerGroup &&) = delete;
+    VideoEncoderWorkerGroup& operator=(VideoEncoderWorkerGroup &&) = delete;
+
+    void Stop();
+    void Loop(uint32_t index, uint64_t generation);
+
+    std::vector<std::thread> m_threads = {};
+    std::mutex m_lock = {};
+    std::condition_variable m_cond = {};      // 通知工作线程开始新任务或退出
+    std::condition_variable m_doneCond = {};  // 通知调用线程各工作线程已完成
+    const Task *m_task = nullptr;
+    uint64_t m_generation = 0;
+    uint32_t m_pending = 0;
+    bool m_isStopping = false;
+};
+
+#endif  // VIDEO_ENCODER_WORKER_GROUP_H
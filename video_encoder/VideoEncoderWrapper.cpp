@@ -4,25 +4,148 @@
 
 #define LOG_TAG "VideoEncoderWrapper"
 #include "VideoEncoderWrapper.h"
-#include <unordered_map>
 #include <string>
 #include <memory>
+#include <new>
+#include <algorithm>
+#include <cstring>
 #include <atomic>
 #include <mutex>
+#include <vector>
 #include <dlfcn.h>
 #include <cinttypes>
 #include <sys/system_properties.h>
 #include "VideoCodecApi.h"
 #include "VideoEncoderLog.h"
+#include "VideoEncoderHandleTable.h"
+#include "VideoEncoderAsyncWorker.h"
+#include "VideoEncoderBufferPool.h"
+#include "VideoEncoderCapture.h"
+#include "VideoEncoderColorConverter.h"
+#include "VideoEncoderDirtyDetector.h"
+#include "VideoEncoderExecutor.h"
+#include "VideoEncoderFrameRing.h"
+#include "VideoEncoderFrameTrace.h"
+#include "VideoEncoderNalParser.h"
+#include "VideoEncoderOutputRing.h"
+#include "VideoEncoderRateControl.h"
+#include "VideoEncoderScaler.h"
+#include "VideoEncoderScheduler.h"
+#include "VideoEncoderStats.h"
+#include "VideoEncoderTime.h"
+#include "VideoEncoderWarmPool.h"
+#include "VideoEncoderWorkerGroup.h"
 
 namespace {
-    constexpr uint32_t INVALID_ENCODER_HANDLE = 0;
-    std::atomic<uint32_t> g_encHandle = { INVALID_ENCODER_HANDLE };
     struct EncoderObject {
+        std::mutex lock = {};  // 实例锁，串行化同一编码器上的所有操作
         uint32_t encType = 0;
-        VideoEncoder *encoder = nullptr;
+        VideoEncoder *encoder = nullptr;  // 编码器销毁后置空
+        // 保护以下附属对象指针，这些对象会在不持有实例锁的情况下被访问，避免与正在进行的编码互相阻塞
+        std::mutex attachLock = {};
+        std::shared_ptr<VideoEncoderAsyncWorker> asyncWorker = nullptr;
+        std::shared_ptr<VideoEncoderRateController> rateController = nullptr;
+        std::shared_ptr<VideoEncoderStats> stats = nullptr;  // 创建后不再改变，读取统计时不持有实例锁
+        bool isInitialized = false;
+        bool isStarted = false;
+        bool isWarm = false;  // 从预热池取得且尚未初始化，params为池中编码器当前的参数
+        EncodeParams params = {};
+        uint64_t pixelRate = 0;  // 计入调度负载的每秒编码像素数
+        bool isInputPoolEnabled = false;
+        VmiBufferPoolConfig inputPoolConfig = {};
+        VideoEncoderBufferPool inputPool;  // 自带锁，获取/归还缓冲区时不持有实例锁
+        bool isOutputRingEnabled = false;
+        VideoEncoderOutputRing outputRing;  // 自带锁，释放槽位时不持有实例锁
+        VideoEncoderNalParser nalParser;  // 自带锁，获取参数集时不持有实例锁
+        std::unique_ptr<VideoEncoderDirtyDetector> dirtyDetector = nullptr;
+        VmiDirtyDetectConfig dirtyDetectConfig = {};
+        bool isKeyFramePending = true;  // 下一帧将被编码为I帧，不能跳过
+        uint64_t lastEncodeUs = 0;
+        VmiInputFormat inputFormat = {};
+        std::unique_ptr<VideoEncoderColorConverter> colorConverter = nullptr;  // 输入为编码器原生格式时为空
+        std::unique_ptr<VideoEncoderCaptureWriter> capture = nullptr;  // 未开始抓取时为空
+        uint64_t frameSeq = 0;  // 编码调用序号，作为逐帧追踪的键
     };
-    std::unordered_map<uint32_t, EncoderObject> g_vencHandleMap = {};
+    // 句柄低10位为槽位下标，最多同时存在1024个编码器实例
+    constexpr uint32_t ENCODER_HANDLE_INDEX_BITS = 10;
+    using EncoderHandleTable = VideoEncoderHandleTable<EncoderObject, ENCODER_HANDLE_INDEX_BITS>;
+    EncoderHandleTable g_encoderTable;
+
+    // 持有实例锁的编码器对象引用，编码器已销毁时视为无效
+    class EncoderObjectRef {
+    public:
+        explicit EncoderObjectRef(std::shared_ptr<EncoderObject> encObj) : m_encObj(std::move(encObj))
+        {
+            if (m_encObj != nullptr) {
+                m_lck = std::unique_lock<std::mutex>(m_encObj->lock);
+            }
+        }
+
+        explicit operator bool() const
+        {
+            return m_encObj != nullptr && m_encObj->encoder != nullptr;
+        }
+
+        EncoderObject *operator->() const
+        {
+            return m_encObj.get();
+        }
+
+        EncoderObject &operator*() const
+        {
+            return *m_encObj;
+        }
+
+    private:
+        std::shared_ptr<EncoderObject> m_encObj;
+        std::unique_lock<std::mutex> m_lck;
+    };
+
+    EncoderObjectRef AcquireEncoder(uint32_t encHandle)
+    {
+        return EncoderObjectRef(g_encoderTable.Find(encHandle));
+    }
+
+    // 编码调用使用，追踪句柄查找和锁等待，取得实例锁后分配帧序号
+    EncoderObjectRef AcquireEncoder(uint32_t encHandle, FrameTraceKey &traceKey)
+    {
+        VideoEncoderTraceSpan lookupSpan(FRAME_TRACE_LOOKUP, traceKey);
+        auto found = g_encoderTable.Find(encHandle);
+        lookupSpan.End();
+        VideoEncoderTraceSpan lockSpan(FRAME_TRACE_LOCK_WAIT, traceKey);
+        EncoderObjectRef encObj(std::move(found));
+        lockSpan.End();
+        if (encObj) {
+            traceKey.frameSeq = ++encObj->frameSeq;
+        }
+        return encObj;
+    }
+
+    std::shared_ptr<VideoEncoderAsyncWorker> GetAsyncWorker(uint32_t encHandle)
+    {
+        auto encObj = g_encoderTable.Find(encHandle);
+        if (encObj == nullptr) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lck(encObj->attachLock);
+        return encObj->asyncWorker;
+    }
+
+    std::shared_ptr<VideoEncoderRateController> GetRateController(EncoderObject &encObj)
+    {
+        std::lock_guard<std::mutex> lck(encObj.attachLock);
+        return encObj.rateController;
+    }
+
+    std::shared_ptr<VideoEncoderAsyncWorker> DetachAsyncWorker(uint32_t encHandle)
+    {
+        auto encObj = g_encoderTable.Find(encHandle);
+        if (encObj == nullptr) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lck(encObj->attachLock);
+        return std::move(encObj->asyncWorker);
+    }
 
     std::string PROP_ENCODER_TYPE = "vmi.demo.video.encoder.type";
 
@@ -38,17 +161,41 @@ namespace {
     DestroyVideoEncoderFuncPtr g_destroyVideoEncoder = nullptr;
     void *g_libHandle = nullptr;
     std::atomic<bool> g_isVideoCodecLoaded = { false };
-    std::mutex g_instanceLock = {};
-
-    std::unordered_map<int, int> g_logLevelMap = {
-        { LOG_LEVEL_DEBUG, ANDROID_LOG_DEBUG },
-        { LOG_LEVEL_INFO, ANDROID_LOG_INFO },
-        { LOG_LEVEL_WARN, ANDROID_LOG_WARN },
-        { LOG_LEVEL_ERROR, ANDROID_LOG_ERROR },
-        { LOG_LEVEL_FATAL, ANDROID_LOG_FATAL },
+    // 保护编解码库加载/卸载、编码器实例创建/销毁以及存活实例计数，不参与编码热路径
+    std::mutex g_codecLibLock = {};
+    uint32_t g_liveEncoderCount = 0;  // 包括预热池中的空闲编码器
+    bool g_isCodecLibResident = false;
+
+    // 按MediaLogLevel下标映射到Android日志级别，只读，编解码库线程可并发查询
+    constexpr int LOG_LEVEL_MAP[] = {
+        ANDROID_LOG_DEBUG,  // LOG_LEVEL_DEBUG
+        ANDROID_LOG_INFO,   // LOG_LEVEL_INFO
+        ANDROID_LOG_WARN,   // LOG_LEVEL_WARN
+        ANDROID_LOG_ERROR,  // LOG_LEVEL_ERROR
+        ANDROID_LOG_FATAL,  // LOG_LEVEL_FATAL
     };
 
     constexpr uint32_t GOP_SIZE_DEFAULT = 300;
+    constexpr uint32_t OUTPUT_RING_SLOT_COUNT_DEFAULT = 4;
+    constexpr uint32_t OUTPUT_RING_SLOT_COUNT_MAX = 64;
+}
+
+uint32_t GetInputFrameSize(uint32_t width, uint32_t height)
+{
+    // YUV420: 一个全分辨率亮度平面和两个宽高各减半的色度平面
+    uint64_t lumaSize = static_cast<uint64_t>(width) * height;
+    uint64_t chromaSize = static_cast<uint64_t>((width + 1) / 2) * ((height + 1) / 2);
+    uint64_t frameSize = lumaSize + 2 * chromaSize;
+    return (frameSize > UINT32_MAX) ? 0 : static_cast<uint32_t>(frameSize);
+}
+
+EncodeParams ToEncodeParams(const VmiEncodeParams &encParams)
+{
+    EncodeParams params = {
+        encParams.frameRate, encParams.bitrate, (encParams.gopSize == 0) ? GOP_SIZE_DEFAULT : encParams.gopSize,
+        encParams.profile, encParams.width, encParams.height
+    };
+    return params;
 }
 
 void UnloadVideoCodecSharedLib()
@@ -103,65 +250,375 @@ bool LoadVideoCodecSharedLib()
 
 void MediaLogCallback(int level, const char *tag, const char *fmt)
 {
-    int vmiLevel = g_logLevelMap[level];
-    if (vmiLevel < VideoEncoderLog::GetInstance().GetLogLevel() || vmiLevel > ANDROID_LOG_SILENT || fmt == nullptr) {
+    if (level < LOG_LEVEL_DEBUG || level > LOG_LEVEL_FATAL) {
         return;
     }
-    (void) __android_log_write(vmiLevel, tag, fmt);
+    VmiLogWrite(LOG_LEVEL_MAP[level], tag, fmt);
 }
 
 /**
- * @功能描述: 创建编码器
- * @参数 [out] encHandle: 编码器对象句柄
- * @返回值: VMI_ENCODER_SUCCESS 成功
- *          VMI_ENCODER_CREATE_FAIL 创建编码器失败
+ * @功能描述: 读取系统属性配置的编码器类型
+ * @参数 [out] encType: 编码器类型
+ * @返回值: true 成功，false 属性不存在或取值非法
  */
-VmiEncoderRetCode VencCreateEncoder(uint32_t *encHandle)
+bool GetEncoderTypeProperty(uint32_t &encType)
 {
-    ++g_encHandle;
-    if (g_encHandle == INVALID_ENCODER_HANDLE) {
-        ERR("VencCreateEncoder failed: encoder handle exceeds max instances");
-        return VMI_ENCODER_CREATE_FAIL;
-    }
     char prop[PROP_VALUE_MAX] = {'\0'};
     int len = __system_property_get(PROP_ENCODER_TYPE.c_str(), prop);
     if (len == 0) {
-        ERR("VencCreateEncoder failed: get system property[%s] failed", PROP_ENCODER_TYPE.c_str());
-        return VMI_ENCODER_CREATE_FAIL;
+        ERR("get system property[%s] failed", PROP_ENCODER_TYPE.c_str());
+        return false;
     }
     char *end = nullptr;
     intmax_t result = strtoimax(prop, &end, 0);
     if (prop == end || (result < INT32_MIN || result > INT32_MAX)) {
-        ERR("VencCreateEncoder failed: property[%s]'s value[%s] is not in range of int32",
-            PROP_ENCODER_TYPE.c_str(), prop);
-        return VMI_ENCODER_CREATE_FAIL;
+        ERR("property[%s]'s value[%s] is not in range of int32", PROP_ENCODER_TYPE.c_str(), prop);
+        return false;
     }
-    auto encType = static_cast<uint32_t>(result);
-    std::unique_lock<std::mutex> lck(g_instanceLock);
-    VideoEncoder *encoder = nullptr;
+    encType = static_cast<uint32_t>(result);
+    return true;
+}
+
+/**
+ * @功能描述: 按需加载编解码库并创建厂商编码器实例
+ * @参数 [in] encType: 编码器类型
+ * @返回值: 编码器实例，失败时返回空
+ */
+VideoEncoder *CreateVendorEncoder(uint32_t encType)
+{
+    std::lock_guard<std::mutex> lck(g_codecLibLock);
     if (!g_isVideoCodecLoaded) {
         if (!LoadVideoCodecSharedLib()) {
-            ERR("VencCreateEncoder failed: load video codec shared lib failed");
-            return VMI_ENCODER_CREATE_FAIL;
+            ERR("load video codec shared lib failed");
+            return nullptr;
         }
         (*g_registerMediaLogCallback)(MediaLogCallback);
     }
+    VideoEncoder *encoder = nullptr;
     auto createRet = (*g_createVideoEncoder)(encType, &encoder);
     if (createRet != VIDEO_ENCODER_SUCCESS || encoder == nullptr) {
-        ERR("VencCreateEncoder failed: create video encoder failed %#x", createRet);
+        ERR("create video encoder failed %#x", createRet);
+        if (g_liveEncoderCount == 0 && !g_isCodecLibResident) {
+            UnloadVideoCodecSharedLib();
+        }
+        return nullptr;
+    }
+    ++g_liveEncoderCount;
+    return encoder;
+}
+
+/**
+ * @功能描述: 销毁厂商编码器实例，最后一个实例销毁且未要求常驻时卸载编解码库
+ * @参数 [in] encType: 编码器类型
+ * @参数 [in] encoder: 编码器实例
+ */
+void DestroyVendorEncoder(uint32_t encType, VideoEncoder *encoder)
+{
+    std::lock_guard<std::mutex> lck(g_codecLibLock);
+    encoder->DestroyEncoder();
+    (void) (*g_destroyVideoEncoder)(encType, encoder);
+    if (--g_liveEncoderCount == 0 && !g_isCodecLibResident) {
+        UnloadVideoCodecSharedLib();
+    }
+}
+
+namespace {
+    // 定义在g_codecLibLock之后，进程退出时先于其析构
+    VideoEncoderWarmPool g_warmPool(DestroyVendorEncoder);
+}
+
+/**
+ * @功能描述: 创建指定类型的编码器对象，优先从预热池取得编码器
+ * @参数 [in] encType: 编码器类型
+ * @参数 [out] encHandle: 编码器对象句柄
+ * @参数 [in] reservedPixelRate: 已在调度器中预留的每秒编码像素数，为空时不经容量检查直接计入会话；
+ *                               创建失败时释放预留，成功时该预留由编码器对象持有，销毁时释放
+ * @返回值: true 成功，false 失败
+ */
+bool CreateEncoderObject(uint32_t encType, uint32_t &encHandle, const uint64_t *reservedPixelRate = nullptr)
+{
+    auto &scheduler = VideoEncoderScheduler::GetInstance();
+    EncodeParams warmParams = {};
+    VideoEncoder *encoder = g_warmPool.AcquireAny(encType, warmParams);
+    bool isWarm = (encoder != nullptr);
+    if (!isWarm) {
+        encoder = CreateVendorEncoder(encType);
+        if (encoder == nullptr) {
+            ERR("create video encoder of type %u failed", encType);
+            if (reservedPixelRate != nullptr) {
+                scheduler.CancelReservation(encType, *reservedPixelRate);
+            }
+            scheduler.OnFailure(encType, false);
+            return false;
+        }
+    }
+    std::shared_ptr<EncoderObject> encObj(new (std::nothrow) EncoderObject());
+    std::shared_ptr<VideoEncoderStats> stats(new (std::nothrow) VideoEncoderStats());
+    uint32_t handle = EncoderHandleTable::INVALID_HANDLE;
+    if (encObj != nullptr && stats != nullptr) {
+        encObj->encType = encType;
+        encObj->encoder = encoder;
+        encObj->stats = stats;
+        encObj->isWarm = isWarm;
+        encObj->params = warmParams;
+        // 初始化时按实际参数从预留值调整负载
+        encObj->pixelRate = (reservedPixelRate != nullptr) ? *reservedPixelRate : 0;
+        handle = g_encoderTable.Insert(std::move(encObj));
+    }
+    if (handle == EncoderHandleTable::INVALID_HANDLE) {
+        ERR("encoder handle exceeds max instances %u", EncoderHandleTable::CAPACITY);
+        if (!isWarm || !g_warmPool.Release(encType, warmParams, encoder)) {
+            DestroyVendorEncoder(encType, encoder);
+        }
+        if (reservedPixelRate != nullptr) {
+            scheduler.CancelReservation(encType, *reservedPixelRate);
+        }
+        return false;
+    }
+    VideoEncoderStatsRegistry::GetInstance().Register(stats);
+    if (reservedPixelRate == nullptr) {
+        scheduler.OnSessionCreated(encType);
+    }
+    encHandle = handle;
+    return true;
+}
+
+/**
+ * @功能描述: 创建编码器
+ * @参数 [out] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CREATE_FAIL 创建编码器失败
+ */
+VmiEncoderRetCode VencCreateEncoder(uint32_t *encHandle)
+{
+    if (encHandle == nullptr) {
+        ERR("VencCreateEncoder failed: encoder handle is null");
+        return VMI_ENCODER_CREATE_FAIL;
+    }
+    uint32_t encType = 0;
+    if (!GetEncoderTypeProperty(encType)) {
+        ERR("VencCreateEncoder failed: get encoder type failed");
+        return VMI_ENCODER_CREATE_FAIL;
+    }
+    if (!CreateEncoderObject(encType, *encHandle)) {
+        ERR("VencCreateEncoder failed: create encoder object failed");
         return VMI_ENCODER_CREATE_FAIL;
     }
-    EncoderObject encObj = { encType, encoder };
-    auto ret = g_vencHandleMap.emplace(g_encHandle, encObj);
-    if (!ret.second) {
-        ERR("VencCreateEncoder failed: video encoder object insert into map failed");
-        (void) (*g_destroyVideoEncoder)(encType, encoder);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 按候选编码器类型创建并初始化编码器，创建或初始化失败时回退到下一候选
+ * @参数 [in] selectConfig: 编码器类型选择配置
+ * @参数 [in] encParams: 编码参数结构体
+ * @参数 [out] encHandle: 编码器对象句柄
+ * @参数 [out] encType: 实际使用的编码器类型，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CREATE_FAIL 所有候选类型均创建或初始化失败
+ */
+VmiEncoderRetCode VencCreateEncoderEx(const VmiEncoderSelectConfig *selectConfig, const VmiEncodeParams encParams,
+    uint32_t *encHandle, uint32_t *encType)
+{
+    if (selectConfig == nullptr || encHandle == nullptr) {
+        ERR("VencCreateEncoderEx failed: select config or encoder handle is null");
         return VMI_ENCODER_CREATE_FAIL;
     }
-    *encHandle = g_encHandle;
+    VmiEncoderSelectConfig config = *selectConfig;
+    if (config.typeCount == 0) {
+        if (!GetEncoderTypeProperty(config.encTypes[0])) {
+            ERR("VencCreateEncoderEx failed: get encoder type failed");
+            return VMI_ENCODER_CREATE_FAIL;
+        }
+        config.typeCount = 1;
+    }
+    auto &scheduler = VideoEncoderScheduler::GetInstance();
+    uint64_t pixelRate = VideoEncoderScheduler::GetPixelRate(encParams.width, encParams.height, encParams.frameRate);
+    std::vector<uint32_t> candidates = scheduler.Select(config, pixelRate);
+    std::vector<uint32_t> failedTypes;
+    for (uint32_t candidate : candidates) {
+        // Select之后其他线程可能已占用剩余容量，预留成功才创建，并发创建合计不超过上限
+        if (!scheduler.TryReserve(candidate, pixelRate)) {
+            continue;
+        }
+        uint32_t handle = EncoderHandleTable::INVALID_HANDLE;
+        if (!CreateEncoderObject(candidate, handle, &pixelRate)) {
+            failedTypes.push_back(candidate);
+            continue;
+        }
+        if (VencInitEncoder(handle, encParams) != VMI_ENCODER_SUCCESS) {
+            (void) VencDestroyEncoder(handle);
+            scheduler.OnFailure(candidate, true);
+            failedTypes.push_back(candidate);
+            continue;
+        }
+        scheduler.OnPlaced(candidate, failedTypes);
+        if (!failedTypes.empty()) {
+            WARN("video encoder %#x falls back to type %u after %zu failed types", handle, candidate,
+                failedTypes.size());
+        }
+        *encHandle = handle;
+        if (encType != nullptr) {
+            *encType = candidate;
+        }
+        return VMI_ENCODER_SUCCESS;
+    }
+    ERR("VencCreateEncoderEx failed: %zu of %u encoder types available, all failed", candidates.size(),
+        config.typeCount);
+    return VMI_ENCODER_CREATE_FAIL;
+}
+
+/**
+ * @功能描述: 配置编码器类型的容量上限
+ * @参数 [in] encType: 编码器类型
+ * @参数 [in] config: 容量配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SCHEDULER_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigEncoderBackend(uint32_t encType, const VmiEncoderBackendConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencConfigEncoderBackend failed: encoder type %u config is null", encType);
+        return VMI_ENCODER_SCHEDULER_FAIL;
+    }
+    VideoEncoderScheduler::GetInstance().Configure(encType, *config);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取编码器类型的调度统计
+ * @参数 [in] encType: 编码器类型
+ * @参数 [out] stats: 调度统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SCHEDULER_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetEncoderBackendStats(uint32_t encType, VmiEncoderBackendStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetEncoderBackendStats failed: encoder type %u stats is null", encType);
+        return VMI_ENCODER_SCHEDULER_FAIL;
+    }
+    VideoEncoderScheduler::GetInstance().GetStats(encType, *stats);
     return VMI_ENCODER_SUCCESS;
 }
 
+/**
+ * @功能描述: 持有实例锁时更新编码参数，并同步调度器中该会话的负载
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] params: 编码参数
+ */
+void UpdateParamsLocked(const EncoderObjectRef &encObj, const EncodeParams &params)
+{
+    bool isResized = (params.width != encObj->params.width) || (params.height != encObj->params.height);
+    encObj->params = params;
+    if (isResized) {
+        encObj->nalParser.Clear();
+    }
+    if (encObj->capture != nullptr) {
+        encObj->capture->RecordParams(params);
+    }
+    if (isResized && encObj->dirtyDetector != nullptr && !encObj->dirtyDetector->Init(params.width, params.height)) {
+        WARN("resize dirty detector failed, dirty detect is disabled");
+        encObj->dirtyDetector = nullptr;
+    }
+    // 转换失败时保留转换器，之后的编码因输入无法转换而失败，避免把非原生格式的数据送给编码器
+    if (isResized && encObj->colorConverter != nullptr &&
+        !encObj->colorConverter->Init(encObj->inputFormat, params.width, params.height)) {
+        ERR("resize color converter failed, encode will fail until input format is reset");
+    }
+    uint64_t pixelRate = VideoEncoderScheduler::GetPixelRate(params.width, params.height, params.frameRate);
+    VideoEncoderScheduler::GetInstance().OnSessionLoadChanged(encObj->encType, encObj->pixelRate, pixelRate);
+    encObj->pixelRate = pixelRate;
+    std::lock_guard<std::mutex> lck(encObj->attachLock);
+    if (encObj->asyncWorker != nullptr) {
+        encObj->asyncWorker->SetFrameRate(params.frameRate);
+    }
+}
+
+/**
+ * @功能描述: 持有实例锁时初始化从预热池取得的编码器。参数与池中编码器一致时跳过初始化，
+ *            否则优先换用池中参数一致的编码器，都没有时对当前编码器重设参数
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] params: 编码参数
+ * @返回值: true 成功，false 失败
+ */
+bool InitWarmEncoderLocked(const EncoderObjectRef &encObj, uint32_t encHandle, const EncodeParams &params)
+{
+    encObj->isWarm = false;
+    if (params == encObj->params) {
+        return true;
+    }
+    VideoEncoder *encoder = g_warmPool.AcquireExact(encObj->encType, params);
+    if (encoder != nullptr) {
+        if (!g_warmPool.Release(encObj->encType, encObj->params, encObj->encoder)) {
+            DestroyVendorEncoder(encObj->encType, encObj->encoder);
+        }
+        encObj->encoder = encoder;
+        return true;
+    }
+    g_warmPool.RecordReconfig();
+    EncoderRetCode ret = encObj->encoder->SetEncodeParams(params);
+    if (ret == VIDEO_ENCODER_SUCCESS) {
+        return true;
+    }
+    WARN("video encoder %#x reconfig pooled encoder error %#x, init again", encHandle, ret);
+    ret = encObj->encoder->InitEncoder(params);
+    if (ret != VIDEO_ENCODER_SUCCESS) {
+        ERR("video encoder %#x init encoder error %#x", encHandle, ret);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @功能描述: 持有实例锁时获取一帧输入数据的大小，设置了输入格式时按输入格式计算
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @返回值: 一帧输入数据大小
+ */
+uint32_t GetInputBufferSizeLocked(const EncoderObjectRef &encObj)
+{
+    if (encObj->colorConverter != nullptr) {
+        return encObj->colorConverter->GetInputSize();
+    }
+    return GetInputFrameSize(encObj->params.width, encObj->params.height);
+}
+
+/**
+ * @功能描述: 持有实例锁时按当前编码参数设置输入格式，原生格式不创建转换器
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputFormat: 输入格式
+ * @返回值: true 成功，false 输入格式无效或创建转换器失败
+ */
+bool SetInputFormatLocked(const EncoderObjectRef &encObj, uint32_t encHandle, const VmiInputFormat &inputFormat)
+{
+    encObj->inputFormat = inputFormat;
+    if (VideoEncoderColorConverter::IsNativeFormat(inputFormat, encObj->params.width)) {
+        encObj->colorConverter = nullptr;
+        if (encObj->capture != nullptr) {
+            encObj->capture->RecordInputFormat(inputFormat);
+        }
+        return true;
+    }
+    if (encObj->colorConverter == nullptr) {
+        encObj->colorConverter.reset(new (std::nothrow) VideoEncoderColorConverter());
+        if (encObj->colorConverter == nullptr) {
+            ERR("video encoder %#x alloc color converter failed", encHandle);
+            return false;
+        }
+    }
+    if (!encObj->colorConverter->Init(inputFormat, encObj->params.width, encObj->params.height)) {
+        ERR("video encoder %#x init color converter failed", encHandle);
+        encObj->colorConverter = nullptr;
+        encObj->inputFormat = {};
+        return false;
+    }
+    if (encObj->capture != nullptr) {
+        encObj->capture->RecordInputFormat(inputFormat);
+    }
+    return true;
+}
+
 /**
  * @功能描述: 初始化编码器
  * @参数 [in] encHandle: 编码器对象句柄
@@ -171,18 +628,47 @@ VmiEncoderRetCode VencCreateEncoder(uint32_t *encHandle)
  */
 VmiEncoderRetCode VencInitEncoder(uint32_t encHandle, const VmiEncodeParams encParams)
 {
-    std::unique_lock<std::mutex> lck(g_instanceLock);
-    if (g_vencHandleMap.find(encHandle) == g_vencHandleMap.end()) {
+    return VencInitEncoderEx(encHandle, encParams, nullptr);
+}
+
+/**
+ * @功能描述: 按指定输入格式初始化编码器，已按相同编码参数初始化时只更新输入格式
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] encParams: 编码参数结构体
+ * @参数 [in] inputFormat: 输入格式，为空时为紧密排列的I420
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_INIT_FAIL 输入格式无效或初始化编码器失败
+ */
+VmiEncoderRetCode VencInitEncoderEx(uint32_t encHandle, const VmiEncodeParams encParams,
+    const VmiInputFormat *inputFormat)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
         ERR("VencInitEncoder failed: encoder handle %#x does not exist.", encHandle);
         return VMI_ENCODER_INIT_FAIL;
     }
-    EncodeParams params = {
-        encParams.frameRate, encParams.bitrate, GOP_SIZE_DEFAULT, ENCODE_PROFILE_BASELINE,
-        encParams.width, encParams.height
-    };
-    EncoderRetCode ret = g_vencHandleMap[encHandle].encoder->InitEncoder(params);
-    if (ret != VIDEO_ENCODER_SUCCESS) {
-        ERR("VencInitEncoder failed: video encoder %#x init encoder error %#x", encHandle, ret);
+    EncodeParams params = ToEncodeParams(encParams);
+    if (encObj->isWarm) {
+        if (!InitWarmEncoderLocked(encObj, encHandle, params)) {
+            ERR("VencInitEncoder failed: video encoder %#x init pooled encoder failed", encHandle);
+            return VMI_ENCODER_INIT_FAIL;
+        }
+    } else if (inputFormat == nullptr || !encObj->isInitialized || !(params == encObj->params)) {
+        EncoderRetCode ret = encObj->encoder->InitEncoder(params);
+        if (ret != VIDEO_ENCODER_SUCCESS) {
+            ERR("VencInitEncoder failed: video encoder %#x init encoder error %#x", encHandle, ret);
+            return VMI_ENCODER_INIT_FAIL;
+        }
+    }
+    encObj->isInitialized = true;
+    UpdateParamsLocked(encObj, params);
+    if (!SetInputFormatLocked(encObj, encHandle, (inputFormat == nullptr) ? VmiInputFormat() : *inputFormat)) {
+        ERR("VencInitEncoder failed: video encoder %#x set input format failed", encHandle);
+        return VMI_ENCODER_INIT_FAIL;
+    }
+    if (encObj->isInputPoolEnabled &&
+        !encObj->inputPool.Init(GetInputBufferSizeLocked(encObj), encObj->inputPoolConfig)) {
+        ERR("VencInitEncoder failed: video encoder %#x init input buffer pool failed", encHandle);
         return VMI_ENCODER_INIT_FAIL;
     }
     return VMI_ENCODER_SUCCESS;
@@ -196,85 +682,1944 @@ VmiEncoderRetCode VencInitEncoder(uint32_t encHandle, const VmiEncodeParams encP
  */
 VmiEncoderRetCode VencStartEncoder(uint32_t encHandle)
 {
-    std::unique_lock<std::mutex> lck(g_instanceLock);
-    if (g_vencHandleMap.find(encHandle) == g_vencHandleMap.end()) {
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
         ERR("VencStartEncoder failed: encoder handle %#x does not exist.", encHandle);
         return VMI_ENCODER_START_FAIL;
     }
-    EncoderRetCode ret = g_vencHandleMap[encHandle].encoder->StartEncoder();
+    EncoderRetCode ret = encObj->encoder->StartEncoder();
     if (ret != VIDEO_ENCODER_SUCCESS) {
         ERR("VencStartEncoder failed: video encoder %#x start encoder error %#x", encHandle, ret);
         return VMI_ENCODER_START_FAIL;
     }
+    encObj->isStarted = true;
+    encObj->isKeyFramePending = true;
     return VMI_ENCODER_SUCCESS;
 }
 
 /**
- * @功能描述: 编码器编码一帧数据
+ * @功能描述: 持有实例锁时修改编码参数，参数与当前一致时不做任何操作
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
  * @参数 [in] encHandle: 编码器对象句柄
- * @参数 [in] inputData: 编码输入数据地址
- * @参数 [in] inputSize: 编码输入数据大小
- * @参数 [out] outputData: 编码输出数据地址
- * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [in] params: 编码参数
  * @返回值: VMI_ENCODER_SUCCESS 成功
- *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_SET_PARAMS_FAIL 设置编码参数失败
  */
-VmiEncoderRetCode VencEncodeOneFrame(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
-    uint8_t **outputData, uint32_t *outputSize)
+VmiEncoderRetCode SetEncodeParamsLocked(const EncoderObjectRef &encObj, uint32_t encHandle,
+    const EncodeParams &params)
 {
-    std::unique_lock<std::mutex> lck(g_instanceLock);
-    if (g_vencHandleMap.find(encHandle) == g_vencHandleMap.end()) {
-        ERR("VencEncodeOneFrame failed: encoder handle %#x does not exist.", encHandle);
-        return VMI_ENCODER_ENCODE_FAIL;
+    if (params == encObj->params) {
+        return VMI_ENCODER_SUCCESS;
     }
-    EncoderRetCode ret = g_vencHandleMap[encHandle].encoder->
-        EncodeOneFrame(inputData, inputSize, outputData, outputSize);
+    EncoderRetCode ret = encObj->encoder->SetEncodeParams(params);
     if (ret != VIDEO_ENCODER_SUCCESS) {
-        ERR("VencEncodeOneFrame failed: video encoder %#x encode one frame error %#x", encHandle, ret);
-        return VMI_ENCODER_ENCODE_FAIL;
+        ERR("video encoder %#x set encode params error %#x", encHandle, ret);
+        return VMI_ENCODER_SET_PARAMS_FAIL;
+    }
+    bool isResized = (params.width != encObj->params.width) || (params.height != encObj->params.height);
+    UpdateParamsLocked(encObj, params);
+    INFO("video encoder %#x set encode params: %ux%u, frame rate %u, bitrate %u, gop size %u, profile %u",
+        encHandle, params.width, params.height, params.frameRate, params.bitrate, params.gopSize, params.profile);
+    if (isResized && encObj->isInputPoolEnabled &&
+        !encObj->inputPool.Init(GetInputBufferSizeLocked(encObj), encObj->inputPoolConfig)) {
+        ERR("video encoder %#x resize input buffer pool failed", encHandle);
+        return VMI_ENCODER_SET_PARAMS_FAIL;
     }
     return VMI_ENCODER_SUCCESS;
 }
 
 /**
- * @功能描述: 停止编码器
+ * @功能描述: 码控开启时记录本帧输出大小，并在策略要求时下发新的码率/帧率
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
  * @参数 [in] encHandle: 编码器对象句柄
- * @返回值: VMI_ENCODER_SUCCESS 成功
- *          VMI_ENCODER_STOP_FAIL 停止编码器失败
+ * @参数 [in] outputSize: 本帧编码输出大小
  */
-VmiEncoderRetCode VencStopEncoder(uint32_t encHandle)
+void RunRateControlLocked(const EncoderObjectRef &encObj, uint32_t encHandle, uint32_t outputSize)
 {
-    std::unique_lock<std::mutex> lck(g_instanceLock);
-    if (g_vencHandleMap.find(encHandle) == g_vencHandleMap.end()) {
-        ERR("VencStopEncoder failed: encoder handle %#x does not exist.", encHandle);
-        return VMI_ENCODER_STOP_FAIL;
+    auto rateController = GetRateController(*encObj);
+    if (rateController == nullptr) {
+        return;
+    }
+    uint64_t nowUs = GetMonotonicTimeUs();
+    rateController->OnFrameEncoded(nowUs, outputSize);
+    EncodeParams target = {};
+    if (rateController->Decide(nowUs, encObj->params, target)) {
+        (void) SetEncodeParamsLocked(encObj, encHandle, target);
     }
-    EncoderRetCode ret = g_vencHandleMap[encHandle].encoder->StopEncoder();
+}
+
+/**
+ * @功能描述: 持有实例锁时调用编码器编码一帧数据，并记录编码耗时等统计
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [out] outputData: 编码器内部输出缓冲区地址
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [out] frameInfo: 编码帧信息，为空时只解析到第一个切片以识别帧类型和提取参数集
+ * @返回值: true 成功，false 编码失败
+ */
+bool EncodeOneFrameLocked(const EncoderObjectRef &encObj, uint32_t encHandle, const uint8_t *inputData,
+    uint32_t inputSize, uint8_t **outputData, uint32_t *outputSize, VmiEncodeFrameInfo *frameInfo)
+{
+    FrameTraceKey traceKey = { encHandle, encObj->frameSeq };
+    VideoEncoderTraceSpan encodeSpan(FRAME_TRACE_ENCODE, traceKey);
+    uint64_t startUs = GetMonotonicTimeUs();
+    EncoderRetCode ret = encObj->encoder->EncodeOneFrame(inputData, inputSize, outputData, outputSize);
+    uint64_t encodeTimeUs = GetMonotonicTimeUs() - startUs;
+    encodeSpan.End();
     if (ret != VIDEO_ENCODER_SUCCESS) {
-        ERR("VencStopEncoder failed: video encoder %#x stop encoder error %#x", encHandle, ret);
-        return VMI_ENCODER_STOP_FAIL;
+        ERR("video encoder %#x encode one frame error %#x", encHandle, ret);
+        encObj->stats->RecordFailure();
+        return false;
     }
-    return VMI_ENCODER_SUCCESS;
+    VmiEncodeFrameInfo headerInfo;
+    VmiEncodeFrameInfo &info = (frameInfo != nullptr) ? *frameInfo : headerInfo;
+    VideoEncoderNalParser::Parse(encObj->encType, *outputData, *outputSize, frameInfo == nullptr, info);
+    info.timestampUs = startUs;
+    info.encodeTimeUs = static_cast<uint32_t>(std::min<uint64_t>(encodeTimeUs, UINT32_MAX));
+    encObj->nalParser.UpdateParameterSets(encObj->encType, *outputData, info);
+    encObj->stats->RecordEncode(encodeTimeUs, inputSize, *outputSize, info.isKeyFrame);
+    encObj->isKeyFramePending = false;
+    encObj->lastEncodeUs = startUs;
+    return true;
 }
 
 /**
- * @功能描述: 销毁编码器
+ * @功能描述: 持有实例锁时将非原生格式的输入转换为I420，原生格式时不做任何操作
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
  * @参数 [in] encHandle: 编码器对象句柄
- * @返回值: VMI_ENCODER_SUCCESS 成功
- *          VMI_ENCODER_DESTROY_FAIL 销毁编码器失败
+ * @参数 [in,out] inputData: 编码输入数据地址，转换后为转换器内部的I420数据
+ * @参数 [in,out] inputSize: 编码输入数据大小，转换后为一帧I420数据大小
+ * @返回值: true 成功，false 输入数据不足一帧或转换器未初始化
  */
-VmiEncoderRetCode VencDestroyEncoder(uint32_t encHandle)
+bool ConvertInputLocked(const EncoderObjectRef &encObj, uint32_t encHandle, const uint8_t *&inputData,
+    uint32_t &inputSize)
 {
-    std::unique_lock<std::mutex> lck(g_instanceLock);
-    if (g_vencHandleMap.find(encHandle) == g_vencHandleMap.end()) {
-        ERR("VencDestroyEncoder failed: encoder handle %#x does not exist.", encHandle);
-        return VMI_ENCODER_DESTROY_FAIL;
+    VideoEncoderColorConverter *converter = encObj->colorConverter.get();
+    if (converter == nullptr) {
+        return true;
     }
-    g_vencHandleMap[encHandle].encoder->DestroyEncoder();
-    (void) (*g_destroyVideoEncoder)(g_vencHandleMap[encHandle].encType, g_vencHandleMap[encHandle].encoder);
-    (void) g_vencHandleMap.erase(encHandle);
-    if (g_vencHandleMap.empty()) {
-        UnloadVideoCodecSharedLib();
+    if (inputSize < converter->GetInputSize()) {
+        ERR("video encoder %#x input size %u is less than %u", encHandle, inputSize, converter->GetInputSize());
+        return false;
+    }
+    FrameTraceKey traceKey = { encHandle, encObj->frameSeq };
+    VideoEncoderTraceSpan convertSpan(FRAME_TRACE_CONVERT, traceKey);
+    const uint8_t *frame = converter->Convert(inputData);
+    if (frame == nullptr) {
+        ERR("video encoder %#x convert input failed", encHandle);
+        return false;
+    }
+    inputData = frame;
+    inputSize = converter->GetFrameSize();
+    return true;
+}
+
+/**
+ * @功能描述: 持有实例锁时检测输入帧的变化区域，判断是否跳过该帧
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @返回值: true 静止帧且按策略跳过，false 需要编码
+ */
+bool DetectStaticFrameLocked(const EncoderObjectRef &encObj, const uint8_t *inputData, uint32_t inputSize)
+{
+    VideoEncoderDirtyDetector *detector = encObj->dirtyDetector.get();
+    if (detector == nullptr) {
+        return false;
+    }
+    if (inputData == nullptr || inputSize < detector->GetFrameSize()) {
+        // 无法检测的帧之后参考帧不再可信
+        detector->Invalidate();
+        return false;
+    }
+    if (detector->Detect(inputData) != 0 || encObj->isKeyFramePending ||
+        encObj->dirtyDetectConfig.policy != VMI_STATIC_FRAME_SKIP) {
+        return false;
+    }
+    constexpr uint64_t usPerMs = 1000;
+    uint64_t repeatIntervalUs = encObj->dirtyDetectConfig.repeatIntervalMs * usPerMs;
+    if (repeatIntervalUs != 0 && GetMonotonicTimeUs() - encObj->lastEncodeUs >= repeatIntervalUs) {
+        return false;
+    }
+    detector->RecordSkip();
+    return true;
+}
+
+/**
+ * @功能描述: 持有实例锁时丢弃变化区域检测的参考帧，检测后未能编码交付的帧已写入参考帧，
+ *            不丢弃时重试该帧或其后的静止画面会被误判为静止而跳过
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ */
+void InvalidateDirtyReferenceLocked(const EncoderObjectRef &encObj)
+{
+    if (encObj->dirtyDetector != nullptr) {
+        encObj->dirtyDetector->Invalidate();
+    }
+}
+
+/**
+ * @功能描述: 持有实例锁时丢弃一帧已编码但未交付的码流，后续帧以其为参考无法解码，因此强制下一帧编码为I帧
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ */
+void DropEncodedFrameLocked(const EncoderObjectRef &encObj, uint32_t encHandle)
+{
+    encObj->stats->RecordFailure();
+    EncoderRetCode ret = encObj->encoder->ForceKeyFrame();
+    if (ret != VIDEO_ENCODER_SUCCESS) {
+        ERR("video encoder %#x force key frame after dropped frame error %#x", encHandle, ret);
+    }
+    encObj->isKeyFramePending = true;
+    InvalidateDirtyReferenceLocked(encObj);
+}
+
+/**
+ * @功能描述: 持有实例锁时编码一帧数据，启用输出环时将码流拷贝到预留的槽位中
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [out] outputData: 编码输出数据地址
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [out] frameInfo: 编码帧信息，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 输出环无空闲槽位或写入输出环失败
+ */
+VmiEncoderRetCode EncodeFrameLocked(const EncoderObjectRef &encObj, uint32_t encHandle, const uint8_t *inputData,
+    uint32_t inputSize, uint8_t **outputData, uint32_t *outputSize, VmiEncodeFrameInfo *frameInfo)
+{
+    if (!ConvertInputLocked(encObj, encHandle, inputData, inputSize)) {
+        encObj->stats->RecordFailure();
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    // 先预留输出槽位再检测变化区域，输出环满时参考帧保持不变，重试该帧仍能检测到变化
+    int32_t ringSlot = VideoEncoderOutputRing::INVALID_SLOT;
+    if (encObj->isOutputRingEnabled) {
+        ringSlot = encObj->outputRing.Reserve();
+        if (ringSlot == VideoEncoderOutputRing::INVALID_SLOT) {
+            ERR("encode one frame failed: video encoder %#x output ring is full", encHandle);
+            return VMI_ENCODER_OUTPUT_FAIL;
+        }
+    }
+    if (DetectStaticFrameLocked(encObj, inputData, inputSize)) {
+        if (ringSlot != VideoEncoderOutputRing::INVALID_SLOT) {
+            encObj->outputRing.Cancel(ringSlot);
+        }
+        *outputData = nullptr;
+        *outputSize = 0;
+        if (frameInfo != nullptr) {
+            VideoEncoderNalParser::Parse(encObj->encType, nullptr, 0, false, *frameInfo);
+            frameInfo->timestampUs = GetMonotonicTimeUs();
+            frameInfo->encodeTimeUs = 0;
+        }
+        return VMI_ENCODER_SUCCESS;
+    }
+    uint8_t *encodedData = nullptr;
+    uint32_t encodedSize = 0;
+    if (!EncodeOneFrameLocked(encObj, encHandle, inputData, inputSize, &encodedData, &encodedSize, frameInfo)) {
+        if (ringSlot != VideoEncoderOutputRing::INVALID_SLOT) {
+            encObj->outputRing.Cancel(ringSlot);
+        }
+        InvalidateDirtyReferenceLocked(encObj);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    if (ringSlot != VideoEncoderOutputRing::INVALID_SLOT) {
+        FrameTraceKey traceKey = { encHandle, encObj->frameSeq };
+        VideoEncoderTraceSpan outputSpan(FRAME_TRACE_OUTPUT, traceKey);
+        encodedData = encObj->outputRing.Commit(ringSlot, encodedData, encodedSize);
+        if (encodedData == nullptr) {
+            ERR("encode one frame failed: video encoder %#x commit output ring failed", encHandle);
+            encObj->outputRing.Cancel(ringSlot);
+            DropEncodedFrameLocked(encObj, encHandle);
+            return VMI_ENCODER_OUTPUT_FAIL;
+        }
+    }
+    *outputData = encodedData;
+    *outputSize = encodedSize;
+    RunRateControlLocked(encObj, encHandle, encodedSize);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 持有实例锁时将一次编码调用写入抓取文件，未开始抓取时不做任何操作
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] startUs: 开始编码的单调时钟时间
+ * @参数 [in] ret: 编码结果
+ * @参数 [in] inputData: 调用者传入的输入数据地址
+ * @参数 [in] inputSize: 调用者传入的输入数据大小
+ * @参数 [in] outputSize: 编码输出数据大小，编码失败时为0
+ */
+void CaptureFrameLocked(const EncoderObjectRef &encObj, uint64_t startUs, VmiEncoderRetCode ret,
+    const uint8_t *inputData, uint32_t inputSize, uint32_t outputSize)
+{
+    if (encObj->capture == nullptr) {
+        return;
+    }
+    uint64_t callTimeUs = GetMonotonicTimeUs() - startUs;
+    encObj->capture->RecordFrame(startUs, callTimeUs, ret, inputData, inputSize, outputSize);
+}
+
+/**
+ * @功能描述: 编码器编码一帧数据
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [out] outputData: 编码输出数据地址
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 输出环无空闲槽位，该帧未编码；写入输出环失败时该帧被丢弃，下一帧编码为I帧
+ */
+VmiEncoderRetCode VencEncodeOneFrame(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    uint8_t **outputData, uint32_t *outputSize)
+{
+    if (outputData == nullptr || outputSize == nullptr) {
+        ERR("VencEncodeOneFrame failed: encoder %#x output param is null", encHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    FrameTraceKey traceKey = { encHandle, 0 };
+    VideoEncoderTraceSpan frameSpan(FRAME_TRACE_FRAME, traceKey);
+    uint64_t lockStartNs = GetMonotonicTimeNs();
+    auto encObj = AcquireEncoder(encHandle, traceKey);
+    if (!encObj) {
+        ERR("VencEncodeOneFrame failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    encObj->stats->RecordLockWait(GetMonotonicTimeNs() - lockStartNs);
+    uint64_t startUs = GetMonotonicTimeUs();
+    VmiEncoderRetCode ret = EncodeFrameLocked(encObj, encHandle, inputData, inputSize, outputData, outputSize,
+        nullptr);
+    CaptureFrameLocked(encObj, startUs, ret, inputData, inputSize, (ret == VMI_ENCODER_SUCCESS) ? *outputSize : 0);
+    return ret;
+}
+
+/**
+ * @功能描述: 编码器编码一帧数据，同时返回该帧的NAL单元索引、帧类型、时间戳和编码耗时
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [out] outputData: 编码输出数据地址
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [out] frameInfo: 编码帧信息
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 输出环无空闲槽位，该帧未编码；写入输出环失败时该帧被丢弃，下一帧编码为I帧
+ */
+VmiEncoderRetCode VencEncodeOneFrameEx(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    uint8_t **outputData, uint32_t *outputSize, VmiEncodeFrameInfo *frameInfo)
+{
+    if (outputData == nullptr || outputSize == nullptr || frameInfo == nullptr) {
+        ERR("VencEncodeOneFrameEx failed: encoder %#x output param is null", encHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    FrameTraceKey traceKey = { encHandle, 0 };
+    VideoEncoderTraceSpan frameSpan(FRAME_TRACE_FRAME, traceKey);
+    uint64_t lockStartNs = GetMonotonicTimeNs();
+    auto encObj = AcquireEncoder(encHandle, traceKey);
+    if (!encObj) {
+        ERR("VencEncodeOneFrameEx failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    encObj->stats->RecordLockWait(GetMonotonicTimeNs() - lockStartNs);
+    uint64_t startUs = GetMonotonicTimeUs();
+    VmiEncoderRetCode ret = EncodeFrameLocked(encObj, encHandle, inputData, inputSize, outputData, outputSize,
+        frameInfo);
+    CaptureFrameLocked(encObj, startUs, ret, inputData, inputSize, (ret == VMI_ENCODER_SUCCESS) ? *outputSize : 0);
+    return ret;
+}
+
+/**
+ * @功能描述: 获取编码器最近输出的参数集
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] buffer: 参数集输出缓冲区
+ * @参数 [in] bufferSize: 输出缓冲区大小
+ * @参数 [out] size: 参数集大小，缓冲区不足时为所需大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_OUTPUT_FAIL 缓冲区不足
+ *          VMI_ENCODER_PARAMETER_SETS_FAIL 编码器不存在或尚未输出完整的参数集
+ */
+VmiEncoderRetCode VencGetParameterSets(uint32_t encHandle, uint8_t *buffer, uint32_t bufferSize, uint32_t *size)
+{
+    if ((buffer == nullptr && bufferSize != 0) || size == nullptr) {
+        ERR("VencGetParameterSets failed: encoder %#x output param is null", encHandle);
+        return VMI_ENCODER_PARAMETER_SETS_FAIL;
+    }
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencGetParameterSets failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_PARAMETER_SETS_FAIL;
+    }
+    if (!encObj->nalParser.GetParameterSets(buffer, bufferSize, *size)) {
+        WARN("VencGetParameterSets failed: encoder %#x has not output parameter sets yet", encHandle);
+        return VMI_ENCODER_PARAMETER_SETS_FAIL;
+    }
+    if (*size > bufferSize) {
+        // 传入空缓冲区查询所需大小时不打印错误
+        if (buffer != nullptr) {
+            ERR("VencGetParameterSets failed: encoder %#x buffer size %u is less than %u", encHandle, bufferSize,
+                *size);
+        }
+        return VMI_ENCODER_OUTPUT_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 持有实例锁时编码一帧数据，码流直接写入调用者提供的分散缓冲区
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [in] iov: 输出缓冲区数组
+ * @参数 [in] iovCount: 输出缓冲区个数
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @返回值: 同VencEncodeOneFrameToBuffer
+ */
+VmiEncoderRetCode EncodeFrameToBufferLocked(const EncoderObjectRef &encObj, uint32_t encHandle,
+    const uint8_t *inputData, uint32_t inputSize, const VmiIoVec *iov, uint32_t iovCount, uint32_t *outputSize)
+{
+    if (!ConvertInputLocked(encObj, encHandle, inputData, inputSize)) {
+        encObj->stats->RecordFailure();
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    if (DetectStaticFrameLocked(encObj, inputData, inputSize)) {
+        *outputSize = 0;
+        return VMI_ENCODER_SUCCESS;
+    }
+    // 编码器接口只返回其内部缓冲区，因此直接从该缓冲区拷贝到最终目的地，不经过输出环
+    uint8_t *encodedData = nullptr;
+    uint32_t encodedSize = 0;
+    if (!EncodeOneFrameLocked(encObj, encHandle, inputData, inputSize, &encodedData, &encodedSize, nullptr)) {
+        InvalidateDirtyReferenceLocked(encObj);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    *outputSize = encodedSize;
+    uint64_t capacity = 0;
+    for (uint32_t i = 0; i < iovCount; ++i) {
+        capacity += iov[i].len;
+    }
+    if (capacity < encodedSize) {
+        ERR("VencEncodeOneFrameToBuffer failed: video encoder %#x output buffer size %" PRIu64 " is less than %u",
+            encHandle, capacity, encodedSize);
+        // 未交付的帧不计入码控
+        DropEncodedFrameLocked(encObj, encHandle);
+        return VMI_ENCODER_OUTPUT_FAIL;
+    }
+    FrameTraceKey traceKey = { encHandle, encObj->frameSeq };
+    VideoEncoderTraceSpan outputSpan(FRAME_TRACE_OUTPUT, traceKey);
+    uint32_t copied = 0;
+    for (uint32_t i = 0; i < iovCount && copied < encodedSize; ++i) {
+        uint32_t len = std::min(iov[i].len, encodedSize - copied);
+        (void) memcpy(iov[i].base, encodedData + copied, len);
+        copied += len;
+    }
+    RunRateControlLocked(encObj, encHandle, encodedSize);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 编码器编码一帧数据，码流直接写入调用者提供的分散缓冲区
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [in] iov: 输出缓冲区数组，按顺序依次填充
+ * @参数 [in] iovCount: 输出缓冲区个数
+ * @参数 [out] outputSize: 编码输出数据大小，缓冲区不足时为该帧所需大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 缓冲区总大小不足，该帧码流被丢弃，下一帧编码为I帧
+ */
+VmiEncoderRetCode VencEncodeOneFrameToBuffer(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    const VmiIoVec *iov, uint32_t iovCount, uint32_t *outputSize)
+{
+    if ((iov == nullptr && iovCount != 0) || outputSize == nullptr) {
+        ERR("VencEncodeOneFrameToBuffer failed: encoder %#x output param is null", encHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    FrameTraceKey traceKey = { encHandle, 0 };
+    VideoEncoderTraceSpan frameSpan(FRAME_TRACE_FRAME, traceKey);
+    uint64_t lockStartNs = GetMonotonicTimeNs();
+    auto encObj = AcquireEncoder(encHandle, traceKey);
+    if (!encObj) {
+        ERR("VencEncodeOneFrameToBuffer failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    encObj->stats->RecordLockWait(GetMonotonicTimeNs() - lockStartNs);
+    uint64_t startUs = GetMonotonicTimeUs();
+    VmiEncoderRetCode ret = EncodeFrameToBufferLocked(encObj, encHandle, inputData, inputSize, iov, iovCount,
+        outputSize);
+    // 缓冲区不足时该帧已编码，outputSize为其实际大小
+    CaptureFrameLocked(encObj, startUs, ret, inputData, inputSize, (ret != VMI_ENCODER_ENCODE_FAIL) ? *outputSize : 0);
+    return ret;
+}
+
+/**
+ * @功能描述: 停止编码器
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STOP_FAIL 停止编码器失败
+ */
+VmiEncoderRetCode VencStopEncoder(uint32_t encHandle)
+{
+    auto asyncWorker = GetAsyncWorker(encHandle);
+    if (asyncWorker != nullptr) {
+        asyncWorker->Flush();
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencStopEncoder failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_STOP_FAIL;
+    }
+    EncoderRetCode ret = encObj->encoder->StopEncoder();
+    if (ret != VIDEO_ENCODER_SUCCESS) {
+        ERR("VencStopEncoder failed: video encoder %#x stop encoder error %#x", encHandle, ret);
+        return VMI_ENCODER_STOP_FAIL;
+    }
+    encObj->isStarted = false;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 持有实例锁时将编码器停止并重置后放回预热池
+ * @参数 [in] encObj: 持有实例锁的编码器对象引用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: true 已放回预热池，false 预热池未开启或编码器无法复用，调用者负责销毁
+ */
+bool RecycleEncoderLocked(const EncoderObjectRef &encObj, uint32_t encHandle)
+{
+    if (!g_warmPool.IsEnabled() || !(encObj->isInitialized || encObj->isWarm)) {
+        return false;
+    }
+    if (encObj->isStarted) {
+        EncoderRetCode ret = encObj->encoder->StopEncoder();
+        if (ret != VIDEO_ENCODER_SUCCESS) {
+            WARN("video encoder %#x stop encoder error %#x, not recycled", encHandle, ret);
+            return false;
+        }
+        encObj->isStarted = false;
+    }
+    if (encObj->isInitialized) {
+        EncoderRetCode ret = encObj->encoder->ResetEncoder();
+        if (ret != VIDEO_ENCODER_SUCCESS) {
+            WARN("video encoder %#x reset encoder error %#x, not recycled", encHandle, ret);
+            return false;
+        }
+    }
+    return g_warmPool.Release(encObj->encType, encObj->params, encObj->encoder);
+}
+
+/**
+ * @功能描述: 销毁编码器，预热池开启时编码器放回池中
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DESTROY_FAIL 销毁编码器失败
+ */
+VmiEncoderRetCode VencDestroyEncoder(uint32_t encHandle)
+{
+    auto asyncWorker = DetachAsyncWorker(encHandle);
+    if (asyncWorker != nullptr) {
+        asyncWorker->Stop(false);
+    }
+    auto encObj = EncoderObjectRef(g_encoderTable.Remove(encHandle));
+    if (!encObj) {
+        ERR("VencDestroyEncoder failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_DESTROY_FAIL;
+    }
+    if (!RecycleEncoderLocked(encObj, encHandle)) {
+        DestroyVendorEncoder(encObj->encType, encObj->encoder);
+    }
+    encObj->encoder = nullptr;
+    encObj->capture = nullptr;
+    VideoEncoderStatsRegistry::GetInstance().Unregister(encObj->stats);
+    VideoEncoderScheduler::GetInstance().OnSessionDestroyed(encObj->encType, encObj->pixelRate);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 运行时修改编码参数，参数与当前一致时不做任何操作
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] encParams: 编码参数结构体
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SET_PARAMS_FAIL 设置编码参数失败
+ */
+VmiEncoderRetCode VencSetEncodeParams(uint32_t encHandle, const VmiEncodeParams encParams)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencSetEncodeParams failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_SET_PARAMS_FAIL;
+    }
+    if (!encObj->isInitialized) {
+        ERR("VencSetEncodeParams failed: video encoder %#x is not initialized", encHandle);
+        return VMI_ENCODER_SET_PARAMS_FAIL;
+    }
+    return SetEncodeParamsLocked(encObj, encHandle, ToEncodeParams(encParams));
+}
+
+/**
+ * @功能描述: 强制下一帧编码为I帧
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FORCE_KEY_FRAME_FAIL 强制I帧失败
+ */
+VmiEncoderRetCode VencForceKeyFrame(uint32_t encHandle)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencForceKeyFrame failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_FORCE_KEY_FRAME_FAIL;
+    }
+    EncoderRetCode ret = encObj->encoder->ForceKeyFrame();
+    if (ret != VIDEO_ENCODER_SUCCESS) {
+        ERR("VencForceKeyFrame failed: video encoder %#x force key frame error %#x", encHandle, ret);
+        return VMI_ENCODER_FORCE_KEY_FRAME_FAIL;
+    }
+    encObj->isKeyFramePending = true;
+    if (encObj->capture != nullptr) {
+        encObj->capture->RecordKeyFrameRequest();
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 重置编码器，保留当前编码参数
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RESET_FAIL 重置编码器失败
+ */
+VmiEncoderRetCode VencResetEncoder(uint32_t encHandle)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencResetEncoder failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_RESET_FAIL;
+    }
+    EncoderRetCode ret = encObj->encoder->ResetEncoder();
+    if (ret != VIDEO_ENCODER_SUCCESS) {
+        ERR("VencResetEncoder failed: video encoder %#x reset encoder error %#x", encHandle, ret);
+        return VMI_ENCODER_RESET_FAIL;
+    }
+    encObj->isKeyFramePending = true;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 开启闭环码控
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 码控配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RATE_CONTROL_FAIL 开启码控失败
+ */
+VmiEncoderRetCode VencEnableRateControl(uint32_t encHandle, const VmiRateControlConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencEnableRateControl failed: encoder %#x rate control config is null", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencEnableRateControl failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    if (!encObj->isInitialized) {
+        ERR("VencEnableRateControl failed: video encoder %#x is not initialized", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    std::unique_ptr<RateControlPolicy> policy = CreateRateControlPolicy(*config, encObj->params);
+    if (policy == nullptr) {
+        ERR("VencEnableRateControl failed: encoder %#x create rate control policy %u failed",
+            encHandle, config->policy);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    std::shared_ptr<VideoEncoderRateController> rateController(
+        new (std::nothrow) VideoEncoderRateController(std::move(policy)));
+    if (rateController == nullptr) {
+        ERR("VencEnableRateControl failed: encoder %#x create rate controller failed", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(encObj->attachLock);
+    encObj->rateController = std::move(rateController);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 关闭闭环码控，保持当前编码参数
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RATE_CONTROL_FAIL 关闭码控失败
+ */
+VmiEncoderRetCode VencDisableRateControl(uint32_t encHandle)
+{
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencDisableRateControl failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(encObj->attachLock);
+    encObj->rateController = nullptr;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 上报网络反馈，供闭环码控使用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] feedback: 网络反馈
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RATE_CONTROL_FAIL 未开启码控
+ */
+VmiEncoderRetCode VencReportNetworkFeedback(uint32_t encHandle, const VmiNetworkFeedback *feedback)
+{
+    if (feedback == nullptr) {
+        ERR("VencReportNetworkFeedback failed: encoder %#x feedback is null", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencReportNetworkFeedback failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    auto rateController = GetRateController(*encObj);
+    if (rateController == nullptr) {
+        ERR("VencReportNetworkFeedback failed: encoder %#x rate control is not enabled", encHandle);
+        return VMI_ENCODER_RATE_CONTROL_FAIL;
+    }
+    rateController->OnNetworkFeedback(GetMonotonicTimeUs(), *feedback);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取编码器统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 编码统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STATS_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetEncoderStats(uint32_t encHandle, VmiEncoderStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetEncoderStats failed: encoder %#x stats is null", encHandle);
+        return VMI_ENCODER_STATS_FAIL;
+    }
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencGetEncoderStats failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_STATS_FAIL;
+    }
+    EncoderStatsSnapshot snapshot;
+    encObj->stats->MergeInto(snapshot);
+    snapshot.ToVmiStats(*stats);
+    stats->activeEncoders = 1;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 清零编码器统计，清零前的累计值仍计入进程级汇总
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STATS_FAIL 清零统计失败
+ */
+VmiEncoderRetCode VencResetEncoderStats(uint32_t encHandle)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencResetEncoderStats failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_STATS_FAIL;
+    }
+    VideoEncoderStatsRegistry::GetInstance().Reset(encObj->stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取进程级汇总统计，包括已销毁编码器的累计值
+ * @参数 [out] stats: 编码统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STATS_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetGlobalEncoderStats(VmiEncoderStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetGlobalEncoderStats failed: stats is null");
+        return VMI_ENCODER_STATS_FAIL;
+    }
+    VideoEncoderStatsRegistry::GetInstance().GetAggregate(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 配置预热池
+ * @参数 [in] config: 预热池配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_WARM_POOL_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigWarmPool(const VmiWarmPoolConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencConfigWarmPool failed: config is null");
+        return VMI_ENCODER_WARM_POOL_FAIL;
+    }
+    {
+        std::lock_guard<std::mutex> lck(g_codecLibLock);
+        g_isCodecLibResident = config->keepLibraryResident;
+    }
+    bool isOk = g_warmPool.Configure(*config);
+    std::lock_guard<std::mutex> lck(g_codecLibLock);
+    if (g_liveEncoderCount == 0 && !g_isCodecLibResident && g_isVideoCodecLoaded) {
+        UnloadVideoCodecSharedLib();
+    }
+    if (!isOk) {
+        ERR("VencConfigWarmPool failed: configure warm pool failed");
+        return VMI_ENCODER_WARM_POOL_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 预先创建并初始化编码器放入预热池
+ * @参数 [in] encType: 编码器类型，0表示使用系统属性配置的类型
+ * @参数 [in] encParams: 编码参数结构体
+ * @参数 [in] count: 预热个数
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_WARM_POOL_FAIL 预热池未开启或创建编码器失败
+ */
+VmiEncoderRetCode VencPrewarmEncoders(uint32_t encType, const VmiEncodeParams encParams, uint32_t count)
+{
+    if (!g_warmPool.IsEnabled()) {
+        ERR("VencPrewarmEncoders failed: warm pool is disabled");
+        return VMI_ENCODER_WARM_POOL_FAIL;
+    }
+    if (encType == 0 && !GetEncoderTypeProperty(encType)) {
+        ERR("VencPrewarmEncoders failed: get encoder type failed");
+        return VMI_ENCODER_WARM_POOL_FAIL;
+    }
+    EncodeParams params = ToEncodeParams(encParams);
+    for (uint32_t i = 0; i < count; ++i) {
+        VideoEncoder *encoder = CreateVendorEncoder(encType);
+        if (encoder == nullptr) {
+            ERR("VencPrewarmEncoders failed: create video encoder failed, %u prewarmed", i);
+            return VMI_ENCODER_WARM_POOL_FAIL;
+        }
+        EncoderRetCode ret = encoder->InitEncoder(params);
+        if (ret != VIDEO_ENCODER_SUCCESS) {
+            ERR("VencPrewarmEncoders failed: init encoder error %#x, %u prewarmed", ret, i);
+            DestroyVendorEncoder(encType, encoder);
+            return VMI_ENCODER_WARM_POOL_FAIL;
+        }
+        if (!g_warmPool.Release(encType, params, encoder)) {
+            ERR("VencPrewarmEncoders failed: warm pool is disabled, %u prewarmed", i);
+            DestroyVendorEncoder(encType, encoder);
+            return VMI_ENCODER_WARM_POOL_FAIL;
+        }
+    }
+    INFO("prewarmed %u encoders of type %u: %ux%u, frame rate %u, bitrate %u", count, encType,
+        params.width, params.height, params.frameRate, params.bitrate);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取预热池统计
+ * @参数 [out] stats: 预热池统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_WARM_POOL_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetWarmPoolStats(VmiWarmPoolStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetWarmPoolStats failed: stats is null");
+        return VMI_ENCODER_WARM_POOL_FAIL;
+    }
+    g_warmPool.GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 开启变化区域检测，已开启时只更新配置
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 检测配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 开启失败
+ */
+VmiEncoderRetCode VencEnableDirtyDetect(uint32_t encHandle, const VmiDirtyDetectConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencEnableDirtyDetect failed: encoder %#x dirty detect config is null", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencEnableDirtyDetect failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    if (!encObj->isInitialized) {
+        ERR("VencEnableDirtyDetect failed: video encoder %#x is not initialized", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    if (encObj->dirtyDetector == nullptr) {
+        std::unique_ptr<VideoEncoderDirtyDetector> detector(new (std::nothrow) VideoEncoderDirtyDetector());
+        if (detector == nullptr || !detector->Init(encObj->params.width, encObj->params.height)) {
+            ERR("VencEnableDirtyDetect failed: video encoder %#x create dirty detector failed", encHandle);
+            return VMI_ENCODER_DIRTY_DETECT_FAIL;
+        }
+        encObj->dirtyDetector = std::move(detector);
+    }
+    encObj->dirtyDetectConfig = *config;
+    INFO("video encoder %#x enable dirty detect: policy %u, repeat interval %u ms", encHandle, config->policy,
+        config->repeatIntervalMs);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 关闭变化区域检测
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 关闭失败
+ */
+VmiEncoderRetCode VencDisableDirtyDetect(uint32_t encHandle)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencDisableDirtyDetect failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    encObj->dirtyDetector = nullptr;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 提供下一帧的变化区域
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] rects: 变化区域
+ * @参数 [in] rectCount: 变化区域个数，0表示下一帧无变化
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 未开启变化区域检测
+ */
+VmiEncoderRetCode VencSetDamageHint(uint32_t encHandle, const VmiRect *rects, uint32_t rectCount)
+{
+    if (rects == nullptr && rectCount != 0) {
+        ERR("VencSetDamageHint failed: encoder %#x damage rects is null", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj || encObj->dirtyDetector == nullptr) {
+        ERR("VencSetDamageHint failed: encoder handle %#x does not exist or dirty detect is disabled", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    encObj->dirtyDetector->SetDamageHint(rects, rectCount);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取最近一帧的变化区域
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] rects: 变化区域
+ * @参数 [in] maxRects: rects可容纳的个数
+ * @参数 [out] rectCount: 变化区域个数
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 未开启变化区域检测
+ */
+VmiEncoderRetCode VencGetDirtyRegion(uint32_t encHandle, VmiRect *rects, uint32_t maxRects, uint32_t *rectCount)
+{
+    if ((rects == nullptr && maxRects != 0) || rectCount == nullptr) {
+        ERR("VencGetDirtyRegion failed: encoder %#x output param is null", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj || encObj->dirtyDetector == nullptr) {
+        ERR("VencGetDirtyRegion failed: encoder handle %#x does not exist or dirty detect is disabled", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    *rectCount = encObj->dirtyDetector->GetDirtyRects(rects, maxRects);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取变化区域检测统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 检测统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 未开启变化区域检测
+ */
+VmiEncoderRetCode VencGetDirtyDetectStats(uint32_t encHandle, VmiDirtyDetectStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetDirtyDetectStats failed: encoder %#x stats is null", encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj || encObj->dirtyDetector == nullptr) {
+        ERR("VencGetDirtyDetectStats failed: encoder handle %#x does not exist or dirty detect is disabled",
+            encHandle);
+        return VMI_ENCODER_DIRTY_DETECT_FAIL;
+    }
+    encObj->dirtyDetector->GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+namespace {
+    struct SimulcastLayer {
+        uint32_t encHandle = 0;
+        bool isStarted = false;
+        std::unique_ptr<VideoEncoderScaler> scaler = nullptr;  // 与输入同分辨率时为空
+    };
+
+    struct SimulcastGroup {
+        std::mutex lock = {};  // 串行化同一联播组上的编码和销毁
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t layerCount = 0;  // 已创建的层数，销毁后清零
+        SimulcastLayer layers[VMI_SIMULCAST_LAYER_MAX];
+        std::unique_ptr<VideoEncoderColorConverter> colorConverter = nullptr;  // 输入为编码器原生格式时为空
+        VideoEncoderWorkerGroup workers;  // 每个线程缩放并编码一层
+    };
+    // 句柄低8位为槽位下标，最多同时存在256个联播组
+    constexpr uint32_t SIMULCAST_HANDLE_INDEX_BITS = 8;
+    using SimulcastHandleTable = VideoEncoderHandleTable<SimulcastGroup, SIMULCAST_HANDLE_INDEX_BITS>;
+    SimulcastHandleTable g_simulcastTable;
+}
+
+/**
+ * @功能描述: 停止并销毁联播组已创建的各层编码器，调用者持有组锁或组尚未发布
+ * @参数 [in] group: 联播组
+ * @返回值: true 成功，false 某层销毁失败
+ */
+bool DestroySimulcastLayers(SimulcastGroup &group)
+{
+    bool isSuccess = true;
+    for (uint32_t i = 0; i < group.layerCount; ++i) {
+        SimulcastLayer &layer = group.layers[i];
+        if (layer.isStarted) {
+            (void) VencStopEncoder(layer.encHandle);
+            layer.isStarted = false;
+        }
+        isSuccess = (VencDestroyEncoder(layer.encHandle) == VMI_ENCODER_SUCCESS) && isSuccess;
+        layer.scaler.reset();
+    }
+    group.layerCount = 0;
+    return isSuccess;
+}
+
+/**
+ * @功能描述: 创建、初始化并启动联播组的一层编码器，分辨率与输入不同时创建缩放器并启用输入缓冲池存放缩放结果
+ * @参数 [in] group: 联播组
+ * @参数 [in] encType: 编码器类型
+ * @参数 [in] params: 该层编码参数
+ * @返回值: true 成功，false 失败，已创建的编码器计入group.layerCount由调用者销毁
+ */
+bool CreateSimulcastLayer(SimulcastGroup &group, uint32_t encType, const VmiEncodeParams &params)
+{
+    SimulcastLayer &layer = group.layers[group.layerCount];
+    if (!CreateEncoderObject(encType, layer.encHandle)) {
+        return false;
+    }
+    ++group.layerCount;
+    if (VencInitEncoder(layer.encHandle, params) != VMI_ENCODER_SUCCESS) {
+        return false;
+    }
+    if (params.width != group.width || params.height != group.height) {
+        layer.scaler.reset(new (std::nothrow) VideoEncoderScaler());
+        if (layer.scaler == nullptr || !layer.scaler->Init(group.width, group.height, params.width, params.height)) {
+            ERR("simulcast layer %#x create scaler %ux%u -> %ux%u failed", layer.encHandle, group.width,
+                group.height, params.width, params.height);
+            return false;
+        }
+        VmiBufferPoolConfig poolConfig = {};
+        if (VencConfigInputBufferPool(layer.encHandle, &poolConfig) != VMI_ENCODER_SUCCESS) {
+            return false;
+        }
+    }
+    if (VencStartEncoder(layer.encHandle) != VMI_ENCODER_SUCCESS) {
+        return false;
+    }
+    layer.isStarted = true;
+    return true;
+}
+
+/**
+ * @功能描述: 在工作线程上缩放并编码联播组的一层
+ * @参数 [in] layer: 联播层
+ * @参数 [in] frame: 紧密排列的I420输入帧
+ * @参数 [in] frameSize: 输入帧大小
+ * @参数 [out] output: 该层编码输出
+ */
+void EncodeSimulcastLayer(SimulcastLayer &layer, const uint8_t *frame, uint32_t frameSize,
+    VmiSimulcastLayerOutput &output)
+{
+    output = {};
+    output.encHandle = layer.encHandle;
+    if (layer.scaler == nullptr) {
+        output.result = VencEncodeOneFrame(layer.encHandle, frame, frameSize, &output.outputData, &output.outputSize);
+        return;
+    }
+    uint8_t *buffer = nullptr;
+    uint32_t bufferSize = 0;
+    output.result = VencAcquireInputBuffer(layer.encHandle, &buffer, &bufferSize);
+    if (output.result != VMI_ENCODER_SUCCESS) {
+        return;
+    }
+    if (bufferSize < layer.scaler->GetDstFrameSize() || !layer.scaler->Scale(frame, buffer)) {
+        ERR("simulcast layer %#x scale failed: buffer size %u, layer frame size %u", layer.encHandle, bufferSize,
+            layer.scaler->GetDstFrameSize());
+        output.result = VMI_ENCODER_BUFFER_FAIL;
+    } else {
+        output.result = VencEncodeOneFrame(layer.encHandle, buffer, layer.scaler->GetDstFrameSize(),
+            &output.outputData, &output.outputSize);
+    }
+    (void) VencReleaseInputBuffer(layer.encHandle, buffer);
+}
+
+/**
+ * @功能描述: 创建联播组
+ * @参数 [in] config: 联播组配置
+ * @参数 [out] groupHandle: 联播组句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SIMULCAST_FAIL 配置无效
+ *          VMI_ENCODER_CREATE_FAIL 创建、初始化或启动某层编码器失败
+ */
+VmiEncoderRetCode VencCreateSimulcastGroup(const VmiSimulcastConfig *config, uint32_t *groupHandle)
+{
+    if (config == nullptr || groupHandle == nullptr || config->layerCount == 0 ||
+        config->layerCount > VMI_SIMULCAST_LAYER_MAX || config->inputWidth == 0 || config->inputHeight == 0 ||
+        GetInputFrameSize(config->inputWidth, config->inputHeight) == 0) {
+        ERR("VencCreateSimulcastGroup failed: config or group handle is null, or layer count or input size invalid");
+        return VMI_ENCODER_SIMULCAST_FAIL;
+    }
+    for (uint32_t i = 0; i < config->layerCount; ++i) {
+        const VmiEncodeParams &params = config->layers[i];
+        if (params.width == 0 || params.height == 0 || params.width > config->inputWidth ||
+            params.height > config->inputHeight) {
+            ERR("VencCreateSimulcastGroup failed: layer %u resolution %ux%u exceeds input %ux%u", i, params.width,
+                params.height, config->inputWidth, config->inputHeight);
+            return VMI_ENCODER_SIMULCAST_FAIL;
+        }
+    }
+    uint32_t encType = config->encType;
+    if (encType == 0 && !GetEncoderTypeProperty(encType)) {
+        ERR("VencCreateSimulcastGroup failed: get encoder type failed");
+        return VMI_ENCODER_CREATE_FAIL;
+    }
+    std::shared_ptr<SimulcastGroup> group(new (std::nothrow) SimulcastGroup());
+    if (group == nullptr) {
+        ERR("VencCreateSimulcastGroup failed: alloc simulcast group failed");
+        return VMI_ENCODER_CREATE_FAIL;
+    }
+    group->width = config->inputWidth;
+    group->height = config->inputHeight;
+    if (!VideoEncoderColorConverter::IsNativeFormat(config->inputFormat, group->width)) {
+        group->colorConverter.reset(new (std::nothrow) VideoEncoderColorConverter());
+        if (group->colorConverter == nullptr ||
+            !group->colorConverter->Init(config->inputFormat, group->width, group->height)) {
+            ERR("VencCreateSimulcastGroup failed: init color converter for format %u failed",
+                config->inputFormat.pixelFormat);
+            return VMI_ENCODER_SIMULCAST_FAIL;
+        }
+    }
+    for (uint32_t i = 0; i < config->layerCount; ++i) {
+        if (!CreateSimulcastLayer(*group, encType, config->layers[i])) {
+            ERR("VencCreateSimulcastGroup failed: create layer %u of type %u failed", i, encType);
+            (void) DestroySimulcastLayers(*group);
+            return VMI_ENCODER_CREATE_FAIL;
+        }
+    }
+    uint32_t parallelism = group->workers.Resize(group->layerCount);
+    uint32_t layerCount = group->layerCount;
+    uint32_t handle = g_simulcastTable.Insert(group);
+    if (handle == SimulcastHandleTable::INVALID_HANDLE) {
+        ERR("VencCreateSimulcastGroup failed: group handle exceeds max instances %u", SimulcastHandleTable::CAPACITY);
+        (void) DestroySimulcastLayers(*group);
+        return VMI_ENCODER_CREATE_FAIL;
+    }
+    INFO("simulcast group %#x created: input %ux%u, %u layers, %u threads", handle, config->inputWidth,
+        config->inputHeight, layerCount, parallelism);
+    *groupHandle = handle;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 销毁联播组
+ * @参数 [in] groupHandle: 联播组句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DESTROY_FAIL 联播组不存在或销毁某层编码器失败
+ */
+VmiEncoderRetCode VencDestroySimulcastGroup(uint32_t groupHandle)
+{
+    auto group = g_simulcastTable.Remove(groupHandle);
+    if (group == nullptr) {
+        ERR("VencDestroySimulcastGroup failed: group handle %#x does not exist.", groupHandle);
+        return VMI_ENCODER_DESTROY_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(group->lock);
+    if (!DestroySimulcastLayers(*group)) {
+        ERR("VencDestroySimulcastGroup failed: group %#x destroy layer encoders failed", groupHandle);
+        return VMI_ENCODER_DESTROY_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取联播组某层的编码器对象句柄
+ * @参数 [in] groupHandle: 联播组句柄
+ * @参数 [in] layer: 层下标
+ * @参数 [out] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SIMULCAST_FAIL 联播组不存在或层下标越界
+ */
+VmiEncoderRetCode VencGetSimulcastLayerHandle(uint32_t groupHandle, uint32_t layer, uint32_t *encHandle)
+{
+    if (encHandle == nullptr) {
+        ERR("VencGetSimulcastLayerHandle failed: group %#x encoder handle is null", groupHandle);
+        return VMI_ENCODER_SIMULCAST_FAIL;
+    }
+    auto group = g_simulcastTable.Find(groupHandle);
+    if (group == nullptr) {
+        ERR("VencGetSimulcastLayerHandle failed: group handle %#x does not exist.", groupHandle);
+        return VMI_ENCODER_SIMULCAST_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(group->lock);
+    if (layer >= group->layerCount) {
+        ERR("VencGetSimulcastLayerHandle failed: group %#x layer %u out of %u", groupHandle, layer,
+            group->layerCount);
+        return VMI_ENCODER_SIMULCAST_FAIL;
+    }
+    *encHandle = group->layers[layer].encHandle;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 联播编码一帧数据
+ * @参数 [in] groupHandle: 联播组句柄
+ * @参数 [in] inputData: 一帧输入数据
+ * @参数 [in] inputSize: 输入数据大小
+ * @参数 [out] outputs: 各层编码输出
+ * @参数 [in] outputCount: outputs个数
+ * @返回值: VMI_ENCODER_SUCCESS 所有层编码成功
+ *          VMI_ENCODER_ENCODE_FAIL 参数无效或至少一层编码失败
+ */
+VmiEncoderRetCode VencEncodeSimulcastFrame(uint32_t groupHandle, const uint8_t *inputData, uint32_t inputSize,
+    VmiSimulcastLayerOutput *outputs, uint32_t outputCount)
+{
+    if (inputData == nullptr || outputs == nullptr) {
+        ERR("VencEncodeSimulcastFrame failed: group %#x input data or outputs is null", groupHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    auto group = g_simulcastTable.Find(groupHandle);
+    if (group == nullptr) {
+        ERR("VencEncodeSimulcastFrame failed: group handle %#x does not exist.", groupHandle);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(group->lock);
+    if (group->layerCount == 0 || outputCount < group->layerCount) {
+        ERR("VencEncodeSimulcastFrame failed: group %#x is destroyed or output count %u less than %u layers",
+            groupHandle, outputCount, group->layerCount);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    const uint8_t *frame = inputData;
+    uint32_t frameSize = GetInputFrameSize(group->width, group->height);
+    uint32_t expectSize = (group->colorConverter == nullptr) ? frameSize : group->colorConverter->GetInputSize();
+    if (inputSize < expectSize) {
+        ERR("VencEncodeSimulcastFrame failed: group %#x input size %u less than %u", groupHandle, inputSize,
+            expectSize);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    if (group->colorConverter != nullptr) {
+        frame = group->colorConverter->Convert(inputData);
+        if (frame == nullptr) {
+            ERR("VencEncodeSimulcastFrame failed: group %#x convert input failed", groupHandle);
+            return VMI_ENCODER_ENCODE_FAIL;
+        }
+    }
+    SimulcastGroup &groupRef = *group;
+    // 并行度不足层数时(创建线程失败)由各线程按步长分担剩余层
+    uint32_t parallelism = groupRef.workers.GetCount();
+    groupRef.workers.Run([&groupRef, frame, frameSize, outputs, parallelism](uint32_t index) {
+        for (uint32_t i = index; i < groupRef.layerCount; i += parallelism) {
+            EncodeSimulcastLayer(groupRef.layers[i], frame, frameSize, outputs[i]);
+        }
+    });
+    uint32_t failedLayers = 0;
+    for (uint32_t i = 0; i < groupRef.layerCount; ++i) {
+        failedLayers += (outputs[i].result == VMI_ENCODER_SUCCESS) ? 0 : 1;
+    }
+    if (failedLayers != 0) {
+        ERR("VencEncodeSimulcastFrame failed: group %#x %u of %u layers failed", groupHandle, failedLayers,
+            groupRef.layerCount);
+        return VMI_ENCODER_ENCODE_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 开始抓取编码会话，记录当前编码参数和输入格式作为回放起点
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 抓取配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CAPTURE_FAIL 创建抓取文件失败
+ */
+VmiEncoderRetCode VencStartCapture(uint32_t encHandle, const VmiCaptureConfig *config)
+{
+    constexpr uint64_t defaultMaxFileSizeMb = 1024;
+    constexpr uint64_t bytesPerMb = 1024 * 1024;
+    if (config == nullptr || config->path == nullptr) {
+        ERR("VencStartCapture failed: encoder %#x capture config or path is null", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencStartCapture failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    std::unique_ptr<VideoEncoderCaptureWriter> capture(new (std::nothrow) VideoEncoderCaptureWriter());
+    if (capture == nullptr) {
+        ERR("VencStartCapture failed: encoder %#x alloc capture writer failed", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    uint64_t maxFileSizeMb = (config->maxFileSizeMb == 0) ? defaultMaxFileSizeMb : config->maxFileSizeMb;
+    try {
+        if (!capture->Open(config->path, maxFileSizeMb * bytesPerMb, encObj->encType)) {
+            ERR("VencStartCapture failed: encoder %#x open capture file failed", encHandle);
+            return VMI_ENCODER_CAPTURE_FAIL;
+        }
+    } catch (const std::bad_alloc &e) {
+        ERR("VencStartCapture failed: encoder %#x alloc memory failed", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    if (encObj->isInitialized) {
+        capture->RecordParams(encObj->params);
+        capture->RecordInputFormat(encObj->inputFormat);
+    }
+    encObj->capture = std::move(capture);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 停止抓取并关闭抓取文件
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CAPTURE_FAIL 未开始抓取
+ */
+VmiEncoderRetCode VencStopCapture(uint32_t encHandle)
+{
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencStopCapture failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    if (encObj->capture == nullptr) {
+        ERR("VencStopCapture failed: encoder %#x capture is not started", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    encObj->capture = nullptr;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取抓取统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 抓取统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CAPTURE_FAIL 未开始抓取
+ */
+VmiEncoderRetCode VencGetCaptureStats(uint32_t encHandle, VmiCaptureStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetCaptureStats failed: encoder %#x stats is null", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencGetCaptureStats failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    if (encObj->capture == nullptr) {
+        ERR("VencGetCaptureStats failed: encoder %#x capture is not started", encHandle);
+        return VMI_ENCODER_CAPTURE_FAIL;
+    }
+    encObj->capture->GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 开启进程内所有编码器的逐帧追踪
+ * @参数 [in] config: 追踪配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_TRACE_FAIL 配置无效，或只要求写入trace_marker而其无法打开
+ */
+VmiEncoderRetCode VencEnableFrameTrace(const VmiFrameTraceConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencEnableFrameTrace failed: frame trace config is null");
+        return VMI_ENCODER_FRAME_TRACE_FAIL;
+    }
+    if (!VideoEncoderFrameTrace::GetInstance().Enable(*config)) {
+        ERR("VencEnableFrameTrace failed: enable frame trace failed");
+        return VMI_ENCODER_FRAME_TRACE_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 关闭逐帧追踪，已记录的事件保留到下次开启
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ */
+VmiEncoderRetCode VencDisableFrameTrace()
+{
+    VideoEncoderFrameTrace::GetInstance().Disable();
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 将各线程缓冲区中的事件导出为Chrome trace JSON
+ * @参数 [in] path: 文件路径
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_TRACE_FAIL 文件无法写入
+ */
+VmiEncoderRetCode VencExportFrameTrace(const char *path)
+{
+    if (path == nullptr) {
+        ERR("VencExportFrameTrace failed: path is null");
+        return VMI_ENCODER_FRAME_TRACE_FAIL;
+    }
+    try {
+        if (!VideoEncoderFrameTrace::GetInstance().Export(path)) {
+            return VMI_ENCODER_FRAME_TRACE_FAIL;
+        }
+    } catch (const std::bad_alloc &e) {
+        ERR("VencExportFrameTrace failed: alloc memory failed");
+        return VMI_ENCODER_FRAME_TRACE_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取逐帧追踪统计
+ * @参数 [out] stats: 追踪统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_TRACE_FAIL 参数为空
+ */
+VmiEncoderRetCode VencGetFrameTraceStats(VmiFrameTraceStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetFrameTraceStats failed: stats is null");
+        return VMI_ENCODER_FRAME_TRACE_FAIL;
+    }
+    VideoEncoderFrameTrace::GetInstance().GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+namespace {
+    struct FrameRingObject {
+        // 生产者和消费者各自的调用在本进程内串行化，两者互不阻塞
+        std::mutex producerLock = {};
+        std::mutex consumerLock = {};
+        VideoEncoderFrameRing ring;
+    };
+    // 句柄低6位为槽位下标，最多同时存在64个帧环
+    constexpr uint32_t FRAME_RING_HANDLE_INDEX_BITS = 6;
+    using FrameRingHandleTable = VideoEncoderHandleTable<FrameRingObject, FRAME_RING_HANDLE_INDEX_BITS>;
+    FrameRingHandleTable g_frameRingTable;
+}
+
+/**
+ * @功能描述: 登记已创建或映射的帧环并分配句柄
+ * @参数 [in] ringObj: 帧环对象
+ * @参数 [out] ringHandle: 帧环句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 帧环数已达上限
+ */
+VmiEncoderRetCode InsertFrameRing(std::shared_ptr<FrameRingObject> ringObj, uint32_t *ringHandle)
+{
+    uint32_t handle = g_frameRingTable.Insert(std::move(ringObj));
+    if (handle == FrameRingHandleTable::INVALID_HANDLE) {
+        ERR("insert frame ring failed: frame ring count reaches max %u", FrameRingHandleTable::CAPACITY);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    *ringHandle = handle;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 在编码进程中创建跨进程共享内存帧环
+ * @参数 [in] config: 帧环配置
+ * @参数 [out] ringHandle: 帧环句柄
+ * @参数 [out] fd: 共享内存文件描述符
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 配置无效或创建共享内存失败
+ */
+VmiEncoderRetCode VencCreateFrameRing(const VmiFrameRingConfig *config, uint32_t *ringHandle, int *fd)
+{
+    if (config == nullptr || ringHandle == nullptr || fd == nullptr) {
+        ERR("VencCreateFrameRing failed: config, ring handle or fd is null");
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    std::shared_ptr<FrameRingObject> ringObj(new (std::nothrow) FrameRingObject());
+    if (ringObj == nullptr || !ringObj->ring.Create(config->slotCount, config->slotSize)) {
+        ERR("VencCreateFrameRing failed: create %u slots of %u bytes failed", config->slotCount, config->slotSize);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    int ringFd = ringObj->ring.GetFd();
+    VmiEncoderRetCode ret = InsertFrameRing(std::move(ringObj), ringHandle);
+    if (ret == VMI_ENCODER_SUCCESS) {
+        *fd = ringFd;
+    }
+    return ret;
+}
+
+/**
+ * @功能描述: 在生产者进程中映射共享内存帧环
+ * @参数 [in] fd: 共享内存文件描述符
+ * @参数 [out] ringHandle: 帧环句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 映射失败或共享内存不是帧环
+ */
+VmiEncoderRetCode VencAttachFrameRing(int fd, uint32_t *ringHandle)
+{
+    if (ringHandle == nullptr) {
+        ERR("VencAttachFrameRing failed: ring handle is null");
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    std::shared_ptr<FrameRingObject> ringObj(new (std::nothrow) FrameRingObject());
+    if (ringObj == nullptr || !ringObj->ring.Attach(fd)) {
+        ERR("VencAttachFrameRing failed: attach fd %d failed", fd);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    return InsertFrameRing(std::move(ringObj), ringHandle);
+}
+
+/**
+ * @功能描述: 解除帧环映射
+ * @参数 [in] ringHandle: 帧环句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在
+ */
+VmiEncoderRetCode VencDestroyFrameRing(uint32_t ringHandle)
+{
+    if (g_frameRingTable.Remove(ringHandle) == nullptr) {
+        ERR("VencDestroyFrameRing failed: frame ring handle %#x does not exist.", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 生产者获取下一个空闲槽位
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [in] timeoutMs: 无空闲槽位时的等待时间，0表示不等待，小于0表示一直等待
+ * @参数 [out] slot: 槽位地址
+ * @参数 [out] slotSize: 槽位大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_TIMEOUT 等待超时
+ *          VMI_ENCODER_FRAME_RING_FAIL 获取失败
+ */
+VmiEncoderRetCode VencAcquireFrameSlot(uint32_t ringHandle, int32_t timeoutMs, uint8_t **slot, uint32_t *slotSize)
+{
+    if (slot == nullptr || slotSize == nullptr) {
+        ERR("VencAcquireFrameSlot failed: frame ring %#x slot or slot size is null", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    auto ringObj = g_frameRingTable.Find(ringHandle);
+    if (ringObj == nullptr) {
+        ERR("VencAcquireFrameSlot failed: frame ring handle %#x does not exist.", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(ringObj->producerLock);
+    return ringObj->ring.AcquireSlot(timeoutMs, *slot, *slotSize);
+}
+
+/**
+ * @功能描述: 生产者提交已写入的槽位
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [in] dataSize: 帧数据大小
+ * @参数 [in] timestampNs: 时间戳
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 提交失败
+ */
+VmiEncoderRetCode VencCommitFrameSlot(uint32_t ringHandle, uint32_t dataSize, uint64_t timestampNs)
+{
+    auto ringObj = g_frameRingTable.Find(ringHandle);
+    if (ringObj == nullptr) {
+        ERR("VencCommitFrameSlot failed: frame ring handle %#x does not exist.", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(ringObj->producerLock);
+    return ringObj->ring.CommitSlot(dataSize, timestampNs);
+}
+
+/**
+ * @功能描述: 消费者等待帧环中的下一帧，在槽位上原地编码后交还槽位
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [in] timeoutMs: 无待编码帧时的等待时间，0表示不等待，小于0表示一直等待
+ * @参数 [out] outputData: 编码输出数据地址
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [out] frame: 取出的帧信息，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_TIMEOUT 等待超时
+ *          VMI_ENCODER_FRAME_RING_FAIL 取帧失败
+ *          其他 与VencEncodeOneFrame相同
+ */
+VmiEncoderRetCode VencEncodeFromFrameRing(uint32_t encHandle, uint32_t ringHandle, int32_t timeoutMs,
+    uint8_t **outputData, uint32_t *outputSize, VmiFrameRingFrame *frame)
+{
+    // 先校验输出参数，避免取出的帧因编码参数错误而丢失
+    if (outputData == nullptr || outputSize == nullptr) {
+        ERR("VencEncodeFromFrameRing failed: encoder %#x output data or output size is null", encHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    auto ringObj = g_frameRingTable.Find(ringHandle);
+    if (ringObj == nullptr) {
+        ERR("VencEncodeFromFrameRing failed: frame ring handle %#x does not exist.", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    std::lock_guard<std::mutex> lck(ringObj->consumerLock);
+    VideoEncoderFrameRing::Frame ringFrame;
+    VmiEncoderRetCode ret = ringObj->ring.AcquireFrame(timeoutMs, ringFrame);
+    if (ret != VMI_ENCODER_SUCCESS) {
+        return ret;
+    }
+    ret = VencEncodeOneFrame(encHandle, ringFrame.data, ringFrame.dataSize, outputData, outputSize);
+    ringObj->ring.ReleaseFrame();
+    if (frame != nullptr) {
+        frame->frameSeq = ringFrame.frameSeq;
+        frame->timestampNs = ringFrame.timestampNs;
+        frame->dataSize = ringFrame.dataSize;
+    }
+    return ret;
+}
+
+/**
+ * @功能描述: 获取本进程一侧的帧环统计
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [out] stats: 帧环统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在或参数为空
+ */
+VmiEncoderRetCode VencGetFrameRingStats(uint32_t ringHandle, VmiFrameRingStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetFrameRingStats failed: frame ring %#x stats is null", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    auto ringObj = g_frameRingTable.Find(ringHandle);
+    if (ringObj == nullptr) {
+        ERR("VencGetFrameRingStats failed: frame ring handle %#x does not exist.", ringHandle);
+        return VMI_ENCODER_FRAME_RING_FAIL;
+    }
+    ringObj->ring.GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 开启异步编码，为编码器创建有界待编码队列和专属编码线程，或登记到共享编码执行器
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 异步编码配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 开启异步编码失败
+ */
+VmiEncoderRetCode VencEnableAsyncEncode(uint32_t encHandle, const VmiAsyncEncodeConfig *config)
+{
+    if (config == nullptr || config->callback == nullptr) {
+        ERR("VencEnableAsyncEncode failed: encoder %#x async config or callback is null", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    if (config->overloadPolicy > VMI_OVERLOAD_LATEST_WINS) {
+        ERR("VencEnableAsyncEncode failed: encoder %#x overload policy %u is invalid", encHandle,
+            config->overloadPolicy);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencEnableAsyncEncode failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    // 与UpdateParamsLocked相同，先实例锁后附属对象锁，开启之后的帧率变化都会同步给工作线程
+    std::lock_guard<std::mutex> instanceLck(encObj->lock);
+    std::lock_guard<std::mutex> lck(encObj->attachLock);
+    if (encObj->asyncWorker != nullptr) {
+        ERR("VencEnableAsyncEncode failed: encoder %#x async encode is already enabled", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    auto encodeFunc = [encHandle](const uint8_t *inputData, uint32_t inputSize, uint8_t **outputData,
+        uint32_t *outputSize) {
+        return VencEncodeOneFrame(encHandle, inputData, inputSize, outputData, outputSize);
+    };
+    std::weak_ptr<EncoderObject> weakObj = encObj;
+    auto inputDoneFunc = [weakObj](const uint8_t *inputData) {
+        auto owner = weakObj.lock();
+        if (owner != nullptr && owner->inputPool.IsAcquired(inputData)) {
+            (void) owner->inputPool.Release(inputData);
+        }
+    };
+    std::shared_ptr<VideoEncoderAsyncWorker> asyncWorker(
+        new (std::nothrow) VideoEncoderAsyncWorker(encHandle, *config, encObj->params.frameRate, encodeFunc,
+        inputDoneFunc));
+    if (asyncWorker == nullptr || !asyncWorker->Start()) {
+        ERR("VencEnableAsyncEncode failed: encoder %#x start async worker failed", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    encObj->asyncWorker = std::move(asyncWorker);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 关闭异步编码，等待已提交的帧全部编码并回调完成后退出编码线程
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 关闭异步编码失败
+ */
+VmiEncoderRetCode VencDisableAsyncEncode(uint32_t encHandle)
+{
+    auto asyncWorker = DetachAsyncWorker(encHandle);
+    if (asyncWorker == nullptr) {
+        ERR("VencDisableAsyncEncode failed: encoder %#x does not exist or async encode is not enabled", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    asyncWorker->Stop(true);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 异步提交一帧数据，编码完成后通过回调返回结果
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [in] timeoutMs: 队列满时的等待时间，0表示不等待，小于0表示一直等待
+ * @参数 [out] frameSeq: 分配的帧序号，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_QUEUE_FULL 等待超时后队列仍满
+ *          VMI_ENCODER_SUBMIT_FAIL 提交失败
+ */
+VmiEncoderRetCode VencSubmitFrame(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    int32_t timeoutMs, uint64_t *frameSeq)
+{
+    auto asyncWorker = GetAsyncWorker(encHandle);
+    if (asyncWorker == nullptr) {
+        ERR("VencSubmitFrame failed: encoder %#x does not exist or async encode is not enabled", encHandle);
+        return VMI_ENCODER_SUBMIT_FAIL;
+    }
+    return asyncWorker->Submit(inputData, inputSize, timeoutMs, frameSeq);
+}
+
+/**
+ * @功能描述: 等待已提交的帧全部编码并回调完成
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 未开启异步编码
+ */
+VmiEncoderRetCode VencFlushEncoder(uint32_t encHandle)
+{
+    auto asyncWorker = GetAsyncWorker(encHandle);
+    if (asyncWorker == nullptr) {
+        ERR("VencFlushEncoder failed: encoder %#x does not exist or async encode is not enabled", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    asyncWorker->Flush();
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取异步编码统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 异步编码统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 未开启异步编码
+ */
+VmiEncoderRetCode VencGetAsyncEncodeStats(uint32_t encHandle, VmiAsyncEncodeStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetAsyncEncodeStats failed: encoder %#x stats is null", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    auto asyncWorker = GetAsyncWorker(encHandle);
+    if (asyncWorker == nullptr) {
+        ERR("VencGetAsyncEncodeStats failed: encoder %#x does not exist or async encode is not enabled", encHandle);
+        return VMI_ENCODER_ASYNC_FAIL;
+    }
+    asyncWorker->GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 配置共享编码执行器的线程数和绑核策略
+ * @参数 [in] config: 执行器配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_EXECUTOR_FAIL 配置无效或仍有会话在使用执行器
+ */
+VmiEncoderRetCode VencConfigEncodeExecutor(const VmiEncodeExecutorConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencConfigEncodeExecutor failed: executor config is null");
+        return VMI_ENCODER_EXECUTOR_FAIL;
+    }
+    if (!VideoEncoderExecutor::GetInstance().Configure(*config)) {
+        return VMI_ENCODER_EXECUTOR_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取共享编码执行器统计
+ * @参数 [out] stats: 执行器统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_EXECUTOR_FAIL 参数为空
+ */
+VmiEncoderRetCode VencGetEncodeExecutorStats(VmiEncodeExecutorStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetEncodeExecutorStats failed: executor stats is null");
+        return VMI_ENCODER_EXECUTOR_FAIL;
+    }
+    VideoEncoderExecutor::GetInstance().GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 配置并启用输入缓冲池
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 缓冲池配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigInputBufferPool(uint32_t encHandle, const VmiBufferPoolConfig *config)
+{
+    if (config == nullptr) {
+        ERR("VencConfigInputBufferPool failed: encoder %#x buffer pool config is null", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencConfigInputBufferPool failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    encObj->isInputPoolEnabled = true;
+    encObj->inputPoolConfig = *config;
+    if (encObj->isInitialized && !encObj->inputPool.Init(
+        GetInputBufferSizeLocked(encObj), encObj->inputPoolConfig)) {
+        ERR("VencConfigInputBufferPool failed: encoder %#x init input buffer pool failed", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 从输入缓冲池获取一个缓冲区
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] buffer: 缓冲区地址
+ * @参数 [out] bufferSize: 缓冲区大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 缓冲池未启用或缓冲区已耗尽
+ */
+VmiEncoderRetCode VencAcquireInputBuffer(uint32_t encHandle, uint8_t **buffer, uint32_t *bufferSize)
+{
+    if (buffer == nullptr || bufferSize == nullptr) {
+        ERR("VencAcquireInputBuffer failed: encoder %#x output param is null", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencAcquireInputBuffer failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    uint32_t size = 0;
+    uint8_t *data = encObj->inputPool.Acquire(size);
+    if (data == nullptr) {
+        ERR("VencAcquireInputBuffer failed: encoder %#x input buffer pool is disabled or exhausted", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    *buffer = data;
+    *bufferSize = size;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 向输入缓冲池归还缓冲区
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] buffer: 通过VencAcquireInputBuffer获取的缓冲区地址
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 缓冲区不属于该编码器或未被占用
+ */
+VmiEncoderRetCode VencReleaseInputBuffer(uint32_t encHandle, uint8_t *buffer)
+{
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencReleaseInputBuffer failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    if (!encObj->inputPool.Release(buffer)) {
+        ERR("VencReleaseInputBuffer failed: encoder %#x buffer %p is not acquired from pool", encHandle, buffer);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 获取输入缓冲池统计信息
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 统计信息
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 获取失败
+ */
+VmiEncoderRetCode VencGetInputBufferPoolStats(uint32_t encHandle, VmiBufferPoolStats *stats)
+{
+    if (stats == nullptr) {
+        ERR("VencGetInputBufferPoolStats failed: encoder %#x stats is null", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencGetInputBufferPoolStats failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_BUFFER_FAIL;
+    }
+    encObj->inputPool.GetStats(*stats);
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 配置并启用输出环
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 输出环配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_OUTPUT_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigOutputRing(uint32_t encHandle, const VmiOutputRingConfig *config)
+{
+    if (config == nullptr || config->slotCount > OUTPUT_RING_SLOT_COUNT_MAX) {
+        ERR("VencConfigOutputRing failed: encoder %#x output ring config is null or slot count exceeds %u",
+            encHandle, OUTPUT_RING_SLOT_COUNT_MAX);
+        return VMI_ENCODER_OUTPUT_FAIL;
+    }
+    auto encObj = AcquireEncoder(encHandle);
+    if (!encObj) {
+        ERR("VencConfigOutputRing failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_OUTPUT_FAIL;
+    }
+    uint32_t slotCount = (config->slotCount == 0) ? OUTPUT_RING_SLOT_COUNT_DEFAULT : config->slotCount;
+    if (!encObj->outputRing.Init(slotCount, config->slotSize)) {
+        ERR("VencConfigOutputRing failed: encoder %#x init output ring failed", encHandle);
+        return VMI_ENCODER_OUTPUT_FAIL;
+    }
+    encObj->isOutputRingEnabled = true;
+    return VMI_ENCODER_SUCCESS;
+}
+
+/**
+ * @功能描述: 释放输出环中的一帧输出数据
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] outputData: 编码输出数据地址
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_OUTPUT_FAIL 地址不属于该编码器输出环或已释放
+ */
+VmiEncoderRetCode VencReleaseOutputBuffer(uint32_t encHandle, uint8_t *outputData)
+{
+    auto encObj = g_encoderTable.Find(encHandle);
+    if (encObj == nullptr) {
+        ERR("VencReleaseOutputBuffer failed: encoder handle %#x does not exist.", encHandle);
+        return VMI_ENCODER_OUTPUT_FAIL;
+    }
+    if (!encObj->outputRing.Release(outputData)) {
+        ERR("VencReleaseOutputBuffer failed: encoder %#x buffer %p is not held in output ring",
+            encHandle, outputData);
+        return VMI_ENCODER_OUTPUT_FAIL;
     }
     return VMI_ENCODER_SUCCESS;
 }
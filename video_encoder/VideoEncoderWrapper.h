@@ -15,7 +15,42 @@ enum VmiEncoderRetCode : uint32_t {
     VMI_ENCODER_ENCODE_FAIL   = 0x04,  // 编码失败
     VMI_ENCODER_STOP_FAIL     = 0x05,  // 停止编码器失败
     VMI_ENCODER_DESTROY_FAIL  = 0x06,  // 销毁编码器失败
-    VMI_ENCODER_REGISTER_FAIL = 0x07   // 注册函数失败
+    VMI_ENCODER_REGISTER_FAIL = 0x07,  // 注册函数失败
+    VMI_ENCODER_ASYNC_FAIL    = 0x08,  // 设置异步编码失败
+    VMI_ENCODER_SUBMIT_FAIL   = 0x09,  // 提交编码帧失败
+    VMI_ENCODER_QUEUE_FULL    = 0x0A,  // 异步编码队列已满
+    VMI_ENCODER_FRAME_DROPPED = 0x0B,  // 帧未编码即被丢弃
+    VMI_ENCODER_BUFFER_FAIL   = 0x0C,  // 输入缓冲区操作失败
+    VMI_ENCODER_OUTPUT_FAIL   = 0x0D,  // 输出缓冲区不足或操作失败
+    VMI_ENCODER_RESET_FAIL    = 0x0E,  // 重置编码器失败
+    VMI_ENCODER_FORCE_KEY_FRAME_FAIL = 0x0F,  // 强制I帧失败
+    VMI_ENCODER_SET_PARAMS_FAIL = 0x10,  // 设置编码参数失败
+    VMI_ENCODER_RATE_CONTROL_FAIL = 0x11,  // 码控操作失败
+    VMI_ENCODER_STATS_FAIL    = 0x12,  // 获取或清零统计失败
+    VMI_ENCODER_WARM_POOL_FAIL = 0x13,  // 预热池操作失败
+    VMI_ENCODER_SCHEDULER_FAIL = 0x14,  // 编码器调度配置或查询失败
+    VMI_ENCODER_DIRTY_DETECT_FAIL = 0x15,  // 变化区域检测操作失败
+    VMI_ENCODER_SIMULCAST_FAIL = 0x16,  // 联播组配置或查询失败
+    VMI_ENCODER_EXECUTOR_FAIL = 0x17,  // 共享编码执行器配置或查询失败
+    VMI_ENCODER_PARAMETER_SETS_FAIL = 0x18,  // 参数集尚未生成或获取失败
+    VMI_ENCODER_CAPTURE_FAIL = 0x19,  // 抓取操作失败
+    VMI_ENCODER_FRAME_TRACE_FAIL = 0x1A,  // 逐帧追踪操作失败
+    VMI_ENCODER_FRAME_RING_FAIL = 0x1B,  // 共享内存帧环操作失败
+    VMI_ENCODER_FRAME_RING_TIMEOUT = 0x1C  // 等待帧环空闲槽位或待编码帧超时
+};
+
+// 编码器类型，与厂商编解码库的编码器类型取值一致
+enum VmiEncoderType : uint32_t {
+    VMI_ENCODER_TYPE_OPENH264 = 0x01,    // 开源OpenH264软件编码器
+    VMI_ENCODER_TYPE_NETINTH264 = 0x02,  // NETINT h.264硬件编码器
+    VMI_ENCODER_TYPE_NETINTH265 = 0x03   // NETINT h.265硬件编码器，与h.264共用同一硬件设备
+};
+
+// 编码档位
+enum VmiEncodeProfile : uint32_t {
+    VMI_ENCODE_PROFILE_BASELINE = 0x00,
+    VMI_ENCODE_PROFILE_MAIN     = 0x01,
+    VMI_ENCODE_PROFILE_HIGH     = 0x02
 };
 
 // 编码参数
@@ -24,6 +59,361 @@ struct VmiEncodeParams {
     uint32_t height = 0;     // 编码输入/输出高度
     uint32_t frameRate = 0;  // 编码输入帧率
     uint32_t bitrate = 0;    // 编码输出码率
+    uint32_t gopSize = 0;    // 关键帧间隔，0表示使用默认值300
+    uint32_t profile = VMI_ENCODE_PROFILE_BASELINE;  // 编码档位，取值见VmiEncodeProfile
+};
+
+// 输入像素格式
+enum VmiPixelFormat : uint32_t {
+    VMI_PIXEL_FORMAT_I420 = 0x00,  // YUV420平面格式，依次为Y、U、V平面，编码器原生格式
+    VMI_PIXEL_FORMAT_NV12 = 0x01,  // YUV420半平面格式，Y平面之后为UV交错平面
+    VMI_PIXEL_FORMAT_RGBA = 0x02,  // 每像素4字节，内存中依次为R、G、B、A
+    VMI_PIXEL_FORMAT_BGRA = 0x03   // 每像素4字节，内存中依次为B、G、R、A
+};
+
+// 输入格式，非紧密排列的I420及其他格式在编码前转换为紧密排列的I420
+struct VmiInputFormat {
+    uint32_t pixelFormat = VMI_PIXEL_FORMAT_I420;  // 像素格式，取值见VmiPixelFormat
+    uint32_t stride = 0;          // 首个平面的行跨度，单位字节，0表示紧密排列；I420色度平面的行跨度为其一半
+                                  // (向上取整)，NV12的UV平面行跨度与之相同
+    uint32_t convertThreads = 0;  // 格式转换线程数，按行分带并行转换，0表示按分辨率自动选择
+};
+
+// 异步编码输出
+struct VmiEncodeOutput {
+    uint64_t frameSeq = 0;                        // 帧序号，由VencSubmitFrame按提交顺序分配
+    VmiEncoderRetCode result = VMI_ENCODER_SUCCESS;  // 该帧编码结果
+    const uint8_t *inputData = nullptr;           // 该帧编码输入数据地址，回调返回后调用者可复用
+    uint32_t inputSize = 0;                       // 该帧编码输入数据大小
+    uint8_t *outputData = nullptr;                // 编码输出数据地址，未启用输出环时仅在回调期间有效，
+                                                  // 启用输出环时在VencReleaseOutputBuffer之前有效
+    uint32_t outputSize = 0;                      // 编码输出数据大小
+};
+
+/**
+ * @功能描述: 异步编码完成回调，在编码器工作线程或共享执行器线程上按提交顺序调用，每个提交的帧恰好回调一次
+ *            回调中不能对同一句柄调用VencFlushEncoder、VencDisableAsyncEncode、VencStopEncoder或VencDestroyEncoder；
+ *            使用共享执行器时回调阻塞会推迟其他会话的编码
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] output: 编码输出
+ * @参数 [in] userData: 注册时传入的用户数据
+ */
+using VmiEncodeOutputCallback = void (*)(uint32_t encHandle, const VmiEncodeOutput *output, void *userData);
+
+// 异步编码过载策略，决定编码慢于提交时如何处理积压的帧
+enum VmiOverloadPolicy : uint32_t {
+    VMI_OVERLOAD_BLOCK = 0x00,        // 队列满时提交按timeoutMs等待，积压的帧依次编码，时延随积压增长
+    VMI_OVERLOAD_LATEST_WINS = 0x01   // 待编码帧数达到队列深度时新帧替换最旧的未编码帧，被替换的帧在工作线程上
+                                      // 以VMI_ENCODER_FRAME_DROPPED回调，回调前仍占用队列槽位。编码一帧期间
+                                      // 替换的帧累计占满64个槽位时，提交仍按timeoutMs等待，超时返回
+                                      // VMI_ENCODER_QUEUE_FULL
+};
+
+// 异步编码配置
+struct VmiAsyncEncodeConfig {
+    uint32_t queueDepth = 0;                    // 待编码队列深度，0表示使用默认值
+    VmiEncodeOutputCallback callback = nullptr;  // 编码完成回调，不能为空
+    void *userData = nullptr;                   // 透传给回调的用户数据
+    bool useSharedExecutor = false;  // 由进程内共享的编码执行器编码，不创建专属编码线程
+    uint32_t deadlineMs = 0;         // 帧从提交到编码完成的时限，共享执行器优先编码截止时间最早的帧，
+                                     // 0表示编码参数frameRate的一帧间隔，未设置帧率时按30帧/秒
+    uint32_t overloadPolicy = VMI_OVERLOAD_BLOCK;  // 过载策略，取值见VmiOverloadPolicy，LATEST_WINS时
+                                                   // queueDepth为0表示1，即只保留最新的一帧
+    bool dropLateFrames = false;     // 开始编码时预计无法在截止时间前完成、且其后还有待编码帧的帧不编码，
+                                     // 以VMI_ENCODER_FRAME_DROPPED回调，最新的帧总会被编码
+    bool adaptiveFrameRate = false;  // 编码耗时超过帧间隔时按两者之比抽帧，被抽掉的帧由VencSubmitFrame
+                                     // 直接返回VMI_ENCODER_FRAME_DROPPED，不分配帧序号也不回调
+};
+
+// 异步编码统计
+struct VmiAsyncEncodeStats {
+    uint64_t submittedFrames = 0;  // 提交的帧数
+    uint64_t encodedFrames = 0;    // 送编码器编码的帧数，包括编码失败的帧
+    uint64_t droppedFrames = 0;    // 未编码即被丢弃的帧数
+    uint64_t deadlineMisses = 0;   // 编码完成晚于截止时间的帧数
+    uint64_t queueWaitAvgUs = 0;   // 从提交到开始编码的等待时间均值，单位微秒
+    uint64_t queueWaitMaxUs = 0;   // 从提交到开始编码的等待时间最大值，单位微秒
+    uint64_t latencyAvgUs = 0;     // 从提交到编码完成的时延均值，单位微秒
+    uint64_t latencyMaxUs = 0;     // 从提交到编码完成的时延最大值，单位微秒
+    uint64_t replacedFrames = 0;   // LATEST_WINS策略下被新帧替换的帧数，计入droppedFrames
+    uint64_t lateDroppedFrames = 0;  // 预计超过截止时间而丢弃的帧数，计入droppedFrames
+    uint64_t decimatedFrames = 0;  // 自适应抽帧在提交时拒绝的帧数，不计入submittedFrames
+    uint32_t decimation = 1;       // 当前抽帧倍数，每decimation帧接受一帧
+    uint64_t encodeTimeUs = 0;     // 单帧编码耗时的滑动平均，单位微秒，超时丢帧和自适应抽帧据此估计
+};
+
+// 共享编码执行器绑核策略
+enum VmiExecutorAffinity : uint32_t {
+    VMI_EXECUTOR_AFFINITY_NONE = 0x00,  // 不绑定
+    VMI_EXECUTOR_AFFINITY_CORE = 0x01,  // 每个线程绑定一个CPU，线程数多于CPU数时循环分配
+    VMI_EXECUTOR_AFFINITY_NODE = 0x02   // 每个线程绑定一个NUMA节点的全部CPU，按节点循环分配
+};
+
+// 共享编码执行器配置
+struct VmiEncodeExecutorConfig {
+    uint32_t threadCount = 0;  // 工作线程数，0表示进程可用的CPU数
+    uint32_t affinity = VMI_EXECUTOR_AFFINITY_NONE;  // 绑核策略，取值见VmiExecutorAffinity
+};
+
+// 共享编码执行器统计
+struct VmiEncodeExecutorStats {
+    uint32_t threadCount = 0;     // 运行中的工作线程数，尚无会话使用时为0
+    uint32_t affinity = VMI_EXECUTOR_AFFINITY_NONE;  // 绑核策略
+    uint32_t sessions = 0;        // 使用执行器的会话数
+    uint64_t queuedTasks = 0;     // 有待编码帧、等待工作线程的会话数
+    uint64_t tasksExecuted = 0;   // 执行的编码步骤数，每步编码或丢弃一个会话的一帧
+    uint64_t steals = 0;          // 从其他工作线程本地队列窃取的步骤数
+    uint64_t deadlineMisses = 0;  // 所有会话编码完成晚于截止时间的帧数
+};
+
+// 输入缓冲池配置
+struct VmiBufferPoolConfig {
+    uint32_t initCount = 0;    // 初始化编码器时预分配的缓冲区个数，0表示使用默认值
+    uint32_t maxCount = 0;     // 缓冲区个数上限，0表示使用默认值
+    bool useHugePage = false;  // 优先使用大页内存
+};
+
+// 输入缓冲池统计信息
+struct VmiBufferPoolStats {
+    uint32_t bufferSize = 0;       // 单个缓冲区大小，按编码宽高和输入格式计算的一帧输入数据大小
+    uint32_t totalBuffers = 0;     // 当前已分配的缓冲区个数
+    uint32_t acquiredBuffers = 0;  // 当前被占用的缓冲区个数
+    uint32_t highWaterMark = 0;    // 同时被占用的缓冲区个数峰值
+    uint64_t hits = 0;             // 直接复用空闲缓冲区的次数
+    uint64_t misses = 0;           // 无空闲缓冲区的次数
+    uint64_t exhausted = 0;        // 无空闲缓冲区且已达上限导致获取失败的次数
+};
+
+// 输出环配置
+struct VmiOutputRingConfig {
+    uint32_t slotCount = 0;  // 槽位个数，即可同时被调用者持有的输出帧个数，0表示使用默认值
+    uint32_t slotSize = 0;   // 每个槽位的预分配大小，帧码流超过该大小时槽位自动扩容
+};
+
+// 分散输出缓冲区描述
+struct VmiIoVec {
+    uint8_t *base = nullptr;  // 缓冲区地址
+    uint32_t len = 0;         // 缓冲区大小
+};
+
+// 码控策略类型
+enum VmiRateControlPolicyType : uint32_t {
+    VMI_RATE_CONTROL_POLICY_AIMD = 0x00  // 根据丢包和时延加性增、乘性减，并按可用带宽封顶
+};
+
+// 码控配置
+struct VmiRateControlConfig {
+    uint32_t policy = VMI_RATE_CONTROL_POLICY_AIMD;  // 码控策略，取值见VmiRateControlPolicyType
+    uint32_t minBitrate = 0;        // 码率下限，0表示开启码控时码率上限的1/8
+    uint32_t maxBitrate = 0;        // 码率上限，0表示开启码控时的码率
+    uint32_t minFrameRate = 0;      // 帧率下限，0表示帧率上限的1/2
+    uint32_t maxFrameRate = 0;      // 帧率上限，0表示开启码控时的帧率
+    uint32_t minIntervalMs = 0;     // 两次上调之间的最小间隔，下调间隔为其1/4，0表示使用默认值1000ms
+    uint32_t thresholdPercent = 0;  // 码率变化超过当前码率的该百分比才下发，0表示使用默认值10
+};
+
+// 网络反馈
+struct VmiNetworkFeedback {
+    uint32_t rttMs = 0;             // 往返时延，单位毫秒，0表示未知
+    uint32_t lossPermille = 0;      // 丢包率，千分比
+    uint32_t availableBitrate = 0;  // 可用带宽估计，单位bps，0表示未知
+};
+
+// 编码统计，时延为单帧调用编码器编码接口的耗时
+struct VmiEncoderStats {
+    uint32_t activeEncoders = 0;   // 存活编码器个数，仅进程级汇总有效
+    uint64_t framesEncoded = 0;    // 编码成功帧数
+    uint64_t encodeFailures = 0;   // 编码失败帧数
+    uint64_t keyFrames = 0;        // 关键帧数
+    uint64_t inputBytes = 0;       // 编码输入字节数
+    uint64_t outputBytes = 0;      // 编码输出字节数
+    uint64_t encodeTimeAvgUs = 0;  // 编码耗时均值，单位微秒
+    uint64_t encodeTimeP50Us = 0;  // 编码耗时中位数，单位微秒
+    uint64_t encodeTimeP99Us = 0;  // 编码耗时99分位，单位微秒
+    uint64_t encodeTimeMaxUs = 0;  // 编码耗时最大值，单位微秒
+    uint64_t lockWaitTotalUs = 0;  // 查找句柄和等待实例锁的累计时间，单位微秒
+    uint64_t lockWaitMaxUs = 0;    // 查找句柄和等待实例锁的最大时间，单位微秒
+};
+
+// 预热池配置，池中为已初始化并处于重置状态的编码器，按编码器类型和编码参数区分
+struct VmiWarmPoolConfig {
+    uint32_t maxIdleEncoders = 0;      // 空闲编码器总数上限，0表示关闭预热池
+    uint32_t maxIdlePerKey = 0;        // 相同类型和参数的空闲编码器上限，0表示只受总数限制
+    uint32_t idleTimeoutMs = 0;        // 空闲超时时间，超时的编码器被销毁，0表示使用默认值60000
+    bool keepLibraryResident = false;  // 无存活编码器时仍保持编解码库加载
+};
+
+// 预热池统计
+struct VmiWarmPoolStats {
+    uint32_t idleEncoders = 0;  // 当前空闲编码器个数
+    uint64_t hits = 0;          // 创建编码器时从池中取得编码器的次数
+    uint64_t misses = 0;        // 创建编码器时池中无可用编码器的次数
+    uint64_t reconfigs = 0;     // 初始化时池中无相同参数的编码器，对取得的编码器重设参数的次数
+    uint64_t evictions = 0;     // 因超时或超出上限被销毁的空闲编码器个数
+};
+
+// 编码器类型选择策略
+enum VmiEncoderSelectPolicy : uint32_t {
+    VMI_ENCODER_SELECT_PREFERENCE = 0x00,   // 按候选顺序选择第一个未满载的类型
+    VMI_ENCODER_SELECT_LEAST_LOADED = 0x01  // 选择负载率最低的类型，负载率相同时按候选顺序
+};
+
+constexpr uint32_t VMI_ENCODER_TYPE_LIST_MAX = 4;
+
+// 编码器类型选择配置
+struct VmiEncoderSelectConfig {
+    uint32_t encTypes[VMI_ENCODER_TYPE_LIST_MAX] = {};  // 候选编码器类型，按优先顺序排列
+    uint32_t typeCount = 0;  // 候选个数，0表示只使用系统属性配置的类型
+    uint32_t policy = VMI_ENCODER_SELECT_PREFERENCE;  // 选择策略，取值见VmiEncoderSelectPolicy
+};
+
+// 编码器类型容量配置，超出任一上限的类型不再被选择
+struct VmiEncoderBackendConfig {
+    uint32_t maxSessions = 0;   // 存活会话数上限，0表示不限制
+    uint64_t maxPixelRate = 0;  // 每秒编码像素数(宽×高×帧率)之和的上限，0表示不限制
+};
+
+// 编码器类型调度统计
+struct VmiEncoderBackendStats {
+    uint32_t liveSessions = 0;    // 该类型存活会话数
+    uint32_t deviceSessions = 0;  // 同一设备上所有类型的存活会话数
+    uint64_t pixelRate = 0;       // 该类型存活会话的每秒编码像素数之和
+    uint64_t placements = 0;      // 选择该类型并创建成功的次数
+    uint64_t createFailures = 0;  // 创建编码器失败次数
+    uint64_t initFailures = 0;    // 初始化编码器失败次数
+    uint64_t fallbacks = 0;       // 该类型失败后回退到下一候选的次数
+    bool isSaturated = false;     // 设备因创建或初始化失败被临时标记为满载
+};
+
+// 静止帧处理策略
+enum VmiStaticFramePolicy : uint32_t {
+    VMI_STATIC_FRAME_ENCODE = 0x00,  // 静止帧照常编码，只检测并上报变化区域
+    VMI_STATIC_FRAME_SKIP = 0x01     // 跳过静止帧，不调用编码器，编码成功且输出大小为0
+};
+
+// 变化区域检测配置
+struct VmiDirtyDetectConfig {
+    uint32_t policy = VMI_STATIC_FRAME_SKIP;  // 静止帧处理策略，取值见VmiStaticFramePolicy
+    uint32_t repeatIntervalMs = 0;  // 跳过策略下距上次编码超过该时间的静止帧仍送编码器编码，0表示一直跳过
+};
+
+// 矩形区域，单位像素
+struct VmiRect {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// 变化区域检测统计
+struct VmiDirtyDetectStats {
+    uint32_t tileSize = 0;         // 亮度分块边长，单位像素
+    uint32_t tilesPerFrame = 0;    // 每帧分块数
+    uint64_t framesChecked = 0;    // 经过检测的帧数
+    uint64_t staticFrames = 0;     // 无变化的帧数
+    uint64_t skippedFrames = 0;    // 被跳过未编码的帧数
+    uint64_t hintedFrames = 0;     // 使用调用者提供的变化区域、未扫描的帧数
+    uint64_t dirtyTiles = 0;       // 累计变化分块数
+    uint64_t detectTimeAvgUs = 0;  // 单帧检测耗时均值，单位微秒
+    uint64_t detectTimeMaxUs = 0;  // 单帧检测耗时最大值，单位微秒
+};
+
+constexpr uint32_t VMI_SIMULCAST_LAYER_MAX = 4;
+
+// 联播组配置，同一输入帧按各层参数缩放后分别编码
+struct VmiSimulcastConfig {
+    uint32_t encType = 0;      // 各层编码器类型，取值见VmiEncoderType，0表示使用系统属性
+    uint32_t inputWidth = 0;   // 输入帧宽度
+    uint32_t inputHeight = 0;  // 输入帧高度
+    VmiInputFormat inputFormat = {};  // 输入格式，各层共享一次格式转换
+    uint32_t layerCount = 0;   // 层数，取值范围[1, VMI_SIMULCAST_LAYER_MAX]
+    VmiEncodeParams layers[VMI_SIMULCAST_LAYER_MAX] = {};  // 各层编码参数，宽高不能大于输入宽高
+};
+
+// 联播单层编码输出
+struct VmiSimulcastLayerOutput {
+    uint32_t encHandle = 0;                          // 该层编码器对象句柄
+    VmiEncoderRetCode result = VMI_ENCODER_SUCCESS;  // 该层编码结果
+    uint8_t *outputData = nullptr;  // 编码输出数据地址，有效期与该层句柄上VencEncodeOneFrame的输出相同
+    uint32_t outputSize = 0;        // 编码输出数据大小
+};
+
+// 编码帧信息中记录的NAL单元个数上限
+constexpr uint32_t VMI_NAL_UNIT_MAX = 32;
+
+// 编码输出中的一个NAL单元
+struct VmiNalUnit {
+    uint32_t offset = 0;  // NAL头相对编码输出起始地址的偏移，不含起始码
+    uint32_t size = 0;    // NAL单元大小，从NAL头到下一个起始码之前，不含末尾的补零字节
+    uint32_t type = 0;    // NAL单元类型，h.264取NAL头低5位，h.265取NAL头第1~6位
+};
+
+// 编码帧信息
+struct VmiEncodeFrameInfo {
+    uint64_t timestampUs = 0;        // 开始编码时的单调时钟时间，单位微秒
+    uint32_t encodeTimeUs = 0;       // 编码器编码该帧的耗时，单位微秒，跳过的静止帧为0
+    bool isKeyFrame = false;         // 是否为关键帧，即h.264 IDR帧或h.265 IRAP帧
+    bool hasParameterSets = false;   // 是否携带参数集，即h.264 SPS/PPS或h.265 VPS/SPS/PPS
+    uint32_t nalCount = 0;           // nals中记录的NAL单元个数，不超过VMI_NAL_UNIT_MAX
+    uint32_t nalTotal = 0;           // 编码输出中的NAL单元总数，超过VMI_NAL_UNIT_MAX时只记录前面的NAL单元
+    VmiNalUnit nals[VMI_NAL_UNIT_MAX] = {};  // 按码流顺序排列的NAL单元
+};
+
+// 编码会话抓取配置
+struct VmiCaptureConfig {
+    const char *path = nullptr;  // 抓取文件路径，文件已存在时覆盖
+    uint32_t maxFileSizeMb = 0;  // 抓取文件大小上限，单位MB，达到上限后不再记录，0表示1024
+};
+
+// 编码会话抓取统计
+struct VmiCaptureStats {
+    uint64_t frames = 0;         // 已记录的帧数
+    uint64_t droppedFrames = 0;  // 因达到文件大小上限未记录的帧数
+    uint64_t inputBytes = 0;     // 已记录帧的输入数据总大小
+    uint64_t fileBytes = 0;      // 抓取文件已写入的大小
+    bool isFull = false;         // 是否已达到文件大小上限
+};
+
+// 逐帧追踪输出方式，可组合
+enum VmiFrameTraceMode : uint32_t {
+    VMI_FRAME_TRACE_BUFFER = 0x01,  // 记录到每线程环形缓冲区，由VencExportFrameTrace导出为Chrome trace JSON
+    VMI_FRAME_TRACE_ATRACE = 0x02   // 实时写入内核trace_marker(ATrace格式)，由systrace/Perfetto采集
+};
+
+// 逐帧追踪配置
+struct VmiFrameTraceConfig {
+    uint32_t modes = VMI_FRAME_TRACE_BUFFER;  // 输出方式，取值见VmiFrameTraceMode
+    uint32_t eventsPerThread = 0;  // 每线程缓冲区可容纳的事件数，向上取整为2的幂，写满后覆盖最旧的事件，0表示65536
+};
+
+// 逐帧追踪统计
+struct VmiFrameTraceStats {
+    uint64_t recordedEvents = 0;     // 本次开启以来记录的事件数
+    uint64_t overwrittenEvents = 0;  // 因缓冲区写满被覆盖的事件数
+    uint32_t threads = 0;            // 分配了缓冲区的线程数
+};
+
+// 共享内存帧环配置
+struct VmiFrameRingConfig {
+    uint32_t slotCount = 0;  // 帧槽位个数，向上取整为2的幂，0表示4，最大64
+    uint32_t slotSize = 0;   // 单个帧槽位大小，不能为0，向上取整为页大小的整数倍
+};
+
+// 从共享内存帧环取出并编码的帧
+struct VmiFrameRingFrame {
+    uint64_t frameSeq = 0;     // 帧序号，按生产者提交顺序从0开始连续分配
+    uint64_t timestampNs = 0;  // 生产者提交时传入的时间戳
+    uint32_t dataSize = 0;     // 帧数据大小
+};
+
+// 共享内存帧环统计，只统计本进程一侧的调用
+struct VmiFrameRingStats {
+    uint32_t slotCount = 0;
+    uint32_t slotSize = 0;
+    uint64_t frames = 0;    // 生产者一侧为提交的帧数，消费者一侧为取出的帧数
+    uint64_t waits = 0;     // 无空闲槽位或无待编码帧而睡眠等待的次数
+    uint64_t wakeups = 0;   // 对端正在等待而唤醒对端的次数
+    uint64_t timeouts = 0;  // 等待超时的次数
 };
 
 #ifdef __cplusplus
@@ -39,6 +429,37 @@ extern "C"
  */
 VmiEncoderRetCode VencCreateEncoder(uint32_t *encHandle);
 
+/**
+ * @功能描述: 按候选编码器类型创建并初始化编码器。按选择策略对候选排序，跳过已达容量上限的类型，
+ *            创建或初始化失败时自动回退到下一候选
+ * @参数 [in] selectConfig: 编码器类型选择配置
+ * @参数 [in] encParams: 编码参数结构体
+ * @参数 [out] encHandle: 编码器对象句柄
+ * @参数 [out] encType: 实际使用的编码器类型，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CREATE_FAIL 所有候选类型均创建或初始化失败
+ */
+VmiEncoderRetCode VencCreateEncoderEx(const VmiEncoderSelectConfig *selectConfig, const VmiEncodeParams encParams,
+    uint32_t *encHandle, uint32_t *encType);
+
+/**
+ * @功能描述: 配置编码器类型的容量上限
+ * @参数 [in] encType: 编码器类型
+ * @参数 [in] config: 容量配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SCHEDULER_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigEncoderBackend(uint32_t encType, const VmiEncoderBackendConfig *config);
+
+/**
+ * @功能描述: 获取编码器类型的调度统计
+ * @参数 [in] encType: 编码器类型
+ * @参数 [out] stats: 调度统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SCHEDULER_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetEncoderBackendStats(uint32_t encType, VmiEncoderBackendStats *stats);
+
 /**
  * @功能描述: 初始化编码器
  * @参数 [in] encHandle: 编码器对象句柄
@@ -48,6 +469,18 @@ VmiEncoderRetCode VencCreateEncoder(uint32_t *encHandle);
  */
 VmiEncoderRetCode VencInitEncoder(uint32_t encHandle, const VmiEncodeParams encParams);
 
+/**
+ * @功能描述: 按指定输入格式初始化编码器，之后各编码接口的输入为该格式的一帧数据。RGBA/BGRA按BT.601
+ *            有限范围转换，色度取2x2像素的平均值；已按相同编码参数初始化时只更新输入格式
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] encParams: 编码参数结构体
+ * @参数 [in] inputFormat: 输入格式，为空时等同于VencInitEncoder
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_INIT_FAIL 输入格式无效或初始化编码器失败
+ */
+VmiEncoderRetCode VencInitEncoderEx(uint32_t encHandle, const VmiEncodeParams encParams,
+    const VmiInputFormat *inputFormat);
+
 /**
  * @功能描述: 启动编码器
  * @参数 [in] encHandle: 编码器对象句柄
@@ -58,6 +491,8 @@ VmiEncoderRetCode VencStartEncoder(uint32_t encHandle);
 
 /**
  * @功能描述: 编码器编码一帧数据
+ *            未启用输出环时，输出数据由编码器持有，在同一句柄的下一次编码、停止或销毁之前有效；
+ *            启用输出环时，输出数据位于输出环槽位中，在调用VencReleaseOutputBuffer之前有效
  * @参数 [in] encHandle: 编码器对象句柄
  * @参数 [in] inputData: 编码输入数据地址
  * @参数 [in] inputSize: 编码输入数据大小
@@ -65,10 +500,56 @@ VmiEncoderRetCode VencStartEncoder(uint32_t encHandle);
  * @参数 [out] outputSize: 编码输出数据大小
  * @返回值: VMI_ENCODER_SUCCESS 成功
  *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 输出环无空闲槽位，该帧未编码；写入输出环失败时该帧被丢弃，下一帧编码为I帧
  */
 VmiEncoderRetCode VencEncodeOneFrame(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
     uint8_t **outputData, uint32_t *outputSize);
 
+/**
+ * @功能描述: 编码器编码一帧数据，同时返回该帧的NAL单元索引、帧类型、时间戳和编码耗时，
+ *            调用者无需再扫描码流查找起始码；跳过的静止帧输出大小和NAL单元个数均为0
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [out] outputData: 编码输出数据地址，有效期与VencEncodeOneFrame的输出相同
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [out] frameInfo: 编码帧信息
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 输出环无空闲槽位，该帧未编码；写入输出环失败时该帧被丢弃，下一帧编码为I帧
+ */
+VmiEncoderRetCode VencEncodeOneFrameEx(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    uint8_t **outputData, uint32_t *outputSize, VmiEncodeFrameInfo *frameInfo);
+
+/**
+ * @功能描述: 获取编码器最近输出的参数集，即h.264 SPS/PPS或h.265 VPS/SPS/PPS，按码流顺序排列，
+ *            每个参数集前带4字节起始码。新观众加入时可先发送参数集，等待下一个关键帧即可解码，
+ *            可与同一句柄上的编码并发调用且不会等待正在进行的编码
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] buffer: 参数集输出缓冲区，为空且bufferSize为0时只查询所需大小
+ * @参数 [in] bufferSize: 输出缓冲区大小
+ * @参数 [out] size: 参数集大小，缓冲区不足时为所需大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_OUTPUT_FAIL 缓冲区不足
+ *          VMI_ENCODER_PARAMETER_SETS_FAIL 编码器不存在，或自初始化或修改分辨率以来尚未输出完整的参数集
+ */
+VmiEncoderRetCode VencGetParameterSets(uint32_t encHandle, uint8_t *buffer, uint32_t bufferSize, uint32_t *size);
+
+/**
+ * @功能描述: 编码器编码一帧数据，码流直接写入调用者提供的分散缓冲区，例如网络发送缓冲区
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [in] iov: 输出缓冲区数组，按顺序依次填充
+ * @参数 [in] iovCount: 输出缓冲区个数
+ * @参数 [out] outputSize: 编码输出数据大小，缓冲区不足时为该帧所需大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ENCODE_FAIL 编码一帧失败
+ *          VMI_ENCODER_OUTPUT_FAIL 缓冲区总大小不足，该帧码流被丢弃，下一帧编码为I帧
+ */
+VmiEncoderRetCode VencEncodeOneFrameToBuffer(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    const VmiIoVec *iov, uint32_t iovCount, uint32_t *outputSize);
+
 /**
  * @功能描述: 停止编码器
  * @参数 [in] encHandle: 编码器对象句柄
@@ -85,6 +566,471 @@ VmiEncoderRetCode VencStopEncoder(uint32_t encHandle);
  */
 VmiEncoderRetCode VencDestroyEncoder(uint32_t encHandle);
 
+/**
+ * @功能描述: 运行时修改编码参数，无需重新创建编码器，参数与当前一致时不做任何操作
+ *            可与同一句柄上的编码并发调用，修改在当前正在编码的帧完成后生效；
+ *            异步编码时修改宽高前应先调用VencFlushEncoder，避免已提交的旧尺寸帧按新尺寸编码
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] encParams: 编码参数结构体
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SET_PARAMS_FAIL 设置编码参数失败
+ */
+VmiEncoderRetCode VencSetEncodeParams(uint32_t encHandle, const VmiEncodeParams encParams);
+
+/**
+ * @功能描述: 强制下一帧编码为I帧，用于丢包恢复或新观众加入
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FORCE_KEY_FRAME_FAIL 强制I帧失败
+ */
+VmiEncoderRetCode VencForceKeyFrame(uint32_t encHandle);
+
+/**
+ * @功能描述: 重置编码器，保留当前编码参数
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RESET_FAIL 重置编码器失败
+ */
+VmiEncoderRetCode VencResetEncoder(uint32_t encHandle);
+
+/**
+ * @功能描述: 开启闭环码控，根据编码输出大小和网络反馈自动调整码率和帧率，需在初始化编码器后调用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 码控配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RATE_CONTROL_FAIL 开启码控失败
+ */
+VmiEncoderRetCode VencEnableRateControl(uint32_t encHandle, const VmiRateControlConfig *config);
+
+/**
+ * @功能描述: 关闭闭环码控，保持当前编码参数
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RATE_CONTROL_FAIL 关闭码控失败
+ */
+VmiEncoderRetCode VencDisableRateControl(uint32_t encHandle);
+
+/**
+ * @功能描述: 上报网络反馈，供闭环码控使用，可在任意线程调用且不会等待正在进行的编码
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] feedback: 网络反馈
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_RATE_CONTROL_FAIL 未开启码控
+ */
+VmiEncoderRetCode VencReportNetworkFeedback(uint32_t encHandle, const VmiNetworkFeedback *feedback);
+
+/**
+ * @功能描述: 获取编码器统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 编码统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STATS_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetEncoderStats(uint32_t encHandle, VmiEncoderStats *stats);
+
+/**
+ * @功能描述: 清零编码器统计，清零前的累计值仍计入进程级汇总
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STATS_FAIL 清零统计失败
+ */
+VmiEncoderRetCode VencResetEncoderStats(uint32_t encHandle);
+
+/**
+ * @功能描述: 获取进程级汇总统计，包括已销毁编码器的累计值
+ * @参数 [out] stats: 编码统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_STATS_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetGlobalEncoderStats(VmiEncoderStats *stats);
+
+/**
+ * @功能描述: 配置预热池。开启后销毁的编码器经停止和重置后放回池中，创建编码器时优先从池中取得，
+ *            初始化参数与池中编码器一致时跳过编码器初始化；关闭或缩小上限时立即销毁多余的空闲编码器
+ * @参数 [in] config: 预热池配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_WARM_POOL_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigWarmPool(const VmiWarmPoolConfig *config);
+
+/**
+ * @功能描述: 预先创建并初始化编码器放入预热池，需先开启预热池
+ * @参数 [in] encType: 编码器类型，0表示使用系统属性配置的类型
+ * @参数 [in] encParams: 编码参数结构体
+ * @参数 [in] count: 预热个数，受预热池上限约束
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_WARM_POOL_FAIL 预热池未开启或创建编码器失败
+ */
+VmiEncoderRetCode VencPrewarmEncoders(uint32_t encType, const VmiEncodeParams encParams, uint32_t count);
+
+/**
+ * @功能描述: 获取预热池统计
+ * @参数 [out] stats: 预热池统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_WARM_POOL_FAIL 获取统计失败
+ */
+VmiEncoderRetCode VencGetWarmPoolStats(VmiWarmPoolStats *stats);
+
+/**
+ * @功能描述: 开启变化区域检测。编码前将输入帧与上一帧按分块比较，得到变化区域，
+ *            静止帧按策略跳过；强制I帧、重置或启动编码器后的第一帧总是送编码器编码。
+ *            只对完整的一帧输入生效，设置了输入格式时比较转换后的YUV420数据，需在初始化编码器之后调用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 检测配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 开启失败
+ */
+VmiEncoderRetCode VencEnableDirtyDetect(uint32_t encHandle, const VmiDirtyDetectConfig *config);
+
+/**
+ * @功能描述: 关闭变化区域检测
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 关闭失败
+ */
+VmiEncoderRetCode VencDisableDirtyDetect(uint32_t encHandle);
+
+/**
+ * @功能描述: 提供下一帧的变化区域，该帧不再扫描比较。rectCount为0表示下一帧无变化
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] rects: 变化区域
+ * @参数 [in] rectCount: 变化区域个数
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 未开启变化区域检测
+ */
+VmiEncoderRetCode VencSetDamageHint(uint32_t encHandle, const VmiRect *rects, uint32_t rectCount);
+
+/**
+ * @功能描述: 获取最近一帧的变化区域，由变化分块合并而成，超出maxRects时合并为一个外接矩形
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] rects: 变化区域
+ * @参数 [in] maxRects: rects可容纳的个数
+ * @参数 [out] rectCount: 变化区域个数，0表示静止帧
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 未开启变化区域检测
+ */
+VmiEncoderRetCode VencGetDirtyRegion(uint32_t encHandle, VmiRect *rects, uint32_t maxRects, uint32_t *rectCount);
+
+/**
+ * @功能描述: 获取变化区域检测统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 检测统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DIRTY_DETECT_FAIL 未开启变化区域检测
+ */
+VmiEncoderRetCode VencGetDirtyDetectStats(uint32_t encHandle, VmiDirtyDetectStats *stats);
+
+/**
+ * @功能描述: 创建联播组，为每层创建、初始化并启动一个编码器。编码时输入帧只做一次格式转换，
+ *            再由各层工作线程缩放到该层分辨率后并行编码。各层句柄可用于强制I帧、码控、统计和输出环，
+ *            但不能单独销毁、停止或修改宽高
+ * @参数 [in] config: 联播组配置
+ * @参数 [out] groupHandle: 联播组句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SIMULCAST_FAIL 配置无效
+ *          VMI_ENCODER_CREATE_FAIL 创建、初始化或启动某层编码器失败，已创建的层被销毁
+ */
+VmiEncoderRetCode VencCreateSimulcastGroup(const VmiSimulcastConfig *config, uint32_t *groupHandle);
+
+/**
+ * @功能描述: 销毁联播组，等待正在进行的编码完成后停止并销毁各层编码器
+ * @参数 [in] groupHandle: 联播组句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_DESTROY_FAIL 联播组不存在或销毁某层编码器失败
+ */
+VmiEncoderRetCode VencDestroySimulcastGroup(uint32_t groupHandle);
+
+/**
+ * @功能描述: 获取联播组某层的编码器对象句柄
+ * @参数 [in] groupHandle: 联播组句柄
+ * @参数 [in] layer: 层下标，与创建时配置的顺序相同
+ * @参数 [out] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_SIMULCAST_FAIL 联播组不存在或层下标越界
+ */
+VmiEncoderRetCode VencGetSimulcastLayerHandle(uint32_t groupHandle, uint32_t layer, uint32_t *encHandle);
+
+/**
+ * @功能描述: 联播编码一帧数据，各层并行缩放和编码，全部完成后返回
+ * @参数 [in] groupHandle: 联播组句柄
+ * @参数 [in] inputData: 按联播组输入格式组织的一帧数据
+ * @参数 [in] inputSize: 输入数据大小
+ * @参数 [out] outputs: 各层编码输出，按层下标排列
+ * @参数 [in] outputCount: outputs个数，不能小于层数
+ * @返回值: VMI_ENCODER_SUCCESS 所有层编码成功
+ *          VMI_ENCODER_ENCODE_FAIL 参数无效或至少一层编码失败，各层结果见outputs
+ */
+VmiEncoderRetCode VencEncodeSimulcastFrame(uint32_t groupHandle, const uint8_t *inputData, uint32_t inputSize,
+    VmiSimulcastLayerOutput *outputs, uint32_t outputCount);
+
+/**
+ * @功能描述: 开始抓取编码会话，此后的编码参数、输入格式、强制I帧请求以及每次编码调用的输入帧、时间和输出大小
+ *            追加写入内存映射的抓取文件，输入帧与上一帧等长时按差分存储，可用vmi_capture_replay离线回放。
+ *            抓取在编码线程上同步写入，会增加每帧编码调用的耗时；已在抓取时重新开始抓取到新文件
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 抓取配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CAPTURE_FAIL 创建抓取文件失败
+ */
+VmiEncoderRetCode VencStartCapture(uint32_t encHandle, const VmiCaptureConfig *config);
+
+/**
+ * @功能描述: 停止抓取并关闭抓取文件，销毁编码器时自动停止
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CAPTURE_FAIL 未开始抓取
+ */
+VmiEncoderRetCode VencStopCapture(uint32_t encHandle);
+
+/**
+ * @功能描述: 获取抓取统计
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 抓取统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_CAPTURE_FAIL 未开始抓取
+ */
+VmiEncoderRetCode VencGetCaptureStats(uint32_t encHandle, VmiCaptureStats *stats);
+
+/**
+ * @功能描述: 开启进程内所有编码器的逐帧追踪，记录每次编码调用的句柄查找、锁等待、格式转换、厂商编码、
+ *            输出交付和异步回调各阶段，事件以句柄和帧序号(每个句柄的编码调用序号，从1开始)为键。
+ *            已开启时按新配置重新开始，之前记录的事件被丢弃；未开启时每个追踪点只有一次分支判断
+ * @参数 [in] config: 追踪配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_TRACE_FAIL 配置无效，或只要求写入trace_marker而其无法打开
+ */
+VmiEncoderRetCode VencEnableFrameTrace(const VmiFrameTraceConfig *config);
+
+/**
+ * @功能描述: 关闭逐帧追踪，已记录的事件保留到下次开启，仍可导出
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ */
+VmiEncoderRetCode VencDisableFrameTrace();
+
+/**
+ * @功能描述: 将各线程缓冲区中的事件导出为Chrome trace JSON，可在chrome://tracing或ui.perfetto.dev中打开，
+ *            开启期间也可导出
+ * @参数 [in] path: 文件路径
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_TRACE_FAIL 文件无法写入
+ */
+VmiEncoderRetCode VencExportFrameTrace(const char *path);
+
+/**
+ * @功能描述: 获取逐帧追踪统计
+ * @参数 [out] stats: 追踪统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_TRACE_FAIL 参数为空
+ */
+VmiEncoderRetCode VencGetFrameTraceStats(VmiFrameTraceStats *stats);
+
+/**
+ * @功能描述: 在编码进程中创建跨进程共享内存帧环。帧环基于memfd，包含单生产者单消费者的帧槽位环，
+ *            生产者进程(如合成器)直接把帧写入槽位，编码进程在槽位上原地编码，帧数据不经过socket或binder拷贝。
+ *            创建者为消费者一侧，返回的fd需通过SCM_RIGHTS等方式传给生产者进程，由其调用VencAttachFrameRing
+ * @参数 [in] config: 帧环配置
+ * @参数 [out] ringHandle: 帧环句柄
+ * @参数 [out] fd: 共享内存文件描述符，由帧环持有，VencDestroyFrameRing时关闭，调用者不应关闭
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 配置无效或创建共享内存失败
+ */
+VmiEncoderRetCode VencCreateFrameRing(const VmiFrameRingConfig *config, uint32_t *ringHandle, int *fd);
+
+/**
+ * @功能描述: 在生产者进程中映射编码进程创建的共享内存帧环，映射后不再需要fd，调用者可自行关闭
+ * @参数 [in] fd: VencCreateFrameRing返回的共享内存文件描述符
+ * @参数 [out] ringHandle: 帧环句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 映射失败或共享内存不是帧环
+ */
+VmiEncoderRetCode VencAttachFrameRing(int fd, uint32_t *ringHandle);
+
+/**
+ * @功能描述: 解除帧环映射，创建者一侧同时关闭共享内存fd；正在等待的调用返回后才真正解除映射
+ * @参数 [in] ringHandle: 帧环句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在
+ */
+VmiEncoderRetCode VencDestroyFrameRing(uint32_t ringHandle);
+
+/**
+ * @功能描述: 生产者获取下一个空闲槽位，写入帧数据后调用VencCommitFrameSlot提交。
+ *            同一时刻只能有一个进程作为生产者，提交前不能再次获取
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [in] timeoutMs: 无空闲槽位时的等待时间，0表示不等待，小于0表示一直等待
+ * @参数 [out] slot: 槽位地址，页对齐
+ * @参数 [out] slotSize: 槽位大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_TIMEOUT 等待超时
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在、已有未提交的槽位或共享状态损坏
+ */
+VmiEncoderRetCode VencAcquireFrameSlot(uint32_t ringHandle, int32_t timeoutMs, uint8_t **slot, uint32_t *slotSize);
+
+/**
+ * @功能描述: 生产者提交已写入的槽位，编码进程正在等待时将其唤醒
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [in] dataSize: 帧数据大小，不能超过槽位大小
+ * @参数 [in] timestampNs: 时间戳，原样传给编码进程，可用于计算传递时延
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在、未获取槽位或数据大小无效
+ */
+VmiEncoderRetCode VencCommitFrameSlot(uint32_t ringHandle, uint32_t dataSize, uint64_t timestampNs);
+
+/**
+ * @功能描述: 消费者等待帧环中的下一帧，在共享内存槽位上原地编码，编码返回后把槽位交还生产者。
+ *            输出数据的有效期与VencEncodeOneFrame相同，同一时刻只能有一个进程作为消费者
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [in] timeoutMs: 无待编码帧时的等待时间，0表示不等待，小于0表示一直等待
+ * @参数 [out] outputData: 编码输出数据地址
+ * @参数 [out] outputSize: 编码输出数据大小
+ * @参数 [out] frame: 取出的帧信息，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_TIMEOUT 等待超时
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在或共享状态损坏
+ *          其他 与VencEncodeOneFrame相同，槽位同样交还生产者
+ */
+VmiEncoderRetCode VencEncodeFromFrameRing(uint32_t encHandle, uint32_t ringHandle, int32_t timeoutMs,
+    uint8_t **outputData, uint32_t *outputSize, VmiFrameRingFrame *frame);
+
+/**
+ * @功能描述: 获取本进程一侧的帧环统计
+ * @参数 [in] ringHandle: 帧环句柄
+ * @参数 [out] stats: 帧环统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_FRAME_RING_FAIL 句柄不存在或参数为空
+ */
+VmiEncoderRetCode VencGetFrameRingStats(uint32_t ringHandle, VmiFrameRingStats *stats);
+
+/**
+ * @功能描述: 开启异步编码，为编码器创建有界待编码队列和专属编码线程，或登记到共享编码执行器，
+ *            同一会话的帧始终按提交顺序编码，编码慢于提交时按配置的过载策略替换、丢弃或抽取积压的帧。
+ *            开启后应通过VencSubmitFrame提交数据，不应再与VencEncodeOneFrame混用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 异步编码配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 开启异步编码失败
+ */
+VmiEncoderRetCode VencEnableAsyncEncode(uint32_t encHandle, const VmiAsyncEncodeConfig *config);
+
+/**
+ * @功能描述: 关闭异步编码，等待已提交的帧全部编码并回调完成后退出编码线程
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 关闭异步编码失败
+ */
+VmiEncoderRetCode VencDisableAsyncEncode(uint32_t encHandle);
+
+/**
+ * @功能描述: 异步提交一帧数据，编码完成后通过回调返回结果
+ *            输入数据在该帧回调之前必须保持有效
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] inputData: 编码输入数据地址
+ * @参数 [in] inputSize: 编码输入数据大小
+ * @参数 [in] timeoutMs: 队列满时的等待时间，0表示不等待，小于0表示一直等待；LATEST_WINS策略下
+ *                       只有被替换但尚未回调的帧占满队列时才会等待
+ * @参数 [out] frameSeq: 分配的帧序号，可为空
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_QUEUE_FULL 等待超时后队列仍满
+ *          VMI_ENCODER_FRAME_DROPPED 被自适应抽帧丢弃，不会回调，输入数据可立即复用
+ *          VMI_ENCODER_SUBMIT_FAIL 提交失败
+ */
+VmiEncoderRetCode VencSubmitFrame(uint32_t encHandle, const uint8_t *inputData, uint32_t inputSize,
+    int32_t timeoutMs, uint64_t *frameSeq);
+
+/**
+ * @功能描述: 等待已提交的帧全部编码并回调完成
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 未开启异步编码
+ */
+VmiEncoderRetCode VencFlushEncoder(uint32_t encHandle);
+
+/**
+ * @功能描述: 获取异步编码统计，各会话之间比较可用于评估调度公平性
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 异步编码统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_ASYNC_FAIL 未开启异步编码
+ */
+VmiEncoderRetCode VencGetAsyncEncodeStats(uint32_t encHandle, VmiAsyncEncodeStats *stats);
+
+/**
+ * @功能描述: 配置共享编码执行器的线程数和绑核策略，需在没有会话使用执行器时调用，
+ *            工作线程在第一个会话以useSharedExecutor开启异步编码时启动
+ * @参数 [in] config: 执行器配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_EXECUTOR_FAIL 配置无效或仍有会话在使用执行器
+ */
+VmiEncoderRetCode VencConfigEncodeExecutor(const VmiEncodeExecutorConfig *config);
+
+/**
+ * @功能描述: 获取共享编码执行器统计
+ * @参数 [out] stats: 执行器统计
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_EXECUTOR_FAIL 参数为空
+ */
+VmiEncoderRetCode VencGetEncodeExecutorStats(VmiEncodeExecutorStats *stats);
+
+/**
+ * @功能描述: 配置并启用输入缓冲池，缓冲区大小按编码宽高计算，在初始化编码器时预分配；
+ *            若编码器已初始化则立即按当前宽高重新分配
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 缓冲池配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigInputBufferPool(uint32_t encHandle, const VmiBufferPoolConfig *config);
+
+/**
+ * @功能描述: 从输入缓冲池获取一个缓冲区，调用者可直接将一帧数据写入其中再提交编码
+ *            用于VencEncodeOneFrame时，调用者在编码返回后调用VencReleaseInputBuffer归还；
+ *            用于VencSubmitFrame时，编码器在该帧回调返回后自动归还，调用者不应再归还
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] buffer: 缓冲区地址
+ * @参数 [out] bufferSize: 缓冲区大小
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 缓冲池未启用或缓冲区已耗尽
+ */
+VmiEncoderRetCode VencAcquireInputBuffer(uint32_t encHandle, uint8_t **buffer, uint32_t *bufferSize);
+
+/**
+ * @功能描述: 向输入缓冲池归还缓冲区
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] buffer: 通过VencAcquireInputBuffer获取的缓冲区地址
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 缓冲区不属于该编码器或未被占用
+ */
+VmiEncoderRetCode VencReleaseInputBuffer(uint32_t encHandle, uint8_t *buffer);
+
+/**
+ * @功能描述: 获取输入缓冲池统计信息
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [out] stats: 统计信息
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_BUFFER_FAIL 获取失败
+ */
+VmiEncoderRetCode VencGetInputBufferPoolStats(uint32_t encHandle, VmiBufferPoolStats *stats);
+
+/**
+ * @功能描述: 配置并启用输出环，此后VencEncodeOneFrame和异步回调返回的输出数据
+ *            在调用VencReleaseOutputBuffer之前保持有效，可直接交给发送线程而无需拷贝
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] config: 输出环配置
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_OUTPUT_FAIL 配置失败
+ */
+VmiEncoderRetCode VencConfigOutputRing(uint32_t encHandle, const VmiOutputRingConfig *config);
+
+/**
+ * @功能描述: 释放输出环中的一帧输出数据，可在任意线程调用
+ * @参数 [in] encHandle: 编码器对象句柄
+ * @参数 [in] outputData: 编码输出数据地址
+ * @返回值: VMI_ENCODER_SUCCESS 成功
+ *          VMI_ENCODER_OUTPUT_FAIL 地址不属于该编码器输出环或已释放
+ */
+VmiEncoderRetCode VencReleaseOutputBuffer(uint32_t encHandle, uint8_t *outputData);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,272 @@
+/*
+ * 功能说明: 性能基准公共工具，包括命令行参数解析、时延统计和JSON结果输出
+ */
+#ifndef VMI_BENCHMARK_COMMON_H
+#define VMI_BENCHMARK_COMMON_H
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "VideoEncoderTime.h"
+
+namespace vmi_bench {
+
+// 命令行参数，格式为--key=value，仅有--key时值为"1"
+class Args {
+public:
+    Args(int argc, char *argv[])
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg(argv[i]);
+            if (arg.compare(0, 2, "--") != 0) {
+                continue;
+            }
+            size_t pos = arg.find('=');
+            if (pos == std::string::npos) {
+                m_values[arg.substr(2)] = "1";
+            } else {
+                m_values[arg.substr(2, pos - 2)] = arg.substr(pos + 1);
+            }
+        }
+    }
+
+    bool Has(const std::string &key) const
+    {
+        return m_values.find(key) != m_values.end();
+    }
+
+    std::string GetString(const std::string &key, const std::string &defaultValue) const
+    {
+        auto it = m_values.find(key);
+        return (it == m_values.end()) ? defaultValue : it->second;
+    }
+
+    uint32_t GetU32(const std::string &key, uint32_t defaultValue) const
+    {
+        auto it = m_values.find(key);
+        return (it == m_values.end()) ? defaultValue : static_cast<uint32_t>(strtoul(it->second.c_str(), nullptr, 0));
+    }
+
+private:
+    std::unordered_map<std::string, std::string> m_values = {};
+};
+
+// 时延样本，单位纳秒
+class LatencySamples {
+public:
+    void Reserve(size_t count)
+    {
+        m_samples.reserve(count);
+    }
+
+    void Add(uint64_t ns)
+    {
+        m_samples.push_back(ns);
+    }
+
+    void Append(const LatencySamples &other)
+    {
+        m_samples.insert(m_samples.end(), other.m_samples.begin(), other.m_samples.end());
+    }
+
+    size_t Count() const
+    {
+        return m_samples.size();
+    }
+
+    uint64_t Sum() const
+    {
+        uint64_t sum = 0;
+        for (uint64_t sample : m_samples) {
+            sum += sample;
+        }
+        return sum;
+    }
+
+    // 排序后取百分位，调用后样本顺序改变
+    uint64_t Percentile(double percentile)
+    {
+        if (m_samples.empty()) {
+            return 0;
+        }
+        if (!m_isSorted) {
+            std::sort(m_samples.begin(), m_samples.end());
+            m_isSorted = true;
+        }
+        auto index = static_cast<size_t>(percentile * (m_samples.size() - 1) + 0.5);
+        return m_samples[std::min(index, m_samples.size() - 1)];
+    }
+
+private:
+    std::vector<uint64_t> m_samples = {};
+    bool m_isSorted = false;
+};
+
+// 流式JSON输出，按调用顺序生成对象/数组，自动处理逗号和缩进
+class JsonWriter {
+public:
+    explicit JsonWriter(FILE *file) : m_file(file) {}
+
+    void BeginObject(const char *key = nullptr)
+    {
+        Begin(key, '{');
+    }
+
+    void EndObject()
+    {
+        End('}');
+    }
+
+    void BeginArray(const char *key = nullptr)
+    {
+        Begin(key, '[');
+    }
+
+    void EndArray()
+    {
+        End(']');
+    }
+
+    void Field(const char *key, uint64_t value)
+    {
+        Key(key);
+        fprintf(m_file, "%" PRIu64, value);
+    }
+
+    void Field(const char *key, uint32_t value)
+    {
+        Field(key, static_cast<uint64_t>(value));
+    }
+
+    void Field(const char *key, double value)
+    {
+        Key(key);
+        fprintf(m_file, "%.3f", value);
+    }
+
+    void Field(const char *key, bool value)
+    {
+        Key(key);
+        fprintf(m_file, "%s", value ? "true" : "false");
+    }
+
+    void Field(const char *key, const std::string &value)
+    {
+        Key(key);
+        fputc('"', m_file);
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                fputc('\\', m_file);
+            }
+            fputc(c, m_file);
+        }
+        fputc('"', m_file);
+    }
+
+    void Field(const char *key, const char *value)
+    {
+        Field(key, std::string(value));
+    }
+
+    // 输出时延样本摘要，单位微秒
+    void LatencyField(const char *key, LatencySamples &samples)
+    {
+        constexpr double nsPerUs = 1000.0;
+        BeginObject(key);
+        Field("count", static_cast<uint64_t>(samples.Count()));
+        Field("avg_us", (samples.Count() == 0) ? 0.0 : samples.Sum() / nsPerUs / samples.Count());
+        Field("p50_us", samples.Percentile(0.50) / nsPerUs);
+        Field("p90_us", samples.Percentile(0.90) / nsPerUs);
+        Field("p99_us", samples.Percentile(0.99) / nsPerUs);
+        Field("max_us", samples.Percentile(1.0) / nsPerUs);
+        EndObject();
+    }
+
+    void Finish()
+    {
+        fputc('\n', m_file);
+        fflush(m_file);
+    }
+
+private:
+    void Indent()
+    {
+        fputc('\n', m_file);
+        for (size_t i = 0; i < m_hasItems.size(); ++i) {
+            fputs("  ", m_file);
+        }
+    }
+
+    void Key(const char *key)
+    {
+        if (!m_hasItems.empty()) {
+            if (m_hasItems.back()) {
+                fputc(',', m_file);
+            }
+            m_hasItems.back() = true;
+            Indent();
+        }
+        if (key != nullptr) {
+            fprintf(m_file, "\"%s\": ", key);
+        }
+    }
+
+    void Begin(const char *key, char bracket)
+    {
+        Key(key);
+        fputc(bracket, m_file);
+        m_hasItems.push_back(false);
+    }
+
+    void End(char bracket)
+    {
+        bool hasItems = m_hasItems.back();
+        m_hasItems.pop_back();
+        if (hasItems) {
+            Indent();
+        }
+        fputc(bracket, m_file);
+    }
+
+    FILE *m_file = nullptr;
+    std::vector<bool> m_hasItems = {};
+};
+
+// 打开结果文件，未指定或为"-"时输出到标准输出
+inline FILE *OpenOutput(const Args &args)
+{
+    std::string path = args.GetString("output", "-");
+    if (path == "-") {
+        return stdout;
+    }
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        fprintf(stderr, "open output file %s failed, fall back to stdout\n", path.c_str());
+        return stdout;
+    }
+    return file;
+}
+
+inline void CloseOutput(FILE *file)
+{
+    if (file != stdout) {
+        (void) fclose(file);
+    }
+}
+
+// 设置环境变量，overwrite为false时保留用户已设置的值
+inline void SetEnv(const char *name, uint64_t value, bool overwrite = true)
+{
+    std::string str = std::to_string(value);
+    (void) setenv(name, str.c_str(), overwrite ? 1 : 0);
+}
+
+}  // namespace vmi_bench
+
+#endif  // VMI_BENCHMARK_COMMON_H
@@ -0,0 +1,284 @@
+/*
+ * 功能说明: 编码会话回放工具，读取VencStartCapture生成的抓取文件，按记录顺序通过Venc*接口重新设置参数、
+ *           输入格式、强制I帧并编码每一帧，按原始时间间隔或最快速度回放，输出吞吐、调用时延以及与抓取时
+ *           调用耗时和输出大小的对比，用于离线复现线上会话的性能问题
+ *
+ * 用法: vmi_capture_replay --trace=capture.bin [--speed=original|max] [--enc-type=N] [--output=result.json]
+ *
+ * 未指定--enc-type时使用抓取时的编码器类型；使用模拟库还是真实libVideoCodec.so由LD_LIBRARY_PATH决定。
+ */
+
+#include <chrono>
+#include <thread>
+#include "BenchmarkCommon.h"
+#include "VideoEncoderCapture.h"
+#include "VideoEncoderWrapper.h"
+
+using namespace vmi_bench;
+
+namespace {
+    constexpr uint64_t NS_PER_US = 1000;
+    constexpr uint64_t US_PER_SEC = 1000000;
+    constexpr double NS_PER_SEC = 1e9;
+
+    template <typename T>
+    bool ReadPayload(const VideoEncoderCaptureReader::Record &record, T &value)
+    {
+        if (record.size < sizeof(T)) {
+            return false;
+        }
+        (void) memcpy(&value, record.payload, sizeof(T));
+        return true;
+    }
+
+    VmiEncodeParams ToVmiEncodeParams(const CaptureParamsRecord &record)
+    {
+        VmiEncodeParams params = {};
+        params.width = record.width;
+        params.height = record.height;
+        params.frameRate = record.frameRate;
+        params.bitrate = record.bitrate;
+        params.gopSize = record.gopSize;
+        params.profile = record.profile;
+        return params;
+    }
+
+    struct ReplayStats {
+        uint64_t frames = 0;
+        uint64_t failedFrames = 0;
+        uint64_t resultMismatches = 0;  // 编码结果与抓取时不同的帧数
+        uint64_t lateFrames = 0;        // 原速回放时开始时间晚于原始时间一个帧间隔以上的帧数
+        uint64_t paramChanges = 0;
+        uint64_t formatChanges = 0;
+        uint64_t keyFrameRequests = 0;
+        uint64_t inputBytes = 0;
+        uint64_t recordedOutputBytes = 0;
+        uint64_t replayedOutputBytes = 0;
+        uint64_t outputSizeMismatches = 0;
+        LatencySamples recordedCall;
+        LatencySamples replayedCall;
+        LatencySamples decode;  // 从抓取记录还原输入帧的耗时
+    };
+
+    class Replayer {
+    public:
+        Replayer(uint32_t encType, bool isOriginalSpeed) : m_encType(encType), m_isOriginalSpeed(isOriginalSpeed) {}
+
+        ~Replayer()
+        {
+            if (m_handle != 0) {
+                (void) VencStopEncoder(m_handle);
+                (void) VencDestroyEncoder(m_handle);
+            }
+        }
+
+        bool OnParams(const VideoEncoderCaptureReader::Record &record)
+        {
+            CaptureParamsRecord params = {};
+            if (!ReadPayload(record, params)) {
+                return false;
+            }
+            m_params = ToVmiEncodeParams(params);
+            m_hasParams = true;
+            if (m_handle == 0) {
+                return true;
+            }
+            ++m_stats.paramChanges;
+            return VencSetEncodeParams(m_handle, m_params) == VMI_ENCODER_SUCCESS;
+        }
+
+        bool OnInputFormat(const VideoEncoderCaptureReader::Record &record)
+        {
+            CaptureInputFormatRecord format = {};
+            if (!ReadPayload(record, format)) {
+                return false;
+            }
+            m_format.pixelFormat = format.pixelFormat;
+            m_format.stride = format.stride;
+            m_format.convertThreads = format.convertThreads;
+            if (m_handle == 0) {
+                return true;
+            }
+            ++m_stats.formatChanges;
+            return VencInitEncoderEx(m_handle, m_params, &m_format) == VMI_ENCODER_SUCCESS;
+        }
+
+        bool OnKeyFrame()
+        {
+            ++m_stats.keyFrameRequests;
+            return (m_handle == 0) || VencForceKeyFrame(m_handle) == VMI_ENCODER_SUCCESS;
+        }
+
+        bool OnFrame(const VideoEncoderCaptureReader::Record &record)
+        {
+            CaptureFrameRecord frame = {};
+            if (!ReadPayload(record, frame)) {
+                return false;
+            }
+            uint64_t decodeStartNs = GetMonotonicTimeNs();
+            if (!VideoEncoderCaptureReader::DecodeFrame(record, m_frame)) {
+                fprintf(stderr, "decode frame %" PRIu64 " failed\n", m_stats.frames);
+                return false;
+            }
+            m_stats.decode.Add(GetMonotonicTimeNs() - decodeStartNs);
+            if (m_handle == 0 && !OpenEncoder()) {
+                return false;
+            }
+            if (m_stats.frames == 0) {
+                m_firstFrameUs = frame.timestampUs;
+                m_startNs = GetMonotonicTimeNs();
+            }
+            if (m_isOriginalSpeed) {
+                WaitUntil(frame.timestampUs);
+            }
+            uint8_t *outputData = nullptr;
+            uint32_t outputSize = 0;
+            uint64_t callStartNs = GetMonotonicTimeNs();
+            VmiEncoderRetCode ret = VencEncodeOneFrame(m_handle, m_frame.data(), frame.inputSize, &outputData,
+                &outputSize);
+            m_stats.replayedCall.Add(GetMonotonicTimeNs() - callStartNs);
+            m_stats.recordedCall.Add(static_cast<uint64_t>(frame.callTimeUs) * NS_PER_US);
+            ++m_stats.frames;
+            m_stats.inputBytes += frame.inputSize;
+            m_stats.failedFrames += (ret == VMI_ENCODER_SUCCESS) ? 0 : 1;
+            m_stats.resultMismatches += (ret == frame.result) ? 0 : 1;
+            outputSize = (ret == VMI_ENCODER_SUCCESS) ? outputSize : 0;
+            m_stats.recordedOutputBytes += frame.outputSize;
+            m_stats.replayedOutputBytes += outputSize;
+            m_stats.outputSizeMismatches += (outputSize == frame.outputSize) ? 0 : 1;
+            return true;
+        }
+
+        uint64_t GetElapsedNs() const
+        {
+            return (m_stats.frames == 0) ? 0 : GetMonotonicTimeNs() - m_startNs;
+        }
+
+        ReplayStats &GetStats()
+        {
+            return m_stats;
+        }
+
+    private:
+        bool OpenEncoder()
+        {
+            if (!m_hasParams) {
+                fprintf(stderr, "trace has no encode params before first frame\n");
+                return false;
+            }
+            VmiEncoderSelectConfig selectConfig = {};
+            selectConfig.encTypes[0] = m_encType;
+            selectConfig.typeCount = 1;
+            uint32_t encType = 0;
+            if (VencCreateEncoderEx(&selectConfig, m_params, &m_handle, &encType) != VMI_ENCODER_SUCCESS) {
+                fprintf(stderr, "create encoder of type %u failed\n", m_encType);
+                m_handle = 0;
+                return false;
+            }
+            if (VencInitEncoderEx(m_handle, m_params, &m_format) != VMI_ENCODER_SUCCESS ||
+                VencStartEncoder(m_handle) != VMI_ENCODER_SUCCESS) {
+                fprintf(stderr, "init or start encoder failed\n");
+                return false;
+            }
+            return true;
+        }
+
+        // 按抓取时相对首帧的时间间隔等待，落后超过一个帧间隔时计为迟到并立即编码
+        void WaitUntil(uint64_t timestampUs)
+        {
+            uint64_t targetNs = m_startNs + (timestampUs - m_firstFrameUs) * NS_PER_US;
+            uint64_t nowNs = GetMonotonicTimeNs();
+            if (nowNs < targetNs) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(targetNs - nowNs));
+                return;
+            }
+            uint64_t intervalNs = US_PER_SEC * NS_PER_US / std::max(1U, m_params.frameRate);
+            m_stats.lateFrames += (nowNs - targetNs > intervalNs) ? 1 : 0;
+        }
+
+        uint32_t m_encType = 0;
+        bool m_isOriginalSpeed = false;
+        uint32_t m_handle = 0;
+        bool m_hasParams = false;
+        VmiEncodeParams m_params = {};
+        VmiInputFormat m_format = {};
+        std::vector<uint8_t> m_frame = {};  // 上一帧，差分帧在其基础上还原
+        uint64_t m_firstFrameUs = 0;
+        uint64_t m_startNs = 0;
+        ReplayStats m_stats = {};
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    Args args(argc, argv);
+    std::string tracePath = args.GetString("trace", "");
+    VideoEncoderCaptureReader reader;
+    if (tracePath.empty() || !reader.Open(tracePath)) {
+        fprintf(stderr, "open capture %s failed\n", tracePath.c_str());
+        return 1;
+    }
+    std::string speed = args.GetString("speed", "original");
+    if (speed != "original" && speed != "max") {
+        fprintf(stderr, "unknown speed %s\n", speed.c_str());
+        return 1;
+    }
+    uint32_t encType = args.GetU32("enc-type", reader.GetHeader().encType);
+
+    Replayer replayer(encType, speed == "original");
+    VideoEncoderCaptureReader::Record record;
+    bool isOk = true;
+    while (isOk && reader.Next(record)) {
+        switch (record.type) {
+            case CAPTURE_RECORD_PARAMS:
+                isOk = replayer.OnParams(record);
+                break;
+            case CAPTURE_RECORD_INPUT_FORMAT:
+                isOk = replayer.OnInputFormat(record);
+                break;
+            case CAPTURE_RECORD_KEY_FRAME:
+                isOk = replayer.OnKeyFrame();
+                break;
+            case CAPTURE_RECORD_FRAME:
+                isOk = replayer.OnFrame(record);
+                break;
+            default:
+                // 新版本增加的记录类型，跳过
+                break;
+        }
+    }
+    uint64_t elapsedNs = replayer.GetElapsedNs();
+    ReplayStats &stats = replayer.GetStats();
+    if (!isOk) {
+        fprintf(stderr, "replay stopped after %" PRIu64 " frames\n", stats.frames);
+    }
+
+    FILE *output = OpenOutput(args);
+    JsonWriter json(output);
+    json.BeginObject();
+    json.Field("benchmark", "vmi_capture_replay");
+    json.Field("trace", tracePath);
+    json.Field("speed", speed);
+    json.Field("enc_type", encType);
+    json.Field("completed", isOk);
+    json.Field("frames", stats.frames);
+    json.Field("failed_frames", stats.failedFrames);
+    json.Field("result_mismatches", stats.resultMismatches);
+    json.Field("late_frames", stats.lateFrames);
+    json.Field("param_changes", stats.paramChanges);
+    json.Field("format_changes", stats.formatChanges);
+    json.Field("key_frame_requests", stats.keyFrameRequests);
+    json.Field("elapsed_ms", elapsedNs / NS_PER_SEC * 1000.0);
+    json.Field("fps", (elapsedNs == 0) ? 0.0 : stats.frames * NS_PER_SEC / elapsedNs);
+    json.Field("input_mb_per_sec", (elapsedNs == 0) ? 0.0 : stats.inputBytes / 1e6 * NS_PER_SEC / elapsedNs);
+    json.Field("recorded_output_bytes", stats.recordedOutputBytes);
+    json.Field("replayed_output_bytes", stats.replayedOutputBytes);
+    json.Field("output_size_mismatches", stats.outputSizeMismatches);
+    json.LatencyField("recorded_call", stats.recordedCall);
+    json.LatencyField("replayed_call", stats.replayedCall);
+    json.LatencyField("decode", stats.decode);
+    json.EndObject();
+    json.Finish();
+    CloseOutput(output);
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,500 @@
+/*
+ * 功能说明: 编码前帧处理性能基准，测量变化区域检测在各指令集实现下的单帧耗时，静止画面下
+ *           跳过静止帧对单会话编码CPU开销的影响，RGBA到I420格式转换的吞吐，以及联播各层I420缩放的单帧耗时，
+ *           结果以JSON格式输出。格式转换和缩放各指令集实现与标量实现的输出逐位比较，不一致时返回非0
+ *
+ * 用法: vmi_frame_benchmark [--case=all|dirty|skip|convert|scale] [--frames=200] [--encode-us=5000]
+ *       [--output=result.json]
+ */
+
+#include <ctime>
+#include "BenchmarkCommon.h"
+#include "VideoEncoderColorConverter.h"
+#include "VideoEncoderDirtyDetector.h"
+#include "VideoEncoderScaler.h"
+#include "VideoEncoderWrapper.h"
+
+using namespace vmi_bench;
+
+namespace {
+    constexpr uint32_t FRAMES_DEFAULT = 200;
+    constexpr uint32_t ENCODE_US_DEFAULT = 5000;
+    constexpr uint32_t FRAME_RATE = 30;
+    constexpr uint32_t BITRATE = 4000000;
+    constexpr uint32_t SKIP_WIDTH = 1280;
+    constexpr uint32_t SKIP_HEIGHT = 720;
+    constexpr double NS_PER_US = 1000.0;
+
+    struct Resolution {
+        const char *name;
+        uint32_t width;
+        uint32_t height;
+    };
+    const Resolution RESOLUTIONS[] = {
+        { "1080p", 1920, 1080 },
+        { "4k", 3840, 2160 },
+    };
+
+    const VideoEncoderSimdLevel SIMD_LEVELS[] = {
+        SIMD_LEVEL_SCALAR, SIMD_LEVEL_SSE41, SIMD_LEVEL_AVX2, SIMD_LEVEL_NEON
+    };
+
+    std::vector<uint8_t> MakeRandomBytes(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> bytes(size);
+        uint32_t state = seed * 2654435761U + 1;
+        for (auto &byte : bytes) {
+            state = state * 1664525U + 1013904223U;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+        return bytes;
+    }
+
+    // 伪随机内容的一帧YUV420数据
+    std::vector<uint8_t> MakeFrame(uint32_t width, uint32_t height, uint32_t seed)
+    {
+        size_t chromaSize = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+        return MakeRandomBytes(static_cast<size_t>(width) * height + 2 * chromaSize, seed);
+    }
+
+    uint64_t GetThreadCpuTimeNs()
+    {
+        constexpr uint64_t nsPerSec = 1000000000ULL;
+        struct timespec ts = {};
+        (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * nsPerSec + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    /**
+     * 变化区域检测单帧耗时，场景: static为画面无变化，需完整比较两帧；cursor为每帧只有一个分块变化；
+     * full为整帧变化，各分块在首行即可判定变化，但需整帧更新参考帧；hint为调用者提供一个变化矩形，不扫描
+     */
+    void RunDirty(uint32_t frames, JsonWriter &json)
+    {
+        json.BeginArray("dirty");
+        for (const auto &resolution : RESOLUTIONS) {
+            std::vector<uint8_t> base = MakeFrame(resolution.width, resolution.height, 1);
+            std::vector<uint8_t> other = MakeFrame(resolution.width, resolution.height, 2);
+            std::vector<uint8_t> cursor = base;
+            size_t cursorOffset = static_cast<size_t>(resolution.height / 2) * resolution.width + resolution.width / 2;
+            cursor[cursorOffset] ^= 0xff;
+            for (auto level : SIMD_LEVELS) {
+                const VideoEncoderSimdKernels *kernels = GetSimdKernels(level);
+                if (kernels == nullptr) {
+                    continue;
+                }
+                json.BeginObject();
+                json.Field("resolution", resolution.name);
+                json.Field("kernel", kernels->name);
+                const char *scenes[] = { "static", "cursor", "full", "hint" };
+                for (const char *scene : scenes) {
+                    VideoEncoderDirtyDetector detector(*kernels);
+                    if (!detector.Init(resolution.width, resolution.height)) {
+                        break;
+                    }
+                    (void) detector.Detect(base.data());
+                    bool isStatic = strcmp(scene, "static") == 0;
+                    bool isHint = strcmp(scene, "hint") == 0;
+                    const std::vector<uint8_t> &changed = (strcmp(scene, "full") == 0) ? other : cursor;
+                    LatencySamples samples;
+                    samples.Reserve(frames);
+                    uint64_t dirtyTiles = 0;
+                    for (uint32_t i = 0; i < frames; ++i) {
+                        const std::vector<uint8_t> &frame = (isStatic || i % 2 == 1) ? base : changed;
+                        if (isHint) {
+                            VmiRect rect = { resolution.width / 2, resolution.height / 2, 1, 1 };
+                            detector.SetDamageHint(&rect, 1);
+                        }
+                        uint64_t t0 = GetMonotonicTimeNs();
+                        dirtyTiles += detector.Detect(frame.data());
+                        samples.Add(GetMonotonicTimeNs() - t0);
+                    }
+                    json.BeginObject(scene);
+                    json.LatencyField("detect", samples);
+                    json.Field("dirty_tiles_per_frame", static_cast<double>(dirtyTiles) / frames);
+                    // 按读取当前帧和参考帧各一遍计算等效带宽，每纳秒1字节即1GB/s
+                    double avgNs = static_cast<double>(samples.Sum()) / std::max<size_t>(1, samples.Count());
+                    json.Field("compare_gbps", (avgNs == 0) ? 0.0 : 2.0 * base.size() / avgNs);
+                    json.EndObject();
+                }
+                json.EndObject();
+                fprintf(stderr, "dirty: %s %s done\n", resolution.name, kernels->name);
+            }
+        }
+        json.EndArray();
+    }
+
+    /**
+     * 静止画面单会话CPU开销: 模拟软件编码器编码一帧忙等--encode-us，对比关闭与开启变化区域检测时
+     * 编码线程每帧消耗的CPU时间
+     */
+    void RunSkip(uint32_t frames, uint32_t encodeUs, JsonWriter &json)
+    {
+        SetEnv("VMI_MOCK_ENCODE_US", encodeUs);
+        SetEnv("VMI_MOCK_ENCODE_SPIN", 1);
+        std::vector<uint8_t> frame = MakeFrame(SKIP_WIDTH, SKIP_HEIGHT, 1);
+        VmiEncodeParams params = {};
+        params.width = SKIP_WIDTH;
+        params.height = SKIP_HEIGHT;
+        params.frameRate = FRAME_RATE;
+        params.bitrate = BITRATE;
+        json.BeginObject("skip");
+        json.Field("encode_us", encodeUs);
+        for (bool isDetect : { false, true }) {
+            uint32_t handle = 0;
+            if (VencCreateEncoder(&handle) != VMI_ENCODER_SUCCESS ||
+                VencInitEncoder(handle, params) != VMI_ENCODER_SUCCESS ||
+                VencStartEncoder(handle) != VMI_ENCODER_SUCCESS) {
+                fprintf(stderr, "skip: open encoder failed\n");
+                break;
+            }
+            VmiDirtyDetectConfig config = {};
+            if (isDetect) {
+                (void) VencEnableDirtyDetect(handle, &config);
+            }
+            uint64_t outputBytes = 0;
+            uint64_t cpuStart = GetThreadCpuTimeNs();
+            for (uint32_t i = 0; i < frames; ++i) {
+                uint8_t *out = nullptr;
+                uint32_t outSize = 0;
+                (void) VencEncodeOneFrame(handle, frame.data(), static_cast<uint32_t>(frame.size()), &out, &outSize);
+                outputBytes += outSize;
+            }
+            uint64_t cpuNs = GetThreadCpuTimeNs() - cpuStart;
+            VmiDirtyDetectStats stats = {};
+            json.BeginObject(isDetect ? "detect" : "baseline");
+            json.Field("cpu_us_per_frame", cpuNs / NS_PER_US / frames);
+            json.Field("output_bytes", outputBytes);
+            if (isDetect && VencGetDirtyDetectStats(handle, &stats) == VMI_ENCODER_SUCCESS) {
+                json.Field("skipped_frames", stats.skippedFrames);
+                json.Field("detect_time_avg_us", stats.detectTimeAvgUs);
+            }
+            json.EndObject();
+            fprintf(stderr, "skip: %s %.1f us cpu per frame\n", isDetect ? "detect" : "baseline",
+                cpuNs / NS_PER_US / frames);
+            (void) VencStopEncoder(handle);
+            (void) VencDestroyEncoder(handle);
+        }
+        json.EndObject();
+    }
+
+    // 转换一帧，失败时返回空
+    std::vector<uint8_t> ConvertFrame(const VideoEncoderSimdKernels &kernels, const VmiInputFormat &format,
+        uint32_t width, uint32_t height, const std::vector<uint8_t> &input)
+    {
+        VideoEncoderColorConverter converter(kernels);
+        if (!converter.Init(format, width, height) || input.size() < converter.GetInputSize()) {
+            return {};
+        }
+        const uint8_t *frame = converter.Convert(input.data());
+        return std::vector<uint8_t>(frame, frame + converter.GetFrameSize());
+    }
+
+    // 纯色RGBA像素按BT.601有限范围转换的已知结果
+    bool VerifyKnownColors()
+    {
+        struct KnownColor {
+            uint8_t r, g, b, y, u, v;
+        };
+        const KnownColor colors[] = {
+            { 0, 0, 0, 16, 128, 128 },
+            { 255, 255, 255, 235, 128, 128 },
+            { 255, 0, 0, 82, 90, 240 },
+            { 0, 255, 0, 144, 54, 34 },
+            { 0, 0, 255, 41, 240, 110 },
+        };
+        constexpr uint32_t size = 2;
+        VmiInputFormat format = {};
+        format.pixelFormat = VMI_PIXEL_FORMAT_RGBA;
+        for (const auto &color : colors) {
+            std::vector<uint8_t> input;
+            for (uint32_t i = 0; i < size * size; ++i) {
+                input.insert(input.end(), { color.r, color.g, color.b, 0xff });
+            }
+            std::vector<uint8_t> frame = ConvertFrame(*GetSimdKernels(SIMD_LEVEL_SCALAR), format, size, size, input);
+            const uint8_t expected[] = { color.y, color.y, color.y, color.y, color.u, color.v };
+            if (frame.size() != sizeof(expected) || memcmp(frame.data(), expected, sizeof(expected)) != 0) {
+                fprintf(stderr, "convert: known color (%u,%u,%u) mismatch\n", color.r, color.g, color.b);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * 各指令集实现及多线程转换与单线程标量实现逐位比较，覆盖奇数宽高、行跨度填充和SIMD尾部处理
+     */
+    bool VerifyConvert(JsonWriter &json)
+    {
+        struct Case {
+            uint32_t pixelFormat;
+            uint32_t width;
+            uint32_t height;
+            uint32_t stridePadding;
+        };
+        const Case cases[] = {
+            { VMI_PIXEL_FORMAT_RGBA, 1920, 1080, 0 },
+            { VMI_PIXEL_FORMAT_BGRA, 1921, 1081, 12 },
+            { VMI_PIXEL_FORMAT_RGBA, 67, 33, 4 },
+            { VMI_PIXEL_FORMAT_BGRA, 1, 1, 0 },
+            { VMI_PIXEL_FORMAT_NV12, 1921, 1081, 7 },
+            { VMI_PIXEL_FORMAT_I420, 1280, 720, 64 },
+        };
+        bool isKnownExact = VerifyKnownColors();
+        bool isAllExact = isKnownExact;
+        json.BeginObject("exact");
+        json.Field("known_colors", isKnownExact);
+        for (auto level : SIMD_LEVELS) {
+            const VideoEncoderSimdKernels *kernels = GetSimdKernels(level);
+            if (kernels == nullptr) {
+                continue;
+            }
+            bool isExact = true;
+            for (const auto &c : cases) {
+                uint32_t rowBytes = (c.pixelFormat == VMI_PIXEL_FORMAT_RGBA || c.pixelFormat == VMI_PIXEL_FORMAT_BGRA) ?
+                    c.width * 4 : ((c.pixelFormat == VMI_PIXEL_FORMAT_NV12) ? (c.width + 1) / 2 * 2 : c.width);
+                VmiInputFormat format = {};
+                format.pixelFormat = c.pixelFormat;
+                format.stride = rowBytes + c.stridePadding;
+                format.convertThreads = 1;
+                size_t inputSize = static_cast<size_t>(format.stride) * (c.height + (c.height + 1) / 2);
+                std::vector<uint8_t> input = MakeRandomBytes(inputSize, c.width);
+                std::vector<uint8_t> reference = ConvertFrame(*GetSimdKernels(SIMD_LEVEL_SCALAR), format, c.width,
+                    c.height, input);
+                for (uint32_t threads : { 1U, 3U }) {
+                    format.convertThreads = threads;
+                    std::vector<uint8_t> frame = ConvertFrame(*kernels, format, c.width, c.height, input);
+                    if (reference.empty() || frame != reference) {
+                        fprintf(stderr, "convert: %s format %u %ux%u threads %u mismatch\n", kernels->name,
+                            c.pixelFormat, c.width, c.height, threads);
+                        isExact = false;
+                    }
+                }
+            }
+            json.Field(kernels->name, isExact);
+            isAllExact = isAllExact && isExact;
+        }
+        json.EndObject();
+        return isAllExact;
+    }
+
+    /**
+     * RGBA到I420格式转换吞吐: 各指令集实现单线程的单帧耗时和每核吞吐，以及最优实现在4K下
+     * 多线程分带转换的单帧耗时。吞吐按读取的RGBA输入计算，每纳秒1字节即1GB/s
+     */
+    bool RunConvert(uint32_t frames, JsonWriter &json)
+    {
+        json.BeginObject("convert");
+        bool isExact = VerifyConvert(json);
+        json.BeginArray("kernels");
+        VmiInputFormat format = {};
+        format.pixelFormat = VMI_PIXEL_FORMAT_RGBA;
+        for (const auto &resolution : RESOLUTIONS) {
+            std::vector<uint8_t> input = MakeRandomBytes(static_cast<size_t>(resolution.width) * resolution.height * 4,
+                1);
+            std::vector<uint32_t> threadCounts = { 1 };
+            if (resolution.width * resolution.height > 1920 * 1080) {
+                threadCounts = { 1, 2, 4 };
+            }
+            for (auto level : SIMD_LEVELS) {
+                const VideoEncoderSimdKernels *kernels = GetSimdKernels(level);
+                if (kernels == nullptr) {
+                    continue;
+                }
+                bool isBest = (kernels == &GetSimdKernels());
+                for (uint32_t threads : threadCounts) {
+                    if (threads > 1 && !isBest) {
+                        continue;
+                    }
+                    format.convertThreads = threads;
+                    VideoEncoderColorConverter converter(*kernels);
+                    if (!converter.Init(format, resolution.width, resolution.height)) {
+                        continue;
+                    }
+                    (void) converter.Convert(input.data());
+                    LatencySamples samples;
+                    samples.Reserve(frames);
+                    for (uint32_t i = 0; i < frames; ++i) {
+                        uint64_t t0 = GetMonotonicTimeNs();
+                        (void) converter.Convert(input.data());
+                        samples.Add(GetMonotonicTimeNs() - t0);
+                    }
+                    double avgNs = static_cast<double>(samples.Sum()) / std::max<size_t>(1, samples.Count());
+                    double gbps = (avgNs == 0) ? 0.0 : input.size() / avgNs;
+                    json.BeginObject();
+                    json.Field("resolution", resolution.name);
+                    json.Field("kernel", kernels->name);
+                    json.Field("threads", converter.GetThreadCount());
+                    json.LatencyField("convert", samples);
+                    json.Field("gbps", gbps);
+                    json.Field("gbps_per_core", gbps / converter.GetThreadCount());
+                    json.EndObject();
+                    fprintf(stderr, "convert: %s %s x%u %.2f GB/s per core\n", resolution.name, kernels->name,
+                        converter.GetThreadCount(), gbps / converter.GetThreadCount());
+                }
+            }
+        }
+        json.EndArray();
+        json.EndObject();
+        return isExact;
+    }
+
+    // 缩放一帧，失败时返回空
+    std::vector<uint8_t> ScaleFrame(const VideoEncoderSimdKernels &kernels, const Resolution &src,
+        const Resolution &dst, const std::vector<uint8_t> &input)
+    {
+        VideoEncoderScaler scaler(kernels);
+        if (!scaler.Init(src.width, src.height, dst.width, dst.height) || input.size() < scaler.GetSrcFrameSize()) {
+            return {};
+        }
+        std::vector<uint8_t> frame(scaler.GetDstFrameSize());
+        if (!scaler.Scale(input.data(), frame.data())) {
+            return {};
+        }
+        return frame;
+    }
+
+    /**
+     * 各指令集实现与标量实现逐位比较，覆盖整2倍盒式滤波、盒式滤波加双线性插值、奇数宽高、
+     * 同分辨率拷贝和放大，并检查纯色帧缩放后保持原值
+     */
+    bool VerifyScale(JsonWriter &json)
+    {
+        struct Case {
+            Resolution src;
+            Resolution dst;
+        };
+        const Case cases[] = {
+            { { "1080p", 1920, 1080 }, { "720p", 1280, 720 } },
+            { { "1080p", 1920, 1080 }, { "540p", 960, 540 } },
+            { { "1080p", 1920, 1080 }, { "360p", 640, 360 } },
+            { { "odd", 1921, 1081 }, { "odd", 853, 481 } },
+            { { "tiny", 67, 33 }, { "tiny", 1, 1 } },
+            { { "same", 640, 360 }, { "same", 640, 360 } },
+            { { "up", 640, 360 }, { "up", 1280, 720 } },
+        };
+        bool isFlatExact = true;
+        for (const auto &c : cases) {
+            size_t srcSize = static_cast<size_t>(c.src.width) * c.src.height +
+                2 * static_cast<size_t>((c.src.width + 1) / 2) * ((c.src.height + 1) / 2);
+            std::vector<uint8_t> flat(srcSize, 0x5a);
+            std::vector<uint8_t> frame = ScaleFrame(*GetSimdKernels(SIMD_LEVEL_SCALAR), c.src, c.dst, flat);
+            if (frame.empty() || std::any_of(frame.begin(), frame.end(), [](uint8_t v) { return v != 0x5a; })) {
+                fprintf(stderr, "scale: flat frame %ux%u -> %ux%u mismatch\n", c.src.width, c.src.height,
+                    c.dst.width, c.dst.height);
+                isFlatExact = false;
+            }
+        }
+        bool isAllExact = isFlatExact;
+        json.BeginObject("exact");
+        json.Field("flat_frames", isFlatExact);
+        for (auto level : SIMD_LEVELS) {
+            const VideoEncoderSimdKernels *kernels = GetSimdKernels(level);
+            if (kernels == nullptr) {
+                continue;
+            }
+            bool isExact = true;
+            for (const auto &c : cases) {
+                size_t srcSize = static_cast<size_t>(c.src.width) * c.src.height +
+                    2 * static_cast<size_t>((c.src.width + 1) / 2) * ((c.src.height + 1) / 2);
+                std::vector<uint8_t> input = MakeRandomBytes(srcSize, c.src.width);
+                std::vector<uint8_t> reference = ScaleFrame(*GetSimdKernels(SIMD_LEVEL_SCALAR), c.src, c.dst, input);
+                std::vector<uint8_t> frame = ScaleFrame(*kernels, c.src, c.dst, input);
+                if (reference.empty() || frame != reference) {
+                    fprintf(stderr, "scale: %s %ux%u -> %ux%u mismatch\n", kernels->name, c.src.width, c.src.height,
+                        c.dst.width, c.dst.height);
+                    isExact = false;
+                }
+            }
+            json.Field(kernels->name, isExact);
+            isAllExact = isAllExact && isExact;
+        }
+        json.EndObject();
+        return isAllExact;
+    }
+
+    /**
+     * 联播典型层的I420缩放: 各指令集实现从1080p缩放到720p(双线性)、540p(盒式)和360p(盒式加双线性)的单帧耗时
+     */
+    bool RunScale(uint32_t frames, JsonWriter &json)
+    {
+        const Resolution src = { "1080p", 1920, 1080 };
+        const Resolution layers[] = {
+            { "720p", 1280, 720 },
+            { "540p", 960, 540 },
+            { "360p", 640, 360 },
+        };
+        json.BeginObject("scale");
+        bool isExact = VerifyScale(json);
+        json.BeginArray("kernels");
+        size_t srcSize = static_cast<size_t>(src.width) * src.height * 3 / 2;
+        std::vector<uint8_t> input = MakeRandomBytes(srcSize, 1);
+        for (const auto &layer : layers) {
+            for (auto level : SIMD_LEVELS) {
+                const VideoEncoderSimdKernels *kernels = GetSimdKernels(level);
+                if (kernels == nullptr) {
+                    continue;
+                }
+                VideoEncoderScaler scaler(*kernels);
+                if (!scaler.Init(src.width, src.height, layer.width, layer.height)) {
+                    continue;
+                }
+                std::vector<uint8_t> frame(scaler.GetDstFrameSize());
+                (void) scaler.Scale(input.data(), frame.data());
+                LatencySamples samples;
+                samples.Reserve(frames);
+                for (uint32_t i = 0; i < frames; ++i) {
+                    uint64_t t0 = GetMonotonicTimeNs();
+                    (void) scaler.Scale(input.data(), frame.data());
+                    samples.Add(GetMonotonicTimeNs() - t0);
+                }
+                double avgUs = static_cast<double>(samples.Sum()) / std::max<size_t>(1, samples.Count()) / NS_PER_US;
+                json.BeginObject();
+                json.Field("source", src.name);
+                json.Field("layer", layer.name);
+                json.Field("kernel", kernels->name);
+                json.LatencyField("scale", samples);
+                json.EndObject();
+                fprintf(stderr, "scale: %s -> %s %s %.1f us\n", src.name, layer.name, kernels->name, avgUs);
+            }
+        }
+        json.EndArray();
+        json.EndObject();
+        return isExact;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Args args(argc, argv);
+    uint32_t frames = std::max(1U, args.GetU32("frames", FRAMES_DEFAULT));
+    std::string testCase = args.GetString("case", "all");
+    SetEnv("VMI_DEMO_VIDEO_ENCODER_TYPE", 1, false);  // ENCODER_TYPE_OPENH264
+    SetEnv("RO_VMI_LOGLEVEL", 6, false);  // ANDROID_LOG_ERROR
+
+    FILE *output = OpenOutput(args);
+    JsonWriter json(output);
+    json.BeginObject();
+    json.Field("benchmark", "vmi_frame");
+    json.Field("frames", frames);
+    json.Field("best_kernel", GetSimdKernels().name);
+    json.BeginObject("results");
+    if (testCase == "all" || testCase == "dirty") {
+        RunDirty(frames, json);
+    }
+    if (testCase == "all" || testCase == "skip") {
+        RunSkip(frames, args.GetU32("encode-us", ENCODE_US_DEFAULT), json);
+    }
+    bool isExact = true;
+    if (testCase == "all" || testCase == "convert") {
+        isExact = RunConvert(frames, json);
+    }
+    if (testCase == "all" || testCase == "scale") {
+        isExact = RunScale(frames, json) && isExact;
+    }
+    json.EndObject();
+    json.EndObject();
+    json.Finish();
+    CloseOutput(output);
+    return isExact ? 0 : 1;
+}
@@ -0,0 +1,443 @@
+/*
+ * 功能说明: 跨进程帧传递性能基准，编码进程fork并重新执行本程序作为生产者进程，对比两种把帧交给编码进程的方式:
+ *           socket为生产者经socketpair发送整帧，编码进程接收到自有缓冲区后调用VencEncodeOneFrame；
+ *           frame_ring为生产者直接写入共享内存帧环槽位，编码进程调用VencEncodeFromFrameRing原地编码。
+ *           测量按帧率提交时从生产者提交到编码完成的时延、不限速时的吞吐和两个进程每帧的CPU时间，
+ *           给出每帧拷贝字节数和按帧率折算的拷贝带宽；verify由编码进程直接读取帧环槽位，按帧序号校验数据
+ *
+ * 用法: vmi_frame_ring_benchmark [--width=1920] [--height=1080] [--fps=60] [--frames=300]
+ *       [--throughput-frames=1000] [--slots=4] [--encode-us=0] [--output=result.json]
+ *
+ * 生产者在帧的每个4KB页写入与帧序号相关的字节，模拟合成器写入帧，两种方式的写入量相同；编码进程设置
+ * VMI_MOCK_READ_INPUT使模拟编码器读取整帧，与真实编码器一样访问输入内存。
+ * 生产者进程由本程序以--role=producer重新执行，不单独使用。
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "BenchmarkCommon.h"
+#include "VideoEncoderFrameRing.h"
+#include "VideoEncoderWrapper.h"
+
+using namespace vmi_bench;
+
+namespace {
+    constexpr uint32_t WIDTH_DEFAULT = 1920;
+    constexpr uint32_t HEIGHT_DEFAULT = 1080;
+    constexpr uint32_t FPS_DEFAULT = 60;
+    constexpr uint32_t FRAMES_DEFAULT = 300;
+    constexpr uint32_t THROUGHPUT_FRAMES_DEFAULT = 1000;
+    constexpr uint32_t SLOTS_DEFAULT = 4;
+    constexpr uint32_t BITRATE = 8000000;
+    constexpr uint32_t PATTERN_STRIDE = 4096;
+    constexpr int32_t CONSUMER_TIMEOUT_MS = 5000;  // 生产者异常退出时编码进程不会一直等待
+    constexpr double NS_PER_SEC = 1e9;
+
+    struct FrameHeader {
+        uint64_t frameSeq;
+        uint64_t timestampNs;
+    };
+
+    // 帧头之后每个页首字节写入与帧序号和页序号相关的值
+    void WriteFrame(uint8_t *frame, uint32_t frameSize, uint64_t frameSeq)
+    {
+        for (uint32_t offset = PATTERN_STRIDE; offset < frameSize; offset += PATTERN_STRIDE) {
+            frame[offset] = static_cast<uint8_t>(frameSeq + offset / PATTERN_STRIDE);
+        }
+        FrameHeader header = { frameSeq, 0 };
+        (void) memcpy(frame, &header, sizeof(header));
+    }
+
+    void StampFrame(uint8_t *frame)
+    {
+        uint64_t nowNs = GetMonotonicTimeNs();
+        (void) memcpy(frame + offsetof(FrameHeader, timestampNs), &nowNs, sizeof(nowNs));
+    }
+
+    bool CheckFrame(const uint8_t *frame, uint32_t frameSize, uint64_t frameSeq)
+    {
+        FrameHeader header = {};
+        (void) memcpy(&header, frame, sizeof(header));
+        if (header.frameSeq != frameSeq) {
+            return false;
+        }
+        for (uint32_t offset = PATTERN_STRIDE; offset < frameSize; offset += PATTERN_STRIDE) {
+            if (frame[offset] != static_cast<uint8_t>(frameSeq + offset / PATTERN_STRIDE)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Pace(uint64_t startNs, uint32_t fps, uint32_t n)
+    {
+        if (fps == 0) {
+            return;
+        }
+        uint64_t dueNs = startNs + static_cast<uint64_t>(n) * static_cast<uint64_t>(NS_PER_SEC) / fps;
+        uint64_t nowNs = GetMonotonicTimeNs();
+        if (dueNs > nowNs) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - nowNs));
+        }
+    }
+
+    bool WriteAll(int fd, const uint8_t *data, size_t size)
+    {
+        while (size > 0) {
+            ssize_t written = write(fd, data, size);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool ReadAll(int fd, uint8_t *data, size_t size)
+    {
+        while (size > 0) {
+            ssize_t received = read(fd, data, size);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            data += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    // 生产者进程: socket方式在自有缓冲区写入帧后整帧发送，帧环方式直接写入槽位后提交
+    int RunProducer(const Args &args)
+    {
+        std::string transport = args.GetString("transport", "");
+        auto fd = static_cast<int>(args.GetU32("fd", 0));
+        uint32_t frames = args.GetU32("frames", 0);
+        uint32_t fps = args.GetU32("fps", 0);
+        uint32_t frameSize = args.GetU32("frame-size", 0);
+        uint64_t startNs = GetMonotonicTimeNs();
+        if (transport == "socket") {
+            std::vector<uint8_t> frame(frameSize, 0);
+            for (uint32_t n = 0; n < frames; ++n) {
+                Pace(startNs, fps, n);
+                WriteFrame(frame.data(), frameSize, n);
+                StampFrame(frame.data());
+                if (!WriteAll(fd, frame.data(), frameSize)) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+        uint32_t ringHandle = 0;
+        if (VencAttachFrameRing(fd, &ringHandle) != VMI_ENCODER_SUCCESS) {
+            return 1;
+        }
+        (void) close(fd);
+        int ret = 0;
+        for (uint32_t n = 0; n < frames && ret == 0; ++n) {
+            Pace(startNs, fps, n);
+            uint8_t *slot = nullptr;
+            uint32_t slotSize = 0;
+            if (VencAcquireFrameSlot(ringHandle, CONSUMER_TIMEOUT_MS, &slot, &slotSize) != VMI_ENCODER_SUCCESS ||
+                slotSize < frameSize) {
+                ret = 1;
+                break;
+            }
+            WriteFrame(slot, frameSize, n);
+            ret = (VencCommitFrameSlot(ringHandle, frameSize, GetMonotonicTimeNs()) == VMI_ENCODER_SUCCESS) ? 0 : 1;
+        }
+        (void) VencDestroyFrameRing(ringHandle);
+        return ret;
+    }
+
+    uint64_t ToNs(const struct timeval &tv)
+    {
+        return static_cast<uint64_t>(tv.tv_sec) * 1000000000ULL + static_cast<uint64_t>(tv.tv_usec) * 1000ULL;
+    }
+
+    uint64_t GetCpuTimeNs(const struct rusage &usage)
+    {
+        return ToNs(usage.ru_utime) + ToNs(usage.ru_stime);
+    }
+
+    class Producer {
+    public:
+        // fd在子进程中继承，exec前清除FD_CLOEXEC
+        bool Spawn(const char *transport, int fd, uint32_t frames, uint32_t fps, uint32_t frameSize)
+        {
+            std::vector<std::string> args = { "vmi_frame_ring_benchmark", "--role=producer",
+                std::string("--transport=") + transport, "--fd=" + std::to_string(fd),
+                "--frames=" + std::to_string(frames), "--fps=" + std::to_string(fps),
+                "--frame-size=" + std::to_string(frameSize) };
+            std::vector<char *> argv;
+            for (std::string &arg : args) {
+                argv.push_back(&arg[0]);
+            }
+            argv.push_back(nullptr);
+            m_pid = fork();
+            if (m_pid == 0) {
+                (void) fcntl(fd, F_SETFD, 0);
+                (void) execv("/proc/self/exe", argv.data());
+                _exit(127);
+            }
+            return m_pid > 0;
+        }
+
+        // 返回生产者是否正常退出，cpuNs为其CPU时间
+        bool Wait(uint64_t &cpuNs)
+        {
+            int status = 0;
+            struct rusage usage = {};
+            if (m_pid <= 0 || wait4(m_pid, &status, 0, &usage) != m_pid) {
+                return false;
+            }
+            cpuNs = GetCpuTimeNs(usage);
+            return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+
+    private:
+        pid_t m_pid = -1;
+    };
+
+    struct RunResult {
+        bool isOk = false;
+        uint32_t failures = 0;
+        uint32_t mismatches = 0;
+        uint64_t elapsedNs = 0;
+        uint64_t consumerCpuNs = 0;
+        uint64_t producerCpuNs = 0;
+        LatencySamples latency;  // 生产者提交到编码完成
+        VmiFrameRingStats ringStats = {};
+    };
+
+    uint64_t GetSelfCpuTimeNs()
+    {
+        struct rusage usage = {};
+        (void) getrusage(RUSAGE_SELF, &usage);
+        return GetCpuTimeNs(usage);
+    }
+
+    void RunSocket(uint32_t encHandle, uint32_t frameSize, uint32_t frames, uint32_t fps, RunResult &result)
+    {
+        int fds[2] = { -1, -1 };
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            fprintf(stderr, "socketpair failed: %s\n", strerror(errno));
+            return;
+        }
+        Producer producer;
+        bool isSpawned = producer.Spawn("socket", fds[1], frames, fps, frameSize);
+        (void) close(fds[1]);
+        std::vector<uint8_t> frame(frameSize, 0);
+        result.latency.Reserve(frames);
+        uint64_t cpu0 = GetSelfCpuTimeNs();
+        uint64_t startNs = GetMonotonicTimeNs();
+        for (uint32_t n = 0; n < frames && isSpawned; ++n) {
+            if (!ReadAll(fds[0], frame.data(), frameSize)) {
+                ++result.failures;
+                break;
+            }
+            FrameHeader header = {};
+            (void) memcpy(&header, frame.data(), sizeof(header));
+            result.mismatches += CheckFrame(frame.data(), frameSize, n) ? 0 : 1;
+            uint8_t *out = nullptr;
+            uint32_t outSize = 0;
+            if (VencEncodeOneFrame(encHandle, frame.data(), frameSize, &out, &outSize) != VMI_ENCODER_SUCCESS) {
+                ++result.failures;
+            }
+            result.latency.Add(GetMonotonicTimeNs() - header.timestampNs);
+        }
+        result.elapsedNs = GetMonotonicTimeNs() - startNs;
+        result.consumerCpuNs = GetSelfCpuTimeNs() - cpu0;
+        (void) close(fds[0]);
+        result.isOk = isSpawned && producer.Wait(result.producerCpuNs) && result.failures == 0;
+    }
+
+    void RunFrameRing(uint32_t encHandle, uint32_t frameSize, uint32_t frames, uint32_t fps, uint32_t slots,
+        RunResult &result)
+    {
+        VmiFrameRingConfig config = {};
+        config.slotCount = slots;
+        config.slotSize = frameSize;
+        uint32_t ringHandle = 0;
+        int fd = -1;
+        if (VencCreateFrameRing(&config, &ringHandle, &fd) != VMI_ENCODER_SUCCESS) {
+            fprintf(stderr, "create frame ring failed\n");
+            return;
+        }
+        Producer producer;
+        bool isSpawned = producer.Spawn("ring", fd, frames, fps, frameSize);
+        result.latency.Reserve(frames);
+        uint64_t cpu0 = GetSelfCpuTimeNs();
+        uint64_t startNs = GetMonotonicTimeNs();
+        for (uint32_t n = 0; n < frames && isSpawned; ++n) {
+            uint8_t *out = nullptr;
+            uint32_t outSize = 0;
+            VmiFrameRingFrame frame;
+            VmiEncoderRetCode ret = VencEncodeFromFrameRing(encHandle, ringHandle, CONSUMER_TIMEOUT_MS, &out,
+                &outSize, &frame);
+            if (ret == VMI_ENCODER_FRAME_RING_TIMEOUT || ret == VMI_ENCODER_FRAME_RING_FAIL) {
+                ++result.failures;
+                break;
+            }
+            result.failures += (ret == VMI_ENCODER_SUCCESS) ? 0 : 1;
+            result.mismatches += (frame.frameSeq == n && frame.dataSize == frameSize) ? 0 : 1;
+            result.latency.Add(GetMonotonicTimeNs() - frame.timestampNs);
+        }
+        result.elapsedNs = GetMonotonicTimeNs() - startNs;
+        result.consumerCpuNs = GetSelfCpuTimeNs() - cpu0;
+        (void) VencGetFrameRingStats(ringHandle, &result.ringStats);
+        result.isOk = isSpawned && producer.Wait(result.producerCpuNs) && result.failures == 0;
+        (void) VencDestroyFrameRing(ringHandle);
+    }
+
+    /**
+     * 校验: 编码进程直接使用帧环读取槽位，逐帧检查帧序号和每页写入的值，确认跨进程可见性和槽位不会在
+     * 交还前被生产者改写
+     */
+    void RunVerify(uint32_t frameSize, uint32_t frames, uint32_t slots, JsonWriter &json)
+    {
+        VideoEncoderFrameRing ring;
+        uint32_t mismatches = 0;
+        uint32_t received = 0;
+        bool isOk = ring.Create(slots, frameSize);
+        Producer producer;
+        isOk = isOk && producer.Spawn("ring", ring.GetFd(), frames, 0, frameSize);
+        for (uint32_t n = 0; n < frames && isOk; ++n) {
+            VideoEncoderFrameRing::Frame frame;
+            if (ring.AcquireFrame(CONSUMER_TIMEOUT_MS, frame) != VMI_ENCODER_SUCCESS) {
+                isOk = false;
+                break;
+            }
+            mismatches += (frame.frameSeq == n && CheckFrame(frame.data, frame.dataSize, n)) ? 0 : 1;
+            ring.ReleaseFrame();
+            ++received;
+        }
+        uint64_t producerCpuNs = 0;
+        isOk = producer.Wait(producerCpuNs) && isOk;
+        json.BeginObject("verify");
+        json.Field("completed", isOk);
+        json.Field("frames", received);
+        json.Field("mismatches", mismatches);
+        json.EndObject();
+        fprintf(stderr, "verify: %u frames, %u mismatches%s\n", received, mismatches, isOk ? "" : ", failed");
+    }
+
+    void WriteRunResult(JsonWriter &json, const char *name, RunResult &result, uint32_t frames)
+    {
+        json.BeginObject(name);
+        json.Field("completed", result.isOk);
+        json.Field("failures", result.failures);
+        json.Field("mismatches", result.mismatches);
+        json.Field("fps", (result.elapsedNs == 0) ? 0.0 : result.latency.Count() * NS_PER_SEC / result.elapsedNs);
+        json.Field("consumer_cpu_us_per_frame", static_cast<double>(result.consumerCpuNs) / frames / 1000.0);
+        json.Field("producer_cpu_us_per_frame", static_cast<double>(result.producerCpuNs) / frames / 1000.0);
+        json.LatencyField("commit_to_encoded", result.latency);
+        json.EndObject();
+    }
+
+    bool OpenEncoder(uint32_t width, uint32_t height, uint32_t fps, uint32_t &handle)
+    {
+        VmiEncodeParams params = {};
+        params.width = width;
+        params.height = height;
+        params.frameRate = (fps == 0) ? FPS_DEFAULT : fps;
+        params.bitrate = BITRATE;
+        if (VencCreateEncoder(&handle) != VMI_ENCODER_SUCCESS) {
+            return false;
+        }
+        if (VencInitEncoder(handle, params) != VMI_ENCODER_SUCCESS || VencStartEncoder(handle) != VMI_ENCODER_SUCCESS) {
+            (void) VencDestroyEncoder(handle);
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Args args(argc, argv);
+    if (args.GetString("role", "") == "producer") {
+        return RunProducer(args);
+    }
+    SetEnv("VMI_DEMO_VIDEO_ENCODER_TYPE", 1, false);  // ENCODER_TYPE_OPENH264
+    SetEnv("RO_VMI_LOGLEVEL", 6, false);  // ANDROID_LOG_ERROR
+    uint32_t width = args.GetU32("width", WIDTH_DEFAULT);
+    uint32_t height = args.GetU32("height", HEIGHT_DEFAULT);
+    uint32_t fps = args.GetU32("fps", FPS_DEFAULT);
+    uint32_t frames = std::max(1U, args.GetU32("frames", FRAMES_DEFAULT));
+    uint32_t throughputFrames = std::max(1U, args.GetU32("throughput-frames", THROUGHPUT_FRAMES_DEFAULT));
+    uint32_t slots = args.GetU32("slots", SLOTS_DEFAULT);
+    SetEnv("VMI_MOCK_ENCODE_US", args.GetU32("encode-us", 0));
+    SetEnv("VMI_MOCK_READ_INPUT", 1);
+    uint32_t frameSize = width * height * 3 / 2;
+    uint32_t encHandle = 0;
+    if (frameSize < sizeof(FrameHeader) || !OpenEncoder(width, height, fps, encHandle)) {
+        fprintf(stderr, "open encoder failed\n");
+        return 1;
+    }
+
+    FILE *output = OpenOutput(args);
+    JsonWriter json(output);
+    json.BeginObject();
+    json.Field("benchmark", "vmi_frame_ring_benchmark");
+    json.Field("width", width);
+    json.Field("height", height);
+    json.Field("frame_size", frameSize);
+    json.Field("fps", fps);
+    json.Field("slots", slots);
+    bool isOk = true;
+    const char *names[] = { "socket", "frame_ring" };
+    for (uint32_t mode = 0; mode < 2; ++mode) {
+        RunResult paced;
+        RunResult unpaced;
+        if (mode == 0) {
+            RunSocket(encHandle, frameSize, frames, fps, paced);
+            RunSocket(encHandle, frameSize, throughputFrames, 0, unpaced);
+        } else {
+            RunFrameRing(encHandle, frameSize, frames, fps, slots, paced);
+            RunFrameRing(encHandle, frameSize, throughputFrames, 0, slots, unpaced);
+        }
+        isOk = isOk && paced.isOk && unpaced.isOk && paced.mismatches == 0 && unpaced.mismatches == 0;
+        // socket方式每帧在发送时拷入内核、接收时拷出，帧环方式不拷贝
+        uint64_t copiedBytes = (mode == 0) ? 2ULL * frameSize : 0;
+        json.BeginObject(names[mode]);
+        json.Field("copied_bytes_per_frame", copiedBytes);
+        WriteRunResult(json, "paced", paced, frames);
+        WriteRunResult(json, "throughput", unpaced, throughputFrames);
+        if (mode == 1) {
+            json.Field("consumer_waits", paced.ringStats.waits);
+            json.Field("consumer_wakeups", paced.ringStats.wakeups);
+        }
+        json.EndObject();
+        fprintf(stderr, "%s: paced p50 %.1f us, p99 %.1f us; throughput %.1f fps, cpu %.1f + %.1f us per frame\n",
+            names[mode], paced.latency.Percentile(0.50) / 1000.0, paced.latency.Percentile(0.99) / 1000.0,
+            (unpaced.elapsedNs == 0) ? 0.0 : unpaced.latency.Count() * NS_PER_SEC / unpaced.elapsedNs,
+            static_cast<double>(unpaced.consumerCpuNs) / throughputFrames / 1000.0,
+            static_cast<double>(unpaced.producerCpuNs) / throughputFrames / 1000.0);
+    }
+    json.Field("copy_bandwidth_saved_mb_per_sec", 2.0 * frameSize * fps / 1e6);
+    RunVerify(frameSize, frames, slots, json);
+    json.EndObject();
+    json.Finish();
+    CloseOutput(output);
+    (void) VencStopEncoder(encHandle);
+    (void) VencDestroyEncoder(encHandle);
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/*
+ * 功能说明: 日志路径性能基准，对比原同步日志实现与异步无锁队列实现的单次调用开销，
+ *           以及错误日志风暴下调用点限流后的开销，结果以JSON格式输出
+ *
+ * 用法: vmi_log_benchmark [--calls=100000] [--burst=128] [--threads=4] [--output=result.json]
+ * 系统日志替身输出到标准错误，测量期间重定向到/dev/null
+ */
+
+#define LOG_TAG "LogBenchmark"
+#include <cstdarg>
+#include <thread>
+#include <vector>
+#include "BenchmarkCommon.h"
+#include "VideoEncoderLog.h"
+
+using namespace vmi_bench;
+
+namespace {
+    constexpr uint32_t CALLS_DEFAULT = 100000;
+    constexpr uint32_t BURST_DEFAULT = 128;
+    constexpr uint32_t THREADS_DEFAULT = 4;
+
+    // 原实现: 每次调用构造std::string标签，并在调用线程上同步写系统日志
+    void LegacyLogPrint(int level, const char *vmiTag, const char *fmt, ...)
+    {
+        if (level < VideoEncoderLog::GetInstance().GetLogLevel() || level > ANDROID_LOG_SILENT || fmt == nullptr) {
+            return;
+        }
+        std::string fullTag = ((vmiTag == nullptr) ? "VMI_Native" : ("VMI_" + std::string(vmiTag)));
+        constexpr int logBufSize = 512;
+        char szBuff[logBufSize] = {0};
+        va_list ap;
+        va_start(ap, fmt);
+        int ret = vsnprintf(szBuff, logBufSize - 1, fmt, ap);
+        va_end(ap);
+        if (ret <= 0) {
+            return;
+        }
+        (void) __android_log_write(level, fullTag.c_str(), szBuff);
+    }
+
+    /**
+     * 按burst条一组调用logFunc并计时，每组之间等待后台线程清空队列(不计时)，
+     * 使异步实现测得的是入队开销而不是队列满时的丢弃开销
+     */
+    template <typename LogFunc>
+    LatencySamples MeasureCalls(uint32_t calls, uint32_t burst, LogFunc logFunc)
+    {
+        LatencySamples samples;
+        samples.Reserve(calls / burst + 1);
+        for (uint32_t done = 0; done < calls; done += burst) {
+            uint64_t start = GetMonotonicTimeNs();
+            for (uint32_t i = 0; i < burst; ++i) {
+                logFunc(done + i);
+            }
+            samples.Add((GetMonotonicTimeNs() - start) / burst);
+            VmiLogFlush();
+        }
+        return samples;
+    }
+
+    double MeasureThreads(uint32_t threadCount, uint32_t calls, uint32_t burst)
+    {
+        std::vector<std::thread> threads;
+        std::vector<uint64_t> elapsed(threadCount, 0);
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                for (uint32_t done = 0; done < calls; done += burst) {
+                    uint64_t start = GetMonotonicTimeNs();
+                    for (uint32_t i = 0; i < burst; ++i) {
+                        VmiLogPrint(ANDROID_LOG_ERROR, LOG_TAG, "encode one frame failed: encoder %#x error %#x",
+                            t, done + i);
+                    }
+                    elapsed[t] += GetMonotonicTimeNs() - start;
+                    std::this_thread::yield();
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        VmiLogFlush();
+        uint64_t total = 0;
+        for (uint64_t ns : elapsed) {
+            total += ns;
+        }
+        return static_cast<double>(total) / (static_cast<uint64_t>(threadCount) * calls);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Args args(argc, argv);
+    uint32_t calls = args.GetU32("calls", CALLS_DEFAULT);
+    uint32_t burst = std::max(1U, args.GetU32("burst", BURST_DEFAULT));
+    uint32_t threadCount = std::max(1U, args.GetU32("threads", THREADS_DEFAULT));
+    SetEnv("RO_VMI_LOGLEVEL", ANDROID_LOG_INFO, false);
+    FILE *output = OpenOutput(args);
+    if (freopen("/dev/null", "w", stderr) == nullptr) {
+        fprintf(output, "redirect stderr failed\n");
+    }
+
+    LatencySamples legacy = MeasureCalls(calls, burst, [](uint32_t i) {
+        LegacyLogPrint(ANDROID_LOG_ERROR, LOG_TAG, "encode one frame failed: encoder %#x error %#x", i, i);
+    });
+    LatencySamples async = MeasureCalls(calls, burst, [](uint32_t i) {
+        VmiLogPrint(ANDROID_LOG_ERROR, LOG_TAG, "encode one frame failed: encoder %#x error %#x", i, i);
+    });
+    // 同一调用点的错误风暴，限流后绝大部分调用只做计数
+    LatencySamples storm = MeasureCalls(calls, burst, [](uint32_t i) {
+        ERR("encode one frame failed: encoder %#x error %#x", i, i);
+    });
+    LatencySamples filtered = MeasureCalls(calls, burst, [](uint32_t i) {
+        DBG("encode one frame: encoder %#x size %u", i, i);
+    });
+    double threaded = MeasureThreads(threadCount, calls, burst);
+
+    JsonWriter json(output);
+    json.BeginObject();
+    json.Field("benchmark", "vmi_log");
+    json.BeginObject("config");
+    json.Field("calls", calls);
+    json.Field("burst", burst);
+    json.Field("threads", threadCount);
+    json.EndObject();
+    json.BeginObject("results");
+    json.LatencyField("legacy_sync_per_call", legacy);
+    json.LatencyField("async_per_call", async);
+    json.LatencyField("rate_limited_storm_per_call", storm);
+    json.LatencyField("filtered_level_per_call", filtered);
+    json.Field("async_multithread_avg_us", threaded / 1000.0);
+    json.EndObject();
+    json.EndObject();
+    json.Finish();
+    CloseOutput(output);
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * 功能说明: 码控离线回放工具，按网络轨迹驱动码控策略，模拟瓶颈链路的排队时延和丢包，
+ *           输出码率跟随、超发时间和参数调整次数等指标，用于在不部署的情况下评估码控策略
+ *
+ * 用法: vmi_rate_control_replay [--trace=trace.csv] [--duration-ms=60000] [--feedback-ms=100]
+ *       [--bitrate=8000000] [--frame-rate=60] [--width=1280] [--height=720] [--output=result.json]
+ *
+ * 轨迹文件每行一个采样点: timeMs,capacityKbps[,baseRttMs]，按时间升序，'#'开头的行为注释；
+ * 采样点之间保持上一个采样点的链路容量。未指定轨迹时使用内置的阶跃轨迹。
+ */
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "BenchmarkCommon.h"
+#include "VideoEncoderRateControl.h"
+
+using namespace vmi_bench;
+
+namespace {
+    constexpr uint64_t US_PER_MS = 1000;
+    constexpr double BITS_PER_BYTE = 8.0;
+    constexpr double KBPS = 1000.0;
+    constexpr uint32_t BASE_RTT_MS_DEFAULT = 40;
+    constexpr uint32_t QUEUE_LIMIT_MS = 200;      // 瓶颈链路缓冲区深度，超出部分丢弃
+    constexpr uint32_t FEEDBACK_MS_DEFAULT = 100;
+    constexpr uint32_t DURATION_MS_DEFAULT = 60000;
+    constexpr uint32_t BITRATE_DEFAULT = 8000000;
+    constexpr uint32_t FRAME_RATE_DEFAULT = 60;
+    constexpr uint32_t WIDTH_DEFAULT = 1280;
+    constexpr uint32_t HEIGHT_DEFAULT = 720;
+    constexpr uint32_t GOP_SIZE_DEFAULT = 300;
+    constexpr double KEY_FRAME_RATIO = 4.0;
+    constexpr double PERMILLE = 1000.0;
+
+    struct TracePoint {
+        uint64_t timeMs = 0;
+        double capacityKbps = 0;
+        uint32_t baseRttMs = BASE_RTT_MS_DEFAULT;
+    };
+
+    bool LoadTrace(const std::string &path, std::vector<TracePoint> &trace)
+    {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::replace(line.begin(), line.end(), ',', ' ');
+            std::istringstream iss(line);
+            TracePoint point;
+            if (!(iss >> point.timeMs >> point.capacityKbps)) {
+                continue;
+            }
+            if (!(iss >> point.baseRttMs)) {
+                point.baseRttMs = BASE_RTT_MS_DEFAULT;
+            }
+            trace.push_back(point);
+        }
+        return !trace.empty();
+    }
+
+    // 内置轨迹: 10Mbps -> 3Mbps -> 10Mbps -> 1.5Mbps -> 6Mbps，每段12秒
+    std::vector<TracePoint> GetDefaultTrace()
+    {
+        constexpr uint64_t stepMs = 12000;
+        const double capacities[] = { 10000, 3000, 10000, 1500, 6000 };
+        std::vector<TracePoint> trace;
+        uint64_t timeMs = 0;
+        for (double capacity : capacities) {
+            TracePoint point;
+            point.timeMs = timeMs;
+            point.capacityKbps = capacity;
+            trace.push_back(point);
+            timeMs += stepMs;
+        }
+        return trace;
+    }
+
+    // 单瓶颈链路: 按容量出队，缓冲区超过QUEUE_LIMIT_MS时丢弃
+    class BottleneckLink {
+    public:
+        // 发送一帧，返回被丢弃的字节数
+        double Send(double bytes, double capacityBps)
+        {
+            double limitBytes = capacityBps / BITS_PER_BYTE * QUEUE_LIMIT_MS / KBPS;
+            double accepted = std::min(bytes, std::max(0.0, limitBytes - m_queueBytes));
+            m_queueBytes += accepted;
+            return bytes - accepted;
+        }
+
+        void Drain(uint64_t elapsedUs, double capacityBps)
+        {
+            double drained = capacityBps / BITS_PER_BYTE * elapsedUs / (US_PER_MS * KBPS);
+            m_queueBytes = std::max(0.0, m_queueBytes - drained);
+        }
+
+        uint32_t GetQueueDelayMs(double capacityBps) const
+        {
+            if (capacityBps <= 0) {
+                return QUEUE_LIMIT_MS;
+            }
+            return static_cast<uint32_t>(m_queueBytes * BITS_PER_BYTE * KBPS / capacityBps);
+        }
+
+    private:
+        double m_queueBytes = 0;
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    Args args(argc, argv);
+    std::vector<TracePoint> trace;
+    std::string tracePath = args.GetString("trace", "");
+    if (tracePath.empty()) {
+        trace = GetDefaultTrace();
+    } else if (!LoadTrace(tracePath, trace)) {
+        fprintf(stderr, "load trace %s failed\n", tracePath.c_str());
+        return 1;
+    }
+    uint64_t durationMs = args.GetU32("duration-ms", DURATION_MS_DEFAULT);
+    uint64_t feedbackUs = args.GetU32("feedback-ms", FEEDBACK_MS_DEFAULT) * US_PER_MS;
+
+    EncodeParams params = {};
+    params.bitrate = args.GetU32("bitrate", BITRATE_DEFAULT);
+    params.frameRate = args.GetU32("frame-rate", FRAME_RATE_DEFAULT);
+    params.width = args.GetU32("width", WIDTH_DEFAULT);
+    params.height = args.GetU32("height", HEIGHT_DEFAULT);
+    params.gopSize = GOP_SIZE_DEFAULT;
+    VmiRateControlConfig rcConfig = {};
+    rcConfig.policy = VMI_RATE_CONTROL_POLICY_AIMD;
+    auto policy = CreateRateControlPolicy(rcConfig, params);
+    if (policy == nullptr) {
+        fprintf(stderr, "create rate control policy failed\n");
+        return 1;
+    }
+
+    BottleneckLink link;
+    size_t traceIndex = 0;
+    uint64_t nowUs = 0;
+    uint64_t lastFeedbackUs = 0;
+    uint64_t frameIndex = 0;
+    double sentBytes = 0;
+    double lostBytes = 0;
+    double windowSentBytes = 0;
+    double windowLostBytes = 0;
+    double deliveredBits = 0;
+    double capacityBits = 0;
+    uint64_t overshootUs = 0;
+    uint32_t paramChanges = 0;
+    uint32_t maxQueueDelayMs = 0;
+    LatencySamples queueDelay;
+    FILE *output = OpenOutput(args);
+    JsonWriter json(output);
+    json.BeginObject();
+    json.Field("benchmark", "vmi_rate_control_replay");
+    json.Field("trace", tracePath.empty() ? std::string("builtin") : tracePath);
+    json.BeginArray("timeline");
+    while (nowUs < durationMs * US_PER_MS) {
+        while (traceIndex + 1 < trace.size() && trace[traceIndex + 1].timeMs * US_PER_MS <= nowUs) {
+            ++traceIndex;
+        }
+        const TracePoint &point = trace[traceIndex];
+        double capacityBps = point.capacityKbps * KBPS;
+        uint64_t frameIntervalUs = US_PER_MS * KBPS / std::max(1U, params.frameRate);
+
+        double frameBytes = params.bitrate / BITS_PER_BYTE / std::max(1U, params.frameRate);
+        if (frameIndex % params.gopSize == 0) {
+            frameBytes *= KEY_FRAME_RATIO;
+        }
+        double lost = link.Send(frameBytes, capacityBps);
+        sentBytes += frameBytes;
+        lostBytes += lost;
+        windowSentBytes += frameBytes;
+        windowLostBytes += lost;
+        policy->OnFrameEncoded(nowUs, static_cast<uint32_t>(frameBytes));
+
+        if (nowUs - lastFeedbackUs >= feedbackUs) {
+            VmiNetworkFeedback feedback = {};
+            uint32_t delayMs = link.GetQueueDelayMs(capacityBps);
+            feedback.rttMs = point.baseRttMs + delayMs;
+            feedback.lossPermille = (windowSentBytes <= 0) ? 0 :
+                static_cast<uint32_t>(windowLostBytes * PERMILLE / windowSentBytes);
+            feedback.availableBitrate = static_cast<uint32_t>(capacityBps);
+            policy->OnNetworkFeedback(nowUs, feedback);
+            queueDelay.Add(static_cast<uint64_t>(delayMs) * US_PER_MS * KBPS);
+            maxQueueDelayMs = std::max(maxQueueDelayMs, delayMs);
+            json.BeginObject();
+            json.Field("time_ms", nowUs / US_PER_MS);
+            json.Field("capacity_kbps", point.capacityKbps);
+            json.Field("bitrate_kbps", params.bitrate / KBPS);
+            json.Field("frame_rate", params.frameRate);
+            json.Field("rtt_ms", feedback.rttMs);
+            json.Field("loss_permille", feedback.lossPermille);
+            json.EndObject();
+            windowSentBytes = 0;
+            windowLostBytes = 0;
+            lastFeedbackUs = nowUs;
+        }
+
+        EncodeParams target = {};
+        if (policy->Decide(nowUs, params, target)) {
+            params = target;
+            ++paramChanges;
+        }
+        link.Drain(frameIntervalUs, capacityBps);
+        if (params.bitrate > capacityBps) {
+            overshootUs += frameIntervalUs;
+        }
+        deliveredBits += std::min<double>(params.bitrate, capacityBps) * frameIntervalUs / (US_PER_MS * KBPS);
+        capacityBits += capacityBps * frameIntervalUs / (US_PER_MS * KBPS);
+        nowUs += frameIntervalUs;
+        ++frameIndex;
+    }
+    json.EndArray();
+    json.BeginObject("summary");
+    json.Field("duration_ms", durationMs);
+    json.Field("frames", frameIndex);
+    json.Field("param_changes", paramChanges);
+    json.Field("utilization", (capacityBits <= 0) ? 0.0 : deliveredBits / capacityBits);
+    json.Field("overshoot_ratio", (nowUs == 0) ? 0.0 : static_cast<double>(overshootUs) / nowUs);
+    json.Field("loss_ratio", (sentBytes <= 0) ? 0.0 : lostBytes / sentBytes);
+    json.Field("max_queue_delay_ms", maxQueueDelayMs);
+    json.LatencyField("queue_delay", queueDelay);
+    json.EndObject();
+    json.EndObject();
+    json.Finish();
+    CloseOutput(output);
+    return 0;
+}
@@ -0,0 +1,1410 @@
+/*
+ * 功能说明: libVideoEncoder封装层性能基准，配合模拟libVideoCodec.so测量编码器生命周期时延、
+ *           单句柄封装开销、多线程多句柄吞吐、单句柄锁竞争、预热池对会话启动时延的影响、
+ *           硬件容量耗尽时的编码器类型调度与回退、联播组与多个独立句柄的对比以及多会话异步编码时
+ *           共享执行器与每会话专属线程的对比，封装层建立NAL单元索引与调用者自行扫描码流的对比，
+ *           会话抓取的每帧开销和抓取文件大小，逐帧追踪开启前后的每帧开销，以及编码慢于采集时各过载策略的
+ *           采集到输出时延和丢帧数，结果以JSON格式输出
+ *
+ * 用法: vmi_encoder_benchmark [--case=all|lifecycle|overhead|throughput|contention|startup|scheduling|simulcast|
+ *       executor|nal|capture|trace|overload] [--width=1280] [--height=720] [--frames=2000] [--throughput-frames=200]
+ *       [--iterations=200] [--threads=8] [--handles=0] [--encode-us=1000] [--spin] [--startup-iterations=20]
+ *       [--create-us=20000] [--init-us=30000] [--sessions=12] [--hw-sessions=4] [--executor-sessions=24]
+ *       [--executor-frames=90] [--executor-threads=0] [--affinity=none|core|node] [--nal-output-size=65536]
+ *       [--capture-path=vmi_capture.bin] [--frame-trace-path=vmi_frame_trace.json] [--overload-encode-us=50000]
+ *       [--overload-frames=60] [--output=result.json]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <ctime>
+#include <dlfcn.h>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BenchmarkCommon.h"
+#include "VideoCodecApi.h"
+#include "VideoEncoderCapture.h"
+#include "VideoEncoderWrapper.h"
+
+using namespace vmi_bench;
+
+namespace {
+    constexpr uint32_t WIDTH_DEFAULT = 1280;
+    constexpr uint32_t HEIGHT_DEFAULT = 720;
+    constexpr uint32_t FRAME_RATE_DEFAULT = 30;
+    constexpr uint32_t BITRATE_DEFAULT = 4000000;
+    constexpr uint32_t FRAMES_DEFAULT = 2000;
+    constexpr uint32_t ITERATIONS_DEFAULT = 200;
+    constexpr uint32_t THREADS_DEFAULT = 8;
+    constexpr uint32_t ENCODE_US_DEFAULT = 1000;
+    constexpr uint32_t THROUGHPUT_FRAMES_DEFAULT = 200;
+    constexpr uint32_t STARTUP_ITERATIONS_DEFAULT = 20;
+    constexpr uint32_t CREATE_US_DEFAULT = 20000;
+    constexpr uint32_t INIT_US_DEFAULT = 30000;
+    constexpr uint32_t WARM_POOL_SIZE = 4;
+    constexpr uint32_t SESSIONS_DEFAULT = 12;
+    constexpr uint32_t HW_SESSIONS_DEFAULT = 4;
+    constexpr uint32_t SIMULCAST_FRAMES = 100;
+    constexpr uint32_t EXECUTOR_SESSIONS_DEFAULT = 24;
+    constexpr uint32_t EXECUTOR_FRAMES_DEFAULT = 90;
+    constexpr uint32_t EXECUTOR_WIDTH = 640;
+    constexpr uint32_t EXECUTOR_HEIGHT = 360;
+    constexpr uint32_t EXECUTOR_QUEUE_DEPTH = 4;
+    constexpr uint32_t NAL_OUTPUT_SIZE_DEFAULT = 65536;
+    constexpr const char *CAPTURE_PATH_DEFAULT = "vmi_capture.bin";
+    constexpr uint32_t CAPTURE_BLOCK_SIZE = 64;  // 每帧变化的亮度块边长
+    constexpr const char *FRAME_TRACE_PATH_DEFAULT = "vmi_frame_trace.json";
+    constexpr uint32_t FRAME_TRACE_THREADS = 2;
+    constexpr uint32_t OVERLOAD_ENCODE_US_DEFAULT = 50000;  // 慢于30帧/秒的一帧间隔
+    constexpr uint32_t OVERLOAD_FRAMES_DEFAULT = 60;
+    constexpr double NS_PER_SEC = 1e9;
+
+    struct BenchConfig {
+        uint32_t width = WIDTH_DEFAULT;
+        uint32_t height = HEIGHT_DEFAULT;
+        uint32_t frames = FRAMES_DEFAULT;
+        uint32_t throughputFrames = THROUGHPUT_FRAMES_DEFAULT;
+        uint32_t iterations = ITERATIONS_DEFAULT;
+        uint32_t threads = THREADS_DEFAULT;
+        uint32_t handles = 0;
+        uint32_t encodeUs = ENCODE_US_DEFAULT;
+        bool isSpin = false;
+        uint32_t startupIterations = STARTUP_ITERATIONS_DEFAULT;
+        uint32_t createUs = CREATE_US_DEFAULT;
+        uint32_t initUs = INIT_US_DEFAULT;
+        uint32_t sessions = SESSIONS_DEFAULT;
+        uint32_t hwSessions = HW_SESSIONS_DEFAULT;
+        uint32_t executorSessions = EXECUTOR_SESSIONS_DEFAULT;
+        uint32_t executorFrames = EXECUTOR_FRAMES_DEFAULT;
+        VmiEncodeExecutorConfig executor = {};
+        uint32_t nalOutputSize = NAL_OUTPUT_SIZE_DEFAULT;
+        std::string capturePath = CAPTURE_PATH_DEFAULT;
+        std::string frameTracePath = FRAME_TRACE_PATH_DEFAULT;
+        uint32_t overloadEncodeUs = OVERLOAD_ENCODE_US_DEFAULT;
+        uint32_t overloadFrames = OVERLOAD_FRAMES_DEFAULT;
+    };
+
+    VmiEncodeParams GetEncodeParams(const BenchConfig &config)
+    {
+        VmiEncodeParams params = {};
+        params.width = config.width;
+        params.height = config.height;
+        params.frameRate = FRAME_RATE_DEFAULT;
+        params.bitrate = BITRATE_DEFAULT;
+        return params;
+    }
+
+    void ConfigMock(uint32_t encodeUs, bool isSpin)
+    {
+        SetEnv("VMI_MOCK_ENCODE_US", encodeUs);
+        SetEnv("VMI_MOCK_ENCODE_SPIN", isSpin ? 1 : 0);
+    }
+
+    bool OpenEncoder(const BenchConfig &config, uint32_t &handle)
+    {
+        if (VencCreateEncoder(&handle) != VMI_ENCODER_SUCCESS) {
+            return false;
+        }
+        if (VencInitEncoder(handle, GetEncodeParams(config)) != VMI_ENCODER_SUCCESS ||
+            VencStartEncoder(handle) != VMI_ENCODER_SUCCESS) {
+            (void) VencDestroyEncoder(handle);
+            return false;
+        }
+        return true;
+    }
+
+    void CloseEncoder(uint32_t handle)
+    {
+        (void) VencStopEncoder(handle);
+        (void) VencDestroyEncoder(handle);
+    }
+
+    // 所有线程就绪后同时开始，避免线程创建时间计入吞吐
+    class StartGate {
+    public:
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lck(m_lock);
+            m_cv.wait(lck, [this] { return m_isOpen; });
+        }
+
+        void Open()
+        {
+            {
+                std::lock_guard<std::mutex> lck(m_lock);
+                m_isOpen = true;
+            }
+            m_cv.notify_all();
+        }
+
+    private:
+        std::mutex m_lock = {};
+        std::condition_variable m_cv = {};
+        bool m_isOpen = false;
+    };
+
+    /**
+     * 生命周期时延: cold为进程内无其他编码器，创建包含编解码库加载、销毁包含库卸载；
+     * warm为另有一个编码器存活，库保持加载
+     */
+    void RunLifecycle(const BenchConfig &config, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        json.BeginObject("lifecycle");
+        for (bool isWarm : { false, true }) {
+            uint32_t anchor = 0;
+            if (isWarm && !OpenEncoder(config, anchor)) {
+                fprintf(stderr, "lifecycle: open anchor encoder failed\n");
+                break;
+            }
+            LatencySamples create;
+            LatencySamples init;
+            LatencySamples start;
+            LatencySamples stop;
+            LatencySamples destroy;
+            uint32_t failures = 0;
+            VmiEncodeParams params = GetEncodeParams(config);
+            for (uint32_t i = 0; i < config.iterations; ++i) {
+                uint32_t handle = 0;
+                uint64_t t0 = GetMonotonicTimeNs();
+                if (VencCreateEncoder(&handle) != VMI_ENCODER_SUCCESS) {
+                    ++failures;
+                    continue;
+                }
+                uint64_t t1 = GetMonotonicTimeNs();
+                bool isOk = VencInitEncoder(handle, params) == VMI_ENCODER_SUCCESS;
+                uint64_t t2 = GetMonotonicTimeNs();
+                isOk = isOk && VencStartEncoder(handle) == VMI_ENCODER_SUCCESS;
+                uint64_t t3 = GetMonotonicTimeNs();
+                (void) VencStopEncoder(handle);
+                uint64_t t4 = GetMonotonicTimeNs();
+                (void) VencDestroyEncoder(handle);
+                uint64_t t5 = GetMonotonicTimeNs();
+                if (!isOk) {
+                    ++failures;
+                    continue;
+                }
+                create.Add(t1 - t0);
+                init.Add(t2 - t1);
+                start.Add(t3 - t2);
+                stop.Add(t4 - t3);
+                destroy.Add(t5 - t4);
+            }
+            if (isWarm) {
+                CloseEncoder(anchor);
+            }
+            json.BeginObject(isWarm ? "warm" : "cold");
+            json.Field("failures", failures);
+            json.LatencyField("create", create);
+            json.LatencyField("init", init);
+            json.LatencyField("start", start);
+            json.LatencyField("stop", stop);
+            json.LatencyField("destroy", destroy);
+            json.EndObject();
+        }
+        json.EndObject();
+    }
+
+    /**
+     * 单句柄封装开销: 模拟编码耗时为0，对比直接调用libVideoCodec.so与经由VencEncodeOneFrame的单帧耗时
+     */
+    void RunOverhead(const BenchConfig &config, const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        uint32_t handle = 0;
+        if (!OpenEncoder(config, handle)) {
+            fprintf(stderr, "overhead: open encoder failed\n");
+            return;
+        }
+        // 封装层已加载库，这里取得同一份映像直接创建模拟编码器作为基线
+        void *lib = dlopen("libVideoCodec.so", RTLD_NOW);
+        auto create = (lib == nullptr) ? nullptr :
+            reinterpret_cast<EncoderRetCode (*)(uint32_t, VideoEncoder**)>(dlsym(lib, "CreateVideoEncoder"));
+        auto destroy = (lib == nullptr) ? nullptr :
+            reinterpret_cast<EncoderRetCode (*)(uint32_t, VideoEncoder*)>(dlsym(lib, "DestroyVideoEncoder"));
+        VideoEncoder *direct = nullptr;
+        if (create == nullptr || destroy == nullptr || create(ENCODER_TYPE_OPENH264, &direct) != VIDEO_ENCODER_SUCCESS) {
+            fprintf(stderr, "overhead: create direct encoder failed: %s\n", dlerror());
+            CloseEncoder(handle);
+            return;
+        }
+        EncodeParams directParams = {};
+        directParams.width = config.width;
+        directParams.height = config.height;
+        directParams.frameRate = FRAME_RATE_DEFAULT;
+        directParams.bitrate = BITRATE_DEFAULT;
+        (void) direct->InitEncoder(directParams);
+        (void) direct->StartEncoder();
+
+        LatencySamples directSamples;
+        LatencySamples wrapperSamples;
+        LatencySamples bufferSamples;
+        directSamples.Reserve(config.frames);
+        wrapperSamples.Reserve(config.frames);
+        bufferSamples.Reserve(config.frames);
+        std::vector<uint8_t> outBuffer(frame.size());
+        VmiIoVec iov = { outBuffer.data(), static_cast<uint32_t>(outBuffer.size()) };
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        for (uint32_t i = 0; i < config.frames; ++i) {
+            uint8_t *out = nullptr;
+            uint32_t outSize = 0;
+            uint64_t t0 = GetMonotonicTimeNs();
+            (void) direct->EncodeOneFrame(frame.data(), inputSize, &out, &outSize);
+            uint64_t t1 = GetMonotonicTimeNs();
+            (void) VencEncodeOneFrame(handle, frame.data(), inputSize, &out, &outSize);
+            uint64_t t2 = GetMonotonicTimeNs();
+            (void) VencEncodeOneFrameToBuffer(handle, frame.data(), inputSize, &iov, 1, &outSize);
+            uint64_t t3 = GetMonotonicTimeNs();
+            directSamples.Add(t1 - t0);
+            wrapperSamples.Add(t2 - t1);
+            bufferSamples.Add(t3 - t2);
+        }
+        (void) direct->StopEncoder();
+        direct->DestroyEncoder();
+        (void) destroy(ENCODER_TYPE_OPENH264, direct);
+        (void) dlclose(lib);
+        CloseEncoder(handle);
+
+        constexpr double nsPerUs = 1000.0;
+        json.BeginObject("overhead");
+        json.LatencyField("direct", directSamples);
+        json.LatencyField("encode_one_frame", wrapperSamples);
+        json.LatencyField("encode_to_buffer", bufferSamples);
+        json.Field("overhead_p50_us", (static_cast<double>(wrapperSamples.Percentile(0.50)) -
+            static_cast<double>(directSamples.Percentile(0.50))) / nsPerUs);
+        json.EndObject();
+    }
+
+    struct WorkloadResult {
+        uint64_t frames = 0;
+        uint64_t failures = 0;
+        uint64_t elapsedNs = 0;
+        LatencySamples latency;
+    };
+
+    /**
+     * 在threadCount个线程上对handles中的编码器并发编码，线程i使用句柄handles[i % handles.size()]
+     */
+    WorkloadResult RunWorkload(const std::vector<uint32_t> &handles, uint32_t threadCount, uint32_t framesPerThread,
+        const std::vector<uint8_t> &frame)
+    {
+        std::vector<WorkloadResult> results(threadCount);
+        std::vector<std::thread> threads;
+        StartGate gate;
+        std::atomic<uint32_t> readyCount = { 0 };
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                WorkloadResult &result = results[t];
+                result.latency.Reserve(framesPerThread);
+                uint32_t handle = handles[t % handles.size()];
+                auto inputSize = static_cast<uint32_t>(frame.size());
+                ++readyCount;
+                gate.Wait();
+                for (uint32_t i = 0; i < framesPerThread; ++i) {
+                    uint8_t *out = nullptr;
+                    uint32_t outSize = 0;
+                    uint64_t t0 = GetMonotonicTimeNs();
+                    VmiEncoderRetCode ret = VencEncodeOneFrame(handle, frame.data(), inputSize, &out, &outSize);
+                    result.latency.Add(GetMonotonicTimeNs() - t0);
+                    ++((ret == VMI_ENCODER_SUCCESS) ? result.frames : result.failures);
+                }
+            });
+        }
+        while (readyCount.load() < threadCount) {
+            std::this_thread::yield();
+        }
+        uint64_t start = GetMonotonicTimeNs();
+        gate.Open();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        WorkloadResult total;
+        total.elapsedNs = GetMonotonicTimeNs() - start;
+        for (auto &result : results) {
+            total.frames += result.frames;
+            total.failures += result.failures;
+            total.latency.Append(result.latency);
+        }
+        return total;
+    }
+
+    /**
+     * 多线程多句柄吞吐: 线程数按1,2,4...递增到--threads，每组使用--handles个句柄(0表示与线程数相同)，
+     * 以单线程吞吐为基准计算扩展效率
+     */
+    void RunThroughput(const BenchConfig &config, const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        ConfigMock(config.encodeUs, config.isSpin);
+        uint32_t framesPerThread = config.throughputFrames;
+        json.BeginObject("throughput");
+        json.Field("encode_us", config.encodeUs);
+        json.Field("spin", config.isSpin);
+        json.Field("frames_per_thread", framesPerThread);
+        json.BeginArray("runs");
+        double baseFps = 0;
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t threads = 1; threads < config.threads; threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+        threadCounts.push_back(config.threads);
+        for (uint32_t threadCount : threadCounts) {
+            uint32_t handleCount = (config.handles == 0) ? threadCount : std::min(config.handles, threadCount);
+            std::vector<uint32_t> handles;
+            for (uint32_t i = 0; i < handleCount; ++i) {
+                uint32_t handle = 0;
+                if (!OpenEncoder(config, handle)) {
+                    fprintf(stderr, "throughput: open encoder %u failed\n", i);
+                    break;
+                }
+                handles.push_back(handle);
+            }
+            if (handles.size() == handleCount) {
+                WorkloadResult result = RunWorkload(handles, threadCount, framesPerThread, frame);
+                double fps = (result.elapsedNs == 0) ? 0 : result.frames * NS_PER_SEC / result.elapsedNs;
+                if (threadCount == 1) {
+                    baseFps = fps;
+                }
+                json.BeginObject();
+                json.Field("threads", threadCount);
+                json.Field("handles", handleCount);
+                json.Field("frames", result.frames);
+                json.Field("failures", result.failures);
+                json.Field("fps", fps);
+                json.Field("scaling_efficiency", (baseFps == 0) ? 0.0 : fps / (baseFps * threadCount));
+                json.LatencyField("frame_latency", result.latency);
+                json.EndObject();
+                fprintf(stderr, "throughput: %u threads x %u handles: %.1f fps\n", threadCount, handleCount, fps);
+            }
+            for (uint32_t handle : handles) {
+                CloseEncoder(handle);
+            }
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+
+    /**
+     * 单句柄锁竞争: 模拟编码耗时为0，多个线程争用同一编码器，输出调用时延和封装层统计的锁等待
+     */
+    void RunContention(const BenchConfig &config, const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        json.BeginObject("contention");
+        json.BeginArray("runs");
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t threads = 1; threads < config.threads; threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+        threadCounts.push_back(config.threads);
+        for (uint32_t threadCount : threadCounts) {
+            uint32_t handle = 0;
+            if (!OpenEncoder(config, handle)) {
+                fprintf(stderr, "contention: open encoder failed\n");
+                break;
+            }
+            WorkloadResult result = RunWorkload({ handle }, threadCount, config.frames, frame);
+            VmiEncoderStats stats = {};
+            (void) VencGetEncoderStats(handle, &stats);
+            CloseEncoder(handle);
+            json.BeginObject();
+            json.Field("threads", threadCount);
+            json.Field("calls_per_sec", (result.elapsedNs == 0) ? 0.0 : result.frames * NS_PER_SEC / result.elapsedNs);
+            json.LatencyField("call_latency", result.latency);
+            json.Field("lock_wait_total_us", stats.lockWaitTotalUs);
+            json.Field("lock_wait_max_us", stats.lockWaitMaxUs);
+            json.Field("lock_wait_avg_us", (stats.framesEncoded == 0) ? 0.0 :
+                static_cast<double>(stats.lockWaitTotalUs) / stats.framesEncoded);
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+
+    /**
+     * 会话启动时延: 从创建编码器到第一帧编码完成的时间，模拟厂商编码器创建和初始化耗时。
+     * cold为关闭预热池且无其他编码器，每次启动都加载编解码库并创建、初始化编码器；
+     * warm_pool为开启预热池并常驻编解码库，预先放入一个相同参数的编码器，销毁的编码器放回池中
+     */
+    void RunStartup(const BenchConfig &config, const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        SetEnv("VMI_MOCK_CREATE_US", config.createUs);
+        SetEnv("VMI_MOCK_INIT_US", config.initUs);
+        VmiEncodeParams params = GetEncodeParams(config);
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        json.BeginObject("startup");
+        json.Field("create_us", config.createUs);
+        json.Field("init_us", config.initUs);
+        for (bool isWarm : { false, true }) {
+            VmiWarmPoolConfig poolConfig = {};
+            if (isWarm) {
+                poolConfig.maxIdleEncoders = WARM_POOL_SIZE;
+                poolConfig.keepLibraryResident = true;
+            }
+            if (VencConfigWarmPool(&poolConfig) != VMI_ENCODER_SUCCESS ||
+                (isWarm && VencPrewarmEncoders(0, params, 1) != VMI_ENCODER_SUCCESS)) {
+                fprintf(stderr, "startup: config warm pool failed\n");
+                break;
+            }
+            LatencySamples firstFrame;
+            uint32_t failures = 0;
+            for (uint32_t i = 0; i < config.startupIterations; ++i) {
+                uint8_t *out = nullptr;
+                uint32_t outSize = 0;
+                uint32_t handle = 0;
+                uint64_t t0 = GetMonotonicTimeNs();
+                bool isOk = OpenEncoder(config, handle) &&
+                    VencEncodeOneFrame(handle, frame.data(), inputSize, &out, &outSize) == VMI_ENCODER_SUCCESS;
+                uint64_t t1 = GetMonotonicTimeNs();
+                if (isOk) {
+                    firstFrame.Add(t1 - t0);
+                    CloseEncoder(handle);
+                } else {
+                    ++failures;
+                }
+            }
+            VmiWarmPoolStats poolStats = {};
+            (void) VencGetWarmPoolStats(&poolStats);
+            json.BeginObject(isWarm ? "warm_pool" : "cold");
+            json.Field("failures", failures);
+            json.LatencyField("time_to_first_frame", firstFrame);
+            json.Field("pool_hits", poolStats.hits);
+            json.Field("pool_misses", poolStats.misses);
+            json.Field("pool_reconfigs", poolStats.reconfigs);
+            json.EndObject();
+            fprintf(stderr, "startup: %s p50 time to first frame %.1f us\n", isWarm ? "warm pool" : "cold",
+                firstFrame.Percentile(0.50) / 1000.0);
+        }
+        VmiWarmPoolConfig disabled = {};
+        (void) VencConfigWarmPool(&disabled);
+        SetEnv("VMI_MOCK_CREATE_US", 0);
+        SetEnv("VMI_MOCK_INIT_US", 0);
+        json.EndObject();
+    }
+
+    void WriteBackendStats(JsonWriter &json, const char *name, uint32_t encType)
+    {
+        VmiEncoderBackendStats stats = {};
+        (void) VencGetEncoderBackendStats(encType, &stats);
+        json.BeginObject(name);
+        json.Field("live_sessions", stats.liveSessions);
+        json.Field("device_sessions", stats.deviceSessions);
+        json.Field("placements", stats.placements);
+        json.Field("create_failures", stats.createFailures);
+        json.Field("init_failures", stats.initFailures);
+        json.Field("fallbacks", stats.fallbacks);
+        json.Field("saturated", stats.isSaturated);
+        json.EndObject();
+    }
+
+    /**
+     * 编码器类型调度: 模拟NETINT设备只能同时承载--hw-sessions个会话，依次创建--sessions个会话。
+     * preference按NETINT h.265、NETINT h.264、OpenH264的优先顺序，硬件容量耗尽后回退到软件编码；
+     * least_loaded为NETINT h.264配置--hw-sessions、OpenH264配置--sessions的会话数上限，按负载率比例放置。
+     * 容量分别在创建和初始化时耗尽两种情况下，输出各类型的放置结果和创建时延，调度统计为进程内累计值
+     */
+    void RunScheduling(const BenchConfig &config, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        SetEnv("VMI_MOCK_NETINT_SESSIONS", config.hwSessions);
+        VmiEncodeParams params = GetEncodeParams(config);
+        json.BeginObject("scheduling");
+        json.Field("sessions", config.sessions);
+        json.Field("hw_sessions", config.hwSessions);
+        const char *names[] = { "preference_create", "preference_init", "least_loaded" };
+        for (uint32_t run = 0; run < sizeof(names) / sizeof(names[0]); ++run) {
+            bool isLeastLoaded = (run == 2);
+            SetEnv("VMI_MOCK_CAPACITY_AT_INIT", (run == 1) ? 1 : 0);
+            VmiEncoderSelectConfig selectConfig = {};
+            VmiEncoderBackendConfig hwConfig = {};
+            VmiEncoderBackendConfig swConfig = {};
+            if (isLeastLoaded) {
+                selectConfig.encTypes[0] = VMI_ENCODER_TYPE_NETINTH264;
+                selectConfig.encTypes[1] = VMI_ENCODER_TYPE_OPENH264;
+                selectConfig.typeCount = 2;
+                selectConfig.policy = VMI_ENCODER_SELECT_LEAST_LOADED;
+                hwConfig.maxSessions = config.hwSessions;
+                swConfig.maxSessions = config.sessions;
+            } else {
+                selectConfig.encTypes[0] = VMI_ENCODER_TYPE_NETINTH265;
+                selectConfig.encTypes[1] = VMI_ENCODER_TYPE_NETINTH264;
+                selectConfig.encTypes[2] = VMI_ENCODER_TYPE_OPENH264;
+                selectConfig.typeCount = 3;
+            }
+            (void) VencConfigEncoderBackend(VMI_ENCODER_TYPE_NETINTH264, &hwConfig);
+            (void) VencConfigEncoderBackend(VMI_ENCODER_TYPE_OPENH264, &swConfig);
+            LatencySamples create;
+            std::vector<uint32_t> handles;
+            uint32_t placed[VMI_ENCODER_TYPE_NETINTH265 + 1] = {};
+            uint32_t failures = 0;
+            for (uint32_t i = 0; i < config.sessions; ++i) {
+                uint32_t handle = 0;
+                uint32_t encType = 0;
+                uint64_t t0 = GetMonotonicTimeNs();
+                VmiEncoderRetCode ret = VencCreateEncoderEx(&selectConfig, params, &handle, &encType);
+                create.Add(GetMonotonicTimeNs() - t0);
+                if (ret != VMI_ENCODER_SUCCESS || encType > VMI_ENCODER_TYPE_NETINTH265) {
+                    ++failures;
+                    continue;
+                }
+                ++placed[encType];
+                handles.push_back(handle);
+            }
+            json.BeginObject(names[run]);
+            json.Field("failures", failures);
+            json.Field("placed_netint_h265", placed[VMI_ENCODER_TYPE_NETINTH265]);
+            json.Field("placed_netint_h264", placed[VMI_ENCODER_TYPE_NETINTH264]);
+            json.Field("placed_openh264", placed[VMI_ENCODER_TYPE_OPENH264]);
+            json.LatencyField("create", create);
+            WriteBackendStats(json, "netint_h265", VMI_ENCODER_TYPE_NETINTH265);
+            WriteBackendStats(json, "netint_h264", VMI_ENCODER_TYPE_NETINTH264);
+            WriteBackendStats(json, "openh264", VMI_ENCODER_TYPE_OPENH264);
+            json.EndObject();
+            fprintf(stderr, "scheduling: %s: h265 %u, h264 %u, openh264 %u, failures %u\n", names[run],
+                placed[VMI_ENCODER_TYPE_NETINTH265], placed[VMI_ENCODER_TYPE_NETINTH264],
+                placed[VMI_ENCODER_TYPE_OPENH264], failures);
+            for (uint32_t handle : handles) {
+                (void) VencDestroyEncoder(handle);
+            }
+        }
+        VmiEncoderBackendConfig unlimited = {};
+        (void) VencConfigEncoderBackend(VMI_ENCODER_TYPE_NETINTH264, &unlimited);
+        (void) VencConfigEncoderBackend(VMI_ENCODER_TYPE_OPENH264, &unlimited);
+        SetEnv("VMI_MOCK_NETINT_SESSIONS", 0);
+        SetEnv("VMI_MOCK_CAPACITY_AT_INIT", 0);
+        json.EndObject();
+    }
+
+    uint64_t GetProcessCpuTimeNs()
+    {
+        struct timespec ts = {};
+        (void) clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    // 调用者自行缩放的基线实现: 逐像素16.16定点双线性插值，不做预缩小
+    void ScalePlaneBilinear(const uint8_t *src, uint32_t srcWidth, uint32_t srcHeight, uint8_t *dst,
+        uint32_t dstWidth, uint32_t dstHeight)
+    {
+        constexpr uint32_t shift = 16;
+        constexpr uint32_t one = 1U << shift;
+        uint64_t xStep = (static_cast<uint64_t>(srcWidth - 1) << shift) / std::max(1U, dstWidth - 1);
+        uint64_t yStep = (static_cast<uint64_t>(srcHeight - 1) << shift) / std::max(1U, dstHeight - 1);
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            uint64_t fy = y * yStep;
+            auto y0 = static_cast<uint32_t>(fy >> shift);
+            uint32_t y1 = std::min(y0 + 1, srcHeight - 1);
+            uint64_t wy = fy & (one - 1);
+            for (uint32_t x = 0; x < dstWidth; ++x) {
+                uint64_t fx = x * xStep;
+                auto x0 = static_cast<uint32_t>(fx >> shift);
+                uint32_t x1 = std::min(x0 + 1, srcWidth - 1);
+                uint64_t wx = fx & (one - 1);
+                uint64_t top = src[y0 * srcWidth + x0] * (one - wx) + src[y0 * srcWidth + x1] * wx;
+                uint64_t bottom = src[y1 * srcWidth + x0] * (one - wx) + src[y1 * srcWidth + x1] * wx;
+                dst[y * dstWidth + x] = static_cast<uint8_t>((top * (one - wy) + bottom * wy) >> (2 * shift));
+            }
+        }
+    }
+
+    void ScaleI420Bilinear(const uint8_t *src, uint32_t srcWidth, uint32_t srcHeight, uint8_t *dst,
+        uint32_t dstWidth, uint32_t dstHeight)
+    {
+        ScalePlaneBilinear(src, srcWidth, srcHeight, dst, dstWidth, dstHeight);
+        const uint8_t *srcChroma = src + srcWidth * srcHeight;
+        uint8_t *dstChroma = dst + dstWidth * dstHeight;
+        uint32_t srcChromaSize = ((srcWidth + 1) / 2) * ((srcHeight + 1) / 2);
+        uint32_t dstChromaSize = ((dstWidth + 1) / 2) * ((dstHeight + 1) / 2);
+        for (uint32_t plane = 0; plane < 2; ++plane) {
+            ScalePlaneBilinear(srcChroma + plane * srcChromaSize, (srcWidth + 1) / 2, (srcHeight + 1) / 2,
+                dstChroma + plane * dstChromaSize, (dstWidth + 1) / 2, (dstHeight + 1) / 2);
+        }
+    }
+
+    void WriteSimulcastResult(JsonWriter &json, const char *name, uint32_t failures, LatencySamples &wall,
+        uint64_t cpuNs, uint32_t frames)
+    {
+        json.BeginObject(name);
+        json.Field("failures", failures);
+        json.LatencyField("frame", wall);
+        json.Field("cpu_us_per_frame", static_cast<double>(cpuNs) / frames / 1000.0);
+        json.EndObject();
+        fprintf(stderr, "simulcast: %s p50 %.1f us per frame, cpu %.1f us per frame\n", name,
+            wall.Percentile(0.50) / 1000.0, static_cast<double>(cpuNs) / frames / 1000.0);
+    }
+
+    /**
+     * 联播: 1080p输入编码为1080p、720p、360p三层。independent为调用者为每层创建独立句柄，
+     * 用标量双线性插值自行缩放后依次编码；simulcast为联播组，SIMD缩放到池化缓冲区并各层并行编码。
+     * 模拟硬件编码器编码一帧睡眠--encode-us(--spin时忙等)，输出每帧墙钟时延和进程CPU时间
+     */
+    void RunSimulcast(const BenchConfig &config, JsonWriter &json)
+    {
+        constexpr uint32_t width = 1920;
+        constexpr uint32_t height = 1080;
+        const uint32_t layerSizes[][2] = { { 1920, 1080 }, { 1280, 720 }, { 640, 360 } };
+        const uint32_t layerBitrates[] = { 4000000, 2000000, 600000 };
+        ConfigMock(config.encodeUs, config.isSpin);
+        VmiSimulcastConfig groupConfig = {};
+        groupConfig.inputWidth = width;
+        groupConfig.inputHeight = height;
+        groupConfig.layerCount = sizeof(layerBitrates) / sizeof(layerBitrates[0]);
+        for (uint32_t i = 0; i < groupConfig.layerCount; ++i) {
+            groupConfig.layers[i].width = layerSizes[i][0];
+            groupConfig.layers[i].height = layerSizes[i][1];
+            groupConfig.layers[i].frameRate = FRAME_RATE_DEFAULT;
+            groupConfig.layers[i].bitrate = layerBitrates[i];
+        }
+        std::vector<uint8_t> frame(width * height * 3 / 2);
+        for (size_t i = 0; i < frame.size(); ++i) {
+            frame[i] = static_cast<uint8_t>(i * 7 + i / width);
+        }
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        json.BeginObject("simulcast");
+        json.Field("encode_us", config.encodeUs);
+        json.Field("layers", groupConfig.layerCount);
+
+        std::vector<uint32_t> handles;
+        std::vector<std::vector<uint8_t>> scaled;
+        for (uint32_t i = 0; i < groupConfig.layerCount; ++i) {
+            BenchConfig layerConfig = config;
+            layerConfig.width = layerSizes[i][0];
+            layerConfig.height = layerSizes[i][1];
+            uint32_t handle = 0;
+            if (OpenEncoder(layerConfig, handle)) {
+                handles.push_back(handle);
+                scaled.emplace_back(layerConfig.width * layerConfig.height * 3 / 2);
+            }
+        }
+        LatencySamples independent;
+        uint32_t failures = (handles.size() == groupConfig.layerCount) ? 0 : 1;
+        uint64_t cpu0 = GetProcessCpuTimeNs();
+        for (uint32_t n = 0; n < SIMULCAST_FRAMES && failures == 0; ++n) {
+            uint64_t t0 = GetMonotonicTimeNs();
+            for (size_t i = 0; i < handles.size(); ++i) {
+                const uint8_t *input = frame.data();
+                uint32_t size = inputSize;
+                if (layerSizes[i][0] != width || layerSizes[i][1] != height) {
+                    ScaleI420Bilinear(frame.data(), width, height, scaled[i].data(), layerSizes[i][0],
+                        layerSizes[i][1]);
+                    input = scaled[i].data();
+                    size = static_cast<uint32_t>(scaled[i].size());
+                }
+                uint8_t *out = nullptr;
+                uint32_t outSize = 0;
+                failures += (VencEncodeOneFrame(handles[i], input, size, &out, &outSize) == VMI_ENCODER_SUCCESS) ?
+                    0 : 1;
+            }
+            independent.Add(GetMonotonicTimeNs() - t0);
+        }
+        WriteSimulcastResult(json, "independent", failures, independent, GetProcessCpuTimeNs() - cpu0,
+            SIMULCAST_FRAMES);
+        for (uint32_t handle : handles) {
+            CloseEncoder(handle);
+        }
+
+        uint32_t groupHandle = 0;
+        LatencySamples grouped;
+        failures = (VencCreateSimulcastGroup(&groupConfig, &groupHandle) == VMI_ENCODER_SUCCESS) ? 0 : 1;
+        cpu0 = GetProcessCpuTimeNs();
+        for (uint32_t n = 0; n < SIMULCAST_FRAMES && failures == 0; ++n) {
+            VmiSimulcastLayerOutput outputs[VMI_SIMULCAST_LAYER_MAX];
+            uint64_t t0 = GetMonotonicTimeNs();
+            failures += (VencEncodeSimulcastFrame(groupHandle, frame.data(), inputSize, outputs,
+                VMI_SIMULCAST_LAYER_MAX) == VMI_ENCODER_SUCCESS) ? 0 : 1;
+            grouped.Add(GetMonotonicTimeNs() - t0);
+        }
+        WriteSimulcastResult(json, "simulcast", failures, grouped, GetProcessCpuTimeNs() - cpu0, SIMULCAST_FRAMES);
+        (void) VencDestroySimulcastGroup(groupHandle);
+        json.EndObject();
+    }
+    // 异步编码会话: 帧序号从0开始连续分配，提交时间按帧序号记录，回调在同一会话内串行执行
+    struct AsyncSession {
+        uint32_t handle = 0;
+        std::vector<uint64_t> submitNs = {};
+        uint32_t submitted = 0;
+        uint32_t rejected = 0;
+        uint32_t failures = 0;
+        LatencySamples latency;
+    };
+
+    void OnAsyncOutput(uint32_t encHandle, const VmiEncodeOutput *output, void *userData)
+    {
+        (void) encHandle;
+        auto session = static_cast<AsyncSession *>(userData);
+        if (output->result != VMI_ENCODER_SUCCESS || output->frameSeq >= session->submitNs.size()) {
+            ++session->failures;
+            return;
+        }
+        session->latency.Add(GetMonotonicTimeNs() - session->submitNs[output->frameSeq]);
+    }
+
+    // 各会话按30帧/秒节拍提交，会话之间的提交时刻在一帧间隔内均匀错开
+    void ProduceFrames(std::vector<AsyncSession> &sessions, uint32_t frames, const std::vector<uint8_t> &frame)
+    {
+        const uint64_t intervalNs = static_cast<uint64_t>(NS_PER_SEC) / FRAME_RATE_DEFAULT;
+        const uint64_t startNs = GetMonotonicTimeNs();
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        for (uint32_t n = 0; n < frames; ++n) {
+            for (size_t i = 0; i < sessions.size(); ++i) {
+                uint64_t dueNs = startNs + n * intervalNs + i * intervalNs / sessions.size();
+                uint64_t nowNs = GetMonotonicTimeNs();
+                if (dueNs > nowNs) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - nowNs));
+                }
+                AsyncSession &session = sessions[i];
+                session.submitNs[session.submitted] = GetMonotonicTimeNs();
+                if (VencSubmitFrame(session.handle, frame.data(), inputSize, 0, nullptr) == VMI_ENCODER_SUCCESS) {
+                    ++session.submitted;
+                } else {
+                    ++session.rejected;
+                }
+            }
+        }
+    }
+
+    void RunExecutorMode(const BenchConfig &config, bool useSharedExecutor, const std::vector<uint8_t> &frame,
+        JsonWriter &json)
+    {
+        const char *name = useSharedExecutor ? "shared_executor" : "thread_per_session";
+        BenchConfig sessionConfig = config;
+        sessionConfig.width = EXECUTOR_WIDTH;
+        sessionConfig.height = EXECUTOR_HEIGHT;
+        std::vector<AsyncSession> sessions(config.executorSessions);
+        uint32_t opened = 0;
+        for (AsyncSession &session : sessions) {
+            session.submitNs.resize(config.executorFrames);
+            session.latency.Reserve(config.executorFrames);
+            if (!OpenEncoder(sessionConfig, session.handle)) {
+                break;
+            }
+            VmiAsyncEncodeConfig asyncConfig = {};
+            asyncConfig.queueDepth = EXECUTOR_QUEUE_DEPTH;
+            asyncConfig.callback = OnAsyncOutput;
+            asyncConfig.userData = &session;
+            asyncConfig.useSharedExecutor = useSharedExecutor;
+            if (VencEnableAsyncEncode(session.handle, &asyncConfig) != VMI_ENCODER_SUCCESS) {
+                CloseEncoder(session.handle);
+                break;
+            }
+            ++opened;
+        }
+        json.BeginObject(name);
+        if (opened != sessions.size()) {
+            fprintf(stderr, "executor: %s open session %u failed\n", name, opened);
+            json.Field("failures", static_cast<uint32_t>(sessions.size()));
+            sessions.resize(opened);
+        } else {
+            uint64_t cpu0 = GetProcessCpuTimeNs();
+            uint64_t t0 = GetMonotonicTimeNs();
+            ProduceFrames(sessions, config.executorFrames, frame);
+            for (AsyncSession &session : sessions) {
+                (void) VencFlushEncoder(session.handle);
+            }
+            uint64_t elapsedNs = GetMonotonicTimeNs() - t0;
+            uint64_t cpuNs = GetProcessCpuTimeNs() - cpu0;
+
+            LatencySamples latency;
+            uint32_t rejected = 0;
+            uint32_t failures = 0;
+            uint64_t deadlineMisses = 0;
+            uint64_t minEncoded = UINT64_MAX;
+            uint64_t maxEncoded = 0;
+            uint64_t minWaitUs = UINT64_MAX;
+            uint64_t maxWaitUs = 0;
+            double sum = 0;
+            double sumSquares = 0;
+            for (AsyncSession &session : sessions) {
+                VmiAsyncEncodeStats stats = {};
+                (void) VencGetAsyncEncodeStats(session.handle, &stats);
+                latency.Append(session.latency);
+                rejected += session.rejected;
+                failures += session.failures;
+                deadlineMisses += stats.deadlineMisses;
+                minEncoded = std::min(minEncoded, stats.encodedFrames);
+                maxEncoded = std::max(maxEncoded, stats.encodedFrames);
+                minWaitUs = std::min(minWaitUs, stats.queueWaitAvgUs);
+                maxWaitUs = std::max(maxWaitUs, stats.queueWaitAvgUs);
+                sum += static_cast<double>(stats.encodedFrames);
+                sumSquares += static_cast<double>(stats.encodedFrames) * stats.encodedFrames;
+            }
+            // Jain公平性指数: 各会话编码帧数相同时为1，越小越不公平
+            double fairness = (sumSquares == 0) ? 0 : sum * sum / (sessions.size() * sumSquares);
+            double fps = (elapsedNs == 0) ? 0 : latency.Count() * NS_PER_SEC / elapsedNs;
+            json.Field("failures", failures);
+            json.Field("rejected", rejected);
+            json.Field("fps", fps);
+            json.Field("cpu_us_per_frame", (latency.Count() == 0) ? 0.0 :
+                static_cast<double>(cpuNs) / latency.Count() / 1000.0);
+            json.LatencyField("submit_to_output", latency);
+            json.Field("deadline_misses", deadlineMisses);
+            json.Field("fairness_index", fairness);
+            json.Field("session_encoded_min", minEncoded);
+            json.Field("session_encoded_max", maxEncoded);
+            json.Field("session_queue_wait_avg_us_min", minWaitUs);
+            json.Field("session_queue_wait_avg_us_max", maxWaitUs);
+            if (useSharedExecutor) {
+                VmiEncodeExecutorStats executorStats = {};
+                (void) VencGetEncodeExecutorStats(&executorStats);
+                json.Field("executor_threads", executorStats.threadCount);
+                json.Field("tasks_executed", executorStats.tasksExecuted);
+                json.Field("steals", executorStats.steals);
+            }
+            fprintf(stderr, "executor: %s %.1f fps, p50 %.1f us, p99 %.1f us, %" PRIu64 " deadline misses, "
+                "fairness %.3f\n", name, fps, latency.Percentile(0.50) / 1000.0, latency.Percentile(0.99) / 1000.0,
+                deadlineMisses, fairness);
+        }
+        json.EndObject();
+        for (AsyncSession &session : sessions) {
+            (void) VencDisableAsyncEncode(session.handle);
+            CloseEncoder(session.handle);
+        }
+    }
+
+    /**
+     * 多会话负载: --executor-sessions个会话各以30帧/秒异步提交--executor-frames帧，对比每会话专属编码线程与
+     * 共享执行器(--executor-threads、--affinity)的吞吐、提交到回调的时延分布、超时帧数和会话间公平性。
+     * 建议配合--spin使用，模拟软件编码占用CPU时线程数多于CPU数的调度开销
+     */
+    void RunExecutor(const BenchConfig &config, JsonWriter &json)
+    {
+        ConfigMock(config.encodeUs, config.isSpin);
+        std::vector<uint8_t> frame(EXECUTOR_WIDTH * EXECUTOR_HEIGHT * 3 / 2, 0x80);
+        json.BeginObject("executor");
+        json.Field("encode_us", config.encodeUs);
+        json.Field("spin", config.isSpin);
+        json.Field("sessions", config.executorSessions);
+        json.Field("frames_per_session", config.executorFrames);
+        json.Field("affinity", config.executor.affinity);
+        RunExecutorMode(config, false, frame, json);
+        if (VencConfigEncodeExecutor(&config.executor) != VMI_ENCODER_SUCCESS) {
+            fprintf(stderr, "executor: config shared executor failed\n");
+        } else {
+            RunExecutorMode(config, true, frame, json);
+        }
+        json.EndObject();
+    }
+
+    // 过载会话: captureNs按帧序号记录采集时刻，即该帧按30帧/秒节拍应被采集的时间，提交阻塞的时间也计入时延
+    struct OverloadSession {
+        std::vector<uint64_t> captureNs = {};
+        uint32_t submitted = 0;
+        uint32_t rejected = 0;
+        uint32_t dropped = 0;
+        uint32_t failures = 0;
+        LatencySamples latency;
+    };
+
+    void OnOverloadOutput(uint32_t encHandle, const VmiEncodeOutput *output, void *userData)
+    {
+        (void) encHandle;
+        auto session = static_cast<OverloadSession *>(userData);
+        if (output->result == VMI_ENCODER_FRAME_DROPPED) {
+            ++session->dropped;
+            return;
+        }
+        if (output->result != VMI_ENCODER_SUCCESS || output->frameSeq >= session->captureNs.size()) {
+            ++session->failures;
+            return;
+        }
+        session->latency.Add(GetMonotonicTimeNs() - session->captureNs[output->frameSeq]);
+    }
+
+    void RunOverloadMode(const BenchConfig &config, const char *name, const VmiAsyncEncodeConfig &baseConfig,
+        const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        BenchConfig sessionConfig = config;
+        sessionConfig.width = EXECUTOR_WIDTH;
+        sessionConfig.height = EXECUTOR_HEIGHT;
+        OverloadSession session;
+        session.captureNs.resize(config.overloadFrames);
+        session.latency.Reserve(config.overloadFrames);
+        uint32_t handle = 0;
+        if (!OpenEncoder(sessionConfig, handle)) {
+            fprintf(stderr, "overload: %s open encoder failed\n", name);
+            return;
+        }
+        VmiAsyncEncodeConfig asyncConfig = baseConfig;
+        asyncConfig.callback = OnOverloadOutput;
+        asyncConfig.userData = &session;
+        if (VencEnableAsyncEncode(handle, &asyncConfig) != VMI_ENCODER_SUCCESS) {
+            fprintf(stderr, "overload: %s enable async encode failed\n", name);
+            CloseEncoder(handle);
+            return;
+        }
+        const uint64_t intervalNs = static_cast<uint64_t>(NS_PER_SEC) / FRAME_RATE_DEFAULT;
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        uint64_t startNs = GetMonotonicTimeNs();
+        for (uint32_t n = 0; n < config.overloadFrames; ++n) {
+            uint64_t dueNs = startNs + n * intervalNs;
+            uint64_t nowNs = GetMonotonicTimeNs();
+            if (dueNs > nowNs) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - nowNs));
+            }
+            // 阻塞策略下提交可能晚于采集时刻，采集时刻仍按节拍计算
+            session.captureNs[session.submitted] = dueNs;
+            VmiEncoderRetCode ret = VencSubmitFrame(handle, frame.data(), inputSize, -1, nullptr);
+            if (ret == VMI_ENCODER_SUCCESS) {
+                ++session.submitted;
+            } else {
+                ++session.rejected;
+            }
+        }
+        (void) VencFlushEncoder(handle);
+        uint64_t elapsedNs = GetMonotonicTimeNs() - startNs;
+        VmiAsyncEncodeStats stats = {};
+        (void) VencGetAsyncEncodeStats(handle, &stats);
+        (void) VencDisableAsyncEncode(handle);
+        CloseEncoder(handle);
+
+        double fps = (elapsedNs == 0) ? 0 : session.latency.Count() * NS_PER_SEC / elapsedNs;
+        json.BeginObject(name);
+        json.Field("failures", session.failures);
+        json.Field("encoded", static_cast<uint64_t>(session.latency.Count()));
+        json.Field("fps", fps);
+        json.LatencyField("capture_to_output", session.latency);
+        json.Field("dropped", session.dropped);
+        json.Field("replaced", stats.replacedFrames);
+        json.Field("late_dropped", stats.lateDroppedFrames);
+        json.Field("decimated", stats.decimatedFrames);
+        json.Field("decimation", stats.decimation);
+        json.Field("deadline_misses", stats.deadlineMisses);
+        json.Field("encode_time_us", stats.encodeTimeUs);
+        json.EndObject();
+        fprintf(stderr, "overload: %s encoded %zu (%.1f fps), p50 %.1f ms, max %.1f ms, dropped %u, decimated %"
+            PRIu64 ", late %" PRIu64 "\n", name, session.latency.Count(), fps, session.latency.Percentile(0.50) / 1e6,
+            session.latency.Percentile(1.0) / 1e6, session.dropped, stats.decimatedFrames, stats.deadlineMisses);
+    }
+
+    /**
+     * 过载: 模拟编码一帧耗时--overload-encode-us，慢于30帧/秒的采集节拍，按节拍提交--overload-frames帧，
+     * 对比block(队列深度4，提交阻塞)、deadline(block加超时丢帧)、latest_wins(只保留最新一帧)、
+     * adaptive(latest_wins加自适应抽帧)的采集到输出时延、编码帧率和丢帧数
+     */
+    void RunOverload(const BenchConfig &config, JsonWriter &json)
+    {
+        ConfigMock(config.overloadEncodeUs, false);
+        std::vector<uint8_t> frame(EXECUTOR_WIDTH * EXECUTOR_HEIGHT * 3 / 2, 0x80);
+        json.BeginObject("overload");
+        json.Field("encode_us", config.overloadEncodeUs);
+        json.Field("frames", config.overloadFrames);
+        VmiAsyncEncodeConfig block = {};
+        block.queueDepth = EXECUTOR_QUEUE_DEPTH;
+        RunOverloadMode(config, "block", block, frame, json);
+        VmiAsyncEncodeConfig deadline = block;
+        deadline.dropLateFrames = true;
+        RunOverloadMode(config, "deadline", deadline, frame, json);
+        VmiAsyncEncodeConfig latestWins = {};
+        latestWins.overloadPolicy = VMI_OVERLOAD_LATEST_WINS;
+        RunOverloadMode(config, "latest_wins", latestWins, frame, json);
+        VmiAsyncEncodeConfig adaptive = latestWins;
+        adaptive.adaptiveFrameRate = true;
+        RunOverloadMode(config, "adaptive", adaptive, frame, json);
+        json.EndObject();
+    }
+
+    // 调用者自行扫描码流的基线实现: 逐字节查找起始码，NAL单元大小的计算方式与封装层一致
+    uint32_t ScanNalUnits(const uint8_t *data, uint32_t size, VmiNalUnit *units, uint32_t maxUnits)
+    {
+        constexpr uint8_t h264TypeMask = 0x1f;
+        uint32_t count = 0;
+        for (uint32_t i = 0; i + 2 < size; ++i) {
+            if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) {
+                continue;
+            }
+            if (count > 0 && count <= maxUnits) {
+                VmiNalUnit &last = units[count - 1];
+                uint32_t end = i;
+                while (end > last.offset + 1 && data[end - 1] == 0) {
+                    --end;
+                }
+                last.size = end - last.offset;
+            }
+            if (count < maxUnits && i + 3 < size) {
+                units[count].offset = i + 3;
+                units[count].size = size - (i + 3);
+                units[count].type = data[i + 3] & h264TypeMask;
+            }
+            ++count;
+            i += 2;
+        }
+        return count;
+    }
+
+    /**
+     * NAL单元索引: 模拟编码耗时为0，非关键帧输出--nal-output-size字节。rescan为VencEncodeOneFrame后调用者
+     * 逐字节扫描起始码，indexed为VencEncodeOneFrameEx直接返回NAL单元索引，两者逐帧比较索引是否一致；
+     * 并检查首个关键帧后VencGetParameterSets返回的参数集与码流中的SPS/PPS一致
+     */
+    void RunNalIndex(const BenchConfig &config, const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        SetEnv("VMI_MOCK_OUTPUT_SIZE", config.nalOutputSize);
+        uint32_t rescanHandle = 0;
+        uint32_t indexedHandle = 0;
+        if (!OpenEncoder(config, rescanHandle)) {
+            fprintf(stderr, "nal: open encoder failed\n");
+            SetEnv("VMI_MOCK_OUTPUT_SIZE", 0);
+            return;
+        }
+        if (!OpenEncoder(config, indexedHandle)) {
+            fprintf(stderr, "nal: open encoder failed\n");
+            CloseEncoder(rescanHandle);
+            SetEnv("VMI_MOCK_OUTPUT_SIZE", 0);
+            return;
+        }
+        LatencySamples rescan;
+        LatencySamples indexed;
+        rescan.Reserve(config.frames);
+        indexed.Reserve(config.frames);
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        uint32_t mismatches = 0;
+        uint32_t keyFrames = 0;
+        bool isParameterSetsMatched = false;
+        VmiNalUnit scanned[VMI_NAL_UNIT_MAX];
+        VmiEncodeFrameInfo info;
+        for (uint32_t i = 0; i < config.frames; ++i) {
+            uint8_t *out = nullptr;
+            uint32_t outSize = 0;
+            uint64_t t0 = GetMonotonicTimeNs();
+            (void) VencEncodeOneFrame(rescanHandle, frame.data(), inputSize, &out, &outSize);
+            uint32_t count = ScanNalUnits(out, outSize, scanned, VMI_NAL_UNIT_MAX);
+            uint64_t t1 = GetMonotonicTimeNs();
+            rescan.Add(t1 - t0);
+
+            uint8_t *indexedOut = nullptr;
+            uint32_t indexedSize = 0;
+            t0 = GetMonotonicTimeNs();
+            (void) VencEncodeOneFrameEx(indexedHandle, frame.data(), inputSize, &indexedOut, &indexedSize, &info);
+            indexed.Add(GetMonotonicTimeNs() - t0);
+
+            bool isSame = (info.nalTotal == count) && (indexedSize == outSize);
+            for (uint32_t n = 0; isSame && n < info.nalCount; ++n) {
+                isSame = scanned[n].offset == info.nals[n].offset && scanned[n].size == info.nals[n].size &&
+                    scanned[n].type == info.nals[n].type;
+            }
+            mismatches += isSame ? 0 : 1;
+            keyFrames += info.isKeyFrame ? 1 : 0;
+            if (i == 0 && info.hasParameterSets) {
+                // 期望的参数集: 首帧中h.264 SPS(7)/PPS(8)各自加4字节起始码后依次拼接
+                constexpr uint32_t h264Sps = 7;
+                constexpr uint32_t h264Pps = 8;
+                std::vector<uint8_t> expected;
+                for (uint32_t n = 0; n < info.nalCount; ++n) {
+                    if (info.nals[n].type == h264Sps || info.nals[n].type == h264Pps) {
+                        expected.insert(expected.end(), { 0x00, 0x00, 0x00, 0x01 });
+                        expected.insert(expected.end(), indexedOut + info.nals[n].offset,
+                            indexedOut + info.nals[n].offset + info.nals[n].size);
+                    }
+                }
+                std::vector<uint8_t> cached(expected.size());
+                uint32_t cachedSize = 0;
+                isParameterSetsMatched = VencGetParameterSets(indexedHandle, cached.data(),
+                    static_cast<uint32_t>(cached.size()), &cachedSize) == VMI_ENCODER_SUCCESS &&
+                    cachedSize == expected.size() && cached == expected;
+            }
+        }
+        CloseEncoder(rescanHandle);
+        CloseEncoder(indexedHandle);
+        SetEnv("VMI_MOCK_OUTPUT_SIZE", 0);
+
+        json.BeginObject("nal");
+        json.Field("output_size", config.nalOutputSize);
+        json.Field("mismatches", mismatches);
+        json.Field("key_frames", keyFrames);
+        json.Field("parameter_sets_matched", isParameterSetsMatched);
+        json.LatencyField("rescan", rescan);
+        json.LatencyField("indexed", indexed);
+        json.EndObject();
+        fprintf(stderr, "nal: rescan p50 %.2f us, indexed p50 %.2f us, %u mismatches, parameter sets %s\n",
+            rescan.Percentile(0.50) / 1000.0, indexed.Percentile(0.50) / 1000.0, mismatches,
+            isParameterSetsMatched ? "matched" : "mismatched");
+    }
+
+    // 抓取用的输入序列: 在上一帧基础上改写一个随帧号移动的亮度块，模拟大部分区域静止的桌面内容
+    void UpdateCaptureFrame(const BenchConfig &config, uint32_t index, std::vector<uint8_t> &frame)
+    {
+        uint32_t blocksPerRow = std::max(1U, config.width / CAPTURE_BLOCK_SIZE);
+        uint32_t blockRows = std::max(1U, config.height / CAPTURE_BLOCK_SIZE);
+        uint32_t x = (index % blocksPerRow) * CAPTURE_BLOCK_SIZE;
+        uint32_t y = (index / blocksPerRow % blockRows) * CAPTURE_BLOCK_SIZE;
+        for (uint32_t row = y; row < std::min(y + CAPTURE_BLOCK_SIZE, config.height); ++row) {
+            uint32_t len = std::min(CAPTURE_BLOCK_SIZE, config.width - x);
+            (void) memset(frame.data() + static_cast<size_t>(row) * config.width + x, static_cast<int>(index), len);
+        }
+    }
+
+    /**
+     * 会话抓取: 模拟编码耗时为0，plain与capture两个句柄交替编码相同的输入序列，capture句柄开启抓取，
+     * 比较每帧调用时延得到抓取开销，并统计抓取文件中每帧占用的字节数；之后读取抓取文件逐帧还原，
+     * 与重新生成的输入序列比较，验证差分编码可无损还原
+     */
+    void RunCapture(const BenchConfig &config, JsonWriter &json)
+    {
+        ConfigMock(0, false);
+        uint32_t plainHandle = 0;
+        uint32_t captureHandle = 0;
+        if (!OpenEncoder(config, plainHandle)) {
+            fprintf(stderr, "capture: open encoder failed\n");
+            return;
+        }
+        VmiCaptureConfig captureConfig = {};
+        captureConfig.path = config.capturePath.c_str();
+        if (!OpenEncoder(config, captureHandle) ||
+            VencStartCapture(captureHandle, &captureConfig) != VMI_ENCODER_SUCCESS) {
+            fprintf(stderr, "capture: start capture to %s failed\n", config.capturePath.c_str());
+            CloseEncoder(plainHandle);
+            if (captureHandle != 0) {
+                CloseEncoder(captureHandle);
+            }
+            return;
+        }
+        LatencySamples plain;
+        LatencySamples captured;
+        plain.Reserve(config.frames);
+        captured.Reserve(config.frames);
+        std::vector<uint8_t> frame(config.width * config.height * 3 / 2, 0x80);
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        for (uint32_t i = 0; i < config.frames; ++i) {
+            UpdateCaptureFrame(config, i, frame);
+            uint8_t *out = nullptr;
+            uint32_t outSize = 0;
+            uint64_t t0 = GetMonotonicTimeNs();
+            (void) VencEncodeOneFrame(plainHandle, frame.data(), inputSize, &out, &outSize);
+            uint64_t t1 = GetMonotonicTimeNs();
+            (void) VencEncodeOneFrame(captureHandle, frame.data(), inputSize, &out, &outSize);
+            captured.Add(GetMonotonicTimeNs() - t1);
+            plain.Add(t1 - t0);
+        }
+        VmiCaptureStats stats = {};
+        (void) VencGetCaptureStats(captureHandle, &stats);
+        (void) VencStopCapture(captureHandle);
+        CloseEncoder(plainHandle);
+        CloseEncoder(captureHandle);
+
+        // 逐帧还原并与重新生成的输入序列比较
+        uint32_t decodedFrames = 0;
+        uint32_t mismatches = 0;
+        VideoEncoderCaptureReader reader;
+        if (reader.Open(config.capturePath)) {
+            std::vector<uint8_t> expected(frame.size(), 0x80);
+            std::vector<uint8_t> decoded;
+            VideoEncoderCaptureReader::Record record;
+            while (reader.Next(record)) {
+                if (record.type != CAPTURE_RECORD_FRAME) {
+                    continue;
+                }
+                UpdateCaptureFrame(config, decodedFrames++, expected);
+                bool isSame = VideoEncoderCaptureReader::DecodeFrame(record, decoded) && decoded == expected;
+                mismatches += isSame ? 0 : 1;
+            }
+        }
+        double bytesPerFrame = (stats.frames == 0) ? 0.0 : static_cast<double>(stats.fileBytes) / stats.frames;
+
+        json.BeginObject("capture");
+        json.Field("frames", stats.frames);
+        json.Field("dropped_frames", stats.droppedFrames);
+        json.Field("raw_bytes_per_frame", inputSize);
+        json.Field("file_bytes_per_frame", bytesPerFrame);
+        json.Field("decoded_frames", decodedFrames);
+        json.Field("mismatches", mismatches);
+        json.LatencyField("plain", plain);
+        json.LatencyField("captured", captured);
+        json.EndObject();
+        fprintf(stderr, "capture: plain p50 %.2f us, captured p50 %.2f us, %.0f of %u bytes per frame, "
+            "%u mismatches\n", plain.Percentile(0.50) / 1000.0, captured.Percentile(0.50) / 1000.0, bytesPerFrame,
+            inputSize, mismatches);
+    }
+
+    // 统计导出文件中的完整事件数
+    uint64_t CountTraceEvents(const std::string &path)
+    {
+        FILE *file = fopen(path.c_str(), "r");
+        if (file == nullptr) {
+            return 0;
+        }
+        uint64_t count = 0;
+        char line[512];
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            count += (strstr(line, "\"ph\":\"X\"") != nullptr) ? 1 : 0;
+        }
+        (void) fclose(file);
+        return count;
+    }
+
+    /**
+     * 逐帧追踪: 模拟编码耗时为0，FRAME_TRACE_THREADS个线程各用一个句柄编码，分别在关闭和开启追踪时测量
+     * 单帧调用时延，开启时每帧记录frame/lookup/lock_wait/encode四个阶段；之后导出Chrome trace JSON并
+     * 检查事件数与记录数一致
+     */
+    void RunFrameTrace(const BenchConfig &config, const std::vector<uint8_t> &frame, JsonWriter &json)
+    {
+        constexpr uint32_t stagesPerFrame = 4;
+        ConfigMock(0, false);
+        std::vector<uint32_t> handles(FRAME_TRACE_THREADS, 0);
+        for (uint32_t &handle : handles) {
+            if (!OpenEncoder(config, handle)) {
+                fprintf(stderr, "trace: open encoder failed\n");
+                for (uint32_t opened : handles) {
+                    if (opened != 0) {
+                        CloseEncoder(opened);
+                    }
+                }
+                return;
+            }
+        }
+        auto inputSize = static_cast<uint32_t>(frame.size());
+        auto runFrames = [&config, &frame, &handles, inputSize](LatencySamples &samples) {
+            std::vector<LatencySamples> perThread(handles.size());
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < handles.size(); ++t) {
+                threads.emplace_back([&config, &frame, &handles, &perThread, inputSize, t] {
+                    perThread[t].Reserve(config.frames);
+                    for (uint32_t i = 0; i < config.frames; ++i) {
+                        uint8_t *out = nullptr;
+                        uint32_t outSize = 0;
+                        uint64_t t0 = GetMonotonicTimeNs();
+                        (void) VencEncodeOneFrame(handles[t], frame.data(), inputSize, &out, &outSize);
+                        perThread[t].Add(GetMonotonicTimeNs() - t0);
+                    }
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+            for (auto &threadSamples : perThread) {
+                samples.Append(threadSamples);
+            }
+        };
+        LatencySamples disabled;
+        LatencySamples enabled;
+        (void) VencDisableFrameTrace();
+        runFrames(disabled);
+        VmiFrameTraceConfig traceConfig = {};
+        traceConfig.eventsPerThread = config.frames * stagesPerFrame;  // 容纳全部事件，导出数应等于预期数
+        bool isEnabled = VencEnableFrameTrace(&traceConfig) == VMI_ENCODER_SUCCESS;
+        runFrames(enabled);
+        (void) VencDisableFrameTrace();
+        for (uint32_t handle : handles) {
+            CloseEncoder(handle);
+        }
+        VmiFrameTraceStats stats = {};
+        (void) VencGetFrameTraceStats(&stats);
+        uint64_t exportStartNs = GetMonotonicTimeNs();
+        bool isExported = isEnabled && VencExportFrameTrace(config.frameTracePath.c_str()) == VMI_ENCODER_SUCCESS;
+        uint64_t exportNs = GetMonotonicTimeNs() - exportStartNs;
+        uint64_t exportedEvents = isExported ? CountTraceEvents(config.frameTracePath) : 0;
+        uint64_t expectedEvents = static_cast<uint64_t>(config.frames) * FRAME_TRACE_THREADS * stagesPerFrame;
+
+        json.BeginObject("trace");
+        json.Field("threads", FRAME_TRACE_THREADS);
+        json.Field("recorded_events", stats.recordedEvents);
+        json.Field("overwritten_events", stats.overwrittenEvents);
+        json.Field("exported_events", exportedEvents);
+        json.Field("expected_events", expectedEvents);
+        json.Field("export_ms", exportNs / 1e6);
+        json.LatencyField("disabled", disabled);
+        json.LatencyField("enabled", enabled);
+        json.EndObject();
+        fprintf(stderr, "trace: disabled p50 %.2f us, enabled p50 %.2f us, exported %" PRIu64 " of %" PRIu64
+            " events\n", disabled.Percentile(0.50) / 1000.0, enabled.Percentile(0.50) / 1000.0, exportedEvents,
+            expectedEvents);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Args args(argc, argv);
+    BenchConfig config;
+    config.width = args.GetU32("width", WIDTH_DEFAULT);
+    config.height = args.GetU32("height", HEIGHT_DEFAULT);
+    config.frames = args.GetU32("frames", FRAMES_DEFAULT);
+    config.throughputFrames = args.GetU32("throughput-frames", THROUGHPUT_FRAMES_DEFAULT);
+    config.iterations = args.GetU32("iterations", ITERATIONS_DEFAULT);
+    config.threads = std::max(1U, args.GetU32("threads", THREADS_DEFAULT));
+    config.handles = args.GetU32("handles", 0);
+    config.encodeUs = args.GetU32("encode-us", ENCODE_US_DEFAULT);
+    config.isSpin = args.Has("spin");
+    config.startupIterations = args.GetU32("startup-iterations", STARTUP_ITERATIONS_DEFAULT);
+    config.createUs = args.GetU32("create-us", CREATE_US_DEFAULT);
+    config.initUs = args.GetU32("init-us", INIT_US_DEFAULT);
+    config.sessions = args.GetU32("sessions", SESSIONS_DEFAULT);
+    config.hwSessions = args.GetU32("hw-sessions", HW_SESSIONS_DEFAULT);
+    config.executorSessions = std::max(1U, args.GetU32("executor-sessions", EXECUTOR_SESSIONS_DEFAULT));
+    config.executorFrames = std::max(1U, args.GetU32("executor-frames", EXECUTOR_FRAMES_DEFAULT));
+    config.executor.threadCount = args.GetU32("executor-threads", 0);
+    std::string affinity = args.GetString("affinity", "none");
+    config.executor.affinity = (affinity == "core") ? VMI_EXECUTOR_AFFINITY_CORE :
+        ((affinity == "node") ? VMI_EXECUTOR_AFFINITY_NODE : VMI_EXECUTOR_AFFINITY_NONE);
+    config.nalOutputSize = args.GetU32("nal-output-size", NAL_OUTPUT_SIZE_DEFAULT);
+    config.capturePath = args.GetString("capture-path", CAPTURE_PATH_DEFAULT);
+    config.frameTracePath = args.GetString("frame-trace-path", FRAME_TRACE_PATH_DEFAULT);
+    config.overloadEncodeUs = args.GetU32("overload-encode-us", OVERLOAD_ENCODE_US_DEFAULT);
+    config.overloadFrames = std::max(1U, args.GetU32("overload-frames", OVERLOAD_FRAMES_DEFAULT));
+    std::string testCase = args.GetString("case", "all");
+
+    // 主机替身从环境变量读取系统属性，用户未设置时使用OpenH264并只打印错误日志
+    SetEnv("VMI_DEMO_VIDEO_ENCODER_TYPE", ENCODER_TYPE_OPENH264, false);
+    SetEnv("RO_VMI_LOGLEVEL", 6, false);  // ANDROID_LOG_ERROR
+
+    std::vector<uint8_t> frame(config.width * config.height * 3 / 2, 0x80);
+    FILE *output = OpenOutput(args);
+    JsonWriter json(output);
+    json.BeginObject();
+    json.Field("benchmark", "vmi_encoder");
+    json.BeginObject("config");
+    json.Field("width", config.width);
+    json.Field("height", config.height);
+    json.Field("frames", config.frames);
+    json.Field("iterations", config.iterations);
+    json.Field("threads", config.threads);
+    json.Field("handles", config.handles);
+    json.Field("hardware_concurrency", std::thread::hardware_concurrency());
+    json.EndObject();
+    json.BeginObject("results");
+    if (testCase == "all" || testCase == "lifecycle") {
+        RunLifecycle(config, json);
+    }
+    if (testCase == "all" || testCase == "overhead") {
+        RunOverhead(config, frame, json);
+    }
+    if (testCase == "all" || testCase == "throughput") {
+        RunThroughput(config, frame, json);
+    }
+    if (testCase == "all" || testCase == "contention") {
+        RunContention(config, frame, json);
+    }
+    if (testCase == "all" || testCase == "startup") {
+        RunStartup(config, frame, json);
+    }
+    if (testCase == "all" || testCase == "scheduling") {
+        RunScheduling(config, json);
+    }
+    if (testCase == "all" || testCase == "simulcast") {
+        RunSimulcast(config, json);
+    }
+    if (testCase == "all" || testCase == "executor") {
+        RunExecutor(config, json);
+    }
+    if (testCase == "all" || testCase == "nal") {
+        RunNalIndex(config, frame, json);
+    }
+    if (testCase == "all" || testCase == "capture") {
+        RunCapture(config, json);
+    }
+    if (testCase == "all" || testCase == "trace") {
+        RunFrameTrace(config, frame, json);
+    }
+    if (testCase == "all" || testCase == "overload") {
+        RunOverload(config, json);
+    }
+    json.EndObject();
+    json.EndObject();
+    json.Finish();
+    CloseOutput(output);
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * 功能说明: 主机构建使用的Android系统接口替身实现，日志输出到标准错误，系统属性从环境变量读取
+ */
+
+#include <android/log.h>
+#include <sys/system_properties.h>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+    char GetPriorityChar(int prio)
+    {
+        static const char priorityChars[] = "??VDIWEFS";
+        if (prio < ANDROID_LOG_UNKNOWN || prio > ANDROID_LOG_SILENT) {
+            return '?';
+        }
+        return priorityChars[prio];
+    }
+}
+
+int __android_log_write(int prio, const char *tag, const char *text)
+{
+    // 单次fprintf调用，多线程打印时不会交错
+    return fprintf(stderr, "%c/%s: %s\n", GetPriorityChar(prio), (tag == nullptr) ? "" : tag,
+        (text == nullptr) ? "" : text);
+}
+
+int __android_log_print(int prio, const char *tag, const char *fmt, ...)
+{
+    constexpr int logBufSize = 512;
+    char buf[logBufSize] = {0};
+    va_list ap;
+    va_start(ap, fmt);
+    (void) vsnprintf(buf, logBufSize, fmt, ap);
+    va_end(ap);
+    return __android_log_write(prio, tag, buf);
+}
+
+int __system_property_get(const char *name, char *value)
+{
+    if (name == nullptr || value == nullptr) {
+        return 0;
+    }
+    value[0] = '\0';
+    std::string envName(name);
+    for (auto &c : envName) {
+        c = (c == '.') ? '_' : static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    const char *env = getenv(envName.c_str());
+    if (env == nullptr) {
+        return 0;
+    }
+    size_t len = strnlen(env, PROP_VALUE_MAX - 1);
+    (void) memcpy(value, env, len);
+    value[len] = '\0';
+    return static_cast<int>(len);
+}
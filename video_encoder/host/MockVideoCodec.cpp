@@ -0,0 +1,354 @@
+/*
+ * 功能说明: 主机构建使用的模拟libVideoCodec.so，按环境变量配置的时延和输出大小模拟编码，
+ *           输出为合法的Annex-B起始码+NAL头，码流内容无意义，仅用于测量封装层开销和并发行为
+ *
+ * 环境变量(创建编码器实例时读取，未设置时使用默认值):
+ *   VMI_MOCK_CREATE_US       创建实例耗时，单位微秒，默认0
+ *   VMI_MOCK_INIT_US         初始化耗时，单位微秒，默认0
+ *   VMI_MOCK_START_US        启动耗时，单位微秒，默认0
+ *   VMI_MOCK_ENCODE_US       编码一帧耗时，单位微秒，默认0
+ *   VMI_MOCK_ENCODE_SPIN     非0时编码耗时以忙等模拟(占用CPU，模拟软件编码)，按线程CPU时间计时，
+ *                            线程数多于CPU数时被抢占的时间不计入，默认睡眠(模拟硬件编码)
+ *   VMI_MOCK_READ_INPUT      非0时编码时完整读取一遍输入数据，模拟编码器的内存带宽消耗，默认0
+ *   VMI_MOCK_OUTPUT_SIZE     非关键帧输出大小，单位字节，默认按码率/帧率计算
+ *   VMI_MOCK_KEY_FRAME_RATIO 关键帧输出大小相对非关键帧的倍数，默认4
+ *   VMI_MOCK_OPENH264_SESSIONS OpenH264同时存在的会话数上限，0表示不限制，默认0
+ *   VMI_MOCK_NETINT_SESSIONS   NETINT设备同时存在的会话数上限，h.264和h.265共用，0表示不限制，默认0
+ *   VMI_MOCK_CAPACITY_AT_INIT  非0时会话数上限在初始化时检查(模拟初始化时才申请硬件资源)，默认在创建时检查
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <thread>
+#include <vector>
+#include "VideoCodecApi.h"
+
+namespace {
+    constexpr uint32_t OUTPUT_SIZE_MIN = 64;
+    constexpr uint32_t KEY_FRAME_RATIO_DEFAULT = 4;
+    constexpr uint32_t BITS_PER_BYTE = 8;
+    constexpr uint8_t START_CODE[] = { 0, 0, 0, 1 };
+
+    // H.264/H.265 NAL头
+    constexpr uint8_t H264_SPS = 0x67;
+    constexpr uint8_t H264_PPS = 0x68;
+    constexpr uint8_t H264_IDR = 0x65;
+    constexpr uint8_t H264_SLICE = 0x41;
+    constexpr uint8_t H265_VPS[] = { 0x40, 0x01 };
+    constexpr uint8_t H265_SPS[] = { 0x42, 0x01 };
+    constexpr uint8_t H265_PPS[] = { 0x44, 0x01 };
+    constexpr uint8_t H265_IDR[] = { 0x26, 0x01 };
+    constexpr uint8_t H265_SLICE[] = { 0x02, 0x01 };
+    constexpr uint32_t PARAM_SET_PAYLOAD = 12;
+    constexpr uint8_t PAYLOAD_FILL = 0x5a;
+
+    MediaLogCallbackFunc g_logCallback = nullptr;
+
+    // 按设备统计占用的会话数，NETINT h.264和h.265共用同一设备
+    enum MockDevice : uint32_t {
+        MOCK_DEVICE_CPU = 0,
+        MOCK_DEVICE_NETINT = 1,
+        MOCK_DEVICE_COUNT = 2
+    };
+    std::atomic<uint32_t> g_deviceSessions[MOCK_DEVICE_COUNT] = {};
+
+    uint32_t GetMockDevice(uint32_t encType)
+    {
+        return (encType == ENCODER_TYPE_OPENH264) ? MOCK_DEVICE_CPU : MOCK_DEVICE_NETINT;
+    }
+
+    // 占用设备上的一个会话，maxSessions为0表示不限制
+    bool AcquireSession(uint32_t device, uint32_t maxSessions)
+    {
+        uint32_t sessions = g_deviceSessions[device].load();
+        do {
+            if (maxSessions != 0 && sessions >= maxSessions) {
+                return false;
+            }
+        } while (!g_deviceSessions[device].compare_exchange_weak(sessions, sessions + 1));
+        return true;
+    }
+
+    void ReleaseSession(uint32_t device)
+    {
+        --g_deviceSessions[device];
+    }
+
+    void LogError(const char *message)
+    {
+        if (g_logCallback != nullptr) {
+            g_logCallback(LOG_LEVEL_ERROR, "MockVideoCodec", message);
+        }
+    }
+
+    uint32_t GetEnvU32(const char *name, uint32_t defaultValue)
+    {
+        const char *env = getenv(name);
+        if (env == nullptr || *env == '\0') {
+            return defaultValue;
+        }
+        return static_cast<uint32_t>(strtoul(env, nullptr, 0));
+    }
+
+    void Delay(uint32_t us, bool isSpin)
+    {
+        if (us == 0) {
+            return;
+        }
+        if (!isSpin) {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+            return;
+        }
+        constexpr uint64_t nsPerUs = 1000;
+        constexpr uint64_t nsPerSec = 1000000000;
+        auto getThreadCpuNs = []() {
+            struct timespec ts = {};
+            (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * nsPerSec + static_cast<uint64_t>(ts.tv_nsec);
+        };
+        uint64_t end = getThreadCpuNs() + us * nsPerUs;
+        while (getThreadCpuNs() < end) {
+        }
+    }
+
+    struct MockConfig {
+        uint32_t createUs = 0;
+        uint32_t initUs = 0;
+        uint32_t startUs = 0;
+        uint32_t encodeUs = 0;
+        bool isSpin = false;
+        bool isReadInput = false;
+        uint32_t outputSize = 0;
+        uint32_t keyFrameRatio = KEY_FRAME_RATIO_DEFAULT;
+        uint32_t maxSessions = 0;
+        bool isCapacityAtInit = false;
+    };
+
+    MockConfig LoadMockConfig(uint32_t encType)
+    {
+        MockConfig config;
+        config.createUs = GetEnvU32("VMI_MOCK_CREATE_US", 0);
+        config.initUs = GetEnvU32("VMI_MOCK_INIT_US", 0);
+        config.startUs = GetEnvU32("VMI_MOCK_START_US", 0);
+        config.encodeUs = GetEnvU32("VMI_MOCK_ENCODE_US", 0);
+        config.isSpin = GetEnvU32("VMI_MOCK_ENCODE_SPIN", 0) != 0;
+        config.isReadInput = GetEnvU32("VMI_MOCK_READ_INPUT", 0) != 0;
+        config.outputSize = GetEnvU32("VMI_MOCK_OUTPUT_SIZE", 0);
+        config.keyFrameRatio = GetEnvU32("VMI_MOCK_KEY_FRAME_RATIO", KEY_FRAME_RATIO_DEFAULT);
+        config.maxSessions = GetEnvU32((GetMockDevice(encType) == MOCK_DEVICE_CPU) ?
+            "VMI_MOCK_OPENH264_SESSIONS" : "VMI_MOCK_NETINT_SESSIONS", 0);
+        config.isCapacityAtInit = GetEnvU32("VMI_MOCK_CAPACITY_AT_INIT", 0) != 0;
+        return config;
+    }
+
+    class MockVideoEncoder : public VideoEncoder {
+    public:
+        MockVideoEncoder(uint32_t encType, const MockConfig &config, bool hasSession)
+            : m_encType(encType), m_config(config), m_hasSession(hasSession) {}
+
+        ~MockVideoEncoder() override
+        {
+            if (m_hasSession) {
+                ReleaseSession(GetMockDevice(m_encType));
+            }
+        }
+
+        EncoderRetCode InitEncoder(const EncodeParams &encParams) override
+        {
+            Delay(m_config.initUs, false);
+            if (!m_hasSession) {
+                if (!AcquireSession(GetMockDevice(m_encType), m_config.maxSessions)) {
+                    LogError("init mock video encoder failed: device sessions exhausted");
+                    return VIDEO_ENCODER_INIT_FAIL;
+                }
+                m_hasSession = true;
+            }
+            return ApplyParams(encParams) ? VIDEO_ENCODER_SUCCESS : VIDEO_ENCODER_INIT_FAIL;
+        }
+
+        EncoderRetCode StartEncoder() override
+        {
+            Delay(m_config.startUs, false);
+            m_isStarted = true;
+            m_isKeyFramePending = true;
+            return VIDEO_ENCODER_SUCCESS;
+        }
+
+        EncoderRetCode EncodeOneFrame(const uint8_t *inputData, uint32_t inputSize,
+            uint8_t **outputData, uint32_t *outputSize) override
+        {
+            if (!m_isStarted || inputData == nullptr || outputData == nullptr || outputSize == nullptr) {
+                return VIDEO_ENCODER_ENCODE_FAIL;
+            }
+            if (m_config.isReadInput) {
+                m_checksum += Checksum(inputData, inputSize);
+            }
+            Delay(m_config.encodeUs, m_config.isSpin);
+            bool isKeyFrame = m_isKeyFramePending || (m_params.gopSize != 0 && m_frameIndex % m_params.gopSize == 0);
+            m_isKeyFramePending = false;
+            ++m_frameIndex;
+            uint32_t size = isKeyFrame ? m_frameSize * m_config.keyFrameRatio : m_frameSize;
+            uint32_t offset = isKeyFrame ? WriteKeyFrameHeaders() : 0;
+            offset = WriteSliceNal(offset, isKeyFrame);
+            size = std::max(size, offset);
+            if (m_output.size() < size) {
+                m_output.resize(size);
+            }
+            // 填充切片负载，覆盖上一帧残留的NAL起始码
+            (void) memset(m_output.data() + offset, PAYLOAD_FILL, size - offset);
+            *outputData = m_output.data();
+            *outputSize = size;
+            return VIDEO_ENCODER_SUCCESS;
+        }
+
+        EncoderRetCode StopEncoder() override
+        {
+            m_isStarted = false;
+            return VIDEO_ENCODER_SUCCESS;
+        }
+
+        void DestroyEncoder() override
+        {
+            m_isStarted = false;
+            std::vector<uint8_t>().swap(m_output);
+        }
+
+        EncoderRetCode ResetEncoder() override
+        {
+            m_frameIndex = 0;
+            m_isKeyFramePending = true;
+            return VIDEO_ENCODER_SUCCESS;
+        }
+
+        EncoderRetCode ForceKeyFrame() override
+        {
+            m_isKeyFramePending = true;
+            return VIDEO_ENCODER_SUCCESS;
+        }
+
+        EncoderRetCode SetEncodeParams(const EncodeParams &encParams) override
+        {
+            return ApplyParams(encParams) ? VIDEO_ENCODER_SUCCESS : VIDEO_ENCODER_SET_ENCODE_PARAMS_FAIL;
+        }
+
+    private:
+        bool IsH265() const
+        {
+            return m_encType == ENCODER_TYPE_NETINTH265;
+        }
+
+        bool ApplyParams(const EncodeParams &encParams)
+        {
+            if (encParams.width == 0 || encParams.height == 0 || encParams.frameRate == 0) {
+                return false;
+            }
+            m_params = encParams;
+            m_frameSize = m_config.outputSize;
+            if (m_frameSize == 0) {
+                m_frameSize = encParams.bitrate / BITS_PER_BYTE / encParams.frameRate;
+            }
+            m_frameSize = std::max(m_frameSize, OUTPUT_SIZE_MIN);
+            return true;
+        }
+
+        static uint8_t Checksum(const uint8_t *data, uint32_t size)
+        {
+            uint8_t sum = 0;
+            for (uint32_t i = 0; i < size; ++i) {
+                sum ^= data[i];
+            }
+            return sum;
+        }
+
+        uint32_t WriteBytes(uint32_t offset, const uint8_t *data, uint32_t size)
+        {
+            if (m_output.size() < offset + size) {
+                m_output.resize(offset + size);
+            }
+            (void) memcpy(m_output.data() + offset, data, size);
+            return offset + size;
+        }
+
+        uint32_t WriteParamSet(uint32_t offset, const uint8_t *header, uint32_t headerSize)
+        {
+            offset = WriteBytes(offset, START_CODE, sizeof(START_CODE));
+            offset = WriteBytes(offset, header, headerSize);
+            const uint8_t payload[PARAM_SET_PAYLOAD] = { 0x42, 0xc0, 0x1f, 0xda, 0x01, 0x40, 0x16, 0xe8,
+                0x40, 0x00, 0x00, 0x03 };
+            return WriteBytes(offset, payload, sizeof(payload));
+        }
+
+        uint32_t WriteKeyFrameHeaders()
+        {
+            uint32_t offset = 0;
+            if (IsH265()) {
+                offset = WriteParamSet(offset, H265_VPS, sizeof(H265_VPS));
+                offset = WriteParamSet(offset, H265_SPS, sizeof(H265_SPS));
+                return WriteParamSet(offset, H265_PPS, sizeof(H265_PPS));
+            }
+            offset = WriteParamSet(offset, &H264_SPS, 1);
+            return WriteParamSet(offset, &H264_PPS, 1);
+        }
+
+        // 写入切片NAL头，负载保持缓冲区原有内容
+        uint32_t WriteSliceNal(uint32_t offset, bool isKeyFrame)
+        {
+            offset = WriteBytes(offset, START_CODE, sizeof(START_CODE));
+            if (IsH265()) {
+                return WriteBytes(offset, isKeyFrame ? H265_IDR : H265_SLICE, sizeof(H265_SLICE));
+            }
+            return WriteBytes(offset, isKeyFrame ? &H264_IDR : &H264_SLICE, 1);
+        }
+
+        uint32_t m_encType = 0;
+        MockConfig m_config = {};
+        EncodeParams m_params = {};
+        uint32_t m_frameSize = OUTPUT_SIZE_MIN;
+        uint64_t m_frameIndex = 0;
+        bool m_isStarted = false;
+        bool m_isKeyFramePending = true;
+        bool m_hasSession = false;  // 是否占用设备会话
+        uint8_t m_checksum = 0;
+        std::vector<uint8_t> m_output = {};
+    };
+}
+
+void RegisterMediaLogCallback(const MediaLogCallbackFunc logCallback)
+{
+    g_logCallback = logCallback;
+}
+
+EncoderRetCode CreateVideoEncoder(uint32_t encType, VideoEncoder** encoder)
+{
+    if (encoder == nullptr || encType < ENCODER_TYPE_OPENH264 || encType > ENCODER_TYPE_NETINTH265) {
+        LogError("create mock video encoder failed: invalid param");
+        return VIDEO_ENCODER_CREATE_FAIL;
+    }
+    MockConfig config = LoadMockConfig(encType);
+    Delay(config.createUs, false);
+    bool hasSession = !config.isCapacityAtInit;
+    if (hasSession && !AcquireSession(GetMockDevice(encType), config.maxSessions)) {
+        LogError("create mock video encoder failed: device sessions exhausted");
+        return VIDEO_ENCODER_CREATE_FAIL;
+    }
+    *encoder = new (std::nothrow) MockVideoEncoder(encType, config, hasSession);
+    if (*encoder == nullptr) {
+        if (hasSession) {
+            ReleaseSession(GetMockDevice(encType));
+        }
+        return VIDEO_ENCODER_CREATE_FAIL;
+    }
+    return VIDEO_ENCODER_SUCCESS;
+}
+
+EncoderRetCode DestroyVideoEncoder(uint32_t encType, VideoEncoder* encoder)
+{
+    (void) encType;
+    delete encoder;
+    return VIDEO_ENCODER_SUCCESS;
+}
@@ -0,0 +1,33 @@
+/*
+ * 功能说明: 主机构建使用的Android日志接口替身，仅声明libVideoEncoder用到的部分
+ */
+#ifndef VMI_HOST_ANDROID_LOG_H
+#define VMI_HOST_ANDROID_LOG_H
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum android_LogPriority {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+} android_LogPriority;
+
+int __android_log_write(int prio, const char *tag, const char *text);
+
+int __android_log_print(int prio, const char *tag, const char *fmt, ...) __attribute__((format (printf, 3, 4)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // VMI_HOST_ANDROID_LOG_H
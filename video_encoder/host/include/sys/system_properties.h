@@ -0,0 +1,26 @@
+/*
+ * 功能说明: 主机构建使用的Android系统属性接口替身，属性值从环境变量读取
+ */
+#ifndef VMI_HOST_SYS_SYSTEM_PROPERTIES_H
+#define VMI_HOST_SYS_SYSTEM_PROPERTIES_H
+
+#define PROP_VALUE_MAX 92
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @功能描述: 读取系统属性，属性名中的'.'替换为'_'并转为大写后作为环境变量名，
+ *            例如"vmi.demo.video.encoder.type"对应环境变量VMI_DEMO_VIDEO_ENCODER_TYPE
+ * @参数 [in] name: 属性名
+ * @参数 [out] value: 属性值，长度不超过PROP_VALUE_MAX
+ * @返回值: 属性值长度，属性不存在时返回0
+ */
+int __system_property_get(const char *name, char *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // VMI_HOST_SYS_SYSTEM_PROPERTIES_H